@@ -149,6 +149,7 @@ def ModifyAntEvoloConfigFile(params, log):
     param_dict['shm_kmer_model_igk'] = os.path.join(home_directory, "data/shm_model/NoKNeighbours_IGK.csv")
     param_dict['shm_kmer_model_igl'] = os.path.join(home_directory, "data/shm_model/NoKNeighbours_IGL.csv")
     param_dict['num_threads'] = params.num_threads
+    param_dict['tree_output_mode'] = "archive" if params.tree_archive else "files"
     ModifyParallelModeParams(params, param_dict)
     process_cfg.substitute_params(params.antevolo_config_file, param_dict, log)
 
@@ -234,6 +235,12 @@ def main(argv):
                                default="",
                                help="RCM file with the decomposition")
     optional_args.set_defaults(compare=False)
+    out_args.add_argument("--tree-archive",
+                          action="store_true",
+                          dest="tree_archive",
+                          help="Write all clonal trees, their vertices and SHMs into a few indexed files " +
+                               "instead of separate files per tree")
+    out_args.set_defaults(tree_archive=False)
 
     algorithm_args = parser.add_argument_group("Algorithm arguments")
     algorithm_args.add_argument("--tau",
@@ -118,7 +118,7 @@ def main(argv, external_logger = ""):
                             type=str,
                             default="",
                             dest="graph",
-                            help="Input graph in GRAPH format")
+                            help="Input graph in GRAPH format or in binary format (.igb)")
     input_args.add_argument("--test",
                             action="store_const",
                             const=os.path.join(home_directory, "test_dataset/dsf/test.graph"),
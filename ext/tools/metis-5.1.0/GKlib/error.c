@@ -14,6 +14,7 @@ This file contains functions dealing with error reporting and termination
                          as an extern function in GKlib.h */
 
 #include <GKlib.h>
+#include <pthread.h>
 
 
 /* These are the jmp_buf for the graceful exit in case of severe errors.
@@ -28,8 +29,13 @@ typedef void (*gksighandler_t)(int);
 /* These are the holders of the old singal handlers for the trapped signals */
 static __thread gksighandler_t old_SIGMEM_handler;  /* Custom signal */
 static __thread gksighandler_t old_SIGERR_handler;  /* Custom signal */
-static __thread gksighandler_t old_SIGMEM_handlers[MAX_JBUFS];  /* Custom signal */
-static __thread gksighandler_t old_SIGERR_handlers[MAX_JBUFS];  /* Custom signal */
+
+/* Signal dispositions are shared by all threads, while the jump buffers are
+   thread-local. So gk_sigthrow is installed once per process and is never
+   uninstalled, and these are the handlers it replaced */
+static pthread_once_t gk_sigthrow_once = PTHREAD_ONCE_INIT;
+static gksighandler_t old_SIGMEM_sigthrow_handler;
+static gksighandler_t old_SIGERR_sigthrow_handler;
 
 /* The following is used to control if the gk_errexit() will actually abort or not.
    There is always a single copy of this variable */
@@ -95,15 +101,20 @@ void gk_errexit(int signum, char *f_str,...)
     of a longjmp
 */
 /***************************************************************************/
+static void gk_install_sigthrow()
+{
+  old_SIGMEM_sigthrow_handler = signal(SIGMEM,  gk_sigthrow);
+  old_SIGERR_sigthrow_handler = signal(SIGERR,  gk_sigthrow);
+}
+
 int gk_sigtrap() 
 {
   if (gk_cur_jbufs+1 >= MAX_JBUFS)
     return 0;
 
-  gk_cur_jbufs++;
+  pthread_once(&gk_sigthrow_once, gk_install_sigthrow);
 
-  old_SIGMEM_handlers[gk_cur_jbufs]  = signal(SIGMEM,  gk_sigthrow);
-  old_SIGERR_handlers[gk_cur_jbufs]  = signal(SIGERR,  gk_sigthrow);
+  gk_cur_jbufs++;
 
   return 1;
 }
@@ -118,9 +129,6 @@ int gk_siguntrap()
   if (gk_cur_jbufs == -1)
     return 0;
 
-  signal(SIGMEM,  old_SIGMEM_handlers[gk_cur_jbufs]);
-  signal(SIGERR,  old_SIGERR_handlers[gk_cur_jbufs]);
-
   gk_cur_jbufs--;
 
   return 1;
@@ -129,12 +137,27 @@ int gk_siguntrap()
 
 /*************************************************************************/
 /*! This function is the custome signal handler, which all it does is to
-    perform a longjump to the most recent saved environment 
+    perform a longjump to the most recent saved environment. Signals raised
+    by threads that are not inside a trapped region are passed to the handler
+    that was replaced by gk_sigthrow
  */
 /*************************************************************************/
 void gk_sigthrow(int signum)
 {
-  longjmp(gk_jbufs[gk_cur_jbufs], signum);
+  gksighandler_t old_handler;
+
+  if (gk_cur_jbufs != -1)
+    longjmp(gk_jbufs[gk_cur_jbufs], signum);
+
+  old_handler = (signum == SIGMEM ? old_SIGMEM_sigthrow_handler : old_SIGERR_sigthrow_handler);
+  if (old_handler == SIG_IGN)
+    return;
+  if (old_handler == SIG_DFL || old_handler == SIG_ERR) {
+    signal(signum, SIG_DFL);
+    raise(signum);
+    return;
+  }
+  old_handler(signum);
 }
   
 
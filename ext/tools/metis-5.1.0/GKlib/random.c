@@ -62,9 +62,10 @@ GK_MKRANDOM(gk_z,   size_t, ssize_t)
 
 
 /* The array for the state vector */
-static uint64_t mt[NN]; 
+/* The state is thread-local so that METIS can be called from several threads of the same process */
+static __thread uint64_t mt[NN]; 
 /* mti==NN+1 means mt[NN] is not initialized */
-static int mti=NN+1; 
+static __thread int mti=NN+1; 
 #endif /* USE_GKRAND */
 
 /* initializes mt[NN] with a seed */
@@ -104,6 +104,26 @@ def parse_args():
                                default=10,
                                dest="number_of_metaroots")
 
+    optional_args.add_argument("-t", "--threads",
+                               type=check_positive,
+                               default=16,
+                               dest="num_threads",
+                               help="Threads number [default: %(default)d]")
+
+    optional_args.add_argument("--seed",
+                               type=int,
+                               default=0,
+                               dest="random_seed",
+                               help="Random seed, simulation is reproducible for a fixed seed "
+                                    "and any number of threads. 0 means a random seed [default: %(default)d]")
+
+    optional_args.add_argument("--tree-dot-files",
+                               action="store_true",
+                               dest="tree_dot_files",
+                               help="Write every clonal tree into a separate .dot file in trees_dir "
+                                    "instead of the single trees.archive file")
+    optional_args.set_defaults(tree_dot_files=False)
+
     optional_args.add_argument("-h", "--help",
                                action="help",
                                help="Help message and exit")
@@ -136,6 +156,8 @@ def PrintParams(params, log):
     log.info("  Loci:\t\t\t" + params.loci)
     log.info("  # of metaroots:\t\t" + str(params.number_of_metaroots) + "\n")
     log.info("  Tree strategy:\t\t" + params.tree_strategy + "\n")
+    log.info("  Threads:\t\t\t" + str(params.num_threads))
+    log.info("  Random seed:\t\t" + str(params.random_seed) + "\n")
 
 ########################################################################################################################
 
@@ -174,6 +196,9 @@ def ModifyConfigFiles(params, log):
     igs_params_dict['loci'] = params.loci
     igs_params_dict['number_of_metaroots'] = params.number_of_metaroots
     igs_params_dict['pool_manager_strategy'] = params.tree_strategy
+    igs_params_dict['num_threads'] = params.num_threads
+    igs_params_dict['random_seed'] = params.random_seed
+    igs_params_dict['tree_output_mode'] = "files" if params.tree_dot_files else "archive"
     igs_params_dict['germline_dir'] = os.path.join(home_directory, "data/germline")
     igs_params_dict['cdr_labeler_config_filename'] = params.cdr_labeler_config_filename
 
@@ -139,7 +139,9 @@ class IgRepConIO:
         self.__log = log
         self.__initVJFinderOutput(output_dir)
         self.__initCompressorOutput(output_dir)
-        self.sw_graph = os.path.join(output_dir, "sw.graph")
+        # graph is passed only between ig_swgraph_construct and dense_sgraph_finder, so it is kept in binary format
+        # (ig_binary_export converts it to GRAPH format); reads, read maps and decompositions are parsed by python tools
+        self.sw_graph = os.path.join(output_dir, "sw.igb")
         self.__initDSFOutput(output_dir)
         self.__initFinalOutput(output_dir)
         self.final_stripped_clusters_fa = os.path.join(output_dir, 'final_repertoire_large.fa')
@@ -221,10 +223,11 @@ class PairReadMergerPhase(Phase):
         )
 
     def _Run(self):
-        command_line = "%s %s %s %s" % (IgRepConConfig().run_pair_reads_merger,
-                                        self.__params.left_reads,
-                                        self.__params.right_reads,
-                                        self.__params.single_reads)
+        command_line = "%s %s %s %s --threads=%d" % (IgRepConConfig().run_pair_reads_merger,
+                                                     self.__params.left_reads,
+                                                     self.__params.right_reads,
+                                                     self.__params.single_reads,
+                                                     self.__params.num_threads)
         cpuprofile = self.__params.output + "/pair_read_merger_prof.out" if self.__params.profile else None
         support.sys_call_ex(command_line, self._log, cpuprofile=cpuprofile)
 
@@ -305,7 +308,8 @@ class TrieCompressionPhase(Phase):
 
     def _Run(self):
         command_line = IgRepConConfig().run_trie_compressor + " -i " + self.__params.io.cropped_reads + \
-                    " -o " + self.__params.io.compressed_reads + " -m " + self.__params.io.map_file + " -Toff"
+                    " -o " + self.__params.io.compressed_reads + " -m " + self.__params.io.map_file + " -Toff" + \
+                    " -t " + str(self.__params.num_threads)
         cpuprofile = self.__params.output + "/trie_compressor_prof.out" if self.__params.profile else None
         support.sys_call_ex(command_line, self._log, cpuprofile=cpuprofile)
 
@@ -30,7 +30,7 @@ namespace algorithms {
     template<typename SubjectDatabase, typename StringType>
     class PairwiseBlockAligner {
         const SubjectQueryKmerIndex<SubjectDatabase, StringType> &kmer_index_;
-        KmerIndexHelper<SubjectDatabase, StringType> &kmer_index_helper_;
+        const KmerIndexHelper<SubjectDatabase, StringType> &kmer_index_helper_;
         const BlockAlignmentScoringScheme scoring_;
         const BlockAlignerParams params_;
 
@@ -99,7 +99,7 @@ namespace algorithms {
 
     public:
         PairwiseBlockAligner(const SubjectQueryKmerIndex<SubjectDatabase, StringType> &kmer_index,
-                             KmerIndexHelper<SubjectDatabase, StringType> &kmer_index_helper,
+                             const KmerIndexHelper<SubjectDatabase, StringType> &kmer_index_helper,
                              BlockAlignmentScoringScheme scoring, BlockAlignerParams params) :
                 kmer_index_(kmer_index),
                 kmer_index_helper_(kmer_index_helper),
@@ -23,7 +23,7 @@ namespace algorithms {
         // input parameters
         const SubjectDatabase & db_;
         size_t k_;
-        KmerIndexHelper<SubjectDatabase, StringType>& kmer_index_helper_;
+        const KmerIndexHelper<SubjectDatabase, StringType>& kmer_index_helper_;
 
         // inner structure
         std::unordered_map<size_t, std::vector<SubjectPosition>> kmer_query_pos_map_;
@@ -45,7 +45,7 @@ namespace algorithms {
     public:
         SubjectQueryKmerIndex(const SubjectDatabase &db,
                               size_t k,
-                              KmerIndexHelper<SubjectDatabase, StringType>& kmer_index_helper) :
+                              const KmerIndexHelper<SubjectDatabase, StringType>& kmer_index_helper) :
                 db_(db),
                 k_(k),
                 kmer_index_helper_(kmer_index_helper) {
@@ -54,6 +54,7 @@ namespace algorithms {
 
         const SubjectDatabase & Db() const { return db_; }
 
+        // index is immutable after construction, so it can be queried from several threads simultaneously
         bool SubjectsContainKmer(size_t kmer) const {
             return kmer_query_pos_map_.find(kmer) != kmer_query_pos_map_.end();
         }
@@ -73,10 +74,10 @@ namespace algorithms {
             size_t start = 0;
             size_t finish = kmer_index_helper_.GetStringLength(query_str);
             for(size_t j = start; j < finish - k() + 1; ++j) {
-                auto kmer = query_hashes[j];
-                if(!SubjectsContainKmer(kmer))
+                auto kmer_it = kmer_query_pos_map_.find(query_hashes[j]);
+                if(kmer_it == kmer_query_pos_map_.end())
                     continue;
-                auto subj_pos = GetSubjectPositions(kmer);
+                const auto &subj_pos = kmer_it->second;
                 //for (const auto &p : subj_it.second) {
                 for(auto it = subj_pos.begin(); it != subj_pos.end(); it++) {
                     size_t kmer_pos_in_query = j;
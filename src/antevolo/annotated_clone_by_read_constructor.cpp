@@ -4,7 +4,7 @@
 namespace antevolo {
     annotation_utils::AnnotatedClone AnnotatedCloneByReadConstructor::GetCloneByRead(core::Read& read) const {
 
-        vj_finder::VJQueryAligner vj_query_aligner(vj_finder_params_, labeled_v_db_, labeled_j_db_);
+        vj_finder::VJQueryAligner vj_query_aligner(vj_finder_params_, *labeled_germline_index_);
         vj_finder::VJHits vj_hits = vj_query_aligner.Align(read);
         cdr_labeler::ReadCDRLabeler read_labeler(shm_config_, v_labeling_, j_labeling_);
         return read_labeler.CreateAnnotatedClone(vj_hits);
@@ -4,6 +4,7 @@
 #include <annotation_utils/annotated_clone.hpp>
 #include <read_labeler.hpp>
 #include <vj_finder_config.hpp>
+#include <vj_germline_index.hpp>
 
 namespace antevolo {
 
@@ -14,6 +15,8 @@ namespace antevolo {
         const cdr_labeler::DbCDRLabeling& j_labeling_;
         const vj_finder::VJFinderConfig::AlgorithmParams& vj_finder_params_;
         const cdr_labeler::CDRLabelerConfig::SHMFindingParams &shm_config_;
+        // k-mer index of labeled databases is constructed once and reused for all reads
+        std::shared_ptr<vj_finder::VJGermlineIndex> labeled_germline_index_;
     public:
         AnnotatedCloneByReadConstructor(germline_utils::CustomGeneDatabase& labeled_v_db,
                                         germline_utils::CustomGeneDatabase& labeled_j_db,
@@ -26,7 +29,10 @@ namespace antevolo {
                 v_labeling_(v_labeling),
                 j_labeling_(j_labeling),
                 vj_finder_params_(vj_finder_params),
-                shm_config_(shm_config) {}
+                shm_config_(shm_config),
+                labeled_germline_index_(std::make_shared<vj_finder::VJGermlineIndex>(vj_finder_params,
+                                                                                      labeled_v_db,
+                                                                                      labeled_j_db)) {}
 
         annotation_utils::AnnotatedClone GetCloneByRead(core::Read& read) const;
 
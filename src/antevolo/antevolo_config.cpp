@@ -16,12 +16,12 @@ namespace antevolo {
     }
 
     void update_paths(AntEvoloConfig::OutputParams &output_params) {
-        output_params.cdr_graph_dir = path::append_path(output_params.output_dir, output_params.cdr_graph_dir);
         output_params.tree_dir = path::append_path(output_params.output_dir, output_params.tree_dir);
         output_params.vertex_dir = path::append_path(output_params.output_dir, output_params.vertex_dir);
         output_params.trash_output = path::append_path(output_params.output_dir, output_params.trash_output);
         output_params.tree_details = path::append_path(output_params.output_dir, output_params.tree_details);
         output_params.tree_shm_dir = path::append_path(output_params.output_dir, output_params.tree_shm_dir);
+        output_params.tree_archive_dir = path::append_path(output_params.output_dir, output_params.tree_archive_dir);
         output_params.parallel_shm_output.parallel_bulges_dir = path::append_path(output_params.output_dir,
                                                                                   output_params.parallel_shm_output.parallel_bulges_dir);
         output_params.parallel_shm_output.parallel_shm_dir = path::append_path(output_params.output_dir,
@@ -35,15 +35,27 @@ namespace antevolo {
         load(parallel_shm_output.parallel_shm_dir, pt, "parallel_shm_dir");
     }
 
+    AntEvoloConfig::OutputParams::TreeOutputMode convert_str_tree_output_mode(const std::string &str) {
+        if(str == "files")
+            return AntEvoloConfig::OutputParams::TreeOutputMode::FilesTreeOutputMode;
+        if(str == "archive")
+            return AntEvoloConfig::OutputParams::TreeOutputMode::ArchiveTreeOutputMode;
+        VERIFY_MSG(false, "Unknown tree output mode: " << str);
+        return AntEvoloConfig::OutputParams::TreeOutputMode::UnknownTreeOutputMode;
+    }
+
     void load(AntEvoloConfig::OutputParams &output_params, boost::property_tree::ptree const &pt, bool) {
         using config_common::load;
         load(output_params.output_dir, pt, "output_dir");
-        load(output_params.cdr_graph_dir, pt, "cdr_graph_dir");
         load(output_params.trash_output, pt, "trash_output");
         load(output_params.tree_dir, pt, "tree_dir");
         load(output_params.vertex_dir, pt, "vertex_dir");
         load(output_params.tree_details, pt, "tree_details");
         load(output_params.tree_shm_dir, pt, "tree_shm_dir");
+        std::string tree_output_mode_str;
+        load(tree_output_mode_str, pt, "tree_output_mode");
+        output_params.tree_output_mode = convert_str_tree_output_mode(tree_output_mode_str);
+        load(output_params.tree_archive_dir, pt, "tree_archive_dir");
         load(output_params.parallel_shm_output, pt, "parallel_shm_output");
         update_paths(output_params);
     }
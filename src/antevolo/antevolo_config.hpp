@@ -18,7 +18,6 @@ namespace antevolo {
 
         struct OutputParams {
             std::string output_dir;
-            std::string cdr_graph_dir;
             std::string tree_dir;
             std::string vertex_dir;
             std::string trash_output;
@@ -26,6 +25,11 @@ namespace antevolo {
             std::string tree_details;
             std::string tree_shm_dir;
 
+            // archive mode writes all trees, vertices and tree SHMs into a few files with an offset index
+            enum TreeOutputMode { UnknownTreeOutputMode, FilesTreeOutputMode, ArchiveTreeOutputMode };
+            TreeOutputMode tree_output_mode;
+            std::string tree_archive_dir;
+
             struct ParallelSHMOutput {
                 std::string parallel_bulges_dir;
                 std::string parallel_shm_dir;
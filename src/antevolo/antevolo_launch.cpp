@@ -93,7 +93,8 @@ namespace antevolo {
         }
 
         cdr_labeler::ReadCDRLabeler read_labeler(config_.cdr_labeler_config.shm_params, v_labeling, j_labeling);
-        auto uncompressed_annotated_clone_set = read_labeler.CreateAnnotatedCloneSet(alignment_info);
+        auto uncompressed_annotated_clone_set = read_labeler.CreateAnnotatedCloneSet(
+                alignment_info, config_.cdr_labeler_config.run_params.num_threads);
         cdr_labeler::CDRLabelingWriter writer(config_.cdr_labeler_config.output_params,
                                               uncompressed_annotated_clone_set);
 
@@ -185,19 +186,26 @@ namespace antevolo {
 
         AntEvoloOutputWriter output_writer(config_.output_params, annotated_storage);
         output_writer.OutputTreeStats();
-        output_writer.OutputSHMForTrees();
+        bool archive_output = config_.output_params.tree_output_mode ==
+                AntEvoloConfig::OutputParams::TreeOutputMode::ArchiveTreeOutputMode;
+        if(!archive_output)
+            output_writer.OutputSHMForTrees();
 
         output_writer.OutputCleanedSequences(final_clone_set);
         INFO("Cleaned sequences were written to " << config_.output_params.output_dir << "/cleaned_sequences.fa");
 
-        for (auto it = connected_tree_storage.cbegin(); it != connected_tree_storage.cend(); it++) {
-            output_writer.WriteTreeInFile(config_.output_params.tree_dir, *it);
-            output_writer.WriteTreeVerticesInFile(config_.output_params.vertex_dir, *it);
-            //TRACE(i + 1 << "-th clonal tree was written to " << tree.Get);
+        if(archive_output) {
+            output_writer.OutputTreeArchive();
+        }
+        else {
+            for (auto it = connected_tree_storage.cbegin(); it != connected_tree_storage.cend(); it++) {
+                output_writer.WriteTreeInFile(config_.output_params.tree_dir, *it);
+                output_writer.WriteTreeVerticesInFile(config_.output_params.vertex_dir, *it);
+                //TRACE(i + 1 << "-th clonal tree was written to " << tree.Get);
+            }
+            INFO("Clonal trees were written to " << config_.output_params.tree_dir);
         }
         output_writer.WriteRcmFromStorageInFile(config_.output_params.output_dir, connected_tree_storage);
-
-        INFO("Clonal trees were written to " << config_.output_params.tree_dir);
     };
 
     void AntEvoloLaunch::AnalyzeParallelEvolution(const EvolutionaryTreeStorage& trees) {
@@ -1,5 +1,6 @@
 #include "antevolo_output_writer.hpp"
 #include "shm_counting/tree_based_shm_convertor.hpp"
+#include "tree_archive.hpp"
 
 namespace antevolo {
     void AntEvoloOutputWriter::OutputSHMForTrees() const {
@@ -12,10 +13,38 @@ namespace antevolo {
         INFO("Tree SHMs were written to " << output_params_.tree_shm_dir);
     }
 
-    void AntEvoloOutputWriter::WriteTreeSHMs(const AnnotatedEvolutionaryTree &tree, std::ofstream &out) const {
-        auto shm_map = tree.SHMMap();
+    void AntEvoloOutputWriter::OutputTreeArchive() const {
+        // trees are rendered in parallel by batches and appended to archive in order of their ids
+        const size_t batch_size = 4096;
+        TreeArchiveWriter archive_writer(output_params_.tree_archive_dir);
+        std::vector<std::string> tree_names;
+        std::vector<TreeSectionRecords> records;
+        for(size_t batch_start = 0; batch_start < annotated_storage_.size(); batch_start += batch_size) {
+            size_t batch_end = std::min(batch_start + batch_size, annotated_storage_.size());
+            tree_names.assign(batch_end - batch_start, "");
+            records.assign(batch_end - batch_start, TreeSectionRecords());
+#pragma omp parallel for schedule(dynamic, 16)
+            for(size_t i = batch_start; i < batch_end; i++) {
+                const auto &annotated_tree = annotated_storage_[i];
+                tree_names[i - batch_start] = annotated_tree.Tree().GetTreeOutputFname("");
+                std::ostringstream tree_out, vertices_out, shms_out;
+                WriteTree(annotated_tree.Tree(), tree_out);
+                WriteTreeVertices(annotated_tree.Tree(), vertices_out);
+                WriteTreeSHMs(annotated_tree, shms_out);
+                records[i - batch_start][TreeArchiveSection::TreeEdgesSection] = tree_out.str();
+                records[i - batch_start][TreeArchiveSection::TreeVerticesSection] = vertices_out.str();
+                records[i - batch_start][TreeArchiveSection::TreeSHMsSection] = shms_out.str();
+            }
+            for(size_t i = 0; i < records.size(); i++)
+                archive_writer.AddTree(tree_names[i], records[i]);
+        }
+        INFO(archive_writer.NumTrees() << " clonal trees were written to archive " << output_params_.tree_archive_dir);
+    }
+
+    void AntEvoloOutputWriter::WriteTreeSHMs(const AnnotatedEvolutionaryTree &tree, std::ostream &out) const {
+        const auto &shm_map = tree.SHMMap();
         auto root_id = tree.Tree().GetRoot();
-        auto clone_set = tree.Tree().GetCloneSet();
+        const auto &clone_set = tree.Tree().GetCloneSet();
         out << "@CDR1:" << clone_set[root_id].CDR1Range().start_pos << "," << clone_set[root_id].CDR1Range().end_pos << std::endl;
         out << "@CDR2:" << clone_set[root_id].CDR2Range().start_pos << "," << clone_set[root_id].CDR2Range().end_pos << std::endl;
         out << "@CDR3:" << clone_set[root_id].CDR3Range().start_pos << "," << clone_set[root_id].CDR3Range().end_pos << std::endl;
@@ -89,7 +118,7 @@ namespace antevolo {
         out.close();
     }
 
-    void AntEvoloOutputWriter::WriteEdge(const EvolutionaryEdgePtr& edge, std::ofstream& out) const { //no endl
+    void AntEvoloOutputWriter::WriteEdge(const EvolutionaryEdgePtr& edge, std::ostream& out) const { //no endl
         out << edge->SrcClone()->Read().id << "\t" << edge->DstClone()->Read().id << "\t"
             << edge->SrcClone()->Read().name << "\t" << edge->DstClone()->Read().name << "\t"
             << edge->SrcClone()->VSHMs().size() + edge->SrcClone()->JSHMs().size() << "\t"
@@ -101,6 +130,11 @@ namespace antevolo {
     void AntEvoloOutputWriter::WriteTreeInFile(std::string output_dir, const EvolutionaryTree& tree) const {
         std::string output_fname = tree.GetTreeOutputFname(output_dir);
         std::ofstream out(output_fname);
+        WriteTree(tree, out);
+        out.close();
+    }
+
+    void AntEvoloOutputWriter::WriteTree(const EvolutionaryTree& tree, std::ostream& out) const {
         out << "Src_id\tDst_id\tSrc_clone\tDst_clone\tNum_Src_SHMs\tNum_Dst_SHMs\tEdge_type\t";
         out << "Num_shared_SHMs\tNum_added_SHMs\tCDR3_dist\tWeight\t";
         out << "Src_productive\tDst_productive\tSynonymous\t";
@@ -121,13 +155,17 @@ namespace antevolo {
             }
             out << "\t" << src_CDR3_string << "\t" << dst_CDR3_string << std::endl;
         }
-        out.close();
     }
 
     void AntEvoloOutputWriter::WriteTreeVerticesInFile(std::string output_dir, const EvolutionaryTree& tree) const {
-        const auto& clone_set = tree.GetCloneSet();
         std::string output_fname = tree.GetTreeOutputFname(output_dir);
         std::ofstream out(output_fname);
+        WriteTreeVertices(tree, out);
+        out.close();
+    }
+
+    void AntEvoloOutputWriter::WriteTreeVertices(const EvolutionaryTree& tree, std::ostream& out) const {
+        const auto& clone_set = tree.GetCloneSet();
         out << "Clone_id\tClone_name\tProductive\tAA_seq\tOFR\tLeft_CDR3_anchor_AA\tRight_CDR3_anchor_AA\tSize\tFake\n";
         for (auto it = tree.c_vertex_begin(); it != tree.c_vertex_end(); it++) {
             auto const& clone = clone_set[*it];
@@ -154,7 +192,6 @@ namespace antevolo {
                 << "\t" << tree.GetCloneSet().IsFake(*it) << "\n";
 
         }
-        out.close();
     }
 
     void AntEvoloOutputWriter::OutputCleanedSequences(CloneSetWithFakesPtr clone_set_ptr) const {
@@ -23,6 +23,9 @@ namespace antevolo {
 
         void OutputSHMForTrees() const;
 
+        // writes trees, vertices & SHMs of all annotated trees into archive in parallel
+        void OutputTreeArchive() const;
+
         void WriteTreeInFile(std::string output_dir, const EvolutionaryTree& tree) const;
 
         void WriteTreeVerticesInFile(std::string output_dir, const EvolutionaryTree& tree) const;
@@ -35,9 +38,13 @@ namespace antevolo {
 
     private:
 
-        void WriteEdge(const EvolutionaryEdgePtr& edge, std::ofstream& out) const;
+        void WriteEdge(const EvolutionaryEdgePtr& edge, std::ostream& out) const;
+
+        void WriteTree(const EvolutionaryTree& tree, std::ostream& out) const;
+
+        void WriteTreeVertices(const EvolutionaryTree& tree, std::ostream& out) const;
 
-        void WriteTreeSHMs(const AnnotatedEvolutionaryTree &tree, std::ofstream& out) const;
+        void WriteTreeSHMs(const AnnotatedEvolutionaryTree &tree, std::ostream& out) const;
 
     };
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <numeric>
+
 #include <logger/logger.hpp>
+#include <verify.hpp>
 
 #include "antevolo_processor.hpp"
 #include "clone_set_decomposers/vj_clone_set_decomposer.hpp"
@@ -7,13 +11,25 @@
 
 namespace antevolo {
 
-    EvolutionaryTreeStorage AntEvoloProcessor::JoinEvolutionaryStoragesFromThreads() {
-        EvolutionaryTreeStorage resulting_tree_storage ;
-        for(auto it = thread_tree_storages_.begin(); it != thread_tree_storages_.end(); it++) {
-            resulting_tree_storage.AppendArchive(*it);
-        }
-//        auto const& tree = *resulting_tree_storage.cbegin();
-        return resulting_tree_storage;
+    namespace {
+        // connected component of CDR3 Hamming graph of a VJ class processed as a separate task
+        struct ComponentTask {
+            size_t class_index;
+            size_t component_index;
+            size_t num_clones;
+            // fakes of the component get indices first_fake_clone_index + 1, ..., first_fake_clone_index + num_clones
+            size_t first_fake_clone_index;
+            CloneSetWithFakesPtr clone_set;
+            std::shared_ptr<EvolutionaryTree> tree;
+            size_t num_reconstructed;
+
+            ComponentTask(size_t class_index, size_t component_index, size_t num_clones) :
+                    class_index(class_index),
+                    component_index(component_index),
+                    num_clones(num_clones),
+                    first_fake_clone_index(0),
+                    num_reconstructed(0) { }
+        };
     }
 
     EvolutionaryTreeStorage AntEvoloProcessor::ConstructClonalTrees() {
@@ -24,64 +40,79 @@ namespace antevolo {
         INFO("Largest class contains " << vj_decomposition.MaxClassSize() << " clone(s)");
         omp_set_num_threads(config_.run_params.num_threads);
         INFO("Construction of clonal trees starts");
-        std::vector<size_t> fake_clone_indices(config_.run_params.num_threads);
-        std::vector<size_t> reconstructed(config_.run_params.num_threads);
-        std::vector<CloneSetWithFakesPtr> clone_sets(config_.run_params.num_threads);
-        for (auto& ptr : clone_sets) {
-            ptr = CloneSetWithFakesPtr(new CloneSetWithFakes(clone_set_));
-        }
-        for (size_t i = 0; i < fake_clone_indices.size(); ++i) {
-            fake_clone_indices[i] = (2 * i + 1) * total_number_of_reads_ ;
+
+        // Hamming graphs of the largest classes are computed first
+        std::vector<size_t> class_order(vj_decomposition.Size());
+        std::iota(class_order.begin(), class_order.end(), 0);
+        std::stable_sort(class_order.begin(), class_order.end(), [&vj_decomposition](size_t i, size_t j) {
+            return vj_decomposition.ClassSize(i) > vj_decomposition.ClassSize(j);
+        });
+        CloneSetWithFakesPtr original_clone_set(new CloneSetWithFakes(clone_set_));
+        std::vector<VJClassProcessorPtr> class_processors(vj_decomposition.Size());
+        std::vector<std::vector<SparseGraphPtr>> class_components(vj_decomposition.Size());
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t k = 0; k < class_order.size(); k++) {
+            size_t i = class_order[k];
+            VJClassProcessorPtr vj_class_processor(new VJClassProcessor(original_clone_set,
+                                                                        config_,
+                                                                        clone_by_read_constructor_));
+            vj_class_processor->CreateUniqueCDR3Map(vj_decomposition.GetClass(i));
+            class_components[i] = vj_class_processor->ComputeCDR3HammingGraphs();
+            TRACE("# connected components: " << class_components[i].size());
+            class_processors[i] = vj_class_processor;
         }
 
-#pragma omp parallel for schedule(dynamic)
-        for(size_t i = 0; i < vj_decomposition.Size(); i++) {
-            size_t thread_id = omp_get_thread_num();
-            auto vj_class = vj_decomposition.GetClass(i);
-//            CloneSetWithFakesPtr fakes_clone_set_ptr(new CloneSetWithFakes(clone_set_));
-            auto vj_class_processor = VJClassProcessor(clone_sets[thread_id],
-                                                       config_,
-                                                       clone_by_read_constructor_,
-                                                       fake_clone_indices[thread_id]);
-            vj_class_processor.CreateUniqueCDR3Map(vj_class);
-            std::string cdrs_fasta = vj_class_processor.WriteUniqueCDR3InFasta(vj_class);
-            std::string graph_fname = vj_class_processor.GetGraphFname(vj_class);
-            TRACE("--------------------------");
-            TRACE("CDR3 fasta: "<< cdrs_fasta << ", CDR3 Hamming graph: " << graph_fname);
-            auto connected_components = vj_class_processor.ComputeCDR3HammingGraphs(cdrs_fasta, graph_fname);
-            TRACE("# connected components: " << connected_components.size());
-            for(size_t component_index = 0; component_index < connected_components.size(); component_index++) {
-                EvolutionaryTree tree(clone_sets[thread_id]);
-                if (config_.algorithm_params.model) {
-                    tree = vj_class_processor.ProcessComponentWithEdmonds(
-                            connected_components[component_index],
-                            component_index, edge_weight_calculator_);
-                } else {
-                    tree = vj_class_processor.ProcessComponentWithEdmonds(
-                            connected_components[component_index],
-                            component_index, edge_weight_calculator_);
-//                    tree = vj_class_processor.ProcessComponentWithKruskal(
-//                            connected_components[component_index],
-//                            component_index);
-                }
-                tree.SetTreeIndices(i + 1, component_index, 0);
-                if (tree.NumEdges() != 0) {
-                    thread_tree_storages_[thread_id].Add(tree);
-                    //TRACE(i + 1 << "-th clonal tree was written to " << tree_output_fname);
-                }
+        // each component is a separate task, so a giant VJ class is spread over all threads;
+        // fake clone indices are assigned in the order of classes & components and do not depend on scheduling
+        std::vector<ComponentTask> tasks;
+        size_t fake_clone_index = total_number_of_reads_;
+        for(size_t i = 0; i < class_processors.size(); i++) {
+            for(size_t component_index = 0; component_index < class_components[i].size(); component_index++) {
+                tasks.push_back(ComponentTask(i, component_index,
+                                              class_processors[i]->ComponentNumberOfClones(component_index)));
+                tasks.back().first_fake_clone_index = fake_clone_index;
+                fake_clone_index += tasks.back().num_clones;
             }
-            fake_clone_indices[thread_id] = vj_class_processor.GetCurrentFakeCloneIndex();
-            reconstructed[thread_id] += vj_class_processor.GetNumberOfReconstructedClones();
+        }
+        std::vector<size_t> task_order(tasks.size());
+        std::iota(task_order.begin(), task_order.end(), 0);
+        std::stable_sort(task_order.begin(), task_order.end(), [&tasks](size_t i, size_t j) {
+            return tasks[i].num_clones > tasks[j].num_clones;
+        });
+        INFO(tasks.size() << " connected components of CDR3 Hamming graphs were computed, largest component contains " <<
+             (tasks.empty() ? 0 : tasks[task_order.front()].num_clones) << " clone(s)");
 
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t k = 0; k < task_order.size(); k++) {
+            auto& task = tasks[task_order[k]];
+            const auto& vj_class_processor = *class_processors[task.class_index];
+            task.clone_set = CloneSetWithFakesPtr(new CloneSetWithFakes(clone_set_));
+            size_t current_fake_clone_index = task.first_fake_clone_index;
+            task.tree = std::make_shared<EvolutionaryTree>(vj_class_processor.ProcessComponentWithEdmonds(
+                    task.clone_set,
+                    class_components[task.class_index][task.component_index],
+                    task.component_index,
+                    current_fake_clone_index,
+                    task.num_reconstructed,
+                    edge_weight_calculator_));
+            VERIFY_MSG(current_fake_clone_index <= task.first_fake_clone_index + task.num_clones,
+                       "Component " << task.component_index << " of VJ class " << task.class_index <<
+                       " exceeds its range of fake clone indices");
+            task.tree->SetTreeIndices(task.class_index + 1, task.component_index, 0);
+            // graphs are not needed anymore
+            class_components[task.class_index][task.component_index] = SparseGraphPtr();
         }
+
         size_t total_reconstructed = 0;
         size_t total_rejected = 0;
-        for (size_t i = 0; i < reconstructed.size(); ++i) {
-            total_reconstructed += reconstructed[i];
-        }
+        EvolutionaryTreeStorage tree_storage;
         final_clone_set_with_fakes_ = CloneSetWithFakesPtr(new CloneSetWithFakes(clone_set_));
-        for (auto ptr : clone_sets) {
-            const auto& current_clone_set = *ptr;
+        for(const auto& task : tasks) {
+            total_reconstructed += task.num_reconstructed;
+            if (task.tree->NumEdges() != 0) {
+                tree_storage.Add(*task.tree);
+            }
+            const auto& current_clone_set = *task.clone_set;
             for (size_t i = current_clone_set.GetOriginalCloneSet().size(); i < current_clone_set.size(); ++i) {
                 final_clone_set_with_fakes_->AddClone(current_clone_set[i]);
             }
@@ -89,6 +120,6 @@ namespace antevolo {
 
         INFO("Number of reconstructed clones: " << total_reconstructed
              << ", number of edges rejected due to inequality of insertion blocks: " << total_rejected);
-        return JoinEvolutionaryStoragesFromThreads();
+        return tree_storage;
     }
-}
\ No newline at end of file
+}
@@ -15,10 +15,6 @@ namespace antevolo {
         const size_t total_number_of_reads_;
         const ShmModelEdgeWeightCalculator& edge_weight_calculator_;
 
-        std::vector<EvolutionaryTreeStorage> thread_tree_storages_;
-
-        EvolutionaryTreeStorage JoinEvolutionaryStoragesFromThreads();
-
     public:
         AntEvoloProcessor(const AntEvoloConfig& config,
                           const annotation_utils::CDRAnnotatedCloneSet& clone_set,
@@ -29,11 +25,7 @@ namespace antevolo {
                 clone_set_(clone_set),
                 clone_by_read_constructor_(clone_by_read_constructor),
                 total_number_of_reads_(total_number_of_reads),
-                edge_weight_calculator_(edge_weight_calculator){
-
-            for(int i = 0; i < config.run_params.num_threads; i++)
-                thread_tree_storages_.push_back(EvolutionaryTreeStorage());
-        }
+                edge_weight_calculator_(edge_weight_calculator) { }
 
         EvolutionaryTreeStorage ConstructClonalTrees();
 
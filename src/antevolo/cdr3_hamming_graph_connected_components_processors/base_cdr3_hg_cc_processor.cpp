@@ -14,7 +14,22 @@ namespace antevolo {
             clone_by_read_constructor_(clone_by_read_constructor),
             hamming_graph_info_(hamming_graph_info),
             current_fake_clone_index_(current_fake_clone_index),
-            reconstructed_(0) { }
+            reconstructed_(0),
+            edge_constructor_(GetEdgeConstructor()) { }
+
+    const CompactClone& Base_CDR3_HG_CC_Processor::GetCompactClone(size_t clone_num) {
+        auto it = compact_clones_.find(clone_num);
+        if (it == compact_clones_.end()) {
+            it = compact_clones_.insert(std::make_pair(clone_num, CompactClone((*clone_set_ptr_)[clone_num]))).first;
+        }
+        return it->second;
+    }
+
+    EvolutionaryEdgeInfo Base_CDR3_HG_CC_Processor::ComputeEdgeInfo(size_t src_num, size_t dst_num) {
+        const auto& src_clone = GetCompactClone(src_num);
+        const auto& dst_clone = GetCompactClone(dst_num);
+        return edge_constructor_->ComputeEdgeInfo(src_clone, dst_clone, src_num, dst_num);
+    }
 
 
     void Base_CDR3_HG_CC_Processor::AddUndirectedForest(boost::disjoint_sets<AP_map, AP_map> &ds_on_undirected_edges,
@@ -59,8 +74,7 @@ namespace antevolo {
     void Base_CDR3_HG_CC_Processor::ReconstructMissingVertices(boost::unordered_set<size_t>& vertices_nums,
                                                                   EvolutionaryTree& tree) {
         const auto& clone_set = *clone_set_ptr_;
-        auto edge_constructor = GetEdgeConstructor();
-        boost::unordered_map<size_t, EvolutionaryEdgePtr> roots_nearest_neighbours;
+        boost::unordered_map<size_t, EvolutionaryEdgeInfo> roots_nearest_neighbours;
         std::vector<size_t> roots;
         boost::unordered_map<size_t, size_t> iterator_index_map;
         boost::unordered_set<size_t> rejected_roots;
@@ -79,14 +93,10 @@ namespace antevolo {
                 if (dst_num == root_num) {
                     continue;
                 }
-                auto edge = edge_constructor->ConstructEdge(
-                        clone_set[root_num],
-                        clone_set[dst_num],
-                        root_num,
-                        dst_num);
-                if (edge->IsIntersected()) {
+                auto edge = ComputeEdgeInfo(root_num, dst_num);
+                if (edge.IsIntersected()) {
                     if (roots_nearest_neighbours.find(root_num) == roots_nearest_neighbours.end() ||
-                        edge->Length() < roots_nearest_neighbours[root_num]->Length()) {
+                        edge.Length() < roots_nearest_neighbours[root_num].Length()) {
                         roots_nearest_neighbours[root_num] = edge;
                     }
                 }
@@ -99,9 +109,9 @@ namespace antevolo {
                 if (!tree.HasParentEdge(roots[i]) &&
                     rejected_roots.find(roots[i]) == rejected_roots.end() &&
                     roots_nearest_neighbours.find(roots[i]) != roots_nearest_neighbours.end() &&
-                    roots_nearest_neighbours[roots[i]]->Length() < best_root_edge_length) {
+                    roots_nearest_neighbours[roots[i]].Length() < best_root_edge_length) {
                     best_root_index = i;
-                    best_root_edge_length = roots_nearest_neighbours[roots[i]]->Length();
+                    best_root_edge_length = roots_nearest_neighbours[roots[i]].Length();
                 }
             }
             if (best_root_edge_length == EVO_EDGE_MAX_LENGTH) {
@@ -116,7 +126,7 @@ namespace antevolo {
             bool reconstructed = ReconstructAncestralLineageSimple(edge,
                                                                    tree,
                                                                    vertices_nums,
-                                                                   edge_constructor,
+                                                                   edge_constructor_,
                                                                    roots,
                                                                    iterator_index_map);
             if (!reconstructed) {
@@ -130,8 +140,7 @@ namespace antevolo {
                                     dst_num,
                                     vertices_nums,
                                     tree,
-                                    roots_nearest_neighbours,
-                                    edge_constructor);
+                                    roots_nearest_neighbours);
             }
         }
     }
@@ -139,9 +148,9 @@ namespace antevolo {
     void Base_CDR3_HG_CC_Processor::Refine(boost::unordered_set<size_t>& vertices_nums,
                                            EvolutionaryTree& tree) {
         auto& clone_set = *clone_set_ptr_;
-        auto edge_constructor = GetEdgeConstructor();
-        boost::unordered_map<size_t, EvolutionaryEdgePtr> best_intersected_edges;
-        boost::unordered_map<size_t, EvolutionaryEdgePtr> best_reverse_edges;
+        const auto& edge_constructor = edge_constructor_;
+        boost::unordered_map<size_t, EvolutionaryEdgeInfo> best_intersected_edges;
+        boost::unordered_map<size_t, EvolutionaryEdgeInfo> best_reverse_edges;
 //        INFO("start refinement");
         for (size_t clone_num : vertices_nums) {
             auto it = getRelatedClonesIterator(hamming_graph_info_, clone_set[clone_num]);
@@ -151,21 +160,17 @@ namespace antevolo {
                 if (src_num == clone_num) {
                     continue;
                 }
-                auto edge = edge_constructor->ConstructEdge(
-                        clone_set[src_num],
-                        clone_set[clone_num],
-                        src_num,
-                        clone_num);
-                if (edge->IsIntersected()) {
+                auto edge = ComputeEdgeInfo(src_num, clone_num);
+                if (edge.IsIntersected()) {
                     if ((best_intersected_edges.find(clone_num) == best_intersected_edges.end() ||
-                         edge->Length() < best_intersected_edges[clone_num]->Length()) &&
-                            CheckClonesConsistencyForReconstruction(*edge->SrcClone(), *edge->DstClone())) {
+                         edge.Length() < best_intersected_edges[clone_num].Length()) &&
+                            CheckClonesConsistencyForReconstruction(clone_set[src_num], clone_set[clone_num])) {
                         best_intersected_edges[clone_num] = edge;
                     }
                 }
-                if (edge->IsReverseDirected()) {
+                if (edge.IsReverseDirected()) {
                     if (best_reverse_edges.find(clone_num) == best_reverse_edges.end() ||
-                        edge->Length() < best_reverse_edges[clone_num]->Length()) {
+                        edge.Length() < best_reverse_edges[clone_num].Length()) {
                         best_reverse_edges[clone_num] = edge;
                     }
                 }
@@ -186,28 +191,28 @@ namespace antevolo {
             size_t default_cost= tree.GetParentEdgeLength(clone_num);
 //            INFO("here 2");
             if (best_reverse_edges.find(clone_num) != best_reverse_edges.end()) {
-                reverse_cost = best_reverse_edges[clone_num]->Length();
+                reverse_cost = best_reverse_edges[clone_num].Length();
             }
             if (best_intersected_edges.find(clone_num) != best_intersected_edges.end()) {
 //                INFO("here 3");
                 auto edge = best_intersected_edges[clone_num];
                 if (SecondCloneIsFirstsAncestor(tree,
-                                                edge->SrcNum(),
+                                                edge.SrcNum(),
                                                 clone_num)) {
                     continue;
                 }
-                if (edge->IsDoubleMutated()) {
-                    intersected_cost = edge->Length();
+                if (edge.IsDoubleMutated()) {
+                    intersected_cost = edge.Length();
                     if (intersected_cost < default_cost && intersected_cost < reverse_cost) {
-                        tree.ReplaceEdge(clone_num, edge);
+                        tree.ReplaceEdge(clone_num, ConstructEdge(edge));
                         continue;
                     }
                 }
                 else {
 //                    INFO("reconstruction case");
-                    const auto& left = *edge->SrcClone();
-                    const auto& right= *edge->DstClone();
-                    size_t left_num = edge->SrcNum();
+                    const auto& left = clone_set[edge.SrcNum()];
+                    const auto& right= clone_set[edge.DstNum()];
+                    size_t left_num = edge.SrcNum();
                     size_t right_num = clone_num;
                     size_t parent_num = clone_set.size();
 
@@ -261,16 +266,16 @@ namespace antevolo {
 //                            }
 //                        }
 //                        continue;
-                        tree.ReplaceEdge(clone_num, edge);
+                        tree.ReplaceEdge(clone_num, ConstructEdge(edge));
                     }
                     --current_fake_clone_index_;
                     --reconstructed_;
                 }
             }
             if (reverse_cost < default_cost && reverse_cost < intersected_cost &&
-                !SecondCloneIsFirstsAncestor(tree, best_reverse_edges[clone_num]->SrcNum(), clone_num)) {
+                !SecondCloneIsFirstsAncestor(tree, best_reverse_edges[clone_num].SrcNum(), clone_num)) {
 //                INFO("reverse case");
-                tree.ReplaceEdge(clone_num, best_reverse_edges[clone_num]);
+                tree.ReplaceEdge(clone_num, ConstructEdge(best_reverse_edges[clone_num]));
                 continue;
             }
         }
@@ -313,24 +318,24 @@ namespace antevolo {
     *           o     o
     */
     bool Base_CDR3_HG_CC_Processor::ReconstructAncestralLineageSimple(
-            EvolutionaryEdgePtr edge,
+            const EvolutionaryEdgeInfo& edge,
             EvolutionaryTree &tree,
             boost::unordered_set<size_t> &vertices_nums,
             const std::shared_ptr<EvolutionaryEdgeConstructor> &edge_constructor,
             std::vector<size_t> &roots,
             boost::unordered_map<size_t, size_t> &iterator_index_map) {
-        VERIFY_MSG(edge->IsIntersected(), "ancesrtal lineage reconstructor got a non-intersected edge");
+        VERIFY_MSG(edge.IsIntersected(), "ancesrtal lineage reconstructor got a non-intersected edge");
         auto& clone_set = *clone_set_ptr_;
-        size_t left_num = edge->DstNum();
-        size_t right_num = edge->SrcNum();
+        size_t left_num = edge.DstNum();
+        size_t right_num = edge.SrcNum();
         while (tree.HasParentEdge(left_num)) {
             left_num = tree.GetParentEdge(left_num)->SrcNum();
         }
         const auto& left = clone_set[left_num];
         const auto& right = clone_set[right_num];
-        auto edge_n = edge_constructor->ConstructEdge(left, right, left_num, right_num);
-        if (edge_n->IsDirected()) {
-            tree.ReplaceEdge(right_num, edge_n);
+        auto edge_n = ComputeEdgeInfo(left_num, right_num);
+        if (edge_n.IsDirected()) {
+            tree.ReplaceEdge(right_num, ConstructEdge(edge_n));
             return false;
         }
         if (!CheckClonesConsistencyForReconstruction(left, right)) {
@@ -379,36 +384,26 @@ namespace antevolo {
             size_t dst_num,
             boost::unordered_set<size_t>& vertices_nums,
             EvolutionaryTree& tree,
-            boost::unordered_map<size_t, EvolutionaryEdgePtr>& roots_nearest_neighbours,
-            const std::shared_ptr<EvolutionaryEdgeConstructor>& edge_constructor) {
+            boost::unordered_map<size_t, EvolutionaryEdgeInfo>& roots_nearest_neighbours) {
 
-        const auto& clone_set = *clone_set_ptr_;
         if (dst_num == root_num || vertices_nums.find(dst_num) == vertices_nums.end()) {
             return;
         }
-        auto edge = edge_constructor->ConstructEdge(
-                clone_set[root_num],
-                clone_set[dst_num],
-                root_num,
-                dst_num);
-        auto edge_r = edge_constructor->ConstructEdge(
-                clone_set[dst_num],
-                clone_set[root_num],
-                dst_num,
-                root_num);
-        if (edge->IsDirected()) {
-            if (!tree.HasParentEdge(dst_num) or edge->Length() < tree.GetParentEdge(dst_num)->Length()) {
-                tree.ReplaceEdge(dst_num, edge);
+        auto edge = ComputeEdgeInfo(root_num, dst_num);
+        auto edge_r = ComputeEdgeInfo(dst_num, root_num);
+        if (edge.IsDirected()) {
+            if (!tree.HasParentEdge(dst_num) or edge.Length() < tree.GetParentEdge(dst_num)->Length()) {
+                tree.ReplaceEdge(dst_num, ConstructEdge(edge));
             }
         }
-        if (edge_r->IsDirected()) {
-            if (!tree.HasParentEdge(root_num) or edge_r->Length() < tree.GetParentEdge(root_num)->Length()) {
-                tree.ReplaceEdge(root_num, edge_r);
+        if (edge_r.IsDirected()) {
+            if (!tree.HasParentEdge(root_num) or edge_r.Length() < tree.GetParentEdge(root_num)->Length()) {
+                tree.ReplaceEdge(root_num, ConstructEdge(edge_r));
             }
         }
-        if (edge->IsIntersected()) {
+        if (edge.IsIntersected()) {
             if (roots_nearest_neighbours.find(root_num) == roots_nearest_neighbours.end() ||
-                edge->Length() < roots_nearest_neighbours[root_num]->Length()) {
+                edge.Length() < roots_nearest_neighbours[root_num].Length()) {
                 roots_nearest_neighbours[root_num] = edge;
             }
         }
@@ -31,6 +31,10 @@ namespace antevolo {
         boost::unordered_map<size_t, bool> parent_edge_handled_;
         boost::unordered_map<size_t, EvolutionaryEdgePtr> undirected_components_edges_;
 
+        // SHMs & CDR3s of clones prepared for classification of edges, filled lazily
+        boost::unordered_map<size_t, CompactClone> compact_clones_;
+        std::shared_ptr<EvolutionaryEdgeConstructor> edge_constructor_;
+
         static const size_t EVO_EDGE_MAX_LENGTH = 400; // todo: move to config
 
         void AddUndirectedPair(size_t src_num, size_t dst_num);
@@ -54,8 +58,18 @@ namespace antevolo {
         bool SecondCloneIsFirstsAncestor(EvolutionaryTree& tree, size_t first_clone, size_t second_clone);
 
 
+        const CompactClone& GetCompactClone(size_t clone_num);
+
+        EvolutionaryEdgeInfo ComputeEdgeInfo(size_t src_num, size_t dst_num);
+
+        EvolutionaryEdgePtr ConstructEdge(const EvolutionaryEdgeInfo& edge_info) {
+            return edge_constructor_->ConstructEdge(edge_info,
+                                                    (*clone_set_ptr_)[edge_info.SrcNum()],
+                                                    (*clone_set_ptr_)[edge_info.DstNum()]);
+        }
+
         bool ReconstructAncestralLineageSimple(
-                EvolutionaryEdgePtr edge,
+                const EvolutionaryEdgeInfo& edge,
                 EvolutionaryTree &tree,
                 boost::unordered_set<size_t> &vertices_nums,
                 const std::shared_ptr<EvolutionaryEdgeConstructor> &edge_constructor,
@@ -66,8 +80,7 @@ namespace antevolo {
                 size_t dst_num,
                 boost::unordered_set<size_t>& vertices_nums,
                 EvolutionaryTree& tree,
-                boost::unordered_map<size_t, EvolutionaryEdgePtr>& roots_nearest_neighbours,
-                const std::shared_ptr<EvolutionaryEdgeConstructor>& edge_constructor);
+                boost::unordered_map<size_t, EvolutionaryEdgeInfo>& roots_nearest_neighbours);
 
         size_t GetUndirectedCompopentRoot(size_t root_num) {
             if (undirected_components_edges_.find(root_num) != undirected_components_edges_.end()) {
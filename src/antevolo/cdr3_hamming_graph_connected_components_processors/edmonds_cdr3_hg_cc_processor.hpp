@@ -7,11 +7,14 @@
 
 namespace antevolo {
     class Edmonds_CDR3_HG_CC_Processor : public Base_CDR3_HG_CC_Processor {
-        boost::unordered_map<size_t, EvolutionaryEdgePtr> shorthest_directed_edge_;
+        // directed & undirected edges of component grouped by source clones in the order of vertices_nums_
+        std::vector<EvolutionaryEdgeInfo> component_edges_;
+        // index of the shortest directed edge in component_edges_
+        boost::unordered_map<size_t, size_t> shorthest_directed_edge_;
         boost::unordered_set<size_t> vertices_nums_;
         const ShmModelEdgeWeightCalculator& edge_weight_calculator_;
 
-        void SetShortestDirectedParentEdges();
+        void ComputeComponentEdges();
 
         std::vector<WeightedEdge<int>> PrepareEdgeVector();
 
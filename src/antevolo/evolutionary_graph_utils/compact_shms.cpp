@@ -0,0 +1,129 @@
+#include <verify.hpp>
+
+#include "compact_shms.hpp"
+
+namespace antevolo {
+    CompactSHMs::CompactSHMs(const annotation_utils::GeneSegmentSHMs &shms) {
+        keys_.reserve(shms.size());
+        read_positions_.reserve(shms.size());
+        for(auto it = shms.cbegin(); it != shms.cend(); it++) {
+            VERIFY(it->gene_nucl_pos < (uint64_t(1) << (64 - POSITION_SHIFT)) && it->read_nucl_pos <= uint32_t(-1));
+            keys_.push_back((uint64_t(it->gene_nucl_pos) << POSITION_SHIFT) |
+                            (uint64_t(static_cast<uint8_t>(it->shm_type)) << TYPE_SHIFT) |
+                            (uint64_t(static_cast<uint8_t>(it->gene_nucl)) << READ_NUCL_BITS) |
+                            uint64_t(static_cast<uint8_t>(it->read_nucl)));
+            read_positions_.push_back(static_cast<uint32_t>(it->read_nucl_pos));
+        }
+    }
+
+    bool CompactSHMs::IsInsertion(size_t index) const {
+        return ((keys_[index] >> TYPE_SHIFT) & 0xFF) == static_cast<uint64_t>(annotation_utils::SHMType::InsertionSHM);
+    }
+
+    size_t CompactSHMs::InsertionBlockSize(size_t index) const {
+        size_t end = index + 1;
+        while(end < size() && IsInsertion(end) && Position(end) == Position(end - 1) &&
+              read_positions_[end] == read_positions_[end - 1] + 1)
+            end++;
+        return end - index;
+    }
+
+    bool CompactSHMs::InsertionBlocksAreEqual(const CompactSHMs &shms1, size_t index1,
+                                              const CompactSHMs &shms2, size_t index2,
+                                              size_t block_size) {
+        uint64_t read_nucl_mask = (uint64_t(1) << READ_NUCL_BITS) - 1;
+        for(size_t i = 0; i < block_size; i++)
+            if((shms1.keys_[index1 + i] & read_nucl_mask) != (shms2.keys_[index2 + i] & read_nucl_mask))
+                return false;
+        return true;
+    }
+
+    // SHMs of both sets are ordered by positions, so SHMs2 located before the current SHM1
+    // can not match it or any of the next SHMs1 and are skipped
+    size_t CompactSHMs::GetNumberOfIntersections(const CompactSHMs &shms1, const CompactSHMs &shms2) {
+        size_t num_shared_shms = 0;
+        size_t index2 = 0;
+        for(size_t index1 = 0; index1 < shms1.size(); index1++) {
+            uint64_t position = shms1.Position(index1);
+            while(index2 < shms2.size() && shms2.Position(index2) < position)
+                index2++;
+            for(size_t i = index2; i < shms2.size() && shms2.Position(i) == position; i++)
+                if(shms1.keys_[index1] == shms2.keys_[i]) {
+                    num_shared_shms++;
+                    index2 = i + 1;
+                    break;
+                }
+        }
+        return num_shared_shms;
+    }
+
+    bool CompactSHMs::SHMs1AreNestedInSHMs2(const CompactSHMs &shms1, const CompactSHMs &shms2) {
+        if(shms1.size() > shms2.size())
+            return false;
+        size_t index2 = 0;
+        for(size_t index1 = 0; index1 < shms1.size(); index1++) {
+            if(shms1.IsInsertion(index1))
+                continue;
+            uint64_t position = shms1.Position(index1);
+            while(index2 < shms2.size() && shms2.Position(index2) < position)
+                index2++;
+            bool shm_found = false;
+            for(size_t i = index2; i < shms2.size() && shms2.Position(i) == position; i++)
+                if(shms1.keys_[index1] == shms2.keys_[i]) {
+                    index2 = i + 1;
+                    shm_found = true;
+                    break;
+                }
+            if(!shm_found)
+                return false;
+        }
+        return AllSHMs1InsertionBlocksArePresentedInSHMs2(shms1, shms2);
+    }
+
+    bool CompactSHMs::AllSHMs1InsertionBlocksArePresentedInSHMs2(const CompactSHMs &shms1,
+                                                                 const CompactSHMs &shms2) {
+        size_t index2 = 0;
+        for(size_t index1 = 0; index1 < shms1.size(); index1++) {
+            if(!shms1.IsInsertion(index1))
+                continue;
+            size_t block1_size = shms1.InsertionBlockSize(index1);
+            uint64_t position = shms1.Position(index1);
+            while(index2 < shms2.size() && shms2.Position(index2) < position)
+                index2++;
+            bool shm_found = false;
+            for(size_t i = index2; i < shms2.size() && shms2.Position(i) == position; i++)
+                if(shms1.keys_[index1] == shms2.keys_[i]) {
+                    size_t block2_size = shms2.InsertionBlockSize(i);
+                    if(block1_size != block2_size || !InsertionBlocksAreEqual(shms1, index1, shms2, i, block1_size))
+                        return false;
+                    shm_found = true;
+                    index1 += block1_size - 1;
+                    index2 = i + block2_size;
+                    break;
+                }
+            if(!shm_found)
+                return false;
+        }
+        return true;
+    }
+
+    bool CompactSHMs::AllAddedSHMs1HaveIdenticallyPositionedSHMs2(const CompactSHMs &shms1,
+                                                                  const CompactSHMs &shms2) {
+        size_t index1 = 0;
+        for(size_t index2 = 0; index2 < shms2.size(); index2++) {
+            uint64_t position = shms2.Position(index2);
+            while(index1 < shms1.size() && shms1.Position(index1) < position)
+                index1++;
+            bool shm_found = false;
+            for(size_t i = index1; i < shms1.size() && shms1.Position(i) == position; i++)
+                if(shms2.PositionedKey(index2) == shms1.PositionedKey(i)) {
+                    index1 = i + 1;
+                    shm_found = true;
+                    break;
+                }
+            if(!shm_found)
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <annotation_utils/annotated_clone.hpp>
+
+namespace antevolo {
+
+    /*
+     * SHMs of gene segment packed into 64-bit keys: position in gene, type, gene & read nucleotides.
+     * Position occupies the highest bits, so keys follow the order of SHMs in GeneSegmentSHMs
+     * and equality of keys is equivalent to SHM::operator==.
+     * Comparisons are merge-based and give the same results as annotation_utils::SHMComparator
+     */
+    class CompactSHMs {
+        std::vector<uint64_t> keys_;
+        // positions in read are needed to split insertions into blocks
+        std::vector<uint32_t> read_positions_;
+
+        static const size_t READ_NUCL_BITS = 8;
+        static const size_t TYPE_SHIFT = 16;
+        static const size_t POSITION_SHIFT = 24;
+
+        // number of consecutive insertions starting at index
+        size_t InsertionBlockSize(size_t index) const;
+
+        static bool InsertionBlocksAreEqual(const CompactSHMs &shms1, size_t index1,
+                                            const CompactSHMs &shms2, size_t index2,
+                                            size_t block_size);
+
+    public:
+        CompactSHMs() { }
+
+        explicit CompactSHMs(const annotation_utils::GeneSegmentSHMs &shms);
+
+        size_t size() const { return keys_.size(); }
+
+        uint64_t Key(size_t index) const { return keys_[index]; }
+
+        uint64_t Position(size_t index) const { return keys_[index] >> POSITION_SHIFT; }
+
+        // key without read nucleotide
+        uint64_t PositionedKey(size_t index) const { return keys_[index] >> READ_NUCL_BITS; }
+
+        bool IsInsertion(size_t index) const;
+
+        bool operator==(const CompactSHMs &shms) const { return keys_ == shms.keys_; }
+
+        static size_t GetNumberOfIntersections(const CompactSHMs &shms1, const CompactSHMs &shms2);
+
+        static bool SHMs1AreNestedInSHMs2(const CompactSHMs &shms1, const CompactSHMs &shms2);
+
+        static bool AllSHMs1InsertionBlocksArePresentedInSHMs2(const CompactSHMs &shms1, const CompactSHMs &shms2);
+
+        static bool InsertionBlocksAreEqual(const CompactSHMs &shms1, const CompactSHMs &shms2) {
+            return AllSHMs1InsertionBlocksArePresentedInSHMs2(shms1, shms2) &&
+                   AllSHMs1InsertionBlocksArePresentedInSHMs2(shms2, shms1);
+        }
+
+        static bool AllAddedSHMs1HaveIdenticallyPositionedSHMs2(const CompactSHMs &shms1, const CompactSHMs &shms2);
+
+        static bool IndividualSHMsAreIdenticallyPositioned(const CompactSHMs &shms1, const CompactSHMs &shms2) {
+            return InsertionBlocksAreEqual(shms1, shms2) && AllAddedSHMs1HaveIdenticallyPositionedSHMs2(shms1, shms2);
+        }
+    };
+
+    // everything that is needed for classification of edges between clones, computed once per clone
+    struct CompactClone {
+        CompactSHMs v_shms;
+        CompactSHMs j_shms;
+        seqan::Dna5String cdr3;
+
+        CompactClone() { }
+
+        explicit CompactClone(const annotation_utils::AnnotatedClone &clone) :
+                v_shms(clone.VSHMs()),
+                j_shms(clone.JSHMs()),
+                cdr3(clone.CDR3()) { }
+
+        size_t NumSHMs() const { return v_shms.size() + j_shms.size(); }
+    };
+}
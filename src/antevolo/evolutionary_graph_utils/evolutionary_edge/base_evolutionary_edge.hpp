@@ -4,7 +4,7 @@
 namespace  antevolo {
 
     template<typename T>
-    size_t HammingDistance(T seq1, T seq2) {
+    size_t HammingDistance(const T &seq1, const T &seq2) {
         size_t dist = 0;
         size_t min_length = std::min<size_t>(seqan::length(seq1), seqan::length(seq2));
         for(size_t i = 0; i < min_length; i++) {
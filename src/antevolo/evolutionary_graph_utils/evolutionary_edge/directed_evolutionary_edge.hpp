@@ -34,10 +34,14 @@ namespace  antevolo {
             num_added_shms = num_added_v_shms + num_added_j_shms;
             num_intersected_shms = num_intersected_v_shms + num_intersected_j_shms;
         }
-        size_t Length() const override {
+        static size_t ComputeLength(size_t num_added_shms, size_t cdr3_distance) {
             return num_added_shms + cdr3_distance;
         }
 
+        size_t Length() const override {
+            return ComputeLength(num_added_shms, cdr3_distance);
+        }
+
         bool IsDirected() const override { return true; }
 
         std::string TypeString() const override { return "directed"; }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "directed_evolutionary_edge.hpp"
+#include "undirected_evolutionary_edge.hpp"
+#include "intersected_evolutionary_edge.hpp"
+#include "reverse_directed_evolutionary_edge.hpp"
+
+namespace antevolo {
+
+    /*
+     * Value-typed description of edge between two clones: type and lengths are the same as
+     * for the corresponding BaseEvolutionaryEdge subclass, but clones are referenced by numbers only.
+     * Candidate edges are classified into infos, edge objects are created only for edges of trees
+     */
+    struct EvolutionaryEdgeInfo {
+        EvolutionaryEdgeType edge_type;
+        size_t src_num;
+        size_t dst_num;
+        size_t cdr3_distance;
+        size_t num_individual_v_shms;
+        size_t num_intersected_v_shms;
+        size_t num_individual_j_shms;
+        size_t num_intersected_j_shms;
+        bool double_mutated;
+
+        EvolutionaryEdgeInfo() :
+                edge_type(EvolutionaryEdgeType::UnknownEdgeType),
+                src_num(size_t(-1)),
+                dst_num(size_t(-1)),
+                cdr3_distance(0),
+                num_individual_v_shms(0),
+                num_intersected_v_shms(0),
+                num_individual_j_shms(0),
+                num_intersected_j_shms(0),
+                double_mutated(false) { }
+
+        size_t SrcNum() const { return src_num; }
+
+        size_t DstNum() const { return dst_num; }
+
+        bool Empty() const { return edge_type == EvolutionaryEdgeType::UnknownEdgeType; }
+
+        bool IsDirected() const { return edge_type == EvolutionaryEdgeType::DirectedEdgeType; }
+
+        bool IsUndirected() const { return edge_type == EvolutionaryEdgeType::UndirectedEdgeType; }
+
+        bool IsIntersected() const { return edge_type == EvolutionaryEdgeType::IntersectedEdgeType; }
+
+        bool IsDoubleMutated() const { return IsIntersected() && double_mutated; }
+
+        bool IsReverseDirected() const { return edge_type == EvolutionaryEdgeType::ReverseDirectedEdgeType; }
+
+        size_t Length() const {
+            switch(edge_type) {
+                case EvolutionaryEdgeType::UndirectedEdgeType:
+                    return UndirectedEvolutionaryEdge::ComputeLength(cdr3_distance);
+                case EvolutionaryEdgeType::DirectedEdgeType:
+                    return DirectedEvolutionaryEdge::ComputeLength(num_individual_v_shms + num_individual_j_shms,
+                                                                   cdr3_distance);
+                case EvolutionaryEdgeType::ReverseDirectedEdgeType:
+                    return ReverseDirectedEvolutionaryEdge::ComputeLength(num_individual_v_shms + num_individual_j_shms,
+                                                                          cdr3_distance);
+                case EvolutionaryEdgeType::IntersectedEdgeType:
+                    return IntersectedEvolutionaryEdge::ComputeLength(num_individual_v_shms, cdr3_distance);
+                default:
+                    return size_t(-1);
+            }
+        }
+    };
+}
@@ -19,7 +19,8 @@ namespace  antevolo {
                                     const annotation_utils::AnnotatedClone &dst_clone,
                                     size_t src_num, size_t dst_num,
                                     size_t num_individual_v_shms, size_t num_intersected_v_shms,
-                                    size_t num_individual_j_shms, size_t num_intersected_j_shms)
+                                    size_t num_individual_j_shms, size_t num_intersected_j_shms,
+                                    bool is_double_mutated)
                 : BaseEvolutionaryEdge(src_clone,
                                        dst_clone,
                                        src_num,
@@ -27,20 +28,20 @@ namespace  antevolo {
                   num_individual_v_shms_(num_individual_v_shms),
                   num_intersected_v_shms_(num_intersected_v_shms),
                   num_individual_j_shms_(num_individual_j_shms),
-                  num_intersected_j_shms_(num_intersected_j_shms) {
+                  num_intersected_j_shms_(num_intersected_j_shms),
+                  is_double_mytated_(is_double_mutated) {
             edge_type = EvolutionaryEdgeType ::IntersectedEdgeType;
             //sum
             num_individual_shms_ = num_individual_v_shms_ + num_individual_v_shms_;
             num_intersected_shms_ = num_intersected_v_shms_ + num_intersected_j_shms_;
-            is_double_mytated_ = annotation_utils::SHMComparator::IndividualSHMsAreIdenticallyPositioned(
-                                         src_clone.VSHMs(),
-                                         dst_clone.VSHMs())   &&
-                                 annotation_utils::SHMComparator::IndividualSHMsAreIdenticallyPositioned(
-                                         src_clone.JSHMs(),
-                                         dst_clone.JSHMs());
         }
+        // individual V SHMs are counted twice (see num_individual_shms_)
+        static size_t ComputeLength(size_t num_individual_v_shms, size_t cdr3_distance) {
+            return cdr3_distance + 2 * num_individual_v_shms;
+        }
+
         size_t Length() const override {
-            return cdr3_distance+num_individual_shms_;
+            return ComputeLength(num_individual_v_shms_, cdr3_distance);
         }
 
         bool IsIntersected() const override { return true; }
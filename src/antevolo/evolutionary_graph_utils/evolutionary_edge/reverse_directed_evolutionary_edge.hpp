@@ -37,10 +37,14 @@ namespace  antevolo {
             num_added_shms = num_added_v_shms + num_added_j_shms;
             num_intersected_shms = num_intersected_v_shms + num_intersected_j_shms;
         }
-        size_t Length() const override {
+        static size_t ComputeLength(size_t num_added_shms, size_t cdr3_distance) {
             return (num_added_shms + cdr3_distance) * PENALTY;
         }
 
+        size_t Length() const override {
+            return ComputeLength(num_added_shms, cdr3_distance);
+        }
+
         bool IsReverseDirected() const override { return true; }
 
         std::string TypeString() const override { return "reverse_directed"; }
@@ -26,10 +26,14 @@ namespace  antevolo {
             num_added_shms = num_added_v_shms + num_added_j_shms;
             num_intersected_shms = num_intersected_v_shms + num_intersected_j_shms;
         }
-        size_t Length() const override {
+        static size_t ComputeLength(size_t cdr3_distance) {
             return cdr3_distance;
         }
 
+        size_t Length() const override {
+            return ComputeLength(cdr3_distance);
+        }
+
         bool IsUndirected() const override { return true; }
 
         std::string TypeString()  const override { return "undirected"; }
@@ -1,7 +1,5 @@
 #include "evolutionary_edge_constructor.hpp"
 
-#include <annotation_utils/shm_comparator.hpp>
-
 namespace antevolo {
 //    std::shared_ptr<BaseEvolutionaryEdge> SimpleEvolutionaryEdgeConstructor::ConstructEdge(
 //            const annotation_utils::AnnotatedClone &src_clone,
@@ -26,53 +24,109 @@ namespace antevolo {
             const annotation_utils::AnnotatedClone &src_clone,
             const annotation_utils::AnnotatedClone &dst_clone,
             size_t src_num, size_t dst_num) const {
-        if (!(annotation_utils::SHMComparator::SHMsInsertionBlocksAreEqual(src_clone.VSHMs(),
-                                                                           dst_clone.VSHMs()) &&
-              annotation_utils::SHMComparator::SHMsInsertionBlocksAreEqual(src_clone.JSHMs(),
-                                                                           dst_clone.JSHMs())))
-            {
-            return std::shared_ptr<BaseEvolutionaryEdge>( new BaseEvolutionaryEdge(src_clone, dst_clone,
-                                                                                   src_num, dst_num) );
+        return ConstructEdge(ComputeEdgeInfo(CompactClone(src_clone), CompactClone(dst_clone), src_num, dst_num),
+                             src_clone, dst_clone);
+    }
+
+    EvolutionaryEdgeInfo VJEvolutionaryEdgeConstructor::ComputeEdgeInfo(
+            const CompactClone &src_clone,
+            const CompactClone &dst_clone,
+            size_t src_num, size_t dst_num) const {
+        EvolutionaryEdgeInfo edge_info;
+        edge_info.src_num = src_num;
+        edge_info.dst_num = dst_num;
+        edge_info.cdr3_distance = HammingDistance(src_clone.cdr3, dst_clone.cdr3);
+        if (!(CompactSHMs::InsertionBlocksAreEqual(src_clone.v_shms, dst_clone.v_shms) &&
+              CompactSHMs::InsertionBlocksAreEqual(src_clone.j_shms, dst_clone.j_shms))) {
+            return edge_info;
         }
         // undirected
-        if (annotation_utils::SHMComparator::SHMsAreEqual(src_clone.VSHMs(), dst_clone.VSHMs()) &&
-            annotation_utils::SHMComparator::SHMsAreEqual(src_clone.JSHMs(), dst_clone.JSHMs()))
-            return std::shared_ptr<BaseEvolutionaryEdge>( new UndirectedEvolutionaryEdge(src_clone, dst_clone,
-                                                                                         src_num, dst_num) );
+        if (src_clone.v_shms == dst_clone.v_shms && src_clone.j_shms == dst_clone.j_shms) {
+            edge_info.edge_type = EvolutionaryEdgeType::UndirectedEdgeType;
+            edge_info.num_intersected_v_shms = src_clone.v_shms.size();
+            edge_info.num_intersected_j_shms = src_clone.j_shms.size();
+            return edge_info;
+        }
         // directed
-        if (annotation_utils::SHMComparator::SHMs1AreNestedInSHMs2(src_clone.VSHMs(), dst_clone.VSHMs()) &&
-            annotation_utils::SHMComparator::SHMs1AreNestedInSHMs2(src_clone.JSHMs(), dst_clone.JSHMs()))
-            return std::shared_ptr<BaseEvolutionaryEdge>( new DirectedEvolutionaryEdge(src_clone, dst_clone,
-                                                                                       src_num, dst_num) );
+        if (CompactSHMs::SHMs1AreNestedInSHMs2(src_clone.v_shms, dst_clone.v_shms) &&
+            CompactSHMs::SHMs1AreNestedInSHMs2(src_clone.j_shms, dst_clone.j_shms)) {
+            VERIFY_MSG(dst_clone.NumSHMs() > src_clone.NumSHMs(),
+                       "# SHMs in destination clone (" << dst_clone.NumSHMs() <<
+                       ") does not exceed # SHMs in source clone (" << src_clone.NumSHMs() << ")");
+            edge_info.edge_type = EvolutionaryEdgeType::DirectedEdgeType;
+            edge_info.num_individual_v_shms = dst_clone.v_shms.size() - src_clone.v_shms.size();
+            edge_info.num_intersected_v_shms = src_clone.v_shms.size();
+            edge_info.num_individual_j_shms = dst_clone.j_shms.size() - src_clone.j_shms.size();
+            edge_info.num_intersected_j_shms = src_clone.j_shms.size();
+            return edge_info;
+        }
         // reverse directed
-        if (annotation_utils::SHMComparator::SHMs1AreNestedInSHMs2(dst_clone.VSHMs(), src_clone.VSHMs()) &&
-            annotation_utils::SHMComparator::SHMs1AreNestedInSHMs2(dst_clone.JSHMs(), src_clone.JSHMs()))
-            return std::shared_ptr<BaseEvolutionaryEdge>( new ReverseDirectedEvolutionaryEdge(src_clone,
-                                                                                              dst_clone,
-                                                                                              src_num,
-                                                                                              dst_num) );
+        if (CompactSHMs::SHMs1AreNestedInSHMs2(dst_clone.v_shms, src_clone.v_shms) &&
+            CompactSHMs::SHMs1AreNestedInSHMs2(dst_clone.j_shms, src_clone.j_shms)) {
+            VERIFY_MSG(src_clone.NumSHMs() > dst_clone.NumSHMs(),
+                       "# SHMs in source clone (" << src_clone.NumSHMs() <<
+                       ") does not exceed # SHMs in destination clone (" << dst_clone.NumSHMs() << ")");
+            edge_info.edge_type = EvolutionaryEdgeType::ReverseDirectedEdgeType;
+            edge_info.num_individual_v_shms = src_clone.v_shms.size() - dst_clone.v_shms.size();
+            edge_info.num_intersected_v_shms = dst_clone.v_shms.size();
+            edge_info.num_individual_j_shms = src_clone.j_shms.size() - dst_clone.j_shms.size();
+            edge_info.num_intersected_j_shms = dst_clone.j_shms.size();
+            return edge_info;
+        }
         // intersected
         // V
-        size_t num_intersected_v_shms = annotation_utils::SHMComparator::GetNumberOfIntersections(src_clone.VSHMs(),
-                                                                                                  dst_clone.VSHMs());
-        size_t num_individual_v_shms = src_clone.VSHMs().size() + dst_clone.VSHMs().size() - 2 * num_intersected_v_shms;
-
+        size_t num_intersected_v_shms = CompactSHMs::GetNumberOfIntersections(src_clone.v_shms, dst_clone.v_shms);
+        size_t num_individual_v_shms = src_clone.v_shms.size() + dst_clone.v_shms.size() - 2 * num_intersected_v_shms;
         // J
-        size_t num_intersected_j_shms = annotation_utils::SHMComparator::GetNumberOfIntersections(src_clone.JSHMs(),
-                                                                                           dst_clone.JSHMs());
-        size_t num_individual_j_shms = src_clone.JSHMs().size() + dst_clone.JSHMs().size() - 2 * num_intersected_j_shms;
+        size_t num_intersected_j_shms = CompactSHMs::GetNumberOfIntersections(src_clone.j_shms, dst_clone.j_shms);
+        size_t num_individual_j_shms = src_clone.j_shms.size() + dst_clone.j_shms.size() - 2 * num_intersected_j_shms;
         // sum
         size_t num_individual_shms = num_individual_v_shms + num_individual_v_shms;
         size_t num_shared_shms = num_intersected_v_shms + num_intersected_j_shms;
         if (num_shared_shms >= params_.min_num_intersected_v_shms &&
-            num_individual_shms <= num_shared_shms * params_.min_num_intersected_v_shms)
-            return std::shared_ptr<BaseEvolutionaryEdge>( new IntersectedEvolutionaryEdge(src_clone, dst_clone,
-                                                                                          src_num, dst_num,
-                                                                                          num_individual_v_shms,
-                                                                                          num_intersected_v_shms,
-                                                                                          num_individual_j_shms,
-                                                                                          num_intersected_j_shms) );
-        return std::shared_ptr<BaseEvolutionaryEdge>( new BaseEvolutionaryEdge(src_clone, dst_clone,
-                                                                               src_num, dst_num) );
+            num_individual_shms <= num_shared_shms * params_.min_num_intersected_v_shms) {
+            edge_info.edge_type = EvolutionaryEdgeType::IntersectedEdgeType;
+            edge_info.num_individual_v_shms = num_individual_v_shms;
+            edge_info.num_intersected_v_shms = num_intersected_v_shms;
+            edge_info.num_individual_j_shms = num_individual_j_shms;
+            edge_info.num_intersected_j_shms = num_intersected_j_shms;
+            edge_info.double_mutated =
+                    CompactSHMs::IndividualSHMsAreIdenticallyPositioned(src_clone.v_shms, dst_clone.v_shms) &&
+                    CompactSHMs::IndividualSHMsAreIdenticallyPositioned(src_clone.j_shms, dst_clone.j_shms);
+        }
+        return edge_info;
+    }
+
+    std::shared_ptr<BaseEvolutionaryEdge> VJEvolutionaryEdgeConstructor::ConstructEdge(
+            const EvolutionaryEdgeInfo &edge_info,
+            const annotation_utils::AnnotatedClone &src_clone,
+            const annotation_utils::AnnotatedClone &dst_clone) const {
+        size_t src_num = edge_info.src_num;
+        size_t dst_num = edge_info.dst_num;
+        switch (edge_info.edge_type) {
+            case EvolutionaryEdgeType::UndirectedEdgeType:
+                return std::shared_ptr<BaseEvolutionaryEdge>( new UndirectedEvolutionaryEdge(src_clone, dst_clone,
+                                                                                             src_num, dst_num) );
+            case EvolutionaryEdgeType::DirectedEdgeType:
+                return std::shared_ptr<BaseEvolutionaryEdge>( new DirectedEvolutionaryEdge(src_clone, dst_clone,
+                                                                                           src_num, dst_num) );
+            case EvolutionaryEdgeType::ReverseDirectedEdgeType:
+                return std::shared_ptr<BaseEvolutionaryEdge>( new ReverseDirectedEvolutionaryEdge(src_clone,
+                                                                                                  dst_clone,
+                                                                                                  src_num,
+                                                                                                  dst_num) );
+            case EvolutionaryEdgeType::IntersectedEdgeType:
+                return std::shared_ptr<BaseEvolutionaryEdge>( new IntersectedEvolutionaryEdge(
+                        src_clone, dst_clone,
+                        src_num, dst_num,
+                        edge_info.num_individual_v_shms,
+                        edge_info.num_intersected_v_shms,
+                        edge_info.num_individual_j_shms,
+                        edge_info.num_intersected_j_shms,
+                        edge_info.double_mutated) );
+            default:
+                return std::shared_ptr<BaseEvolutionaryEdge>( new BaseEvolutionaryEdge(src_clone, dst_clone,
+                                                                                       src_num, dst_num) );
+        }
     }
 }
@@ -6,6 +6,8 @@
 #include "evolutionary_graph_utils/evolutionary_edge/undirected_evolutionary_edge.hpp"
 #include "evolutionary_graph_utils/evolutionary_edge/intersected_evolutionary_edge.hpp"
 #include "evolutionary_graph_utils/evolutionary_edge/reverse_directed_evolutionary_edge.hpp"
+#include "evolutionary_graph_utils/evolutionary_edge/evolutionary_edge_info.hpp"
+#include "evolutionary_graph_utils/compact_shms.hpp"
 
 namespace antevolo {
     class EvolutionaryEdgeConstructor {
@@ -15,6 +17,17 @@ namespace antevolo {
                                                                     size_t src_num,
                                                                     size_t dst_num) const = 0;
 
+        // classification of edge without allocations of edge objects & copying of clones
+        virtual EvolutionaryEdgeInfo ComputeEdgeInfo(const CompactClone &src_clone,
+                                                     const CompactClone &dst_clone,
+                                                     size_t src_num,
+                                                     size_t dst_num) const = 0;
+
+        // creates edge object for already classified edge
+        virtual std::shared_ptr<BaseEvolutionaryEdge> ConstructEdge(const EvolutionaryEdgeInfo &edge_info,
+                                                                    const annotation_utils::AnnotatedClone &src_clone,
+                                                                    const annotation_utils::AnnotatedClone &dst_clone) const = 0;
+
         virtual ~EvolutionaryEdgeConstructor() { }
     };
 
@@ -42,5 +55,14 @@ namespace antevolo {
                                        const annotation_utils::AnnotatedClone &dst_clone,
                                        size_t src_num,
                                        size_t dst_num) const;
+
+        EvolutionaryEdgeInfo ComputeEdgeInfo(const CompactClone &src_clone,
+                                             const CompactClone &dst_clone,
+                                             size_t src_num,
+                                             size_t dst_num) const;
+
+        std::shared_ptr<BaseEvolutionaryEdge> ConstructEdge(const EvolutionaryEdgeInfo &edge_info,
+                                                            const annotation_utils::AnnotatedClone &src_clone,
+                                                            const annotation_utils::AnnotatedClone &dst_clone) const;
     };
 }
\ No newline at end of file
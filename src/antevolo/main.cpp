@@ -23,10 +23,13 @@ void create_console_logger(/*std::string cfg_filename*/) {
 
 void prepare_output_dir(const antevolo::AntEvoloConfig &config) {
     path::make_dir(config.output_params.output_dir);
-    path::make_dir(config.output_params.tree_dir);
-    path::make_dir(config.output_params.vertex_dir);
-    path::make_dir(config.output_params.cdr_graph_dir);
-    path::make_dir(config.output_params.tree_shm_dir);
+    if(config.output_params.tree_output_mode == antevolo::AntEvoloConfig::OutputParams::ArchiveTreeOutputMode)
+        path::make_dir(config.output_params.tree_archive_dir);
+    else {
+        path::make_dir(config.output_params.tree_dir);
+        path::make_dir(config.output_params.vertex_dir);
+        path::make_dir(config.output_params.tree_shm_dir);
+    }
     if(config.algorithm_params.parallel_evolution_params.enable_parallel_shms_finder) {
         path::make_dir(config.output_params.parallel_shm_output.parallel_bulges_dir);
         path::make_dir(config.output_params.parallel_shm_output.parallel_shm_dir);
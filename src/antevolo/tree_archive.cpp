@@ -0,0 +1,97 @@
+#include <cstdlib>
+#include <sstream>
+
+#include <verify.hpp>
+#include <path_helper.hpp>
+
+#include "tree_archive.hpp"
+
+namespace antevolo {
+    std::string GetTreeArchiveSectionFname(const std::string &archive_dir, TreeArchiveSection section) {
+        switch(section) {
+            case TreeArchiveSection::TreeEdgesSection:
+                return path::append_path(archive_dir, "clonal_trees.txt");
+            case TreeArchiveSection::TreeVerticesSection:
+                return path::append_path(archive_dir, "clonal_trees_vertices.txt");
+            case TreeArchiveSection::TreeSHMsSection:
+                return path::append_path(archive_dir, "tree_shms.txt");
+        }
+        VERIFY_MSG(false, "Unknown section of tree archive");
+        return "";
+    }
+
+    std::string GetTreeArchiveIndexFname(const std::string &archive_dir) {
+        return path::append_path(archive_dir, "index.txt");
+    }
+
+    TreeArchiveWriter::TreeArchiveWriter(const std::string &archive_dir) :
+            buffers_(NUM_TREE_ARCHIVE_SECTIONS, std::vector<char>(BUFFER_SIZE)),
+            num_trees_(0) {
+        for(size_t i = 0; i < NUM_TREE_ARCHIVE_SECTIONS; i++) {
+            section_files_[i].rdbuf()->pubsetbuf(buffers_[i].data(), BUFFER_SIZE);
+            std::string fname = GetTreeArchiveSectionFname(archive_dir, TreeArchiveSection(i));
+            section_files_[i].open(fname, std::ios::out | std::ios::binary);
+            VERIFY_MSG(section_files_[i].good(), "Tree archive file " << fname << " was not opened");
+            section_sizes_[i] = 0;
+        }
+        index_.open(GetTreeArchiveIndexFname(archive_dir));
+        VERIFY_MSG(index_.good(), "Index of tree archive " << archive_dir << " was not opened");
+        index_ << "Tree_id\tTree_name\tTree_offset\tTree_length\tVertices_offset\tVertices_length\t"
+                "SHMs_offset\tSHMs_length\n";
+    }
+
+    void TreeArchiveWriter::AddTree(const std::string &tree_name, const TreeSectionRecords &records) {
+        num_trees_++;
+        index_ << num_trees_ << "\t" << tree_name;
+        for(size_t i = 0; i < NUM_TREE_ARCHIVE_SECTIONS; i++) {
+            section_files_[i].write(records[i].data(), records[i].size());
+            index_ << "\t" << section_sizes_[i] << "\t" << records[i].size();
+            section_sizes_[i] += records[i].size();
+        }
+        index_ << "\n";
+    }
+
+    TreeArchiveReader::TreeArchiveReader(const std::string &archive_dir) : archive_dir_(archive_dir) {
+        std::string index_fname = GetTreeArchiveIndexFname(archive_dir);
+        std::ifstream index(index_fname);
+        VERIFY_MSG(index.good(), "Index of tree archive " << index_fname << " was not opened");
+        std::string line;
+        std::getline(index, line);
+        while(std::getline(index, line) && !line.empty()) {
+            std::stringstream ss(line);
+            size_t tree_id;
+            TreeArchiveRecord record;
+            ss >> tree_id >> record.tree_name;
+            for(size_t i = 0; i < NUM_TREE_ARCHIVE_SECTIONS; i++)
+                ss >> record.offsets[i] >> record.lengths[i];
+            VERIFY_MSG(!ss.fail() && tree_id == records_.size() + 1, "Malformed line of " << index_fname <<
+                                                                     ": " << line);
+            name_index_[record.tree_name] = records_.size();
+            records_.push_back(record);
+        }
+    }
+
+    size_t TreeArchiveReader::FindTree(const std::string &tree_id) const {
+        auto it = name_index_.find(tree_id);
+        if(it != name_index_.end())
+            return it->second;
+        char *end = nullptr;
+        size_t id = std::strtoull(tree_id.c_str(), &end, 10);
+        if(tree_id.empty() || *end != '\0' || id == 0 || id > records_.size())
+            return records_.size();
+        return id - 1;
+    }
+
+    std::string TreeArchiveReader::ReadSection(size_t index, TreeArchiveSection section) const {
+        VERIFY(index < records_.size());
+        std::string fname = GetTreeArchiveSectionFname(archive_dir_, section);
+        std::ifstream in(fname, std::ios::in | std::ios::binary);
+        VERIFY_MSG(in.good(), "Tree archive file " << fname << " was not opened");
+        std::string record(records_[index].lengths[section], '\0');
+        in.seekg(records_[index].offsets[section]);
+        in.read(&record[0], record.size());
+        VERIFY_MSG(in.gcount() == static_cast<std::streamsize>(record.size()), "Tree archive file " << fname <<
+                                                                               " is truncated");
+        return record;
+    }
+}
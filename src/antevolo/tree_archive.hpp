@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/unordered_map.hpp>
+
+namespace antevolo {
+    /*
+     * Archive of clonal trees: append-only files with edges of trees, vertices of trees and tree SHMs
+     * (their records are the same as contents of the corresponding files of files output mode)
+     * and text index storing offsets and lengths of records of every tree.
+     * Index line: Tree_id, Tree_name, Tree_offset, Tree_length, Vertices_offset, Vertices_length,
+     * SHMs_offset, SHMs_length. Tree ids are 1-based and coincide with ids of tree_details.txt
+     */
+    enum TreeArchiveSection { TreeEdgesSection, TreeVerticesSection, TreeSHMsSection };
+
+    const size_t NUM_TREE_ARCHIVE_SECTIONS = 3;
+
+    typedef std::array<std::string, NUM_TREE_ARCHIVE_SECTIONS> TreeSectionRecords;
+
+    struct TreeArchiveRecord {
+        std::string tree_name;
+        size_t offsets[NUM_TREE_ARCHIVE_SECTIONS];
+        size_t lengths[NUM_TREE_ARCHIVE_SECTIONS];
+    };
+
+    class TreeArchiveWriter {
+        static const size_t BUFFER_SIZE = 1 << 20;
+
+        std::vector<std::vector<char>> buffers_;
+        std::ofstream section_files_[NUM_TREE_ARCHIVE_SECTIONS];
+        size_t section_sizes_[NUM_TREE_ARCHIVE_SECTIONS];
+        std::ofstream index_;
+        size_t num_trees_;
+
+    public:
+        explicit TreeArchiveWriter(const std::string &archive_dir);
+
+        // records of trees should be added in order of their ids
+        void AddTree(const std::string &tree_name, const TreeSectionRecords &records);
+
+        size_t NumTrees() const { return num_trees_; }
+    };
+
+    class TreeArchiveReader {
+        std::string archive_dir_;
+        std::vector<TreeArchiveRecord> records_;
+        boost::unordered_map<std::string, size_t> name_index_;
+
+    public:
+        explicit TreeArchiveReader(const std::string &archive_dir);
+
+        size_t size() const { return records_.size(); }
+
+        // tree_id is either 1-based id or name of tree; returns size() if there is no such tree
+        size_t FindTree(const std::string &tree_id) const;
+
+        const TreeArchiveRecord& operator[](size_t index) const { return records_[index]; }
+
+        std::string ReadSection(size_t index, TreeArchiveSection section) const;
+    };
+
+    std::string GetTreeArchiveSectionFname(const std::string &archive_dir, TreeArchiveSection section);
+
+    std::string GetTreeArchiveIndexFname(const std::string &archive_dir);
+}
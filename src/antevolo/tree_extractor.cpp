@@ -0,0 +1,43 @@
+#include <cstring>
+#include <iostream>
+
+#include <logger/log_writers.hpp>
+
+#include "tree_archive.hpp"
+
+void create_console_logger() {
+    using namespace logging;
+    logger *lg = create_logger("");
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+bool parse_section(const char *str, antevolo::TreeArchiveSection &section) {
+    if(strcmp(str, "tree") == 0)
+        section = antevolo::TreeArchiveSection::TreeEdgesSection;
+    else if(strcmp(str, "vertices") == 0)
+        section = antevolo::TreeArchiveSection::TreeVerticesSection;
+    else if(strcmp(str, "shms") == 0)
+        section = antevolo::TreeArchiveSection::TreeSHMsSection;
+    else
+        return false;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    create_console_logger();
+    antevolo::TreeArchiveSection section = antevolo::TreeArchiveSection::TreeEdgesSection;
+    if((argc != 3 && argc != 4) || (argc == 4 && !parse_section(argv[3], section))) {
+        INFO("Extracts a single clonal tree from archive written by AntEvolo in archive output mode.");
+        INFO("Usage: <archive dir> <tree id or tree name> [tree|vertices|shms]");
+        return 1;
+    }
+    antevolo::TreeArchiveReader reader(argv[1]);
+    size_t index = reader.FindTree(argv[2]);
+    if(index == reader.size()) {
+        INFO("Tree " << argv[2] << " was not found in archive " << argv[1] << " of " << reader.size() << " trees");
+        return 1;
+    }
+    std::cout << reader.ReadSection(index, section);
+    return 0;
+}
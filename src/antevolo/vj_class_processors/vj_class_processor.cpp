@@ -1,6 +1,5 @@
-#include <path_helper.hpp>
 #include "vj_class_processor.hpp"
-#include "../../graph_utils/graph_io.hpp"
+#include "../../fast_ig_tools/tau_dist_graph.hpp"
 #include "../../graph_utils/graph_splitter.hpp"
 #include <convert.hpp>
 #include <annotation_utils/shm_comparator.hpp>
@@ -14,7 +13,7 @@ namespace antevolo {
     }
 
     void VJClassProcessor::CreateUniqueCDR3Map(
-            core::DecompositionClass decomposition_class) {
+            const core::DecompositionClass& decomposition_class) {
         const auto& clone_set = *clone_set_ptr_;
         for(auto it = decomposition_class.begin(); it != decomposition_class.end(); it++) {
             if(clone_set[*it].RegionIsEmpty(annotation_utils::StructuralRegion::CDR3))
@@ -30,39 +29,14 @@ namespace antevolo {
             cdr3_to_old_index_map_[unique_cdr3s_[i]] = i;
     }
 
-    std::string VJClassProcessor::GetFastaFname(core::DecompositionClass decomposition_class) {
-        std::stringstream ss;
-        size_t key = *decomposition_class.begin();
-        ss << "CDR3_sequences_key_" << key << ".fasta";
-        return path::append_path(config_.output_params.cdr_graph_dir, ss.str());
-    }
-
-    std::string VJClassProcessor::GetGraphFname(core::DecompositionClass decomposition_class) {
-        std::stringstream ss;
-        size_t key = *decomposition_class.begin();
-        ss << "CDR3_sequences_key_" << key << ".graph";
-        return path::append_path(config_.output_params.cdr_graph_dir, ss.str());
-    }
-
-    std::string VJClassProcessor::WriteUniqueCDR3InFasta(core::DecompositionClass decomposition_class) {
-        std::string output_fname = GetFastaFname(decomposition_class);
-        std::ofstream out(output_fname);
-        for(auto it = unique_cdr3s_.begin(); it != unique_cdr3s_.end(); it++)
-            out << ">" << *it << std::endl << *it << std::endl;
-        return output_fname;
-    }
-
     // return connected components of Hamming graph on CDR3s
-    std::vector<SparseGraphPtr> VJClassProcessor::ComputeCDR3HammingGraphs(std::string cdr_fasta,
-                                                                           std::string graph_fname) {
-//        std::string run_graph_constructor = "./build/release/bin/ig_swgraph_construct";
-        std::stringstream ss;
-        ss << config_.cdr_labeler_config.input_params.run_hg_constructor << " -i " << cdr_fasta <<
-                " -o " << graph_fname << " --tau " << num_mismatches_ << " -S " << " 0 " <<
-                " -T " << " 0 " << " -k 10 > " << config_.output_params.trash_output;
-        int err_code = system(ss.str().c_str());
-        VERIFY_MSG(err_code == 0, "Graph constructor finished abnormally, error code: " << err_code);
-        auto sparse_cdr_graph_ = GraphReader(graph_fname).CreateGraph();
+    std::vector<SparseGraphPtr> VJClassProcessor::ComputeCDR3HammingGraphs() {
+        TauDistGraphParams params;
+        params.tau = static_cast<unsigned>(num_mismatches_);
+        params.k = 10;
+        params.strategy = 0;
+        params.ignore_tails = false;
+        auto sparse_cdr_graph_ = tauDistSparseGraph(unique_cdr3s_, params);
         TRACE("Hamming graph contains " << sparse_cdr_graph_->N() << " edges and " << sparse_cdr_graph_->NZ() << " edges");
 
         auto connected_components = ConnectedComponentGraphSplitter(sparse_cdr_graph_).Split();
@@ -71,7 +45,20 @@ namespace antevolo {
     }
 
 
-    EvolutionaryTree VJClassProcessor::ProcessComponentWithKruskal(SparseGraphPtr hg_component, size_t component_id) {
+    size_t VJClassProcessor::ComponentNumberOfClones(size_t component_id) const {
+        size_t num_clones = 0;
+        for(size_t i = 0; i < graph_component_map_.SubgraphSize(component_id); i++) {
+            size_t old_index = graph_component_map_.GetOldVertexByNewVertex(component_id, i);
+            num_clones += unique_cdr3s_map_.find(unique_cdr3s_[old_index])->second.size();
+        }
+        return num_clones;
+    }
+
+    EvolutionaryTree VJClassProcessor::ProcessComponentWithKruskal(CloneSetWithFakesPtr clone_set,
+                                                                   SparseGraphPtr hg_component,
+                                                                   size_t component_id,
+                                                                   size_t& current_fake_clone_index,
+                                                                   size_t& num_reconstructed) const {
 
         CDR3HammingGraphInfo hamming_graph_info(graph_component_map_,
                                                 unique_cdr3s_map_,
@@ -80,20 +67,24 @@ namespace antevolo {
                                                 hg_component,
                                                 component_id);
         std::shared_ptr<Base_CDR3_HG_CC_Processor> forest_calculator(
-                new Kruskal_CDR3_HG_CC_Processor(clone_set_ptr_,
+                new Kruskal_CDR3_HG_CC_Processor(clone_set,
                                                  config_.algorithm_params,
                                                  clone_by_read_constructor_,
                                                  hamming_graph_info,
-                                                 current_fake_clone_index_));
+                                                 current_fake_clone_index));
         auto tree = forest_calculator->ConstructForest();
-        current_fake_clone_index_ = forest_calculator->GetCurrentFakeCloneIndex();
-        reconstructed_ += forest_calculator->GetNumberOfReconstructedClones();
+        current_fake_clone_index = forest_calculator->GetCurrentFakeCloneIndex();
+        num_reconstructed += forest_calculator->GetNumberOfReconstructedClones();
         return tree;
     }
+
     EvolutionaryTree VJClassProcessor::ProcessComponentWithEdmonds(
+            CloneSetWithFakesPtr clone_set,
             SparseGraphPtr hg_component,
             size_t component_id,
-            const ShmModelEdgeWeightCalculator& edge_weight_calculator) {
+            size_t& current_fake_clone_index,
+            size_t& num_reconstructed,
+            const ShmModelEdgeWeightCalculator& edge_weight_calculator) const {
 
         CDR3HammingGraphInfo hamming_graph_info(graph_component_map_,
                                                 unique_cdr3s_map_,
@@ -102,19 +93,15 @@ namespace antevolo {
                                                 hg_component,
                                                 component_id);
         std::shared_ptr<Base_CDR3_HG_CC_Processor> forest_calculator(
-                    new Edmonds_CDR3_HG_CC_Processor(clone_set_ptr_,
+                    new Edmonds_CDR3_HG_CC_Processor(clone_set,
                                                      config_.algorithm_params,
                                                      clone_by_read_constructor_,
                                                      hamming_graph_info,
-                                                     current_fake_clone_index_,
+                                                     current_fake_clone_index,
                                                      edge_weight_calculator));
         auto tree = forest_calculator->ConstructForest();
-        current_fake_clone_index_ = forest_calculator->GetCurrentFakeCloneIndex();
-        reconstructed_ += forest_calculator->GetNumberOfReconstructedClones();
+        current_fake_clone_index = forest_calculator->GetCurrentFakeCloneIndex();
+        num_reconstructed += forest_calculator->GetNumberOfReconstructedClones();
         return tree;
     }
-
-
-
-
 }
\ No newline at end of file
@@ -12,8 +12,6 @@ namespace antevolo {
         const AntEvoloConfig& config_;
         size_t num_mismatches_;
         const AnnotatedCloneByReadConstructor& clone_by_read_constructor_;
-        size_t current_fake_clone_index_;
-        size_t reconstructed_;
         typedef std::map<std::string, std::vector<size_t>> UniqueCDR3IndexMap;
         typedef std::map<std::string, size_t> CDR3ToIndexMap;
         typedef boost::associative_property_map<std::map<size_t, size_t>> AP_map;
@@ -27,29 +25,32 @@ namespace antevolo {
 
         void Clear();
 
-        std::string GetFastaFname(core::DecompositionClass decomposition_class);
-
     public:
         VJClassProcessor(CloneSetWithFakesPtr clone_set,
                          const AntEvoloConfig& config,
-                         const AnnotatedCloneByReadConstructor& clone_by_read_constructor,
-                         size_t current_fake_clone_index) :
+                         const AnnotatedCloneByReadConstructor& clone_by_read_constructor) :
                 BaseCandidateCalculator(clone_set),
                 config_(config),
                 num_mismatches_(config.algorithm_params.similar_cdr3s_params.num_mismatches),
-                clone_by_read_constructor_(clone_by_read_constructor),
-                current_fake_clone_index_(current_fake_clone_index),
-                reconstructed_(0) { }
-
-        void CreateUniqueCDR3Map(core::DecompositionClass decomposition_class);
-        std::string WriteUniqueCDR3InFasta(core::DecompositionClass decomposition_class);
-        std::string GetGraphFname(core::DecompositionClass decomposition_class);
-        std::vector<SparseGraphPtr> ComputeCDR3HammingGraphs(std::string cdr_fasta, std::string cdr_graph);
-        EvolutionaryTree ProcessComponentWithKruskal(SparseGraphPtr hg_component, size_t component_id);
-        EvolutionaryTree ProcessComponentWithEdmonds(SparseGraphPtr hg_component, size_t component_id,
-                                                     const ShmModelEdgeWeightCalculator &edge_weight_calculator);
-
-        size_t GetCurrentFakeCloneIndex() const { return current_fake_clone_index_; };
-        size_t GetNumberOfReconstructedClones() const { return reconstructed_; };
+                clone_by_read_constructor_(clone_by_read_constructor) { }
+
+        void CreateUniqueCDR3Map(const core::DecompositionClass& decomposition_class);
+        std::vector<SparseGraphPtr> ComputeCDR3HammingGraphs();
+
+        size_t ComponentNumberOfClones(size_t component_id) const;
+
+        // components of the same class can be processed concurrently: each component has its own
+        // clone set for reconstructed fakes and its own range of fake clone indices
+        EvolutionaryTree ProcessComponentWithKruskal(CloneSetWithFakesPtr clone_set,
+                                                     SparseGraphPtr hg_component, size_t component_id,
+                                                     size_t& current_fake_clone_index,
+                                                     size_t& num_reconstructed) const;
+        EvolutionaryTree ProcessComponentWithEdmonds(CloneSetWithFakesPtr clone_set,
+                                                     SparseGraphPtr hg_component, size_t component_id,
+                                                     size_t& current_fake_clone_index,
+                                                     size_t& num_reconstructed,
+                                                     const ShmModelEdgeWeightCalculator &edge_weight_calculator) const;
     };
+
+    typedef std::shared_ptr<VJClassProcessor> VJClassProcessorPtr;
 }
\ No newline at end of file
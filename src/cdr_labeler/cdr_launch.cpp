@@ -41,7 +41,7 @@ namespace cdr_labeler {
         INFO(alignment_info.NumVJHits() << " reads were aligned; " << alignment_info.NumFilteredReads() <<
                      " reads were filtered out");
         ReadCDRLabeler read_labeler(config_.shm_params, v_labeling, j_labeling);
-        auto annotated_clone_set = read_labeler.CreateAnnotatedCloneSet(alignment_info);
+        auto annotated_clone_set = read_labeler.CreateAnnotatedCloneSet(alignment_info, config_.run_params.num_threads);
         INFO("CDR sequences and SHMs were computed");
         CDRLabelingWriter writer(config_.output_params, annotated_clone_set);
         writer.OutputCleanedReads();
@@ -54,8 +54,7 @@ namespace cdr_labeler {
         writer.OutputSHMs();
         INFO("Diversity analysis of CDRs");
         DiversityAnalyser cdr_analyser(annotated_clone_set, config_.input_params,
-                                       config_.output_params,
-                                       config_.output_params.cdr3_compressed_fasta);
+                                       config_.output_params);
         INFO("Shannon index. CDR1: " << cdr_analyser.ShannonIndex(StructuralRegion::CDR1) <<
                 ", CDR2: " << cdr_analyser.ShannonIndex(StructuralRegion::CDR2) <<
                 ", CDR3: " << cdr_analyser.ShannonIndex(StructuralRegion::CDR3));
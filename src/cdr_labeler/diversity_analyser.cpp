@@ -1,11 +1,9 @@
 #include <verify.hpp>
 
 #include "diversity_analyser.hpp"
+#include "../fast_ig_tools/tau_dist_graph.hpp"
 #include "../graph_utils/graph_splitter.hpp"
 
-#include <../graph_utils/graph_io.hpp>
-#include <../graph_utils/graph_splitter.hpp>
-
 namespace cdr_labeler {
     size_t DiversityAnalyser::MaxConnectedComponentAbundance() {
         size_t max_abundance = 0;
@@ -18,17 +16,15 @@ namespace cdr_labeler {
         return max_abundance;
     }
 
-    void DiversityAnalyser::InitializeGraph(std::string compressed_cdr3_fasta) {
-        if(compressed_cdr3_fasta == "") {
-            // do something
-        }
-        std::string graph_fname = path::append_path(output_params_.output_dir, "cdr3_graph.graph");
-        std::string run_graph_constructor = input_params_.run_hg_constructor; //"./build/release/bin/ig_swgraph_construct";
-        std::string command_line = run_graph_constructor + " -i " + compressed_cdr3_fasta +
-                                   " -o " + graph_fname + " --tau 3 -T 0 > " + output_params_.trash_output;
-        int err_code = system(command_line.c_str());
-        VERIFY_MSG(err_code == 0, "Graph constructor finished abnormally, error code: " << err_code);
-        auto cdr3_graph = GraphReader(graph_fname).CreateGraph();
+    void DiversityAnalyser::InitializeGraph() {
+        std::vector<seqan::Dna5String> cdr3s;
+        cdr3s.reserve(cdr3_compressed_set_.size());
+        for(auto it = cdr3_compressed_set_.cbegin(); it != cdr3_compressed_set_.cend(); it++)
+            cdr3s.push_back(it->first.cdr_seq);
+        TauDistGraphParams params;
+        params.tau = 3;
+        params.ignore_tails = false;
+        auto cdr3_graph = tauDistSparseGraph(cdr3s, params);
         ConnectedComponentGraphSplitter graph_splitter(cdr3_graph);
         cdr3_graphs_ = graph_splitter.Split();
         graph_component_map_ = cdr3_graph->GetGraphComponentMap();
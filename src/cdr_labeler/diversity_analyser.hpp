@@ -17,7 +17,7 @@ namespace cdr_labeler {
         std::vector<SparseGraphPtr> cdr3_graphs_;
         GraphComponentMap graph_component_map_;
 
-        void InitializeGraph(std::string compressed_cdr3_fasta);
+        void InitializeGraph();
 
         //size_t ComputeD50(const std::vector<SparseGraphPtr> connected_components) const;
 
@@ -28,15 +28,14 @@ namespace cdr_labeler {
     public:
         DiversityAnalyser(const annotation_utils::CDRAnnotatedCloneSet &clone_set,
                           const CDRLabelerConfig::InputParams &input_params,
-                          const CDRLabelerConfig::OutputParams &output_params,
-                          std::string compressed_cdr3_fasta = "") :
+                          const CDRLabelerConfig::OutputParams &output_params) :
                 //clone_set_(clone_set),
                 input_params_(input_params),
                 output_params_(output_params),
                 cdr1_compressed_set_(annotation_utils::StructuralRegion::CDR1, clone_set),
                 cdr2_compressed_set_(annotation_utils::StructuralRegion::CDR2, clone_set),
                 cdr3_compressed_set_(annotation_utils::StructuralRegion::CDR3, clone_set){
-            InitializeGraph(compressed_cdr3_fasta);
+            InitializeGraph();
         }
 
         double ShannonIndex(annotation_utils::StructuralRegion region);
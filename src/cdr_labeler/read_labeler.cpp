@@ -1,5 +1,6 @@
 #include "read_labeler.hpp"
 #include <annotation_utils/annotated_clone_calculator.hpp>
+#include <omp.h>
 
 namespace cdr_labeler {
     std::shared_ptr<annotation_utils::BaseAACalculator> ReadCDRLabeler::GetAACalculator() {
@@ -34,35 +35,56 @@ namespace cdr_labeler {
         return std::shared_ptr<annotation_utils::BaseSHMCalculator>(NULL);
     }
 
-    annotation_utils::AnnotatedClone ReadCDRLabeler::CreateAnnotatedClone(const vj_finder::VJHits &vj_hits) {
+    annotation_utils::AnnotatedCloneCalculator ReadCDRLabeler::CreateCloneCalculator() {
+        return annotation_utils::AnnotatedCloneCalculator(GetAACalculator(), GetVSHMCalculator(), GetJSHMCalculator());
+    }
+
+    annotation_utils::AnnotatedClone ReadCDRLabeler::CreateAnnotatedClone(
+            const vj_finder::VJHits &vj_hits,
+            annotation_utils::AnnotatedCloneCalculator &clone_calculator) const {
+        vj_finder::ImmuneGeneAlignmentConverter alignment_converter;
         auto v_hit = vj_hits.GetVHitByIndex(0);
-        auto v_alignment = alignment_converter_.ConvertToAlignment(v_hit.ImmuneGene(),
-                                                                   vj_hits.Read(),
-                                                                   v_hit.BlockAlignment());
+        auto v_alignment = alignment_converter.ConvertToAlignment(v_hit.ImmuneGene(),
+                                                                  vj_hits.Read(),
+                                                                  v_hit.BlockAlignment());
         auto v_cdr_labeling = v_labeling_.GetLabelingByGene(v_hit.ImmuneGene());
         annotation_utils::CDRRange read_cdr1(v_alignment.QueryPositionBySubjectPosition(v_cdr_labeling.cdr1.start_pos),
                                              v_alignment.QueryPositionBySubjectPosition(v_cdr_labeling.cdr1.end_pos));
         annotation_utils::CDRRange read_cdr2(v_alignment.QueryPositionBySubjectPosition(v_cdr_labeling.cdr2.start_pos),
                                              v_alignment.QueryPositionBySubjectPosition(v_cdr_labeling.cdr2.end_pos));
         auto j_hit = vj_hits.GetJHitByIndex(0);
-        auto j_alignment = alignment_converter_.ConvertToAlignment(j_hit.ImmuneGene(),
-                                                                   vj_hits.Read(),
-                                                                   j_hit.BlockAlignment());
+        auto j_alignment = alignment_converter.ConvertToAlignment(j_hit.ImmuneGene(),
+                                                                  vj_hits.Read(),
+                                                                  j_hit.BlockAlignment());
         auto j_cdr_labeling = j_labeling_.GetLabelingByGene(j_hit.ImmuneGene());
         annotation_utils::CDRRange read_cdr3(v_alignment.QueryPositionBySubjectPosition(v_cdr_labeling.cdr3.start_pos),
                                              j_alignment.QueryPositionBySubjectPosition(j_cdr_labeling.cdr3.end_pos));
 
-        return clone_calculator_.ComputeAnnotatedClone(vj_hits.Read(),
-                                                       annotation_utils::CDRLabeling(read_cdr1, read_cdr2, read_cdr3),
-                                                       v_alignment, j_alignment);
+        return clone_calculator.ComputeAnnotatedClone(vj_hits.Read(),
+                                                      annotation_utils::CDRLabeling(read_cdr1, read_cdr2, read_cdr3),
+                                                      v_alignment, j_alignment);
     }
 
     annotation_utils::CDRAnnotatedCloneSet ReadCDRLabeler::CreateAnnotatedCloneSet(
-            const vj_finder::VJAlignmentInfo &alignment_info) {
-        annotation_utils::CDRAnnotatedCloneSet clone_set;
+            const vj_finder::VJAlignmentInfo &alignment_info, size_t num_threads) {
+        num_threads = std::max<size_t>(num_threads, 1);
+        std::vector<annotation_utils::AnnotatedCloneCalculator> clone_calculators;
+        clone_calculators.reserve(num_threads);
+        for(size_t i = 0; i < num_threads; i++)
+            clone_calculators.push_back(CreateCloneCalculator());
+        // i-th slot is written only by the thread processing i-th VJ hits
+        std::vector<std::unique_ptr<annotation_utils::AnnotatedClone>> clones(alignment_info.NumVJHits());
+#pragma omp parallel for schedule(dynamic, 64) num_threads(num_threads)
         for(size_t i = 0; i < alignment_info.NumVJHits(); i++) {
-            auto vj_hit = alignment_info.GetVJHitsByIndex(i);
-            clone_set.AddClone(CreateAnnotatedClone(vj_hit));
+            auto &clone_calculator = clone_calculators[omp_get_thread_num()];
+            clones[i].reset(new annotation_utils::AnnotatedClone(
+                    CreateAnnotatedClone(alignment_info.GetVJHitsByIndex(i), clone_calculator)));
+        }
+        annotation_utils::CDRAnnotatedCloneSet clone_set;
+        clone_set.reserve(clones.size());
+        for(auto &clone : clones) {
+            clone_set.AddClone(std::move(*clone));
+            clone.reset();
         }
         INFO(clone_set.size() << " annotated sequences were created");
         return clone_set;
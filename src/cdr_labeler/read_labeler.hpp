@@ -16,7 +16,6 @@ namespace cdr_labeler {
         const DbCDRLabeling& j_labeling_;
 
         annotation_utils::AnnotatedCloneCalculator clone_calculator_;
-        vj_finder::ImmuneGeneAlignmentConverter alignment_converter_;
 
         std::shared_ptr<annotation_utils::BaseAACalculator> GetAACalculator();
 
@@ -30,11 +29,21 @@ namespace cdr_labeler {
                 shm_config_(shm_config),
                 v_labeling_(v_labeling),
                 j_labeling_(j_labeling),
-                clone_calculator_(GetAACalculator(), GetVSHMCalculator(), GetJSHMCalculator()){ }
+                clone_calculator_(CreateCloneCalculator()) { }
 
-        annotation_utils::AnnotatedClone CreateAnnotatedClone(const vj_finder::VJHits &vj_hits);
+        // calculator with its own AA and SHM calculators, SHM calculators keep intermediate state
+        annotation_utils::AnnotatedCloneCalculator CreateCloneCalculator();
 
-        annotation_utils::CDRAnnotatedCloneSet CreateAnnotatedCloneSet(const vj_finder::VJAlignmentInfo &alignment_info);
+        annotation_utils::AnnotatedClone CreateAnnotatedClone(const vj_finder::VJHits &vj_hits) {
+            return CreateAnnotatedClone(vj_hits, clone_calculator_);
+        }
+
+        annotation_utils::AnnotatedClone CreateAnnotatedClone(const vj_finder::VJHits &vj_hits,
+                                                              annotation_utils::AnnotatedCloneCalculator &clone_calculator) const;
+
+        // clones follow the order of VJ hits for any number of threads
+        annotation_utils::CDRAnnotatedCloneSet CreateAnnotatedCloneSet(const vj_finder::VJAlignmentInfo &alignment_info,
+                                                                       size_t num_threads = 1);
 
         annotation_utils::AnnotatedCloneCalculator& GetCloneCalculator() {
             return clone_calculator_;
@@ -35,6 +35,12 @@ namespace core {
         INFO(size() << " reads were extracted from " << fastq_file_fname);
     }
 
+    void ReadArchive::AddRead(std::string read_name, seqan::Dna5String read_seq) {
+        size_t index = reads_.size();
+        name_index_map_[read_name] = index;
+        reads_.push_back(Read(read_name, read_seq, index));
+    }
+
     size_t ReadArchive::size() const {
         return reads_.size();
     }
@@ -52,6 +52,9 @@ namespace core {
 
         void ExtractFromFile(std::string fastq_file_fname);
 
+        // appends read with the next index as id
+        void AddRead(std::string read_name, seqan::Dna5String read_seq);
+
         size_t size() const;
 
         typedef std::vector<Read>::const_iterator read_iterator;
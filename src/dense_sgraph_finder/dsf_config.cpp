@@ -76,6 +76,7 @@ void load(dsf_config::metis_io_params &metis_io, boost::property_tree::ptree con
     load(metis_io.path_to_metis, pt, "path_to_metis");
     load(metis_io.run_metis, pt, "run_metis");
     load(metis_io.trash_output, pt, "trash_output");
+    metis_io.run_in_process = pt.get<bool>("run_in_process", true);
     metis_io.run_metis = path::append_path(metis_io.path_to_metis, metis_io.run_metis);
 }
 
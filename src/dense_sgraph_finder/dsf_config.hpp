@@ -43,6 +43,8 @@ struct dsf_config {
         std::string 	path_to_metis;
         std::string		run_metis;
         std::string		trash_output;
+        // if false or in-process ordering fails, METIS binary is run on a graph file
+        bool            run_in_process;
     };
 
     struct dense_sgraph_finder_params {
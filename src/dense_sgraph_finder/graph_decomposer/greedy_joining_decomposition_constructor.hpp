@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <set>
+
 #include "../graph_utils/decomposition.hpp"
 #include "../graph_utils/sparse_graph.hpp"
 
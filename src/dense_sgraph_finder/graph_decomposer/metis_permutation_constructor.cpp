@@ -1,3 +1,5 @@
+#include <metis.h>
+
 #include "metis_permutation_constructor.hpp"
 
 using namespace dense_subgraph_finder;
@@ -38,10 +40,58 @@ PermutationPtr MetisPermutationConstructor::ReadPermutation(std::string permutat
     return perm;
 }
 
-PermutationPtr MetisPermutationConstructor::CreatePermutation() {
+PermutationPtr MetisPermutationConstructor::CreatePermutationUsingFiles() {
     std::string graph_copy_filename = GetMETISGraphFilename();
     WriteHammingGraphInMETISFormat(graph_copy_filename);
     std::string permutation_fname = RunMETIS(graph_copy_filename);
     TRACE("Permutation was written to " << permutation_fname);
     return ReadPermutation(permutation_fname);
+}
+
+PermutationPtr MetisPermutationConstructor::CreatePermutationInProcess() {
+    idx_t num_vertices = static_cast<idx_t>(graph_ptr_->N());
+    // adjacency lists are the same as in METIS graph file: transposed edges come first
+    std::vector<idx_t> xadj(graph_ptr_->N() + 1);
+    std::vector<idx_t> adjncy;
+    adjncy.reserve(2 * graph_ptr_->NZ());
+    for (size_t i = 0; i < graph_ptr_->N(); i++) {
+        xadj[i] = static_cast<idx_t>(adjncy.size());
+        for (size_t j = graph_ptr_->RowIndexT()[i]; j < graph_ptr_->RowIndexT()[i + 1]; j++)
+            adjncy.push_back(static_cast<idx_t>(graph_ptr_->ColT()[j]));
+        for (size_t j = graph_ptr_->RowIndex()[i]; j < graph_ptr_->RowIndex()[i + 1]; j++)
+            adjncy.push_back(static_cast<idx_t>(graph_ptr_->Col()[j]));
+    }
+    xadj[graph_ptr_->N()] = static_cast<idx_t>(adjncy.size());
+
+    // options are the same as default options of ndmetis binary
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    options[METIS_OPTION_CTYPE] = METIS_CTYPE_SHEM;
+    options[METIS_OPTION_IPTYPE] = METIS_IPTYPE_NODE;
+    options[METIS_OPTION_RTYPE] = METIS_RTYPE_SEP1SIDED;
+    options[METIS_OPTION_COMPRESS] = 1;
+    options[METIS_OPTION_NSEPS] = 1;
+    options[METIS_OPTION_NITER] = 10;
+
+    std::vector<idx_t> perm(graph_ptr_->N());
+    std::vector<idx_t> iperm(graph_ptr_->N());
+    int status = METIS_NodeND(&num_vertices, xadj.data(), adjncy.data(), NULL, options, perm.data(), iperm.data());
+    if (status != METIS_OK) {
+        WARN("METIS library returned error code " << status);
+        return PermutationPtr();
+    }
+
+    PermutationPtr permutation(new Permutation(graph_ptr_->N()));
+    permutation->ReadFromVector(std::vector<size_t>(iperm.cbegin(), iperm.cend()));
+    return permutation;
+}
+
+PermutationPtr MetisPermutationConstructor::CreatePermutation() {
+    if (metis_io_params_.run_in_process) {
+        PermutationPtr permutation = CreatePermutationInProcess();
+        if (permutation)
+            return permutation;
+        WARN("In-process METIS ordering failed, METIS binary will be used");
+    }
+    return CreatePermutationUsingFiles();
 }
\ No newline at end of file
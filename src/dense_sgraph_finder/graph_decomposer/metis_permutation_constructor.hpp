@@ -19,6 +19,12 @@ class MetisPermutationConstructor {
 
 	PermutationPtr ReadPermutation(std::string permutation_fname);
 
+	PermutationPtr CreatePermutationUsingFiles();
+
+	// nested dissection ordering is computed by METIS library directly on CRS arrays of the graph
+	// returns nullptr if METIS fails
+	PermutationPtr CreatePermutationInProcess();
+
 public:
 	PermutationPtr CreatePermutation();
 
@@ -28,6 +34,9 @@ public:
 			graph_ptr_(graph_ptr),
 			metis_io_params_(metis_io_params),
 			graph_filename_(graph_filename) { }
+
+private:
+	DECL_LOGGER("MetisPermutationConstructor");
 };
 
 }
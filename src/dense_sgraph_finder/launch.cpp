@@ -57,13 +57,13 @@ namespace {
         DecompositionPtr CreateFinalDecomposition(size_t num_connected_components) {
             GraphComponentMap &component_map = graph_ptr_->GetGraphComponentMap();
             TRACE(component_map);
-            std::map<size_t, size_t> vertex_new_set;
+            std::vector<size_t> vertex_new_set(graph_ptr_->N(), size_t(-1));
             size_t cur_set_id = 0;
             for(size_t i = 0; i < num_connected_components; i++) {
                 //string cur_decomposition_fname = GetDecompositionFilename(i);
                 DecompositionPtr subgraph_decomposition = connected_component_decompositions_[i]; //(new Decomposition(cur_decomposition_fname));
                 for(size_t j = 0; j < subgraph_decomposition->Size(); j++) {
-                    const std::set<size_t> &cur_subclass = subgraph_decomposition->GetClass(j);
+                    DecompositionClass cur_subclass = subgraph_decomposition->GetClass(j);
                     for(auto it = cur_subclass.begin(); it != cur_subclass.end(); it++) {
                         size_t subgraph_vertex = *it;
                         size_t old_vertex = component_map.GetOldVertexByNewVertex(i, subgraph_vertex);
@@ -75,8 +75,8 @@ namespace {
             }
             DecompositionPtr final_decomposition_ptr(new Decomposition(graph_ptr_->N()));
             for(size_t i = 0; i < graph_ptr_->N(); i++) {
-                VERIFY(vertex_new_set.find(i) != vertex_new_set.end());
                 size_t class_id = vertex_new_set[i];
+                VERIFY(class_id != size_t(-1));
                 final_decomposition_ptr->SetClass(i, class_id);
             }
             return final_decomposition_ptr;
@@ -153,6 +153,8 @@ namespace {
 
 int dense_subgraph_finder::DenseSubgraphFinder::Run() {
     INFO("==== Dense subgraph finder starts");
+    // graph is read & split into components using the same threads as dense subgraph search
+    omp_set_num_threads(run_params_.threads_count);
     GraphReader graph_reader(io_.input.graph_filename);
     SparseGraphPtr graph_ptr = graph_reader.CreateGraph();
     if (!graph_ptr) {
@@ -171,7 +173,6 @@ int dense_subgraph_finder::DenseSubgraphFinder::Run() {
     }
     else {
         INFO("Parallel mode was chosen. Number of threads: " << run_params_.threads_count);
-        omp_set_num_threads(run_params_.threads_count);
         dense_sgraph_decomposition = ParallelDenseSubgraphFinder(graph_ptr, dsf_params_, io_, metis_io_).Run();
     }
     INFO(dense_sgraph_decomposition->Size() << " dense subgraphs were constructed");
@@ -73,6 +73,7 @@ def GetSimulateSteps(params, run_params):
                       "--pcr-error1 %f" % run_params.pcr_error_rate,
                       "--pcr-error2 %f" % run_params.pcr_error_rate,
                       # "--pcr-rate 0.001",
+                      "--threads %d" % params.threads,
                       ]),
         ShStep(igrec_dir, ["%s/vj_finder" % igrec_bin,
                            "--input-file %s/amplified/repertoire_comp.fasta" % run_params.data_path,
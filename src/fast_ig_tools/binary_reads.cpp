@@ -0,0 +1,127 @@
+#include "binary_reads.hpp"
+
+#include <algorithm>
+
+#include <seqan/seq_io.h>
+#include <seqan/parallel.h>
+
+#include "ig_final_alignment.hpp"
+
+namespace {
+    const size_t BASES_PER_WORD = 32;
+    const size_t NUM_SECTIONS = 7;
+}
+
+BinaryReadsView::BinaryReadsView(const std::string &filename) :
+        reader_(filename, io::binary::ContainerType::Reads) {
+    VERIFY_MSG(reader_.NumSections() == NUM_SECTIONS,
+               "Binary reads container should contain " << NUM_SECTIONS << " sections");
+    VERIFY(reader_.SectionSize<uint64_t>(0) == 2);
+    num_reads_ = static_cast<size_t>(reader_.Section<uint64_t>(0)[0]);
+    size_t num_bases = static_cast<size_t>(reader_.Section<uint64_t>(0)[1]);
+    VERIFY(reader_.SectionSize<uint64_t>(1) == num_reads_ + 1);
+    VERIFY(reader_.SectionSize<uint64_t>(2) == (num_bases + BASES_PER_WORD - 1) / BASES_PER_WORD);
+    VERIFY(reader_.SectionSize<uint64_t>(4) == num_reads_);
+    VERIFY(reader_.SectionSize<uint64_t>(5) == num_reads_ + 1);
+    read_offsets_ = reader_.Section<uint64_t>(1);
+    packed_bases_ = reader_.Section<uint64_t>(2);
+    n_positions_ = reader_.Section<uint64_t>(3);
+    num_n_positions_ = reader_.SectionSize<uint64_t>(3);
+    abundances_ = reader_.Section<uint64_t>(4);
+    id_offsets_ = reader_.Section<uint64_t>(5);
+    ids_ = reader_.Section<char>(6);
+    VERIFY(read_offsets_[num_reads_] == num_bases);
+    VERIFY(id_offsets_[num_reads_] == reader_.SectionSize<char>(6));
+}
+
+seqan::Dna5String BinaryReadsView::Read(size_t index) const {
+    size_t begin = static_cast<size_t>(read_offsets_[index]);
+    size_t len = ReadLength(index);
+    seqan::Dna5String read;
+    seqan::resize(read, len);
+    for (size_t i = 0; i < len; ++i) {
+        size_t pos = begin + i;
+        read[i] = seqan::Dna5((packed_bases_[pos / BASES_PER_WORD] >> (2 * (pos % BASES_PER_WORD))) & 3);
+    }
+    const uint64_t *n_end = n_positions_ + num_n_positions_;
+    for (const uint64_t *it = std::lower_bound(n_positions_, n_end, uint64_t(begin));
+         it != n_end && *it < begin + len; ++it) {
+        read[*it - begin] = 'N';
+    }
+    return read;
+}
+
+void write_binary_reads(const std::string &filename,
+                        const std::vector<seqan::CharString> &ids,
+                        const std::vector<seqan::Dna5String> &reads,
+                        const std::vector<size_t> &abundances) {
+    VERIFY(ids.size() == reads.size() && reads.size() == abundances.size());
+    std::vector<uint64_t> read_offsets(reads.size() + 1);
+    std::vector<uint64_t> id_offsets(reads.size() + 1);
+    for (size_t i = 0; i < reads.size(); ++i) {
+        read_offsets[i + 1] = read_offsets[i] + seqan::length(reads[i]);
+        id_offsets[i + 1] = id_offsets[i] + seqan::length(ids[i]);
+    }
+    size_t num_bases = static_cast<size_t>(read_offsets.back());
+
+    std::vector<uint64_t> packed_bases((num_bases + BASES_PER_WORD - 1) / BASES_PER_WORD);
+    std::vector<uint64_t> n_positions;
+    std::vector<char> concatenated_ids(static_cast<size_t>(id_offsets.back()));
+    for (size_t i = 0; i < reads.size(); ++i) {
+        for (size_t j = 0; j < seqan::length(reads[i]); ++j) {
+            size_t pos = static_cast<size_t>(read_offsets[i]) + j;
+            uint64_t code = seqan::ordValue(reads[i][j]);
+            if (code > 3) {
+                n_positions.push_back(pos);
+                code = 0;
+            }
+            packed_bases[pos / BASES_PER_WORD] |= code << (2 * (pos % BASES_PER_WORD));
+        }
+        std::copy(seqan::begin(ids[i]), seqan::end(ids[i]), concatenated_ids.begin() + id_offsets[i]);
+    }
+
+    std::vector<uint64_t> sizes = { reads.size(), num_bases };
+    std::vector<uint64_t> abundances64(abundances.cbegin(), abundances.cend());
+    io::binary::ContainerWriter writer(io::binary::ContainerType::Reads);
+    writer.AddSection(sizes);
+    writer.AddSection(read_offsets);
+    writer.AddSection(packed_bases);
+    writer.AddSection(n_positions);
+    writer.AddSection(abundances64);
+    writer.AddSection(id_offsets);
+    writer.AddSection(concatenated_ids);
+    writer.Write(filename);
+}
+
+void read_records(const std::string &filename,
+                  std::vector<seqan::CharString> &ids,
+                  std::vector<seqan::Dna5String> &reads) {
+    if (!io::binary::IsBinaryContainer(filename)) {
+        seqan::SeqFileIn seqFileIn(filename.c_str());
+        seqan::readRecords(ids, reads, seqFileIn);
+        return;
+    }
+
+    BinaryReadsView view(filename);
+    ids.resize(view.size());
+    reads.resize(view.size());
+    SEQAN_OMP_PRAGMA(parallel for schedule(static))
+    for (size_t i = 0; i < view.size(); ++i) {
+        ids[i] = view.Id(i);
+        reads[i] = view.Read(i);
+    }
+}
+
+void write_records(const std::string &filename,
+                   const std::vector<seqan::CharString> &ids,
+                   const std::vector<seqan::Dna5String> &reads) {
+    if (io::binary::HasBinaryExtension(filename)) {
+        write_binary_reads(filename, ids, reads, find_abundances(ids));
+        return;
+    }
+
+    seqan::SeqFileOut seqFileOut(filename.c_str());
+    seqan::writeRecords(seqFileOut, ids, reads);
+}
+
+// vim: ts=4:sw=4
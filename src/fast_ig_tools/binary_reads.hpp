@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <seqan/sequence.h>
+#include <io/binary_container.hpp>
+
+/*
+ * Binary reads container (io::binary::ContainerType::Reads):
+ *      section 0: number of reads, total number of bases
+ *      section 1: offsets of reads in the concatenated sequence (number of reads + 1 values)
+ *      section 2: concatenated sequence, 2 bits per base, 32 bases per 64-bit word starting from lower bits
+ *      section 3: sorted positions of N in the concatenated sequence (stored as A in section 2)
+ *      section 4: abundances of reads
+ *      section 5: offsets of ids in the concatenated ids (number of reads + 1 values)
+ *      section 6: concatenated ids
+ */
+class BinaryReadsView {
+    io::binary::ContainerReader reader_;
+    size_t num_reads_;
+    const uint64_t *read_offsets_;
+    const uint64_t *packed_bases_;
+    const uint64_t *n_positions_;
+    size_t num_n_positions_;
+    const uint64_t *abundances_;
+    const uint64_t *id_offsets_;
+    const char *ids_;
+
+public:
+    explicit BinaryReadsView(const std::string &filename);
+
+    size_t size() const { return num_reads_; }
+
+    size_t ReadLength(size_t index) const {
+        return static_cast<size_t>(read_offsets_[index + 1] - read_offsets_[index]);
+    }
+
+    seqan::Dna5String Read(size_t index) const;
+
+    std::string Id(size_t index) const {
+        return std::string(ids_ + id_offsets_[index], ids_ + id_offsets_[index + 1]);
+    }
+
+    size_t Abundance(size_t index) const { return static_cast<size_t>(abundances_[index]); }
+};
+
+void write_binary_reads(const std::string &filename,
+                        const std::vector<seqan::CharString> &ids,
+                        const std::vector<seqan::Dna5String> &reads,
+                        const std::vector<size_t> &abundances);
+
+// Reads FASTA/FASTQ file or binary reads container, ids of binary reads are restored as they were written
+void read_records(const std::string &filename,
+                  std::vector<seqan::CharString> &ids,
+                  std::vector<seqan::Dna5String> &reads);
+
+// Writes reads in binary format if filename has extension io::binary::BINARY_EXTENSION, otherwise in FASTA/FASTQ.
+// Abundances of binary reads are extracted from ___size___ suffixes of ids
+void write_records(const std::string &filename,
+                   const std::vector<seqan::CharString> &ids,
+                   const std::vector<seqan::Dna5String> &reads);
+
+// vim: ts=4:sw=4
@@ -1,5 +1,7 @@
 #include "fast_ig_tools.hpp"
 #include <limits>
+#include <io/binary_container.hpp>
+#include "../graph_utils/graph_io.hpp"
 
 size_t numEdges(const Graph &graph,
                 bool undirected) {
@@ -17,9 +19,40 @@ size_t numEdges(const Graph &graph,
 }
 
 
+namespace {
+    // Upper triangle of adjacency matrix in the order of adjacency lists
+    void write_binary_graph(const Graph &graph,
+                            const std::vector<size_t> &weights,
+                            const std::string &filename,
+                            bool undirected) {
+        VERIFY_MSG(undirected, "Only undirected graphs can be written in binary format");
+        std::vector<size_t> row_index(graph.size() + 1);
+        std::vector<size_t> col;
+        std::vector<size_t> dist;
+        col.reserve(numEdges(graph, undirected));
+        dist.reserve(col.capacity());
+        for (size_t i = 0; i < graph.size(); ++i) {
+            for (const auto &edge : graph[i]) {
+                if (i < edge.first) {
+                    col.push_back(edge.first);
+                    dist.push_back(static_cast<size_t>(edge.second));
+                }
+            }
+            row_index[i + 1] = col.size();
+        }
+        WriteBinaryGraph(filename, row_index, col, dist, weights);
+    }
+}
+
+
 void write_metis_graph(const Graph &graph,
                        const std::string &filename,
                        bool undirected) {
+    if (io::binary::HasBinaryExtension(filename)) {
+        write_binary_graph(graph, std::vector<size_t>(graph.size(), 1), filename, undirected);
+        return;
+    }
+
     std::ofstream out(filename);
 
     // Count the numder of vertices and the number of edges
@@ -43,6 +76,11 @@ void write_metis_graph(const Graph &graph,
                        bool undirected) {
     VERIFY(graph.size() == weights.size());
 
+    if (io::binary::HasBinaryExtension(filename)) {
+        write_binary_graph(graph, weights, filename, undirected);
+        return;
+    }
+
     std::ofstream out(filename);
 
     // Count the numder of vertices and the number of edges
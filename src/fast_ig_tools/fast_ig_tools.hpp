@@ -16,6 +16,9 @@ using Graph = std::vector<std::vector<std::pair<size_t, int>>>;
 size_t numEdges(const Graph &graph,
                 bool undirected = true);
 
+// Graphs are written in binary format (see graph_utils/graph_io.hpp)
+// if filename has extension io::binary::BINARY_EXTENSION
+
 void write_metis_graph(const Graph &graph,
                        const std::string &filename,
                        bool undirected = true);
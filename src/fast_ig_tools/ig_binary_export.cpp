@@ -0,0 +1,97 @@
+#include <string>
+
+#include <build_info.hpp>
+
+#include <iostream>
+using std::cout;
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include "fast_ig_tools.hpp"
+#include "binary_reads.hpp"
+#include "utils.hpp"
+#include "../graph_utils/graph_io.hpp"
+#include "../graph_utils/decomposition.hpp"
+
+using seqan::Dna5String;
+using seqan::CharString;
+
+// Converts binary container of any type to its text analogue:
+// reads to FASTA, graph to METIS format, decomposition to the list of vertex classes
+int main(int argc, char **argv) {
+    segfault_handler sh;
+    perf_counter pc;
+    create_console_logger("");
+
+    std::string input_file;
+    std::string output_file;
+    try {
+        po::options_description generic("Generic options");
+        generic.add_options()
+            ("version,v", "print version string")
+            ("help,h", "produce help message")
+            ("input-file,i", po::value<std::string>(&input_file)->required(),
+             "name of the input binary container")
+            ("output-file,o", po::value<std::string>(&output_file)->required(),
+             "name of the output text file")
+            ;
+
+        po::positional_options_description p;
+        p.add("input-file", 1);
+        p.add("output-file", 1);
+
+        po::variables_map vm;
+        store(po::command_line_parser(argc, argv).
+              options(generic).positional(p).run(), vm);
+
+        if (vm.count("help")) {
+            cout << generic << std::endl;
+            return 0;
+        }
+
+        if (vm.count("version")) {
+            cout << bformat("IG binary export, part of IgReC version %s; git version: %s") % build_info::version % build_info::git_hash7 << std::endl;
+            return 0;
+        }
+
+        notify(vm);
+    } catch(std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    INFO("Command line: " << join_cmd_line(argc, argv));
+    VERIFY_MSG(!io::binary::HasBinaryExtension(output_file),
+               "Output file " << output_file << " should not have binary extension " << io::binary::BINARY_EXTENSION);
+
+    switch (io::binary::GetContainerType(input_file)) {
+        case io::binary::ContainerType::Reads: {
+            std::vector<CharString> ids;
+            std::vector<Dna5String> reads;
+            read_records(input_file, ids, reads);
+            write_records(output_file, ids, reads);
+            INFO(reads.size() << " reads were written to " << output_file);
+            break;
+        }
+        case io::binary::ContainerType::Graph: {
+            SparseGraphPtr graph = GraphReader(input_file).CreateGraph();
+            GraphWriter(output_file).PrintGraph(graph);
+            INFO("Graph with " << graph->N() << " vertices & " << graph->NZ() << " edges was written to " << output_file);
+            break;
+        }
+        case io::binary::ContainerType::Decomposition: {
+            Decomposition decomposition(input_file);
+            decomposition.SaveTo(output_file);
+            INFO("Decomposition with " << decomposition.Size() << " classes was written to " << output_file);
+            break;
+        }
+        default:
+            VERIFY_MSG(false, "Unknown type of binary container " << input_file);
+    }
+
+    INFO("Running time: " << running_time_format(pc));
+    return 0;
+}
+
+// vim: ts=4:sw=4
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <numeric>
 
 #include <unordered_map>
 #include <build_info.hpp>
@@ -15,13 +16,13 @@ namespace po = boost::program_options;
 #include "fast_ig_tools.hpp"
 #include "ig_final_alignment.hpp"
 #include "ig_matcher.hpp"
+#include "binary_reads.hpp"
 #include "utils.hpp"
 
 #include <seqan/seq_io.h>
 #undef NDEBUG
 
 using seqan::Dna5String;
-using seqan::SeqFileIn;
 using seqan::SeqFileOut;
 using seqan::CharString;
 
@@ -248,7 +249,7 @@ int main(int argc, char **argv) {
             ("config,c", po::value<std::string>(&config_file)->default_value(config_file),
              "name of a file of a configuration")
             ("input-file,i", po::value<std::string>(&reads_file),
-             "name of the input file (FASTA|FASTQ)")
+             "name of the input file (FASTA|FASTQ|binary reads)")
             ("output-file,o", po::value<std::string>(&output_file)->default_value(output_file),
              "output file for final repertoire")
             ("rcm-file,R", po::value<std::string>(&rcm_file)->default_value(rcm_file),
@@ -344,10 +345,8 @@ int main(int argc, char **argv) {
 
     std::vector<Dna5String> input_reads;
     std::vector<CharString> input_ids;
-    SeqFileIn seqFileIn_input(reads_file.c_str());
-
     INFO("Reading input reads starts");
-    readRecords(input_ids, input_reads, seqFileIn_input);
+    read_records(reads_file, input_ids, input_reads);
     INFO(input_reads.size() << " reads were extracted from " << reads_file);
 
     std::vector<size_t> component_indices;
@@ -386,23 +385,40 @@ int main(int argc, char **argv) {
     }
     INFO(bformat("Size of maximal cluster: %d") % max_component_size);
 
+    std::vector<std::pair<std::string, std::vector<size_t>>> comp2readnum_sorted(comp2readnum.cbegin(), comp2readnum.cend());
+    std::sort(comp2readnum_sorted.begin(), comp2readnum_sorted.end());
+
+    // Cluster sizes are heavily skewed, so the largest clusters are scheduled first
+    // to prevent them from being the tail of the computation
+    std::vector<size_t> processing_order(comp2readnum_sorted.size());
+    std::iota(processing_order.begin(), processing_order.end(), 0);
+    std::stable_sort(processing_order.begin(), processing_order.end(),
+                     [&comp2readnum_sorted](size_t i, size_t j) {
+                         return comp2readnum_sorted[i].second.size() > comp2readnum_sorted[j].second.size();
+                     });
+
     omp_set_num_threads(nthreads);
     INFO(bformat("Computation of consensus using %d threads starts") % nthreads);
+
+    // Results are buffered per cluster and written in the sorted order afterwards, so the output does not depend
+    // on the number of threads
+    std::vector<std::vector<std::pair<Dna5String, std::vector<size_t>>>> results(comp2readnum_sorted.size());
+    SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 1))
+    for (size_t i = 0; i < processing_order.size(); ++i) {
+        size_t comp_index = processing_order[i];
+        results[comp_index] = split_component(input_reads, comp2readnum_sorted[comp_index].second,
+                                              max_votes, discard, recursive, flu);
+    }
+
     INFO("Saving results");
 
     SeqFileOut seqFileOut_output(output_file.c_str());
 
     std::ofstream out_rcm(output_rcm_file.c_str());
 
-
-    std::vector<std::pair<std::string, std::vector<size_t>>> comp2readnum_sorted(comp2readnum.cbegin(), comp2readnum.cend());
-    std::sort(comp2readnum_sorted.begin(), comp2readnum_sorted.end());
-
-    // TODO Use multithreading
-    for (const auto &kv : comp2readnum_sorted) {
-        const auto &comp = kv.first;
-        const auto &indices = kv.second;
-        auto result = split_component(input_reads, indices, max_votes, discard, recursive, flu);
+    for (size_t comp_index = 0; comp_index < comp2readnum_sorted.size(); ++comp_index) {
+        const auto &comp = comp2readnum_sorted[comp_index].first;
+        auto &result = results[comp_index];
         for (size_t i = 0; i < result.size(); ++i) {
             std::stringstream ss(comp);
             if (result.size() > 1) {
@@ -420,6 +436,8 @@ int main(int argc, char **argv) {
                 out_rcm << read_id << "\t" << cluster_id << "\n";
             }
         }
+        // Release the buffer as soon as the cluster is written
+        decltype(results)::value_type().swap(result);
     }
 
     INFO("Final repertoire was written to " << output_file);
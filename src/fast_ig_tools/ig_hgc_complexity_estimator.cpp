@@ -33,15 +33,11 @@ std::pair<size_t, std::vector<size_t>> find_candidates_num(const T &read,
 
     std::vector<size_t> costs;
 
-    auto hashes = polyhashes(read, K);
-
-    costs.reserve(hashes.size());
-    for (size_t hash : hashes) {
-        auto it = kmer2reads.find(hash);
-        if (it != kmer2reads.cend()) // TODO check it
-            costs.push_back(it->second.size());
-        else
-            costs.push_back(0);
+    auto kmers = packed_kmers(read, K);
+
+    costs.reserve(kmers.size());
+    for (PackedKmer kmer : kmers) {
+        costs.push_back(kmer2reads.find(kmer).size());
     }
 
     std::vector<size_t> ind = optimal_coverage(costs, K, tau + 1);
@@ -49,11 +45,7 @@ std::pair<size_t, std::vector<size_t>> find_candidates_num(const T &read,
     size_t result = 0;
 
     for (size_t i : ind) {
-        size_t hash = hashes[i];
-        auto it = kmer2reads.find(hash);
-        if (it != kmer2reads.cend()) {
-            result += it->second.size();
-        }
+        result += costs[i];
     }
 
     return { result, ind };
@@ -228,7 +220,8 @@ int main(int argc, char **argv) {
     out << "# tau: " << tau << std::endl;
     out << "k\td_count\tav_d_count" << std::endl;
 
-    for (int K = 5; K <= std::max(static_cast<int>(min_L) / (tau + 1), 100); K += k_step) {
+    int max_K = std::min(std::max(static_cast<int>(min_L) / (tau + 1), 100), static_cast<int>(MAX_PACKED_KMER_SIZE));
+    for (int K = 5; K <= max_K; K += k_step) {
         INFO("K-mer index construction. K = " << K);
         auto kmer2reads = kmerIndexConstruction(input_reads, K);
 
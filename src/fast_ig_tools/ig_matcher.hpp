@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <unordered_map>
 #include <fstream>
@@ -9,38 +10,10 @@
 
 #include <seqan/seq_io.h>
 #include "fast_ig_tools.hpp"
+#include "kmer_index.hpp"
 using seqan::length;
 
 
-// TODO Reimplement it as "generator" with O(1) memory consumption
-template<typename T>
-std::vector<size_t> polyhashes(const T &s, size_t K) {
-    if (length(s) < K) {
-        return {  };
-    }
-
-    const size_t p = 7;
-    std::vector<size_t> result(length(s) - K + 1);
-
-    size_t first = 0;
-    size_t p_pow_K = 1;
-    for (size_t i = 0; i < K; ++i) {
-        first *= p;
-        first += unsigned(s[i]);
-        p_pow_K *= p;
-    }
-
-    result[0] = first;
-    for (size_t i = 1; i < result.size(); ++i) {
-        first *= p;
-        first += unsigned(s[K + i - 1]); //size_t(s[K + i - 1]);
-        first -= unsigned(s[i - 1]) * p_pow_K; //size_t(s[i - 1]) * p_pow_K;
-        result[i] = first;
-    }
-
-    return result;
-}
-
 template<typename T1, typename T2 = T1>
 int hamming_rtrim(const T1& s1, const T2 &s2) {
     size_t len = std::min<size_t>(length(s1), length(s2));
@@ -65,25 +38,9 @@ void remove_duplicates(std::vector<T> &v, bool sorted = false) {
 }
 
 
-using KmerIndex = std::unordered_map<size_t, std::vector<size_t>>;
-
-
 template<typename T>
 KmerIndex kmerIndexConstruction(const std::vector<T> &input_reads, size_t K) {
-    size_t initial_hashtable_size = (K <= 13) ? (1 << (2*K)) : (input_reads.size() * 200);
-    KmerIndex kmer2reads(initial_hashtable_size);
-
-    for (size_t j = 0; j < input_reads.size(); ++j) {
-        for (size_t hash : polyhashes(input_reads[j], K)) {
-            kmer2reads[hash].push_back(j); // Already sorted. Nice!
-        }
-    }
-
-    for (auto &kv : kmer2reads) {
-        remove_duplicates(kv.second, true);
-    }
-
-    return kmer2reads;
+    return KmerIndex(input_reads, K);
 }
 
 
@@ -114,28 +71,34 @@ std::vector<size_t> find_candidates(const T &read,
     } else { // Minimizers strategy
         std::vector<size_t> multiplicities;
 
-        auto hashes = polyhashes(read, K);
-
-        multiplicities.reserve(hashes.size());
-        for (size_t hash : hashes) {
-            auto it = kmer2reads.find(hash);
-            if (it != kmer2reads.cend()) {
-                multiplicities.push_back(it->second.size());
-            } else {
-                multiplicities.push_back(0);
-            }
+        auto kmers = packed_kmers(read, K);
+
+        // Windows with N are not indexed and can never produce a hit, so the coverage should avoid them:
+        // a single such window costs more than any coverage by indexed windows
+        const size_t invalid_multiplicity = (tau + strategy) * target_size + 1;
+        std::vector<KmerIndex::Postings> postings;
+        postings.reserve(kmers.size());
+        multiplicities.reserve(kmers.size());
+        for (PackedKmer kmer : kmers) {
+            postings.push_back(kmer2reads.find(kmer));
+            multiplicities.push_back((kmer == INVALID_KMER) ? invalid_multiplicity : postings.back().size());
         }
 
         std::vector<size_t> ind = optimal_coverage(multiplicities, K, tau + strategy);
 
+        // Too many N to cover the read by indexed windows, the pigeonhole principle does not hold
+        for (size_t i : ind) {
+            if (kmers[i] == INVALID_KMER) {
+                cand.resize(target_size);
+                std::iota(cand.begin(), cand.end(), 0);
+                return cand;
+            }
+        }
+
         std::unordered_map<size_t, size_t> hits;
         for (size_t i : ind) {
-            size_t hash = hashes[i];
-            auto it = kmer2reads.find(hash);
-            if (it != kmer2reads.cend()) {
-                for (size_t candidate_index : it->second) {
-                    ++hits[candidate_index];
-                }
+            for (size_t candidate_index : postings[i]) {
+                ++hits[candidate_index];
             }
         }
 
@@ -150,6 +113,47 @@ std::vector<size_t> find_candidates(const T &read,
 }
 
 
+// Reads shorter than K * (tau + strategy) have no candidates.
+// Switches to single or double strategy if it saves more than 5% of reads
+template<typename T>
+unsigned choose_strategy(const std::vector<T> &input_reads,
+                         unsigned K, unsigned tau,
+                         unsigned strategy,
+                         size_t &discarded_reads) {
+    size_t required_read_length = (strategy != 0) ? (K * (tau + strategy)) : 0;
+    size_t required_read_length_for_single_strategy = K * (tau + 1);
+    size_t required_read_length_for_double_strategy = K * (tau + 2);
+
+    discarded_reads = 0;
+    size_t discarded_reads_single = 0;
+    size_t discarded_reads_double = 0;
+    for (const auto &read : input_reads) {
+        discarded_reads += length(read) < required_read_length;
+        discarded_reads_single += length(read) < required_read_length_for_single_strategy;
+        discarded_reads_double += length(read) < required_read_length_for_double_strategy;
+    }
+
+    int saved_reads_single = static_cast<int>(discarded_reads) - static_cast<int>(discarded_reads_single);
+    int saved_reads_double = static_cast<int>(discarded_reads) - static_cast<int>(discarded_reads_double);
+
+    if (saved_reads_single > 0.05 * static_cast<double>(input_reads.size())) {
+        if (saved_reads_single - saved_reads_double < 0.05 * static_cast<double>(input_reads.size())) {
+            INFO(bformat("Choosing <<double>> strategy for saving %d reads")
+                 % saved_reads_double);
+            discarded_reads = discarded_reads_double;
+            return 2;
+        } else {
+            INFO(bformat("Choosing <<single>> strategy for saving %d reads")
+                 % saved_reads_single);
+            discarded_reads = discarded_reads_single;
+            return 1;
+        }
+    }
+
+    return strategy;
+}
+
+
 template<typename T, typename Tf>
 Graph tauDistGraph(const std::vector<T> &input_reads,
                    const KmerIndex &kmer2reads,
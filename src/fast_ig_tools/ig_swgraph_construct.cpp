@@ -14,12 +14,12 @@ using std::endl;
 
 #include <seqan/seq_io.h>
 using seqan::Dna5String;
-using seqan::SeqFileIn;
 using seqan::CharString;
 
 #include "ig_matcher.hpp"
-#include "banded_half_smith_waterman.hpp"
+#include "packed_distance.hpp"
 #include "ig_final_alignment.hpp"
+#include "binary_reads.hpp"
 #include "utils.hpp"
 #include <build_info.hpp>
 
@@ -49,11 +49,11 @@ bool parse_cmd_line_arguments(int argc, char **argv, SWGCParam &args) {
             ("config,c", po::value<std::string>(&config_file),
              "name of a file of a configuration")
             ("input-file,i", po::value<std::string>(&args.input_file),
-             "name of an input file (FASTA|FASTQ)")
+             "name of an input file (FASTA|FASTQ|binary reads)")
             ("reference-file,r", po::value<std::string>(&args.reference_file)->default_value(args.reference_file),
-             "name of an input file (FASTA|FASTQ)")
+             "name of an input file (FASTA|FASTQ|binary reads)")
             ("output-file,o", po::value<std::string>(&args.output_file),
-             "file for outputted truncated dist-graph in METIS format")
+             "file for outputted truncated dist-graph in METIS format (binary graph if extension is .igb)")
             ("export-abundances,A", "export read abundances to output graph file")
             ("no-export-abundances", "don't export read abundances to output graph file (default)")
             ;
@@ -167,44 +167,16 @@ int main(int argc, char **argv) {
     INFO("Input reads: " << args.input_file);
     INFO("k = " << args.k << ", tau = " << args.tau);
 
-    SeqFileIn seqFileIn_input(args.input_file.c_str());
     std::vector<CharString> input_ids;
     std::vector<Dna5String> input_reads;
 
     INFO("Reading input reads starts");
-    readRecords(input_ids, input_reads, seqFileIn_input);
+    read_records(args.input_file, input_ids, input_reads);
     INFO(input_reads.size() << " reads were extracted from " << args.input_file);
 
     INFO("Read length checking");
-    size_t required_read_length = (args.strategy != 0) ? (args.k * (args.tau + args.strategy)) : 0;
-    size_t required_read_length_for_single_strategy = args.k * (args.tau + 1);
-    size_t required_read_length_for_double_strategy = args.k * (args.tau + 2);
-
-    size_t discarded_reads = 0;
-    size_t discarded_reads_single = 0;
-    size_t discarded_reads_double = 0;
-    for (const auto &read : input_reads) {
-        discarded_reads += length(read) < required_read_length;
-        discarded_reads_single += length(read) < required_read_length_for_single_strategy;
-        discarded_reads_double += length(read) < required_read_length_for_double_strategy;
-    }
-
-    int saved_reads_single = static_cast<int>(discarded_reads) - static_cast<int>(discarded_reads_single);
-    int saved_reads_double = static_cast<int>(discarded_reads) - static_cast<int>(discarded_reads_double);
-
-    if (saved_reads_single > 0.05 * static_cast<double>(input_reads.size())) {
-        if (saved_reads_single - saved_reads_double < 0.05 * static_cast<double>(input_reads.size())) {
-            INFO(bformat("Choosing <<double>> strategy for saving %d reads")
-                 % saved_reads_double);
-            args.strategy = 2;
-            discarded_reads = discarded_reads_double;
-        } else {
-            INFO(bformat("Choosing <<single>> strategy for saving %d reads")
-                 % saved_reads_single);
-            args.strategy = 1;
-            discarded_reads = discarded_reads_single;
-        }
-    }
+    size_t discarded_reads;
+    args.strategy = choose_strategy(input_reads, args.k, args.tau, args.strategy, discarded_reads);
 
     if (discarded_reads) {
         WARN(bformat("Discarded reads %d") % discarded_reads);
@@ -216,18 +188,24 @@ int main(int argc, char **argv) {
 
     INFO("Strategy " << args.strategy << " was chosen");
 
-    auto dist_fun = [&args](const Dna5String& s1, const Dna5String& s2) -> unsigned {
+    // Distances above tau are not computed exactly, the graph keeps only edges with dist <= tau
+    auto dist_fun = [&args](const PackedDna5String& s1, const PackedDna5String& s2) -> unsigned {
         auto delta = [&args](int l) -> int { return (bool)(l)*2 * args.tau; };
-        auto lizard_tail = [&args, &delta](int l) -> int { return args.ignore_tails ? 0 : -delta(l); };
-        return -half_sw_banded(s1, s2, 0, -1, -1, lizard_tail, args.max_indels);
+        auto tail_cost = [&args, &delta](int l) -> int { return args.ignore_tails ? 0 : delta(l); };
+        return static_cast<unsigned>(packed_distance::half_distance(s1, s2, tail_cost, args.max_indels, args.tau));
     };
 
+    INFO("Packing of input reads");
+    std::vector<PackedDna5String> packed_input_reads(input_reads.begin(), input_reads.end());
+    input_reads.clear();
+    input_reads.shrink_to_fit();
+
     if (args.reference_file == "") {
         INFO("K-mer index construction");
-        auto kmer2reads = kmerIndexConstruction(input_reads, args.k);
+        auto kmer2reads = kmerIndexConstruction(packed_input_reads, args.k);
 
         size_t num_of_dist_computations;
-        auto dist_graph = tauDistGraph(input_reads,
+        auto dist_graph = tauDistGraph(packed_input_reads,
                                        kmer2reads,
                                        dist_fun,
                                        args.tau, args.k,
@@ -235,7 +213,7 @@ int main(int argc, char **argv) {
                                        num_of_dist_computations);
 
         INFO("Simularity computations: " << num_of_dist_computations << ", average " << \
-             static_cast<double>(num_of_dist_computations) / static_cast<double>(input_reads.size()) << " per read");
+             static_cast<double>(num_of_dist_computations) / static_cast<double>(packed_input_reads.size()) << " per read");
 
         size_t num_of_edges = numEdges(dist_graph);
         INFO("Edges found: " << num_of_edges);
@@ -251,20 +229,23 @@ int main(int argc, char **argv) {
             write_metis_graph(dist_graph, args.output_file);
         }
     } else {
-        SeqFileIn seqFileIn_reference(args.reference_file.c_str());
         std::vector<CharString> reference_ids;
         std::vector<Dna5String> reference_reads;
 
         INFO("Reading input reads starts");
-        readRecords(reference_ids, reference_reads, seqFileIn_reference);
+        read_records(args.reference_file, reference_ids, reference_reads);
         INFO(reference_reads.size() << " reads were extracted from " << args.reference_file);
 
+        std::vector<PackedDna5String> packed_reference_reads(reference_reads.begin(), reference_reads.end());
+        reference_reads.clear();
+        reference_reads.shrink_to_fit();
+
         INFO("K-mer index construction");
-        auto kmer2reads = kmerIndexConstruction(reference_reads, args.k);
+        auto kmer2reads = kmerIndexConstruction(packed_reference_reads, args.k);
 
         size_t num_of_dist_computations;
-        auto dist_graph = tauMatchGraph(input_reads,
-                                        reference_reads,
+        auto dist_graph = tauMatchGraph(packed_input_reads,
+                                        packed_reference_reads,
                                         kmer2reads,
                                         dist_fun,
                                         args.tau, args.k,
@@ -272,7 +253,7 @@ int main(int argc, char **argv) {
                                         num_of_dist_computations);
 
         INFO("Simularity computations: " << num_of_dist_computations << ", average " << \
-             static_cast<double>(num_of_dist_computations) / static_cast<double>(input_reads.size()) << " per read");
+             static_cast<double>(num_of_dist_computations) / static_cast<double>(packed_input_reads.size()) << " per read");
 
         size_t num_of_edges = numEdges(dist_graph, false);
         INFO("Edges found: " << num_of_edges);
@@ -13,13 +13,13 @@ namespace po = boost::program_options;
 
 #include "fast_ig_tools.hpp"
 #include "ig_trie_compressor.hpp"
+#include "binary_reads.hpp"
 #include "utils.hpp"
 
 using fast_ig_tools::Compressor;
 
 #include <seqan/seq_io.h>
 using seqan::Dna5String;
-using seqan::SeqFileIn;
 using seqan::SeqFileOut;
 using seqan::CharString;
 using seqan::length;
@@ -33,6 +33,7 @@ int main(int argc, char **argv) {
     std::string output_file = "output.fa";
     std::string idmap_file_name = "";
     bool ignore_tails = true;
+    int nthreads = 4;
     try {
         // Declare a group of options that will be
         // allowed only on command line
@@ -42,9 +43,9 @@ int main(int argc, char **argv) {
             ("help,h", "produce help message")
             ("config-file,c", "name of a file of a configuration")
             ("input-file,i", po::value<std::string>(&input_file)->required(),
-             "name of the input file (FASTA|FASTQ)")
+             "name of the input file (FASTA|FASTQ|binary reads)")
             ("output-file,o", po::value<std::string>(&output_file)->default_value(output_file),
-             "name of the output file (FASTA|FASTQ)")
+             "name of the output file (FASTA|FASTQ, binary reads if extension is .igb)")
             ("idmap,m", po::value<std::string>(&idmap_file_name)->default_value(idmap_file_name),
              "map file name; empty (default) for non-producing")
             ;
@@ -54,6 +55,8 @@ int main(int argc, char **argv) {
         // config file
         po::options_description config("Configuration");
         config.add_options()
+            ("threads,t", po::value<int>(&nthreads)->default_value(nthreads),
+             "the number of parallel threads")
             ("ignore-tails,T", po::value<bool>(&ignore_tails)->default_value(ignore_tails),
              "wheather to ignore extra tail of the longest read during read comparison")
             ;
@@ -126,18 +129,17 @@ int main(int argc, char **argv) {
     INFO("Input reads: " << input_file);
     INFO("Output filename: " << output_file);
 
-    SeqFileIn seqFileIn_input(input_file.c_str());
-    SeqFileOut seqFileOut_output(output_file.c_str());
     std::vector<CharString> input_ids;
     std::vector<Dna5String> input_reads;
 
     INFO("Reading input reads starts");
-    readRecords(input_ids, input_reads, seqFileIn_input);
+    read_records(input_file, input_ids, input_reads);
     INFO(length(input_reads) << " reads were extracted from " << input_file);
 
-    INFO("Compression of reads starts");
+    omp_set_num_threads(nthreads);
+    INFO(bformat("Compression of reads using %d threads starts") % nthreads);
     auto indices = Compressor::compressed_reads_indices(input_reads,
-                                                        ignore_tails ? Compressor::Type::TrieCompressor : Compressor::Type::HashCompressor);
+                                                        ignore_tails ? Compressor::Type::ParallelTrieCompressor : Compressor::Type::HashCompressor);
     INFO("Compression of reads finished")
 
     std::vector<size_t> abundances(indices.size());
@@ -153,12 +155,28 @@ int main(int argc, char **argv) {
         abundances[indices[i]] += 1;  // TODO parse input read abundances and add their values here
     }
 
-    for (size_t i = 0; i < indices.size(); ++i) {
-        if (indices[i] == i) {
-            std::string id = seqan::toCString(input_ids[i]);
-            id += "___size___" + std::to_string(abundances[i]);
-
-            seqan::writeRecord(seqFileOut_output, id, input_reads[i]);
+    if (io::binary::HasBinaryExtension(output_file)) {
+        std::vector<CharString> compressed_ids;
+        std::vector<Dna5String> compressed_reads;
+        std::vector<size_t> compressed_abundances;
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (indices[i] == i) {
+                std::string id = seqan::toCString(input_ids[i]);
+                compressed_ids.push_back(id + "___size___" + std::to_string(abundances[i]));
+                compressed_reads.push_back(input_reads[i]);
+                compressed_abundances.push_back(abundances[i]);
+            }
+        }
+        write_binary_reads(output_file, compressed_ids, compressed_reads, compressed_abundances);
+    } else {
+        SeqFileOut seqFileOut_output(output_file.c_str());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (indices[i] == i) {
+                std::string id = seqan::toCString(input_ids[i]);
+                id += "___size___" + std::to_string(abundances[i]);
+
+                seqan::writeRecord(seqFileOut_output, id, input_reads[i]);
+            }
         }
     }
 
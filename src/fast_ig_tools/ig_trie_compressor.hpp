@@ -3,12 +3,14 @@
 #include <algorithm>
 #include <array>
 #include <boost/pool/object_pool.hpp>
+#include <cstdint>
 #include <limits>
 #include <memory>
 #include <boost/unordered_map.hpp>
 #include <vector>
 
 #include <seqan/seq_io.h>
+#include <seqan/parallel.h>
 #include <verify.hpp>
 
 namespace fast_ig_tools {
@@ -20,7 +22,7 @@ using ValueType = Decay<decltype(Decay<TArray>()[0])>;
 
 class Compressor {
 public:
-    enum class Type {HashCompressor, TrieCompressor};
+    enum class Type {HashCompressor, TrieCompressor, ParallelTrieCompressor};
     virtual std::vector<size_t> checkout() = 0;
     virtual ~Compressor() = default;
 
@@ -280,6 +282,219 @@ private:
 };
 
 
+/*
+ * Gives the same result as TrieCompressor: every read is mapped to the first occurrence
+ * of the shortest read that is its prefix.
+ * Reads are partitioned by their first prefix_length_ symbols and subtries of partitions are built in parallel.
+ * Subtries are flat arrays of nodes with 32-bit links, nodes are created after their parents,
+ * so targets are propagated by a single pass over the array instead of recursive DFS.
+ * Reads shorter than prefix_length_ are kept in a dense table indexed by the code of the whole read
+ */
+template <typename TValue = seqan::Dna5>
+class ParallelTrieCompressor : public Compressor {
+public:
+    ParallelTrieCompressor(const ParallelTrieCompressor &) = delete;
+    ParallelTrieCompressor &operator=(const ParallelTrieCompressor &) = delete;
+    ParallelTrieCompressor(ParallelTrieCompressor &&) = default;
+    ParallelTrieCompressor &operator=(ParallelTrieCompressor &&) = default;
+    virtual ~ParallelTrieCompressor() = default;
+
+    template <typename TCont>
+    ParallelTrieCompressor(const TCont &cont) : ParallelTrieCompressor(cont.cbegin(), cont.cend()) { }
+
+    template <typename TIter>
+    ParallelTrieCompressor(TIter b, TIter e) {
+        std::vector<TIter> reads;
+        for (; b != e; ++b) {
+            reads.push_back(b);
+        }
+        compress(reads);
+    }
+
+    size_t size() const {
+        return result_.size();
+    }
+
+    virtual std::vector<size_t> checkout() {
+        return result_;
+    }
+
+private:
+    static constexpr size_t card = seqan::ValueSize<TValue>::VALUE;
+    static constexpr size_t max_num_partitions = 4096;
+    static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t NO_READ = std::numeric_limits<size_t>::max();
+
+    struct TrieNode {
+        std::array<uint32_t, card> children;
+        uint32_t parent;
+        // position of the first read ending at this node in the list of partition reads
+        uint32_t first_read;
+
+        TrieNode(uint32_t parent) : parent(parent), first_read(NO_NODE) {
+            children.fill(NO_NODE);
+        }
+    };
+
+    std::vector<size_t> result_;
+    size_t prefix_length_ = 1;
+    size_t num_partitions_ = card;
+
+    void choose_prefix_length() {
+        while (num_partitions_ * card <= max_num_partitions) {
+            num_partitions_ *= card;
+            ++prefix_length_;
+        }
+    }
+
+    template <typename TIter>
+    void compress(const std::vector<TIter> &reads) {
+        choose_prefix_length();
+        result_.assign(reads.size(), NO_READ);
+
+        // Short reads: code of a read of length l is offsets[l] + its value in base card
+        std::vector<size_t> offsets(prefix_length_ + 1);
+        for (size_t l = 0, num_codes = 1; l < prefix_length_; ++l, num_codes *= card) {
+            offsets[l + 1] = offsets[l] + num_codes;
+        }
+        std::vector<size_t> short_reads(offsets[prefix_length_], NO_READ);
+        for (size_t i = 0; i < reads.size(); ++i) {
+            const auto &read = *reads[i];
+            size_t len = seqan::length(read);
+            if (len < prefix_length_) {
+                size_t &first = short_reads[offsets[len] + value(read, len)];
+                if (first == NO_READ) {
+                    first = i;
+                }
+            }
+        }
+
+        // Reads with a short prefix are resolved by the table, the others get partition of their prefix.
+        // If some read of a partition has a short prefix, all reads of the partition have it
+        std::vector<size_t> partition(reads.size(), NO_READ);
+        SEQAN_OMP_PRAGMA(parallel for schedule(static))
+        for (size_t i = 0; i < reads.size(); ++i) {
+            const auto &read = *reads[i];
+            size_t len = seqan::length(read);
+            size_t code = 0;
+            for (size_t l = 0; l <= std::min(len, prefix_length_ - 1); ++l) {
+                if (short_reads[offsets[l] + code] != NO_READ) {
+                    result_[i] = short_reads[offsets[l] + code];
+                    break;
+                }
+                if (l < len) {
+                    code = code * card + symbol(read, l);
+                }
+            }
+            if (result_[i] == NO_READ) {
+                VERIFY(len >= prefix_length_);
+                partition[i] = code;
+            }
+        }
+
+        // Counting sort of reads by partitions keeps the order of reads inside partitions
+        std::vector<size_t> partition_offsets(num_partitions_ + 1);
+        for (size_t p : partition) {
+            if (p != NO_READ) {
+                ++partition_offsets[p + 1];
+            }
+        }
+        for (size_t p = 0; p < num_partitions_; ++p) {
+            partition_offsets[p + 1] += partition_offsets[p];
+        }
+        std::vector<size_t> partition_reads(partition_offsets[num_partitions_]);
+        {
+            std::vector<size_t> next(partition_offsets.cbegin(), partition_offsets.cend() - 1);
+            for (size_t i = 0; i < reads.size(); ++i) {
+                if (partition[i] != NO_READ) {
+                    partition_reads[next[partition[i]]++] = i;
+                }
+            }
+        }
+        partition.clear();
+        partition.shrink_to_fit();
+
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 1))
+        for (size_t p = 0; p < num_partitions_; ++p) {
+            compress_partition(reads,
+                               partition_reads.data() + partition_offsets[p],
+                               partition_offsets[p + 1] - partition_offsets[p]);
+        }
+    }
+
+    template <typename TIter>
+    void compress_partition(const std::vector<TIter> &reads, const size_t *ids, size_t num_ids) {
+        if (num_ids == 0) {
+            return;
+        }
+        VERIFY(num_ids < NO_NODE);
+
+        // Root of the subtrie is the common prefix of the partition.
+        // As in TrieCompressor, insertion stops at the first node where some read ends
+        std::vector<TrieNode> nodes(1, TrieNode(NO_NODE));
+        std::vector<uint32_t> stop_nodes(num_ids);
+        for (size_t pos = 0; pos < num_ids; ++pos) {
+            const auto &read = *reads[ids[pos]];
+            uint32_t node = 0;
+            for (size_t i = prefix_length_; i < seqan::length(read) && nodes[node].first_read == NO_NODE; ++i) {
+                size_t el = symbol(read, i);
+                uint32_t child = nodes[node].children[el];
+                if (child == NO_NODE) {
+                    VERIFY_MSG(nodes.size() < NO_NODE, "Too many nodes in trie");
+                    child = static_cast<uint32_t>(nodes.size());
+                    nodes.push_back(TrieNode(node));
+                    nodes[node].children[el] = child;
+                }
+                node = child;
+            }
+            if (nodes[node].first_read == NO_NODE) {
+                nodes[node].first_read = static_cast<uint32_t>(pos);
+            }
+            stop_nodes[pos] = node;
+        }
+
+        // Target of a node is its topmost ancestor (or itself) where some read ends
+        std::vector<uint32_t> targets(nodes.size(), NO_NODE);
+        for (size_t node = 0; node < nodes.size(); ++node) {
+            uint32_t parent = nodes[node].parent;
+            if (parent != NO_NODE && targets[parent] != NO_NODE) {
+                targets[node] = targets[parent];
+            } else if (nodes[node].first_read != NO_NODE) {
+                targets[node] = static_cast<uint32_t>(node);
+            }
+        }
+
+        for (size_t pos = 0; pos < num_ids; ++pos) {
+            uint32_t target = targets[stop_nodes[pos]];
+            VERIFY(target != NO_NODE);
+            result_[ids[pos]] = ids[nodes[target].first_read];
+        }
+    }
+
+    template <typename T>
+    static size_t symbol(const T &read, size_t i) {
+        size_t el = seqan::ordValue(read[i]);
+        VERIFY(el < card);
+        return el;
+    }
+
+    template <typename T>
+    static size_t value(const T &read, size_t len) {
+        size_t code = 0;
+        for (size_t i = 0; i < len; ++i) {
+            code = code * card + symbol(read, i);
+        }
+        return code;
+    }
+};
+
+
+template <typename TValue>
+constexpr uint32_t ParallelTrieCompressor<TValue>::NO_NODE;
+
+template <typename TValue>
+constexpr size_t ParallelTrieCompressor<TValue>::NO_READ;
+
 template <typename TValue, typename... Args>
 std::unique_ptr<Compressor> Compressor::factor(Compressor::Type type, Args&&... args) {
     switch (type) {
@@ -287,6 +502,8 @@ std::unique_ptr<Compressor> Compressor::factor(Compressor::Type type, Args&&...
             return std::unique_ptr<Compressor>(new HashCompressor(std::forward<Args>(args)...));
         case Compressor::Type::TrieCompressor:
             return std::unique_ptr<Compressor>(new TrieCompressor<TValue>(std::forward<Args>(args)...));
+        case Compressor::Type::ParallelTrieCompressor:
+            return std::unique_ptr<Compressor>(new ParallelTrieCompressor<TValue>(std::forward<Args>(args)...));
         default:
             return std::unique_ptr<Compressor>(nullptr);
     }
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <verify.hpp>
+#include <openmp_wrapper.h>
+
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+#include <seqan/parallel.h>
+
+
+// 2-bit packed k-mers. Windows containing non-ACGT symbols are marked as invalid
+using PackedKmer = uint64_t;
+const PackedKmer INVALID_KMER = std::numeric_limits<PackedKmer>::max();
+const size_t MAX_PACKED_KMER_SIZE = 32;
+
+
+template<typename T>
+std::vector<PackedKmer> packed_kmers(const T &s, size_t K) {
+    using seqan::length;
+    VERIFY(K > 0 && K <= MAX_PACKED_KMER_SIZE);
+    size_t len = length(s);
+    if (len < K) {
+        return {  };
+    }
+
+    std::vector<PackedKmer> result(len - K + 1);
+    const PackedKmer mask = (K == MAX_PACKED_KMER_SIZE) ? INVALID_KMER : ((PackedKmer(1) << (2 * K)) - 1);
+
+    PackedKmer kmer = 0;
+    size_t last_invalid = 0; // position after the last non-ACGT symbol
+    for (size_t i = 0; i < len; ++i) {
+        unsigned code = unsigned(seqan::ordValue(s[i]));
+        if (code > 3) {
+            last_invalid = i + 1;
+            code = 0;
+        }
+        kmer = ((kmer << 2) | code) & mask;
+        if (i + 1 >= K) {
+            result[i + 1 - K] = (i + 1 - last_invalid >= K) ? kmer : INVALID_KMER;
+        }
+    }
+
+    return result;
+}
+
+
+// Immutable k-mer -> reads index in CSR layout:
+//   keys_ --- sorted distinct k-mers,
+//   offsets_[i] .. offsets_[i + 1] --- range of postings_ with sorted ids of reads containing keys_[i]
+class KmerIndex {
+public:
+    using ReadIndex = uint32_t;
+
+    class Postings {
+        const ReadIndex *begin_;
+        const ReadIndex *end_;
+
+    public:
+        Postings(const ReadIndex *begin = nullptr, const ReadIndex *end = nullptr) : begin_(begin), end_(end) { }
+
+        const ReadIndex* begin() const { return begin_; }
+
+        const ReadIndex* end() const { return end_; }
+
+        size_t size() const { return end_ - begin_; }
+
+        bool empty() const { return begin_ == end_; }
+    };
+
+private:
+    size_t K_;
+    std::vector<PackedKmer> keys_;
+    std::vector<size_t> offsets_;
+    std::vector<ReadIndex> postings_;
+
+    struct KmerOccurrence {
+        PackedKmer kmer;
+        ReadIndex read;
+    };
+
+    template<typename T>
+    void unique_read_kmers(const T &read, std::vector<PackedKmer> &kmers) const {
+        kmers = packed_kmers(read, K_);
+        kmers.erase(std::remove(kmers.begin(), kmers.end(), INVALID_KMER), kmers.end());
+        std::sort(kmers.begin(), kmers.end());
+        kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+    }
+
+    template<typename T>
+    void Initialize(const std::vector<T> &reads) {
+        VERIFY_MSG(reads.size() < std::numeric_limits<ReadIndex>::max(), "Too many reads for k-mer index");
+
+        // Occurrences are bucketed by leading bits of k-mer, so buckets can be sorted independently
+        const size_t bucket_bits = std::min<size_t>(2 * K_, 16);
+        const size_t shift = 2 * K_ - bucket_bits;
+        const size_t nbuckets = size_t(1) << bucket_bits;
+        // Nested regions run with a single thread, per-thread counters are not needed there
+        const size_t nthreads = omp_in_parallel() ? 1 : omp_get_max_threads();
+
+        // Pass 1: count occurrences per (thread, bucket)
+        std::vector<std::vector<size_t>> counts(nthreads, std::vector<size_t>(nbuckets));
+        SEQAN_OMP_PRAGMA(parallel num_threads(nthreads))
+        {
+            std::vector<PackedKmer> kmers;
+            auto &local_counts = counts[omp_get_thread_num()];
+            SEQAN_OMP_PRAGMA(for schedule(static))
+            for (size_t j = 0; j < reads.size(); ++j) {
+                unique_read_kmers(reads[j], kmers);
+                for (PackedKmer kmer : kmers) {
+                    ++local_counts[kmer >> shift];
+                }
+            }
+        }
+
+        // Static schedule gives each thread a contiguous range of reads in increasing order,
+        // so thread-major layout inside a bucket keeps reads sorted
+        std::vector<size_t> bucket_offsets(nbuckets + 1);
+        size_t total = 0;
+        for (size_t b = 0; b < nbuckets; ++b) {
+            bucket_offsets[b] = total;
+            for (size_t t = 0; t < nthreads; ++t) {
+                size_t count = counts[t][b];
+                counts[t][b] = total;
+                total += count;
+            }
+        }
+        bucket_offsets[nbuckets] = total;
+
+        // Pass 2: fill occurrences
+        std::vector<KmerOccurrence> occurrences(total);
+        SEQAN_OMP_PRAGMA(parallel num_threads(nthreads))
+        {
+            std::vector<PackedKmer> kmers;
+            auto &local_offsets = counts[omp_get_thread_num()];
+            SEQAN_OMP_PRAGMA(for schedule(static))
+            for (size_t j = 0; j < reads.size(); ++j) {
+                unique_read_kmers(reads[j], kmers);
+                for (PackedKmer kmer : kmers) {
+                    occurrences[local_offsets[kmer >> shift]++] = { kmer, ReadIndex(j) };
+                }
+            }
+        }
+        counts.clear();
+
+        // Sort buckets and count distinct k-mers in each of them
+        std::vector<size_t> distinct(nbuckets + 1);
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 64))
+        for (size_t b = 0; b < nbuckets; ++b) {
+            auto first = occurrences.begin() + bucket_offsets[b];
+            auto last = occurrences.begin() + bucket_offsets[b + 1];
+            std::stable_sort(first, last,
+                             [](const KmerOccurrence &a, const KmerOccurrence &b) { return a.kmer < b.kmer; });
+            size_t num = 0;
+            for (auto it = first; it != last; ++it) {
+                num += (it == first || (it - 1)->kmer != it->kmer);
+            }
+            distinct[b] = num;
+        }
+
+        size_t num_keys = 0;
+        for (size_t b = 0; b < nbuckets; ++b) {
+            size_t num = distinct[b];
+            distinct[b] = num_keys;
+            num_keys += num;
+        }
+
+        keys_.resize(num_keys);
+        offsets_.resize(num_keys + 1);
+        postings_.resize(total);
+        offsets_[num_keys] = total;
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 64))
+        for (size_t b = 0; b < nbuckets; ++b) {
+            size_t key = distinct[b];
+            for (size_t i = bucket_offsets[b]; i < bucket_offsets[b + 1]; ++i) {
+                if (i == bucket_offsets[b] || occurrences[i - 1].kmer != occurrences[i].kmer) {
+                    keys_[key] = occurrences[i].kmer;
+                    offsets_[key] = i;
+                    ++key;
+                }
+                postings_[i] = occurrences[i].read;
+            }
+        }
+    }
+
+public:
+    KmerIndex() : K_(0), offsets_(1) { }
+
+    template<typename T>
+    KmerIndex(const std::vector<T> &reads, size_t K) : K_(K) {
+        VERIFY(K > 0 && K <= MAX_PACKED_KMER_SIZE);
+        Initialize(reads);
+    }
+
+    size_t K() const { return K_; }
+
+    // Number of distinct k-mers
+    size_t size() const { return keys_.size(); }
+
+    size_t num_postings() const { return postings_.size(); }
+
+    Postings find(PackedKmer kmer) const {
+        if (kmer == INVALID_KMER) {
+            return Postings();
+        }
+        auto it = std::lower_bound(keys_.cbegin(), keys_.cend(), kmer);
+        if (it == keys_.cend() || *it != kmer) {
+            return Postings();
+        }
+        size_t i = it - keys_.cbegin();
+        return Postings(postings_.data() + offsets_[i], postings_.data() + offsets_[i + 1]);
+    }
+};
+
+// vim: ts=4:sw=4
@@ -0,0 +1,275 @@
+// Distance engine over bit-packed Dna5 reads
+// It computes the same distance as -half_sw_banded(s1, s2, 0, -1, -1, tail, max_indels)
+// but optionally stops as soon as the distance is known to exceed a bound
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <seqan/sequence.h>
+#include <verify.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IGREC_PACKED_DISTANCE_X86 1
+#include <immintrin.h>
+#endif
+
+
+// Dna5 string stored as three bit planes of 64-base blocks:
+// bit i of lo/hi planes keeps two lower bits of ordValue(s[i]), bit i of n plane is set for N.
+// Two positions are equal iff all their plane bits are equal, that mimics Dna5 comparison
+class PackedDna5String {
+    size_t length_;
+    size_t num_blocks_;
+    // planar layout: [lo blocks][hi blocks][n blocks]
+    std::vector<uint64_t> planes_;
+
+public:
+    PackedDna5String() : length_(0), num_blocks_(0) { }
+
+    template<typename T>
+    explicit PackedDna5String(const T &s) {
+        length_ = seqan::length(s);
+        num_blocks_ = (length_ + 63) / 64;
+        planes_.assign(3 * num_blocks_, 0);
+        for (size_t i = 0; i < length_; ++i) {
+            uint64_t code = seqan::ordValue(seqan::Dna5(s[i]));
+            uint64_t bit = uint64_t(1) << (i % 64);
+            size_t block = i / 64;
+            if (code & 1) planes_[block] |= bit;
+            if (code & 2) planes_[num_blocks_ + block] |= bit;
+            if (code & 4) planes_[2 * num_blocks_ + block] |= bit;
+        }
+    }
+
+    size_t length() const { return length_; }
+
+    size_t num_blocks() const { return num_blocks_; }
+
+    const uint64_t* lo() const { return planes_.data(); }
+
+    const uint64_t* hi() const { return planes_.data() + num_blocks_; }
+
+    const uint64_t* n() const { return planes_.data() + 2 * num_blocks_; }
+
+    unsigned code(size_t i) const {
+        size_t block = i / 64, shift = i % 64;
+        return unsigned((lo()[block] >> shift) & 1) |
+               unsigned(((hi()[block] >> shift) & 1) << 1) |
+               unsigned(((n()[block] >> shift) & 1) << 2);
+    }
+
+    seqan::Dna5 operator[](size_t i) const {
+        return seqan::Dna5(code(i));
+    }
+};
+
+inline size_t length(const PackedDna5String &s) {
+    return s.length();
+}
+
+
+namespace packed_distance {
+    enum class HammingKernel { Scalar, Popcnt, AVX2 };
+
+    const size_t NO_BOUND = std::numeric_limits<size_t>::max();
+
+    inline uint64_t block_mismatches(const PackedDna5String &s1, const PackedDna5String &s2, size_t block) {
+        return (s1.lo()[block] ^ s2.lo()[block]) | (s1.hi()[block] ^ s2.hi()[block]) | (s1.n()[block] ^ s2.n()[block]);
+    }
+
+    inline uint64_t prefix_mask(size_t len, size_t block) {
+        size_t rest = len - 64 * block;
+        return (rest >= 64) ? ~uint64_t(0) : ((uint64_t(1) << rest) - 1);
+    }
+
+    // Portable fallback, popcount is computed without any special instructions
+    inline size_t hamming_scalar(const PackedDna5String &s1, const PackedDna5String &s2, size_t len, size_t bound) {
+        size_t res = 0;
+        for (size_t block = 0; 64 * block < len; ++block) {
+            uint64_t x = block_mismatches(s1, s2, block) & prefix_mask(len, block);
+            x = x - ((x >> 1) & 0x5555555555555555ULL);
+            x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+            x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            res += size_t((x * 0x0101010101010101ULL) >> 56);
+            if (res > bound) {
+                break;
+            }
+        }
+        return res;
+    }
+
+#ifdef IGREC_PACKED_DISTANCE_X86
+    __attribute__((target("popcnt")))
+    inline size_t hamming_popcnt(const PackedDna5String &s1, const PackedDna5String &s2, size_t len, size_t bound) {
+        size_t res = 0;
+        for (size_t block = 0; 64 * block < len; ++block) {
+            res += size_t(__builtin_popcountll(block_mismatches(s1, s2, block) & prefix_mask(len, block)));
+            if (res > bound) {
+                break;
+            }
+        }
+        return res;
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    inline size_t hamming_avx2(const PackedDna5String &s1, const PackedDna5String &s2, size_t len, size_t bound) {
+        size_t full_blocks = len / 64;
+        size_t res = 0;
+        size_t block = 0;
+        for (; block + 4 <= full_blocks; block += 4) {
+            __m256i lo1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1.lo() + block));
+            __m256i lo2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2.lo() + block));
+            __m256i hi1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1.hi() + block));
+            __m256i hi2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2.hi() + block));
+            __m256i n1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1.n() + block));
+            __m256i n2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2.n() + block));
+            __m256i x = _mm256_or_si256(_mm256_or_si256(_mm256_xor_si256(lo1, lo2), _mm256_xor_si256(hi1, hi2)),
+                                        _mm256_xor_si256(n1, n2));
+            alignas(32) uint64_t words[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(words), x);
+            res += size_t(__builtin_popcountll(words[0]) + __builtin_popcountll(words[1]) +
+                          __builtin_popcountll(words[2]) + __builtin_popcountll(words[3]));
+            if (res > bound) {
+                return res;
+            }
+        }
+        for (; 64 * block < len; ++block) {
+            res += size_t(__builtin_popcountll(block_mismatches(s1, s2, block) & prefix_mask(len, block)));
+            if (res > bound) {
+                break;
+            }
+        }
+        return res;
+    }
+#endif
+
+    inline HammingKernel best_hamming_kernel() {
+#ifdef IGREC_PACKED_DISTANCE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+            return HammingKernel::AVX2;
+        }
+        if (__builtin_cpu_supports("popcnt")) {
+            return HammingKernel::Popcnt;
+        }
+#endif
+        return HammingKernel::Scalar;
+    }
+
+    // Number of mismatches between prefixes of length len.
+    // If it exceeds bound, some value greater than bound is returned
+    inline size_t hamming(const PackedDna5String &s1, const PackedDna5String &s2, size_t len,
+                          size_t bound = NO_BOUND,
+                          HammingKernel kernel = best_hamming_kernel()) {
+        VERIFY(len <= s1.length() && len <= s2.length());
+#ifdef IGREC_PACKED_DISTANCE_X86
+        if (kernel == HammingKernel::AVX2) {
+            return hamming_avx2(s1, s2, len, bound);
+        }
+        if (kernel == HammingKernel::Popcnt) {
+            return hamming_popcnt(s1, s2, len, bound);
+        }
+#endif
+        return hamming_scalar(s1, s2, len, bound);
+    }
+
+    // Banded DP with the same recurrence as half_sw_banded but in terms of costs.
+    // Costs never decrease along the alignment path. A path from (0, 0) either crosses the current row
+    // or stops earlier at a tail cell (i1', len2), so the distance exceeds the bound only when
+    // both the row and all the tail cells of the rows above it exceed it
+    template<typename Tf>
+    size_t banded(const PackedDna5String &s1, const PackedDna5String &s2,
+                  const Tf &tail_cost, int max_indels, size_t bound) {
+        const int INF = 1005000;
+
+        int len1 = static_cast<int>(s1.length());
+        int len2 = static_cast<int>(s2.length());
+        size_t width = 2 * size_t(max_indels) + 1;
+
+        // Buffers are reused by all calls within a thread
+        static thread_local std::vector<int> base;
+        static thread_local std::vector<int> new_base;
+        base.assign(width, INF);
+        new_base.assign(width, INF);
+
+        for (auto i2 = std::max(0, len1 - max_indels); i2 <= std::min(len1 + max_indels, len2); ++i2) {
+            base[i2 + max_indels - len1] = tail_cost(len2 - i2);
+        }
+
+        // tail_min[k] is the minimal cost of tail cells (i1', len2) with tail_start <= i1' <= tail_start + k
+        static thread_local std::vector<int> tail_min;
+        int tail_start = std::max(0, len2 - max_indels);
+        int tail_end = std::min(len1 - 1, len2 + max_indels);
+        tail_min.clear();
+        if (bound != NO_BOUND) {
+            for (int i1 = tail_start; i1 <= tail_end; ++i1) {
+                int value = tail_cost(len1 - i1);
+                tail_min.push_back(tail_min.empty() ? value : std::min(tail_min.back(), value));
+            }
+        }
+
+        for (int i1 = len1 - 1; i1 >= 0; --i1) {
+            unsigned c1 = s1.code(i1);
+            int row_min = INF;
+            for (int i2 = i1 + max_indels; i2 >= i1 - max_indels; --i2) {
+                int inx = max_indels + i2 - i1;
+                int value;
+                if ((i2 < 0) || (i2 > len2)) {
+                    value = INF;
+                } else if (i2 == len2) {
+                    value = tail_cost(len1 - i1);
+                } else {
+                    int m = (c1 == s2.code(i2)) ? 0 : 1;
+
+                    if (inx == 0)
+                        value = std::min(m + base[inx], 1 + new_base[inx + 1]);
+                    else if (inx == 2 * max_indels)
+                        value = std::min(m + base[inx], 1 + base[inx - 1]);
+                    else
+                        value = std::min({ m + base[inx], 1 + base[inx - 1], 1 + new_base[inx + 1] });
+                }
+                new_base[inx] = value;
+                row_min = std::min(row_min, value);
+            }
+
+            std::swap(base, new_base);
+
+            if (bound != NO_BOUND && row_min > static_cast<int>(bound)) {
+                int last_tail = std::min(i1 - 1, tail_end);
+                if (last_tail < tail_start || tail_min[last_tail - tail_start] > static_cast<int>(bound)) {
+                    return bound + 1;
+                }
+            }
+        }
+
+        return static_cast<size_t>(std::min(INF, base[max_indels]));
+    }
+
+    // Distance equal to -half_sw_banded(s1, s2, 0, -1, -1, [](int l) { return -tail_cost(l); }, max_indels).
+    // tail_cost should be non-negative.
+    // If the distance exceeds bound, some value greater than bound is returned
+    template<typename Tf>
+    size_t half_distance(const PackedDna5String &s1, const PackedDna5String &s2,
+                         const Tf &tail_cost,
+                         int max_indels = 0,
+                         size_t bound = NO_BOUND) {
+        if (max_indels == 0) {
+            size_t len1 = s1.length(), len2 = s2.length();
+            size_t tail = static_cast<size_t>(tail_cost(std::abs(static_cast<int>(len1) - static_cast<int>(len2))));
+            if (bound != NO_BOUND && tail > bound) {
+                return bound + 1;
+            }
+            static const HammingKernel kernel = best_hamming_kernel();
+            size_t mismatch_bound = (bound == NO_BOUND) ? NO_BOUND : bound - tail;
+            return tail + hamming(s1, s2, std::min(len1, len2), mismatch_bound, kernel);
+        }
+
+        return banded(s1, s2, tail_cost, max_indels, bound);
+    }
+}
+
+// vim: ts=4:sw=4
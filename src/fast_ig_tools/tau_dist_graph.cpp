@@ -0,0 +1,50 @@
+#include "tau_dist_graph.hpp"
+#include "ig_matcher.hpp"
+#include "packed_distance.hpp"
+
+SparseGraphPtr tauDistSparseGraph(const std::vector<seqan::Dna5String> &input_reads,
+                                  const TauDistGraphParams &params) {
+    size_t discarded_reads;
+    unsigned strategy = choose_strategy(input_reads, params.k, params.tau, params.strategy, discarded_reads);
+    if (discarded_reads) {
+        TRACE(bformat("Discarded reads %d") % discarded_reads);
+    }
+
+    auto dist_fun = [&params](const PackedDna5String& s1, const PackedDna5String& s2) -> unsigned {
+        auto tail_cost = [&params](int l) -> int { return params.ignore_tails ? 0 : (bool)(l)*2 * params.tau; };
+        return static_cast<unsigned>(packed_distance::half_distance(s1, s2, tail_cost, params.max_indels, params.tau));
+    };
+
+    std::vector<PackedDna5String> packed_reads(input_reads.cbegin(), input_reads.cend());
+
+    // Naive strategy compares all pairs and does not use k-mer index
+    KmerIndex kmer2reads = (strategy != 0) ? kmerIndexConstruction(packed_reads, params.k) : KmerIndex();
+
+    size_t num_of_dist_computations;
+    auto dist_graph = tauDistGraph(packed_reads,
+                                   kmer2reads,
+                                   dist_fun,
+                                   params.tau, params.k,
+                                   strategy,
+                                   num_of_dist_computations);
+
+    // Adjacency lists are sorted, so edges (i, j) with i < j come consecutively as CrsMatrix needs
+    std::vector<GraphEdge> edges;
+    edges.reserve(numEdges(dist_graph));
+    for (size_t i = 0; i < dist_graph.size(); ++i) {
+        for (const auto &edge : dist_graph[i]) {
+            if (i < edge.first) {
+                edges.push_back(GraphEdge(i, edge.first, static_cast<size_t>(edge.second)));
+            }
+        }
+    }
+    return SparseGraphPtr(new SparseGraph(dist_graph.size(), edges));
+}
+
+SparseGraphPtr tauDistSparseGraph(const std::vector<std::string> &input_reads,
+                                  const TauDistGraphParams &params) {
+    std::vector<seqan::Dna5String> reads(input_reads.cbegin(), input_reads.cend());
+    return tauDistSparseGraph(reads, params);
+}
+
+// vim: ts=4:sw=4
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <seqan/sequence.h>
+#include "../graph_utils/sparse_graph.hpp"
+
+// Parameters of truncated distance graph, the same as options of ig_swgraph_construct
+struct TauDistGraphParams {
+    unsigned tau = 4;
+    unsigned k = 10;
+    unsigned strategy = 3;
+    unsigned max_indels = 0;
+    bool ignore_tails = true;
+};
+
+// In-memory analogue of ig_swgraph_construct: vertices are input reads (in the same order),
+// edges connect reads with distance at most tau and are weighted by the distance.
+// Can be called from a parallel region, nested loops just run in the calling thread
+SparseGraphPtr tauDistSparseGraph(const std::vector<seqan::Dna5String> &input_reads,
+                                  const TauDistGraphParams &params);
+
+SparseGraphPtr tauDistSparseGraph(const std::vector<std::string> &input_reads,
+                                  const TauDistGraphParams &params);
+
+// vim: ts=4:sw=4
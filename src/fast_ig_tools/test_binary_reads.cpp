@@ -0,0 +1,89 @@
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "binary_reads.hpp"
+#include "fast_ig_tools.hpp"
+#include "../graph_utils/graph_io.hpp"
+#include "../graph_utils/decomposition.hpp"
+
+using namespace ::testing;
+
+namespace {
+    // seqan strings are compared as std::strings, gtest can not print them
+    template<typename T>
+    std::string str(const T &s) {
+        seqan::CharString chars = s;
+        return seqan::toCString(chars);
+    }
+}
+
+TEST(BinaryReads, RoundTrip) {
+    // reads cross word boundaries of packed sequence and contain N
+    std::vector<seqan::CharString> ids = { "read_1___size___3", "empty", "read_3" };
+    std::vector<seqan::Dna5String> reads = { "ACGTNACGTACGTACGTACGTACGTACGTACGTAC", "", "NNTTGCAN" };
+    const std::string filename = "test_binary_reads.igb";
+
+    write_records(filename, ids, reads);
+    ASSERT_TRUE(io::binary::IsBinaryContainer(filename));
+
+    BinaryReadsView view(filename);
+    ASSERT_EQ(reads.size(), view.size());
+    for (size_t i = 0; i < reads.size(); ++i) {
+        EXPECT_EQ(str(reads[i]), str(view.Read(i)));
+        EXPECT_EQ(str(ids[i]), view.Id(i));
+    }
+    EXPECT_EQ(3u, view.Abundance(0));
+    EXPECT_EQ(1u, view.Abundance(2));
+
+    std::vector<seqan::CharString> read_ids;
+    std::vector<seqan::Dna5String> read_reads;
+    read_records(filename, read_ids, read_reads);
+    ASSERT_EQ(reads.size(), read_reads.size());
+    for (size_t i = 0; i < reads.size(); ++i) {
+        EXPECT_EQ(str(ids[i]), str(read_ids[i]));
+        EXPECT_EQ(str(reads[i]), str(read_reads[i]));
+    }
+    std::remove(filename.c_str());
+}
+
+TEST(BinaryGraph, MatchesMetisGraph) {
+    Graph graph = { { { 1, 2 }, { 3, 1 } }, { { 0, 2 } }, { }, { { 0, 1 } } };
+    std::vector<size_t> weights = { 5, 1, 2, 7 };
+    write_metis_graph(graph, weights, "test_binary_graph.graph");
+    write_metis_graph(graph, weights, "test_binary_graph.igb");
+
+    auto text_graph = GraphReader("test_binary_graph.graph").CreateGraph();
+    auto binary_graph = GraphReader("test_binary_graph.igb").CreateGraph();
+    EXPECT_EQ(text_graph->N(), binary_graph->N());
+    ASSERT_EQ(text_graph->NZ(), binary_graph->NZ());
+    EXPECT_EQ(text_graph->RowIndex(), binary_graph->RowIndex());
+    EXPECT_EQ(text_graph->Col(), binary_graph->Col());
+    for (size_t k = 0; k < text_graph->NZ(); ++k) {
+        EXPECT_EQ(text_graph->Dist(k), binary_graph->Dist(k));
+    }
+    EXPECT_EQ(text_graph->Weight(), binary_graph->Weight());
+    std::remove("test_binary_graph.graph");
+    std::remove("test_binary_graph.igb");
+}
+
+TEST(BinaryDecomposition, RoundTrip) {
+    Decomposition decomposition(4);
+    decomposition.SetClass(0, 1);
+    decomposition.SetClass(1, 0);
+    decomposition.SetClass(2, 1);
+    decomposition.SetClass(3, 2);
+    decomposition.SaveTo("test_binary_decomposition.igb");
+
+    Decomposition read_decomposition("test_binary_decomposition.igb");
+    ASSERT_EQ(decomposition.VertexNumber(), read_decomposition.VertexNumber());
+    for (size_t i = 0; i < decomposition.VertexNumber(); ++i) {
+        EXPECT_EQ(decomposition.GetVertexClass(i), read_decomposition.GetVertexClass(i));
+    }
+    EXPECT_EQ(decomposition.Size(), read_decomposition.Size());
+    std::remove("test_binary_decomposition.igb");
+}
+
+// vim: ts=4:sw=4
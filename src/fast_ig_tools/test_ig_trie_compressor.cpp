@@ -1,5 +1,7 @@
 #include <gmock/gmock.h>
 
+#include <random>
+
 #include "ig_trie_compressor.hpp"
 
 using fast_ig_tools::Compressor;
@@ -48,3 +50,35 @@ TEST(basic_tests, hashmap_test) {
     EXPECT_THAT(indices, ElementsAre(0, 1, 0, 3, 4, 5, 4, 7, 1));
     EXPECT_THAT(comp_reads, ElementsAre("AAA", "AAAA", "", "XXX", "sdadasdasd", "X"));
 }
+
+TEST(basic_tests, parallel_trie_compressor_test) {
+    std::vector<std::string> reads = {"AAA", "AAAA", "AAAC", "XX", "XXAA", "sdadasdasd", "XX", ""};
+
+    auto indices = Compressor::compressed_reads_indices(reads, Compressor::Type::ParallelTrieCompressor);
+    EXPECT_THAT(indices, ElementsAre(7, 7, 7, 7, 7, 7, 7, 7));
+
+    reads.pop_back();
+    indices = Compressor::compressed_reads_indices(reads, Compressor::Type::ParallelTrieCompressor);
+    EXPECT_THAT(indices, ElementsAre(0, 0, 0, 3, 3, 5, 3));
+}
+
+TEST(basic_tests, parallel_trie_compressor_is_equal_to_trie_compressor) {
+    // Short reads over small alphabet produce a lot of prefixes and duplicates
+    std::mt19937 gen(17);
+    const std::string nucls = "ACGTN";
+    std::vector<seqan::Dna5String> reads;
+    for (size_t i = 0; i < 20000; ++i) {
+        std::string read;
+        size_t len = gen() % 12;
+        for (size_t j = 0; j < len; ++j) {
+            read.push_back(nucls[gen() % (j < 3 ? 2 : nucls.size())]);
+        }
+        reads.push_back(read);
+    }
+
+    for (size_t num_reads : { size_t(0), size_t(1), size_t(100), reads.size() }) {
+        std::vector<seqan::Dna5String> subset(reads.cbegin(), reads.cbegin() + num_reads);
+        EXPECT_EQ(Compressor::compressed_reads_indices(subset, Compressor::Type::TrieCompressor),
+                  Compressor::compressed_reads_indices(subset, Compressor::Type::ParallelTrieCompressor));
+    }
+}
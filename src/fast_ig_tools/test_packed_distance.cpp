@@ -0,0 +1,134 @@
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <seqan/sequence.h>
+#include "banded_half_smith_waterman.hpp"
+#include "packed_distance.hpp"
+
+using seqan::Dna5String;
+using namespace ::testing;
+
+namespace {
+    std::vector<Dna5String> random_reads(size_t count, unsigned seed) {
+        std::mt19937 gen(seed);
+        std::vector<Dna5String> reads;
+        Dna5String base;
+        for (size_t i = 0; i < 300; ++i) {
+            seqan::appendValue(base, seqan::Dna5(unsigned(gen() % 4)));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            // Reads are mutated copies of a common base, so distances are small enough to be interesting
+            Dna5String read;
+            size_t len = 150 + gen() % 150;
+            for (size_t j = 0; j < len; ++j) {
+                unsigned event = unsigned(gen() % 100);
+                if (event < 2) {
+                    continue;  // deletion
+                } else if (event < 4) {
+                    seqan::appendValue(read, seqan::Dna5(unsigned(gen() % 5)));  // insertion
+                } else if (event < 8) {
+                    seqan::appendValue(read, seqan::Dna5(unsigned(gen() % 5)));  // substitution
+                    continue;
+                }
+                seqan::appendValue(read, base[j]);
+            }
+            reads.push_back(read);
+        }
+        return reads;
+    }
+
+    int reference_distance(const Dna5String &s1, const Dna5String &s2, int max_indels, int tail_penalty) {
+        auto lizard_tail = [tail_penalty](int l) -> int { return l ? -tail_penalty : 0; };
+        return -half_sw_banded(s1, s2, 0, -1, -1, lizard_tail, max_indels);
+    }
+}
+
+TEST(packed_distance_tests, packing_keeps_sequence) {
+    Dna5String read = "ACGTNNACGTTTGCAN";
+    PackedDna5String packed(read);
+
+    ASSERT_EQ(length(packed), length(read));
+    for (size_t i = 0; i < length(read); ++i) {
+        EXPECT_EQ(seqan::ordValue(packed[i]), seqan::ordValue(read[i]));
+    }
+}
+
+TEST(packed_distance_tests, hamming_kernels_agree_with_half_hamming) {
+    auto reads = random_reads(60, 1);
+    std::vector<packed_distance::HammingKernel> kernels = { packed_distance::HammingKernel::Scalar };
+    if (packed_distance::best_hamming_kernel() != packed_distance::HammingKernel::Scalar) {
+        kernels.push_back(packed_distance::HammingKernel::Popcnt);
+    }
+    if (packed_distance::best_hamming_kernel() == packed_distance::HammingKernel::AVX2) {
+        kernels.push_back(packed_distance::HammingKernel::AVX2);
+    }
+
+    for (size_t i = 0; i < reads.size(); ++i) {
+        for (size_t j = 0; j < reads.size(); ++j) {
+            PackedDna5String p1(reads[i]), p2(reads[j]);
+            size_t len = std::min(length(reads[i]), length(reads[j]));
+            size_t expected = static_cast<size_t>(reference_distance(reads[i], reads[j], 0, 0));
+            for (auto kernel : kernels) {
+                EXPECT_EQ(packed_distance::hamming(p1, p2, len, packed_distance::NO_BOUND, kernel), expected);
+                size_t bounded = packed_distance::hamming(p1, p2, len, 4, kernel);
+                EXPECT_EQ(std::min<size_t>(bounded, 5), std::min<size_t>(expected, 5));
+            }
+        }
+    }
+}
+
+TEST(packed_distance_tests, half_distance_agrees_with_half_sw_banded) {
+    auto reads = random_reads(40, 2);
+
+    for (int max_indels : { 0, 1, 2, 4 }) {
+        for (int tail_penalty : { 0, 8 }) {
+            auto tail_cost = [tail_penalty](int l) -> int { return l ? tail_penalty : 0; };
+            for (size_t i = 0; i < reads.size(); ++i) {
+                for (size_t j = 0; j < reads.size(); ++j) {
+                    PackedDna5String p1(reads[i]), p2(reads[j]);
+                    size_t expected = static_cast<size_t>(reference_distance(reads[i], reads[j],
+                                                                             max_indels, tail_penalty));
+                    EXPECT_EQ(packed_distance::half_distance(p1, p2, tail_cost, max_indels), expected);
+
+                    for (size_t tau : { 0, 3, 10 }) {
+                        size_t bounded = packed_distance::half_distance(p1, p2, tail_cost, max_indels, tau);
+                        if (expected <= tau) {
+                            EXPECT_EQ(bounded, expected);
+                        } else {
+                            EXPECT_GT(bounded, tau);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(packed_distance_tests, bounded_distance_reaches_tails_of_long_first_read) {
+    // len1 > len2 + max_indels: rows below len2 + max_indels are out of the band,
+    // but the path may stop at a free tail cell before reaching them
+    Dna5String s2 = "ACGTTGCAACGTAGCTAGCTTACGGATCCA";
+    Dna5String s1 = s2;
+    seqan::append(s1, Dna5String("GGGGGGGG"));
+    Dna5String s1_with_n = s1;
+    s1_with_n[3] = 'N';
+    auto free_tail = [](int) -> int { return 0; };
+    for (int max_indels : { 1, 2, 4 }) {
+        for (const auto &first : { s1, s1_with_n }) {
+            PackedDna5String p1(first), p2(s2);
+            size_t expected = static_cast<size_t>(reference_distance(first, s2, max_indels, 0));
+            EXPECT_EQ(packed_distance::half_distance(p1, p2, free_tail, max_indels), expected);
+            for (size_t tau : { 0, 1, 3 }) {
+                size_t bounded = packed_distance::half_distance(p1, p2, free_tail, max_indels, tau);
+                if (expected <= tau) {
+                    EXPECT_EQ(bounded, expected);
+                } else {
+                    EXPECT_GT(bounded, tau);
+                }
+            }
+        }
+    }
+}
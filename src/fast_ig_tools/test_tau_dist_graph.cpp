@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tau_dist_graph.hpp"
+
+using namespace ::testing;
+
+namespace {
+    // Point mutants of several random CDR3-like sequences of equal length
+    std::vector<std::string> random_cdr3s(size_t count, unsigned seed) {
+        const std::string nucls = "ACGT";
+        std::mt19937 gen(seed);
+        std::vector<std::string> bases(5);
+        for (auto &base : bases) {
+            for (size_t i = 0; i < 45; ++i) {
+                base.push_back(nucls[gen() % 4]);
+            }
+        }
+        std::vector<std::string> cdr3s;
+        for (size_t i = 0; i < count; ++i) {
+            std::string cdr3 = bases[gen() % bases.size()];
+            size_t num_mutations = gen() % 4;
+            for (size_t j = 0; j < num_mutations; ++j) {
+                cdr3[gen() % cdr3.size()] = nucls[gen() % 4];
+            }
+            cdr3s.push_back(cdr3);
+        }
+        return cdr3s;
+    }
+
+    size_t hamming(const std::string &s1, const std::string &s2) {
+        size_t res = 0;
+        for (size_t i = 0; i < s1.size(); ++i) {
+            res += s1[i] != s2[i];
+        }
+        return res;
+    }
+
+    void check_graph(const std::vector<std::string> &cdr3s, const SparseGraph &graph, size_t tau) {
+        ASSERT_EQ(graph.N(), cdr3s.size());
+        size_t num_edges = 0;
+        for (size_t i = 0; i < cdr3s.size(); ++i) {
+            for (size_t j = i + 1; j < cdr3s.size(); ++j) {
+                size_t dist = hamming(cdr3s[i], cdr3s[j]);
+                EXPECT_EQ(graph.HasEdge(i, j), dist <= tau) << i << " " << j;
+                num_edges += dist <= tau;
+            }
+        }
+        EXPECT_EQ(graph.NZ(), num_edges);
+        for (size_t i = 0; i < graph.N(); ++i) {
+            for (size_t k = graph.RowIndex()[i]; k < graph.RowIndex()[i + 1]; ++k) {
+                EXPECT_EQ(graph.Dist(k), hamming(cdr3s[i], cdr3s[graph.Col()[k]]));
+            }
+        }
+    }
+}
+
+TEST(tau_dist_graph_tests, naive_strategy_finds_all_edges) {
+    auto cdr3s = random_cdr3s(200, 1);
+    TauDistGraphParams params;
+    params.tau = 3;
+    params.strategy = 0;
+    params.ignore_tails = false;
+    check_graph(cdr3s, *tauDistSparseGraph(cdr3s, params), params.tau);
+}
+
+TEST(tau_dist_graph_tests, kmer_strategy_finds_all_edges) {
+    auto cdr3s = random_cdr3s(200, 2);
+    TauDistGraphParams params;
+    params.tau = 2;
+    params.k = 7;
+    params.strategy = 3;
+    params.ignore_tails = false;
+    check_graph(cdr3s, *tauDistSparseGraph(cdr3s, params), params.tau);
+}
+
+TEST(tau_dist_graph_tests, empty_input) {
+    TauDistGraphParams params;
+    auto graph = tauDistSparseGraph(std::vector<std::string>(), params);
+    EXPECT_EQ(graph->N(), 0u);
+    EXPECT_EQ(graph->NZ(), 0u);
+}
+
+TEST(tau_dist_graph_tests, kmer_strategy_finds_all_edges_of_reads_with_n) {
+    auto cdr3s = random_cdr3s(200, 3);
+    std::mt19937 gen(3);
+    for (size_t i = 0; i < cdr3s.size(); i += 3) {
+        cdr3s[i][gen() % cdr3s[i].size()] = 'N';
+    }
+    // every window of such reads contains N
+    for (size_t i = 1; i < cdr3s.size(); i += 50) {
+        for (size_t pos = 6; pos < cdr3s[i].size(); pos += 7) {
+            cdr3s[i][pos] = 'N';
+        }
+    }
+    TauDistGraphParams params;
+    params.tau = 2;
+    params.k = 7;
+    params.strategy = 3;
+    params.ignore_tails = false;
+    check_graph(cdr3s, *tauDistSparseGraph(cdr3s, params), params.tau);
+}
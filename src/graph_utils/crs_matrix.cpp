@@ -1,56 +1,106 @@
+#include <algorithm>
+#include <numeric>
 #include <verify.hpp>
 #include "crs_matrix.hpp"
 
-// valid only for consecutive filling of structure
-void CrsMatrix::AddEdge(size_t v1, size_t v2, size_t dist) {
-    VERIFY(v1 < v2);
-    dist_.push_back(dist);
-    col_.push_back(v2);
-    row_index_[v1]++;
+void CrsMatrix::Initialize(const std::vector<GraphEdge> &edges) {
+    VERIFY_MSG(N_ <= MAX_CRS_COLUMN, "Number of vertices " << N_ << " is too large");
+    NZ_ = edges.size();
+    row_index_.assign(N_ + 1, 0);
+    col_.resize(NZ_);
+    CrsWideDist max_dist = 0;
+#pragma omp parallel for schedule(static) reduction(max: max_dist)
+    for(size_t k = 0; k < edges.size(); k++)
+        max_dist = std::max(max_dist, edges[k].dist);
+    if(max_dist > MAX_CRS_DIST)
+        wide_dist_.resize(NZ_);
+    else
+        dist_.resize(NZ_);
+    bool edges_are_consecutive = true;
+#pragma omp parallel for schedule(static) reduction(&&: edges_are_consecutive)
+    for(size_t k = 0; k < edges.size(); k++) {
+        VERIFY(edges[k].i < edges[k].j && edges[k].j < N_);
+        edges_are_consecutive = edges_are_consecutive && (k == 0 || edges[k - 1].i <= edges[k].i);
+        __sync_fetch_and_add(&row_index_[edges[k].i + 1], 1);
+        col_[k] = edges[k].j;
+        if(wide_dist_.empty())
+            dist_[k] = static_cast<CrsDist>(edges[k].dist);
+        else
+            wide_dist_[k] = edges[k].dist;
+    }
+    VERIFY_MSG(edges_are_consecutive, "Edges of CRS matrix should be sorted by rows");
+    std::partial_sum(row_index_.begin(), row_index_.end(), row_index_.begin());
 }
 
-void CrsMatrix::ComputeRowIndex() {
-    size_t num_next_elem = 0;
-    for(size_t i = 0; i < N_ + 1; i++) {
-        size_t tmp = row_index_[i];
-        row_index_[i] = num_next_elem;
-        num_next_elem += tmp;
-    }
+CrsMatrix::CrsMatrix(std::vector<size_t> row_index, std::vector<CrsColumn> col, std::vector<CrsDist> dist) :
+        N_(row_index.size() - 1),
+        NZ_(col.size()),
+        row_index_(std::move(row_index)),
+        col_(std::move(col)),
+        dist_(std::move(dist)) {
+    VERIFY(!row_index_.empty() && row_index_.back() == NZ_ && dist_.size() == NZ_);
+    VERIFY_MSG(N_ <= MAX_CRS_COLUMN, "Number of vertices " << N_ << " is too large");
 }
 
-void CrsMatrix::Initialize(const std::vector<GraphEdge> &edges) {
-    ComputeN_NZ(edges);
-    InitializeRowIndex();
-    for(auto it = edges.begin(); it != edges.end(); it++)
-        AddEdge(it->i, it->j, it->dist);
-    ComputeRowIndex();
+CrsMatrix::CrsMatrix(std::vector<size_t> row_index, std::vector<CrsColumn> col, std::vector<CrsWideDist> dist) :
+        N_(row_index.size() - 1),
+        NZ_(col.size()),
+        row_index_(std::move(row_index)),
+        col_(std::move(col)),
+        wide_dist_(std::move(dist)) {
+    VERIFY(!row_index_.empty() && row_index_.back() == NZ_ && wide_dist_.size() == NZ_);
+    VERIFY_MSG(N_ <= MAX_CRS_COLUMN, "Number of vertices " << N_ << " is too large");
 }
 
 // NOTE: input matrix is transposed
+// counting sort of entries by columns; rows of the result are sorted by columns
+// (and by weights for multiple edges), as they would be after sequential filling
 void CrsMatrix::Initialize(const CrsMatrix &trans_matrix) {
     N_ = trans_matrix.N();
     NZ_ = trans_matrix.NZ();
-    std::vector<std::vector<size_t> > trans_nz_col;
-    std::vector<std::vector<size_t> > trans_nz_val;
-    for(size_t i = 0; i < trans_matrix.N(); i++) {
-        trans_nz_col.push_back(std::vector<size_t>());
-        trans_nz_val.push_back(std::vector<size_t>());
-    }
-    for(size_t i = 0; i < trans_matrix.N(); i++)
-        for(size_t j = trans_matrix.RowIndex()[i]; j < trans_matrix.RowIndex()[i + 1]; j++) {
-            size_t row = i;
-            size_t col = trans_matrix.Col()[j];
-            size_t value = trans_matrix.Dist()[j];
-            trans_nz_col[col].push_back(row);
-            trans_nz_val[col].push_back(value);
+    const std::vector<CrsColumn> &trans_col = trans_matrix.Col();
+    row_index_.assign(N_ + 1, 0);
+#pragma omp parallel for schedule(static)
+    for(size_t j = 0; j < NZ_; j++)
+        __sync_fetch_and_add(&row_index_[trans_col[j] + 1], 1);
+    std::partial_sum(row_index_.begin(), row_index_.end(), row_index_.begin());
+
+    col_.resize(NZ_);
+    if(trans_matrix.WideDist())
+        InitializeTransposedEntries(trans_matrix, trans_matrix.wide_dist_, wide_dist_);
+    else
+        InitializeTransposedEntries(trans_matrix, trans_matrix.dist_, dist_);
+}
+
+template<typename DistType>
+void CrsMatrix::InitializeTransposedEntries(const CrsMatrix &trans_matrix, const std::vector<DistType> &trans_dist,
+                                            std::vector<DistType> &dist) {
+    const std::vector<size_t> &trans_row_index = trans_matrix.RowIndex();
+    const std::vector<CrsColumn> &trans_col = trans_matrix.Col();
+    dist.resize(NZ_);
+    std::vector<size_t> next_position(row_index_.begin(), row_index_.end() - 1);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t i = 0; i < N_; i++)
+        for(size_t j = trans_row_index[i]; j < trans_row_index[i + 1]; j++) {
+            size_t position = __sync_fetch_and_add(&next_position[trans_col[j]], 1);
+            col_[position] = static_cast<CrsColumn>(i);
+            dist[position] = trans_dist[j];
         }
-    row_index_.push_back(0);
-    for(size_t i = 0; i < trans_nz_col.size(); i++) {
-        for(size_t j = 0; j < trans_nz_col[i].size(); j++) {
-            col_.push_back(trans_nz_col[i][j]);
-            dist_.push_back(trans_nz_val[i][j]);
+
+#pragma omp parallel
+    {
+        std::vector<std::pair<CrsColumn, DistType>> row_entries;
+#pragma omp for schedule(dynamic, 1024)
+        for(size_t i = 0; i < N_; i++) {
+            row_entries.clear();
+            for(size_t j = row_index_[i]; j < row_index_[i + 1]; j++)
+                row_entries.push_back(std::make_pair(col_[j], dist[j]));
+            std::sort(row_entries.begin(), row_entries.end());
+            for(size_t j = row_index_[i]; j < row_index_[i + 1]; j++) {
+                col_[j] = row_entries[j - row_index_[i]].first;
+                dist[j] = row_entries[j - row_index_[i]].second;
+            }
         }
-        row_index_.push_back(row_index_[row_index_.size() - 1] + trans_nz_col[i].size());
     }
 }
 
@@ -60,10 +110,10 @@ std::ostream& operator<<(std::ostream &out, const CrsMatrix &matrix) {
     for(auto it = matrix.Col().begin(); it != matrix.Col().end(); it++)
         out << *it << " ";
     out << std::endl << "Values: ";
-    for(auto it = matrix.Dist().begin(); it != matrix.Dist().end(); it++)
-        out << *it << " ";
+    for(size_t k = 0; k < matrix.NZ(); k++)
+        out << matrix.Dist(k) << " ";
     out << std::endl << "Row indices: ";
     for(auto it = matrix.RowIndex().begin(); it != matrix.RowIndex().end(); it++)
         out << *it << " ";
     return out;
-}
\ No newline at end of file
+}
@@ -1,8 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
+#include <verify.hpp>
+
+// column indices & edge weights are narrow: graphs contain less than 2^32 vertices and
+// edge weights are usually distances bounded by small tau
+// matrix keeps its weights in CrsWideDist only if some of them do not fit in CrsDist
+typedef uint32_t CrsColumn;
+typedef uint8_t CrsDist;
+typedef uint32_t CrsWideDist;
+
+const size_t MAX_CRS_COLUMN = static_cast<size_t>(CrsColumn(-1));
+const size_t MAX_CRS_DIST = static_cast<size_t>(CrsDist(-1));
+const size_t MAX_CRS_WIDE_DIST = static_cast<size_t>(CrsWideDist(-1));
+
 /*
     struct Edge characterizes edge of graph
     contains fields:
@@ -10,18 +25,22 @@
         dist - edge weight
  */
 struct GraphEdge {
-    size_t i;
-    size_t j;
-    size_t dist;
+    CrsColumn i;
+    CrsColumn j;
+    CrsWideDist dist;
 
     GraphEdge(size_t i, size_t j, size_t dist):
-            i(i),
-            j(j),
-            dist(dist) { }
+            i(static_cast<CrsColumn>(i)),
+            j(static_cast<CrsColumn>(j)),
+            dist(static_cast<CrsWideDist>(dist)) {
+        VERIFY_MSG(i <= MAX_CRS_COLUMN && j <= MAX_CRS_COLUMN, "Vertex index " << std::max(i, j) << " is too large");
+        VERIFY_MSG(dist <= MAX_CRS_WIDE_DIST, "Edge weight " << dist << " exceeds " << MAX_CRS_WIDE_DIST);
+    }
 };
 
 /*
     class CRS_Matrix for storage of sparse symmetric matrix in compressed rows format
+    matrices are built by counting sort in parallel without per-row allocations
  */
 class CrsMatrix {
     size_t N_;
@@ -29,27 +48,11 @@ class CrsMatrix {
 
     // rows and columns
     std::vector<size_t> row_index_;
-    std::vector<size_t> col_;
-
-    // weights
-    std::vector<size_t> dist_;
-
-    // isolated vertices
-    std::vector<size_t> isolated_vertices_;
-
-    void InitializeRowIndex() {
-        for(size_t i = 0; i < N_+ 1; i++)
-            row_index_.push_back(0);
-    }
+    std::vector<CrsColumn> col_;
 
-    // valid only for consecutive filling of structure
-    void AddEdge(size_t v1, size_t v2, size_t dist);
-
-    void ComputeRowIndex();
-
-    void ComputeN_NZ(const std::vector<GraphEdge> &edges) {
-        NZ_ = edges.size();
-    }
+    // weights, only one of the vectors is filled
+    std::vector<CrsDist> dist_;
+    std::vector<CrsWideDist> wide_dist_;
 
     // edges are consecutive
     void Initialize(const std::vector<GraphEdge> &edges);
@@ -57,6 +60,10 @@ class CrsMatrix {
     // NOTE: input matrix is transposed
     void Initialize(const CrsMatrix &trans_matrix);
 
+    template<typename DistType>
+    void InitializeTransposedEntries(const CrsMatrix &trans_matrix, const std::vector<DistType> &trans_dist,
+                                     std::vector<DistType> &dist);
+
 public:
     CrsMatrix(const CrsMatrix &trans_matrix) :
             N_(0), NZ_(0) {
@@ -68,11 +75,18 @@ public:
         Initialize(edges);
     }
 
-    const std::vector<size_t>& Dist() const { return dist_; }
+    // all entries should be above diagonal
+    CrsMatrix(std::vector<size_t> row_index, std::vector<CrsColumn> col, std::vector<CrsDist> dist);
+
+    CrsMatrix(std::vector<size_t> row_index, std::vector<CrsColumn> col, std::vector<CrsWideDist> dist);
+
+    size_t Dist(size_t k) const { return wide_dist_.empty() ? dist_[k] : wide_dist_[k]; }
+
+    bool WideDist() const { return !wide_dist_.empty(); }
 
     const std::vector<size_t>& RowIndex() const  { return row_index_; }
 
-    const std::vector<size_t>& Col() const { return col_; }
+    const std::vector<CrsColumn>& Col() const { return col_; }
 
     size_t N() const { return N_; }
 
@@ -85,4 +99,4 @@ public:
 
 std::ostream& operator<<(std::ostream &out, const CrsMatrix &matrix);
 
-typedef std::shared_ptr<CrsMatrix> CrsMatrixPtr;
\ No newline at end of file
+typedef std::shared_ptr<CrsMatrix> CrsMatrixPtr;
@@ -1,10 +1,17 @@
 #include "decomposition.hpp"
 #include "../ig_tools/utils/string_tools.hpp"
+#include <io/binary_container.hpp>
 
-Decomposition::Decomposition(std::string decomposition_filename) {
-    std::ifstream in(decomposition_filename);
-    VERIFY(in.good());
-    std::vector <size_t> classes_list = ReadClassIdsFromIfstream(in);
+Decomposition::Decomposition(std::string decomposition_filename) :
+        class_index_is_valid_(false) {
+    std::vector <size_t> classes_list;
+    if(io::binary::IsBinaryContainer(decomposition_filename))
+        classes_list = ReadClassIdsFromBinaryContainer(decomposition_filename);
+    else {
+        std::ifstream in(decomposition_filename);
+        VERIFY(in.good());
+        classes_list = ReadClassIdsFromIfstream(in);
+    }
     TRACE("Decomposition of size " << classes_list.size() << " was extracted from " << decomposition_filename);
     num_vertices_ = classes_list.size();
     InitializeVertexClasses();
@@ -14,8 +21,20 @@ Decomposition::Decomposition(std::string decomposition_filename) {
 
 void Decomposition::InitializeVertexClasses() {
     num_classes_ = 0;
-    for(size_t i = 0; i < num_vertices_; i++)
-        vertex_class_.push_back(size_t(-1));
+    vertex_class_.assign(num_vertices_, size_t(-1));
+}
+
+// counting sort of vertices by classes keeps vertices of each class sorted
+void Decomposition::UpdateClassIndex() const {
+    class_offsets_.assign(Size() + 1, 0);
+    for(size_t i = 0; i < Size(); i++)
+        class_offsets_[i + 1] = class_offsets_[i] + class_sizes_[i];
+    class_vertices_.resize(class_offsets_.back());
+    std::vector<size_t> next_position(class_offsets_.begin(), class_offsets_.end() - 1);
+    for(size_t i = 0; i < vertex_class_.size(); i++)
+        if(ClassIsValid(vertex_class_[i]))
+            class_vertices_[next_position[vertex_class_[i]]++] = i;
+    class_index_is_valid_ = true;
 }
 
 std::vector<size_t> Decomposition::ReadClassIdsFromIfstream(std::ifstream &in) {
@@ -30,9 +49,14 @@ std::vector<size_t> Decomposition::ReadClassIdsFromIfstream(std::ifstream &in) {
     return classes_list;
 }
 
+std::vector<size_t> Decomposition::ReadClassIdsFromBinaryContainer(std::string decomposition_filename) {
+    io::binary::ContainerReader reader(decomposition_filename, io::binary::ContainerType::Decomposition);
+    VERIFY_MSG(reader.NumSections() == 1, "Binary decomposition container should contain 1 section");
+    return reader.CopySection<size_t>(0);
+}
+
 void Decomposition::AddNewClass() {
-    std::set<size_t> new_class;
-    decomposition_classes_.push_back(new_class);
+    class_sizes_.push_back(0);
     num_classes_++;
 }
 
@@ -40,29 +64,34 @@ void Decomposition::RemoveVertex(size_t vertex) {
     size_t vertex_class = vertex_class_[vertex];
     if(!ClassIsValid(vertex_class))
         return;
-    decomposition_classes_[vertex_class].erase(vertex);
+    class_sizes_[vertex_class]--;
 }
 
 void Decomposition::SetClass(size_t vertex, size_t class_id) {
     VERIFY(vertex < num_vertices_);
+    VERIFY(ClassIsValid(class_id));
     RemoveVertex(vertex);
-    if(decomposition_classes_.size() == 0 or class_id > decomposition_classes_.size() - 1)
-        for(size_t i = decomposition_classes_.size(); i <= class_id; i++)
-            AddNewClass();
-    decomposition_classes_[class_id].insert(vertex);
+    for(size_t i = class_sizes_.size(); i <= class_id; i++)
+        AddNewClass();
+    class_sizes_[class_id]++;
     vertex_class_[vertex] = class_id;
+    class_index_is_valid_ = false;
 }
 
 void Decomposition::AddDecomposition(std::shared_ptr<Decomposition> decomposition) {
     size_t last_class_id = LastClassId();
-    for(size_t i = 0; i < decomposition->Size(); i++) {
-        std::set<size_t> cur_class = decomposition->GetClass(i);
-        for(auto it = cur_class.begin(); it != cur_class.end(); it++)
-            SetClass(*it, last_class_id + i);
-    }
+    for(size_t i = 0; i < decomposition->VertexNumber(); i++)
+        if(decomposition->VertexClassIsInitialized(i))
+            SetClass(i, last_class_id + decomposition->GetVertexClass(i));
 };
 
 void Decomposition::SaveTo(std::string output_fname) {
+    if(io::binary::HasBinaryExtension(output_fname)) {
+        io::binary::ContainerWriter writer(io::binary::ContainerType::Decomposition);
+        writer.AddSection(vertex_class_);
+        writer.Write(output_fname);
+        return;
+    }
     std::ofstream out(output_fname.c_str());
     for(auto it = vertex_class_.begin(); it != vertex_class_.end(); it++)
         out << *it << std::endl;
@@ -71,8 +100,8 @@ void Decomposition::SaveTo(std::string output_fname) {
 
 size_t Decomposition::MaxClassSize() {
     size_t max_class = 0;
-    for(auto it = decomposition_classes_.begin(); it != decomposition_classes_.end(); it++)
-        max_class = std::max<size_t>(max_class, it->size());
+    for(auto it = class_sizes_.begin(); it != class_sizes_.end(); it++)
+        max_class = std::max<size_t>(max_class, *it);
     return max_class;
 }
 
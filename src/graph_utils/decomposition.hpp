@@ -1,32 +1,75 @@
 #pragma once
 
+#include <algorithm>
 #include <logger/logger.hpp>
 #include "graph_collapsed_structure.hpp"
 
+// sorted vertices of a decomposition class, a view into the flat class index of Decomposition
+class DecompositionClass {
+    const size_t *begin_;
+    const size_t *end_;
+
+public:
+    DecompositionClass(const size_t *begin, const size_t *end) :
+            begin_(begin),
+            end_(end) { }
+
+    typedef const size_t* const_iterator;
+
+    const_iterator begin() const { return begin_; }
+
+    const_iterator end() const { return end_; }
+
+    size_t size() const { return end_ - begin_; }
+
+    bool empty() const { return begin_ == end_; }
+
+    const_iterator find(size_t vertex) const {
+        const_iterator it = std::lower_bound(begin_, end_, vertex);
+        return it != end_ and *it == vertex ? it : end_;
+    }
+};
+
+/*
+    vertex -> class is stored in flat vector, sizes of classes are updated on the fly,
+    vertices of classes are collected in CRS-like index on the first query of class after modifications
+ */
 class Decomposition {
     // input params
     size_t num_vertices_;
 
     // decomposition fields
     std::vector<size_t> vertex_class_;
-    std::vector<std::set<size_t> > decomposition_classes_;
+    std::vector<size_t> class_sizes_;
+
+    // class index: vertices of class i are class_vertices_[class_offsets_[i]..class_offsets_[i + 1])
+    mutable std::vector<size_t> class_offsets_;
+    mutable std::vector<size_t> class_vertices_;
+    mutable bool class_index_is_valid_;
 
     // number of all classes: real and removed
     size_t num_classes_;
 
     void InitializeVertexClasses();
 
+    void UpdateClassIndex() const;
+
     std::vector<size_t> ReadClassIdsFromIfstream(std::ifstream &in);
 
+    // binary decomposition container (io::binary::ContainerType::Decomposition) keeps
+    // the only section with class ids of vertices
+    std::vector<size_t> ReadClassIdsFromBinaryContainer(std::string decomposition_filename);
+
     void AddNewClass();
 
-    bool ClassIsValid(size_t class_id) { return class_id != size_t(-1); }
+    bool ClassIsValid(size_t class_id) const { return class_id != size_t(-1); }
 
     void RemoveVertex(size_t vertex);
 
 public:
     Decomposition(size_t num_vertices) :
-            num_vertices_(num_vertices) {
+            num_vertices_(num_vertices),
+            class_index_is_valid_(false) {
         InitializeVertexClasses();
     }
 
@@ -36,16 +79,23 @@ public:
 
     void AddDecomposition(std::shared_ptr<Decomposition> decomposition);
 
-    const std::set<size_t>& GetClass(size_t index) const {
+    // class view is invalidated by the next modification of decomposition
+    DecompositionClass GetClass(size_t index) const {
         VERIFY(index < Size());
-        return decomposition_classes_[index];
+        if(!class_index_is_valid_)
+            UpdateClassIndex();
+        return DecompositionClass(class_vertices_.data() + class_offsets_[index],
+                                  class_vertices_.data() + class_offsets_[index + 1]);
     }
 
-    const std::set<size_t>& LastClass() const { return GetClass(Size() - 1); }
+    DecompositionClass LastClass() const { return GetClass(Size() - 1); }
 
-    size_t ClassSize(size_t index) const { return GetClass(index).size(); }
+    size_t ClassSize(size_t index) const {
+        VERIFY(index < Size());
+        return class_sizes_[index];
+    }
 
-    size_t LastClassSize() const { return LastClass().size(); }
+    size_t LastClassSize() const { return ClassSize(Size() - 1); }
 
     size_t LastClassId() const { return Size() - 1; }
 
@@ -56,16 +106,17 @@ public:
         return vertex_class_[vertex];
     }
 
-    bool VertexClassIsInitialized(size_t vertex) {
+    bool VertexClassIsInitialized(size_t vertex) const {
         return ClassIsValid(GetVertexClass(vertex));
     }
 
-    size_t Size() const { return decomposition_classes_.size(); }
+    size_t Size() const { return class_sizes_.size(); }
 
+    // decomposition is written in binary format if filename has extension io::binary::BINARY_EXTENSION
     void SaveTo(std::string output_fname);
 
     bool LastClassContains(size_t vertex) const {
-        return LastClass().find(vertex) != LastClass().end();
+        return Size() != 0 and GetVertexClass(vertex) == LastClassId();
     }
 
     size_t MaxClassSize();
@@ -78,8 +129,6 @@ private:
     DECL_LOGGER("Decomposition");
 };
 
-typedef std::set<size_t> DecompositionClass;
-
 std::ostream& operator<<(std::ostream &out, const Decomposition &hg_decomposition);
 
 typedef std::shared_ptr<Decomposition> DecompositionPtr;
@@ -9,7 +9,7 @@ void GraphCollapsedStructure::InitializeMainVerticesMap() {
 
     for(size_t i = 0; i < hamming_graph_ptr_->N(); i++)
         for(size_t j = hamming_graph_ptr_->RowIndex()[i]; j < hamming_graph_ptr_->RowIndex()[i + 1];j++)
-            if(hamming_graph_ptr_->Dist()[j] == 0)
+            if(hamming_graph_ptr_->Dist(j) == 0)
                 main_vertices_tree[hamming_graph_ptr_->Col()[j]] = i;
 
     for(size_t i = 0; i < main_vertices_tree.size(); i++) {
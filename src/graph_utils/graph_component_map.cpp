@@ -1,39 +1,85 @@
+#include <algorithm>
 #include <verify.hpp>
 #include "graph_component_map.hpp"
 
-void GraphComponentMap::AddComponentInMap(size_t subgraph_id, const std::set<size_t> &old_vertices_set) {
-    VERIFY(component_map_.find(subgraph_id) == component_map_.end());
-    std::map<size_t, size_t> cur_component_map;
+namespace {
+    const size_t NO_ID = size_t(-1);
+}
+
+void GraphComponentMap::AddComponentInMap(size_t subgraph_id, const std::vector<size_t> &old_vertices) {
+    if(subgraph_id >= subgraph_index_.size())
+        subgraph_index_.resize(subgraph_id + 1, NO_ID);
+    VERIFY(subgraph_index_[subgraph_id] == NO_ID);
+    subgraph_index_[subgraph_id] = component_offsets_.size() - 1;
+    if(!old_vertices.empty() and old_vertices.back() >= old_vertex_to_subgraph_.size()) {
+        old_vertex_to_subgraph_.resize(old_vertices.back() + 1, NO_ID);
+        old_vertex_to_new_vertex_.resize(old_vertices.back() + 1, NO_ID);
+    }
     size_t new_vertex_id = 0;
-    for(auto it = old_vertices_set.begin(); it != old_vertices_set.end(); it++) {
-        cur_component_map[new_vertex_id] = *it;
+    for(auto it = old_vertices.begin(); it != old_vertices.end(); it++) {
+        VERIFY(*it < old_vertex_to_subgraph_.size());
+        component_vertices_.push_back(*it);
         old_vertex_to_new_vertex_[*it] = new_vertex_id;
         old_vertex_to_subgraph_[*it] = subgraph_id;
         new_vertex_id++;
     }
-    component_map_[subgraph_id] = cur_component_map;
+    component_offsets_.push_back(component_vertices_.size());
+    subgraph_ids_.clear();
+    old_vertices_list_.clear();
+}
+
+void GraphComponentMap::AddComponentsInMap(std::vector<size_t> component_offsets,
+                                           std::vector<size_t> component_vertices) {
+    VERIFY(subgraph_index_.empty());
+    VERIFY(!component_offsets.empty() and component_offsets.back() == component_vertices.size());
+    size_t num_components = component_offsets.size() - 1;
+    subgraph_index_.resize(num_components);
+    for(size_t i = 0; i < num_components; i++)
+        subgraph_index_[i] = i;
+    component_offsets_ = std::move(component_offsets);
+    component_vertices_ = std::move(component_vertices);
+    size_t num_old_vertices = 0;
+    if(!component_vertices_.empty())
+        num_old_vertices = *std::max_element(component_vertices_.begin(), component_vertices_.end()) + 1;
+    old_vertex_to_subgraph_.assign(num_old_vertices, NO_ID);
+    old_vertex_to_new_vertex_.assign(num_old_vertices, NO_ID);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t i = 0; i < num_components; i++)
+        for(size_t j = component_offsets_[i]; j < component_offsets_[i + 1]; j++) {
+            old_vertex_to_subgraph_[component_vertices_[j]] = i;
+            old_vertex_to_new_vertex_[component_vertices_[j]] = j - component_offsets_[i];
+        }
+    subgraph_ids_.clear();
+    old_vertices_list_.clear();
 }
 
-size_t GraphComponentMap::GetSubgraphIdByOldVertex(size_t old_vertex) {
-    VERIFY(old_vertex_to_subgraph_.find(old_vertex) != old_vertex_to_subgraph_.end());
+size_t GraphComponentMap::SubgraphSize(size_t subgraph_id) const {
+    VERIFY(subgraph_id < subgraph_index_.size() and subgraph_index_[subgraph_id] != NO_ID);
+    size_t index = subgraph_index_[subgraph_id];
+    return component_offsets_[index + 1] - component_offsets_[index];
+}
+
+size_t GraphComponentMap::GetSubgraphIdByOldVertex(size_t old_vertex) const {
+    VERIFY(old_vertex < old_vertex_to_subgraph_.size() and old_vertex_to_subgraph_[old_vertex] != NO_ID);
     return old_vertex_to_subgraph_[old_vertex];
 }
 
-size_t GraphComponentMap::GetNewVertexByOldVertex(size_t old_vertex) {
-    VERIFY(old_vertex_to_new_vertex_.find(old_vertex) != old_vertex_to_new_vertex_.end());
+size_t GraphComponentMap::GetNewVertexByOldVertex(size_t old_vertex) const {
+    VERIFY(old_vertex < old_vertex_to_new_vertex_.size() and old_vertex_to_new_vertex_[old_vertex] != NO_ID);
     return old_vertex_to_new_vertex_[old_vertex];
 }
 
 void GraphComponentMap::InitializeSubgraphIds() {
-    for(auto it = component_map_.begin(); it != component_map_.end(); it++)
-        subgraph_ids_.push_back(it->first);
+    for(size_t i = 0; i < subgraph_index_.size(); i++)
+        if(subgraph_index_[i] != NO_ID)
+            subgraph_ids_.push_back(i);
 }
 
-size_t GraphComponentMap::GetOldVertexByNewVertex(size_t subgraph_id, size_t new_vertex) {
-    VERIFY(component_map_.find(subgraph_id) != component_map_.end());
-    std::map<size_t, size_t> &cur_component_map = component_map_[subgraph_id];
-    VERIFY(cur_component_map.find(new_vertex) != cur_component_map.end());
-    return cur_component_map[new_vertex];
+size_t GraphComponentMap::GetOldVertexByNewVertex(size_t subgraph_id, size_t new_vertex) const {
+    VERIFY(subgraph_id < subgraph_index_.size() and subgraph_index_[subgraph_id] != NO_ID);
+    size_t index = subgraph_index_[subgraph_id];
+    VERIFY(new_vertex < component_offsets_[index + 1] - component_offsets_[index]);
+    return component_vertices_[component_offsets_[index] + new_vertex];
 }
 
 const std::vector<size_t>& GraphComponentMap::SubgraphIds() {
@@ -43,10 +89,11 @@ const std::vector<size_t>& GraphComponentMap::SubgraphIds() {
 }
 
 void GraphComponentMap::InitializeOldVerticesList() {
-    for(auto it = old_vertex_to_subgraph_.begin(); it != old_vertex_to_subgraph_.end(); it++) {
-        VERIFY(old_vertex_to_new_vertex_.find(it->first) != old_vertex_to_new_vertex_.end());
-        old_vertices_list_.push_back(it->first);
-    }
+    for(size_t i = 0; i < old_vertex_to_subgraph_.size(); i++)
+        if(old_vertex_to_subgraph_[i] != NO_ID) {
+            VERIFY(old_vertex_to_new_vertex_[i] != NO_ID);
+            old_vertices_list_.push_back(i);
+        }
 }
 
 const std::vector<size_t>& GraphComponentMap::OldVerticesList() {
@@ -62,4 +109,4 @@ std::ostream& operator<<(std::ostream &out, GraphComponentMap& component_map) {
                 component_map.GetNewVertexByOldVertex(*it) << std::endl;
     }
     return out;
-}
\ No newline at end of file
+}
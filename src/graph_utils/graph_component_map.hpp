@@ -1,14 +1,20 @@
 #pragma once
 
-#include <map>
 #include <vector>
-#include <set>
 #include <memory>
 
+/*
+    map between vertices of graph (old vertices) and vertices of its subgraphs (new vertices)
+    all arrays are flat and indexed by ids of old vertices or subgraphs,
+    vertices of all subgraphs are stored in CRS-like manner in the order of adding subgraphs
+ */
 class GraphComponentMap {
-    std::map<size_t, size_t> old_vertex_to_subgraph_;
-    std::map<size_t, size_t> old_vertex_to_new_vertex_;
-    std::map<size_t, std::map<size_t, size_t>> component_map_;
+    std::vector<size_t> old_vertex_to_subgraph_;
+    std::vector<size_t> old_vertex_to_new_vertex_;
+    // position of subgraph in component_offsets_
+    std::vector<size_t> subgraph_index_;
+    std::vector<size_t> component_offsets_;
+    std::vector<size_t> component_vertices_;
     std::vector<size_t> subgraph_ids_;
     std::vector<size_t> old_vertices_list_;
 
@@ -17,15 +23,26 @@ class GraphComponentMap {
     void InitializeOldVerticesList();
 
 public:
-    GraphComponentMap() { }
+    GraphComponentMap() : component_offsets_(1, 0) { }
 
-    void AddComponentInMap(size_t subgraph_id, const std::set<size_t> &old_vertices_set);
+    // old vertices should be sorted
+    void AddComponentInMap(size_t subgraph_id, const std::vector<size_t> &old_vertices);
 
-    size_t GetSubgraphIdByOldVertex(size_t old_vertex);
+    // adds components 0, 1, ... at once: sorted old vertices of component i are
+    // component_vertices[component_offsets[i]..component_offsets[i + 1]), map should be empty
+    void AddComponentsInMap(std::vector<size_t> component_offsets, std::vector<size_t> component_vertices);
 
-    size_t GetNewVertexByOldVertex(size_t old_vertex);
+    size_t SubgraphSize(size_t subgraph_id) const;
 
-    size_t GetOldVertexByNewVertex(size_t subgraph_id, size_t new_vertex);
+    bool OldVertexBelongsToSubgraph(size_t old_vertex, size_t subgraph_id) const {
+        return old_vertex < old_vertex_to_subgraph_.size() && old_vertex_to_subgraph_[old_vertex] == subgraph_id;
+    }
+
+    size_t GetSubgraphIdByOldVertex(size_t old_vertex) const;
+
+    size_t GetNewVertexByOldVertex(size_t old_vertex) const;
+
+    size_t GetOldVertexByNewVertex(size_t subgraph_id, size_t new_vertex) const;
 
     const std::vector<size_t>& SubgraphIds();
 
@@ -34,4 +51,4 @@ public:
 
 std::ostream& operator<<(std::ostream &out, GraphComponentMap& component_map);
 
-typedef std::shared_ptr<GraphComponentMap> GraphComponentMapPtr;
\ No newline at end of file
+typedef std::shared_ptr<GraphComponentMap> GraphComponentMapPtr;
@@ -1,194 +1,276 @@
+#include <cstring>
+#include <numeric>
 #include <verify.hpp>
+#include <io/binary_container.hpp>
+#include <io/mmapped_reader.hpp>
 #include "graph_io.hpp"
 #include "../ig_tools/utils/string_tools.hpp"
 
-std::vector<std::string> SplitGraphString(std::string str) {
-    std::vector<std::string> final_splits;
-    std::vector<std::string> splits = split(str, ' ');
-    for(auto it = splits.begin(); it != splits.end(); it++) {
-        std::vector<std::string> cur_splits = split(*it, '\t');
-        for(auto it2 = cur_splits.begin(); it2 != cur_splits.end(); it2++)
-            final_splits.push_back(*it2);
+namespace {
+    bool IsBlank(char c) {
+        return c == ' ' or c == '\t' or c == '\r';
+    }
+
+    const char* LineEnd(const char *pos, const char *end) {
+        const char *line_end = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        return line_end == NULL ? end : line_end;
+    }
+
+    // reads the next unsigned number of line, returns false at the end of line
+    bool NextNumber(const char *&pos, const char *line_end, size_t &value) {
+        while(pos != line_end and IsBlank(*pos))
+            pos++;
+        if(pos == line_end)
+            return false;
+        VERIFY_MSG(*pos >= '0' and *pos <= '9', "Unexpected symbol '" << *pos << "' in graph file");
+        value = 0;
+        while(pos != line_end and *pos >= '0' and *pos <= '9') {
+            value = value * 10 + static_cast<size_t>(*pos - '0');
+            pos++;
+        }
+        VERIFY_MSG(pos == line_end or IsBlank(*pos), "Unexpected symbol '" << *pos << "' in graph file");
+        return true;
+    }
+
+    bool LineIsEmpty(const char *pos, const char *line_end) {
+        while(pos != line_end and IsBlank(*pos))
+            pos++;
+        return pos == line_end;
     }
-    return final_splits;
 }
 
 /*
- * class EdgeWeightedGraphReader
- *      takes as an input file stream starting from the first line of the adjacency list
- *      creates list of weighted edges
- *      returns graph
+ * class MetisGraphReader
+ *      maps graph file in METIS format and parses adjacency lists in parallel without copying:
+ *      file is split into chunks at line boundaries, the first pass over chunks counts edges
+ *      of upper triangle and the second one fills CRS arrays of direct matrix
+ *      supports unweighted, edge weighted (001) and edge & vertex weighted (011) graphs
  */
-class EdgeWeightedGraphReader {
-    std::vector<GraphEdge> graph_edges;
-
-    void UpdateGraphEdges(size_t cur_vertex, const std::vector<std::string> &line_splits) {
-        if(line_splits.size() % 2 != 0) {
-            WARN("Line for vertex " << cur_vertex << " contains odd number of elements (" << line_splits.size() << "):");
-            for(auto it = line_splits.begin(); it != line_splits.end(); it++)
-                std::cout << *it << " ";
-            std::cout << std::endl;
-            VERIFY(line_splits.size() % 2 == 0);
+class MetisGraphReader {
+    enum class Format { Unweighted, EdgeWeighted, EdgeVertexWeighted };
+
+    static const size_t CHUNK_SIZE = 1 << 22;
+
+    Format format_;
+    size_t num_vertices_;
+    // chunks of adjacency lists and indices of their first vertices
+    std::vector<const char*> chunk_starts_;
+    std::vector<size_t> chunk_first_vertices_;
+
+    void ReadHeader(const char *&pos, const char *end) {
+        const char *line_end = LineEnd(pos, end);
+        std::vector<std::string> splits;
+        while(!LineIsEmpty(pos, line_end)) {
+            while(IsBlank(*pos))
+                pos++;
+            const char *token_end = pos;
+            while(token_end != line_end and !IsBlank(*token_end))
+                token_end++;
+            splits.push_back(std::string(pos, token_end));
+            pos = token_end;
+        }
+        pos = line_end == end ? end : line_end + 1;
+        VERIFY_MSG(splits.size() > 0, "Header of graph file is empty");
+        num_vertices_ = string_to_number<size_t>(splits[0]);
+        VERIFY_MSG(num_vertices_ <= MAX_CRS_COLUMN, "Number of vertices " << num_vertices_ << " is too large");
+        if(splits.size() == 2) {
+            TRACE("Unweighted graph reader was chosen");
+            format_ = Format::Unweighted;
+        }
+        else if(splits.size() == 3 and splits[2] == "001") {
+            TRACE("Edge weighted graph reader was chosen");
+            format_ = Format::EdgeWeighted;
         }
-        for(size_t i = 0; i < line_splits.size(); i += 2) {
-            size_t dst_vertex = string_to_number<size_t>(line_splits[i]) - 1;
-            size_t edge_weight = string_to_number<size_t>(line_splits[i + 1]);
-            if(cur_vertex < dst_vertex)
-                graph_edges.push_back(GraphEdge(cur_vertex, dst_vertex, edge_weight));
+        else if(splits.size() == 3 and splits[2] == "011") {
+            TRACE("Edge & vertex graph reader was chosen");
+            format_ = Format::EdgeVertexWeighted;
         }
+        else
+            VERIFY_MSG(false, "Unknown format of graph file!");
     }
 
-public:
-    EdgeWeightedGraphReader() { }
-
-    SparseGraphPtr ReadGraph(size_t num_vertices, std::ifstream &graph_stream) {
-        size_t cur_vertex = 0;
-        while(!graph_stream.eof()) {
-            std::string tmp_line;
-            getline(graph_stream, tmp_line);
-            std::vector<std::string> splits = SplitGraphString(tmp_line);
-            if (splits.size() == 0) {
-                cur_vertex++;
-                continue;
-            }
-            UpdateGraphEdges(cur_vertex, splits);
-            cur_vertex++;
-        }
-        return SparseGraphPtr(new SparseGraph(num_vertices, graph_edges));
+    // empty lines of vertex weighted graphs are skipped, in other formats they stand for isolated vertices
+    bool LineIsVertex(const char *pos, const char *line_end) const {
+        return format_ != Format::EdgeVertexWeighted or !LineIsEmpty(pos, line_end);
     }
-};
 
-/*
- * class EdgeVertexWeightedGraphReader
- *      takes as an input file stream starting from the first line of the adjacency list
- *      creates list of weighted edges and weighted vertices
- *      returns graph
- */
-class EdgeVertexWeightedGraphReader {
-    std::vector<GraphEdge> graph_edges;
-
-    void UpdateGraphEdges(size_t cur_vertex, const std::vector<std::string> &line_splits) {
-        if(line_splits.size() % 2 == 0) {
-            WARN("Line for vertex " << cur_vertex << " contains even number of elements (" << line_splits.size() << "):");
-            for(auto it = line_splits.begin(); it != line_splits.end(); it++)
-                std::cout << *it << " ";
-            std::cout << std::endl;
-            VERIFY(line_splits.size() % 2 != 0);
+    void SplitIntoChunks(const char *begin, const char *end) {
+        size_t num_chunks = std::max<size_t>(1, (end - begin) / CHUNK_SIZE);
+        chunk_starts_.push_back(begin);
+        for(size_t i = 1; i < num_chunks; i++) {
+            const char *chunk_start = std::max(begin + (end - begin) * i / num_chunks, chunk_starts_.back());
+            chunk_start = LineEnd(chunk_start, end);
+            chunk_starts_.push_back(chunk_start == end ? end : chunk_start + 1);
         }
-        for(size_t i = 1; i < line_splits.size(); i += 2) {
-            size_t dst_vertex = string_to_number<size_t>(line_splits[i]) - 1;
-            size_t edge_weight = string_to_number<size_t>(line_splits[i + 1]);
-            if(cur_vertex < dst_vertex)
-                graph_edges.push_back(GraphEdge(cur_vertex, dst_vertex, edge_weight));
+        chunk_starts_.push_back(end);
+
+        chunk_first_vertices_.assign(chunk_starts_.size(), 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t i = 0; i < num_chunks; i++) {
+            size_t num_lines = 0;
+            for(const char *pos = chunk_starts_[i]; pos != chunk_starts_[i + 1]; ) {
+                const char *line_end = LineEnd(pos, chunk_starts_[i + 1]);
+                if(LineIsVertex(pos, line_end))
+                    num_lines++;
+                pos = line_end == chunk_starts_[i + 1] ? line_end : line_end + 1;
+            }
+            chunk_first_vertices_[i + 1] = num_lines;
         }
+        std::partial_sum(chunk_first_vertices_.begin(), chunk_first_vertices_.end(), chunk_first_vertices_.begin());
     }
 
-public:
-    EdgeVertexWeightedGraphReader() { }
-
-    SparseGraphPtr ReadGraph(size_t num_vertices, std::ifstream &graph_stream) {
-        size_t cur_vertex = 0;
-        auto weight = std::vector<size_t>(num_vertices, 1);
-        while(!graph_stream.eof()) {
-            std::string tmp_line;
-            getline(graph_stream, tmp_line);
-            std::vector<std::string> splits = SplitGraphString(tmp_line);
-            if (splits.size() == 0)
-                continue;
-            weight[cur_vertex] = string_to_number<size_t>(splits[0]);
-            UpdateGraphEdges(cur_vertex, splits);
-            cur_vertex++;
+    // calls process_edge(vertex, neighbour, weight) for edges of upper triangle
+    template<typename EdgeProcessor>
+    void ParseChunk(size_t chunk_index, std::vector<size_t> &weight, EdgeProcessor process_edge) const {
+        size_t vertex = chunk_first_vertices_[chunk_index];
+        const char *chunk_end = chunk_starts_[chunk_index + 1];
+        for(const char *pos = chunk_starts_[chunk_index]; pos != chunk_end; ) {
+            const char *line_end = LineEnd(pos, chunk_end);
+            bool line_is_vertex = LineIsVertex(pos, line_end);
+            if(line_is_vertex and !LineIsEmpty(pos, line_end)) {
+                VERIFY_MSG(vertex < num_vertices_, "Graph file contains more than " << num_vertices_ << " vertices");
+                size_t value;
+                if(format_ == Format::EdgeVertexWeighted) {
+                    NextNumber(pos, line_end, value);
+                    weight[vertex] = value;
+                }
+                size_t neighbour;
+                while(NextNumber(pos, line_end, neighbour)) {
+                    size_t edge_weight = 1;
+                    if(format_ != Format::Unweighted)
+                        VERIFY_MSG(NextNumber(pos, line_end, edge_weight),
+                                   "Line for vertex " << vertex << " contains odd number of neighbours & weights");
+                    VERIFY_MSG(neighbour >= 1 and neighbour <= num_vertices_,
+                               "Vertex " << vertex << " has invalid neighbour " << neighbour);
+                    if(vertex < neighbour - 1)
+                        process_edge(vertex, neighbour - 1, edge_weight);
+                }
+            }
+            if(line_is_vertex)
+                vertex++;
+            pos = line_end == chunk_end ? line_end : line_end + 1;
         }
-        return SparseGraphPtr(new SparseGraph(num_vertices, graph_edges, weight));
     }
-};
 
-/*
- * class UnweightedGraphReader
- *      takes as an input file stream starting from the first line of the adjacency list
- *      creates list of edges of weight 1
- *      returns graph
- */
-class UnweightedGraphReader {
-    std::vector<GraphEdge> graph_edges;
-
-    void UpdateGraphEdges(size_t cur_vertex, const std::vector<std::string> &line_splits) {
-        size_t num_edges = line_splits.size();
-        for(size_t i = 0; i < num_edges; i++) {
-            size_t dst_vertex = string_to_number<size_t>(line_splits[i]) - 1;
-            size_t edge_weight = 1;
-            if(cur_vertex < dst_vertex)
-                graph_edges.push_back(GraphEdge(cur_vertex, dst_vertex, edge_weight));
+    template<typename DistType>
+    CrsMatrixPtr ReadDirectMatrix(std::vector<size_t> row_index, std::vector<size_t> &weight) const {
+        size_t num_chunks = chunk_starts_.size() - 1;
+        std::vector<CrsColumn> col(row_index.back());
+        std::vector<DistType> dist(row_index.back());
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t i = 0; i < num_chunks; i++) {
+            size_t next_position = row_index[std::min(chunk_first_vertices_[i], num_vertices_)];
+            ParseChunk(i, weight, [&col, &dist, &next_position](size_t, size_t neighbour, size_t edge_weight) {
+                col[next_position] = static_cast<CrsColumn>(neighbour);
+                dist[next_position] = static_cast<DistType>(edge_weight);
+                next_position++;
+            });
         }
+        return std::make_shared<CrsMatrix>(std::move(row_index), std::move(col), std::move(dist));
     }
 
 public:
-    UnweightedGraphReader() { }
-
-    SparseGraphPtr ReadGraph(size_t num_vertices, std::ifstream &graph_stream) {
-        size_t cur_vertex = 0;
-        while(!graph_stream.eof()) {
-            std::string tmp_line;
-            getline(graph_stream, tmp_line);
-            std::vector<std::string> splits = SplitGraphString(tmp_line);
-            UpdateGraphEdges(cur_vertex, splits);
-            cur_vertex++;
-        }
-        return SparseGraphPtr(new SparseGraph(num_vertices, graph_edges));
-    }
-};
+    SparseGraphPtr ReadGraph(const std::string &graph_filename) {
+        MMappedReader reader(graph_filename, false, -1ULL);
+        const char *begin = static_cast<const char*>(reader.data());
+        VERIFY_MSG(begin != NULL, "Graph file " << graph_filename << " is empty");
+        const char *end = begin + reader.size();
+        const char *pos = begin;
+        ReadHeader(pos, end);
+        SplitIntoChunks(pos, end);
+        size_t num_chunks = chunk_starts_.size() - 1;
 
-/*
- *
- */
-class VersatileGraphReader {
-    bool GraphIsUnweighted(const std::vector<std::string> &header_splits) {
-        return header_splits.size() == 2;
-    }
+        std::vector<size_t> weight(num_vertices_, 1);
+        std::vector<size_t> row_index(num_vertices_ + 1, 0);
+        std::vector<size_t> max_edge_weights(num_chunks, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for(size_t i = 0; i < num_chunks; i++)
+            ParseChunk(i, weight, [&row_index, &max_edge_weights, i](size_t vertex, size_t, size_t edge_weight) {
+                row_index[vertex + 1]++;
+                max_edge_weights[i] = std::max(max_edge_weights[i], edge_weight);
+            });
+        std::partial_sum(row_index.begin(), row_index.end(), row_index.begin());
 
-    bool GraphIsEdgeWeighted(const std::vector <std::string> &header_splits) {
-        if(header_splits.size() != 3 || header_splits[2].length() != 3)
-            return false;
-        return header_splits[2] == "001";
+        size_t max_edge_weight = *std::max_element(max_edge_weights.begin(), max_edge_weights.end());
+        VERIFY_MSG(max_edge_weight <= MAX_CRS_WIDE_DIST, "Edge weight " << max_edge_weight << " exceeds " << MAX_CRS_WIDE_DIST);
+        CrsMatrixPtr direct_matrix = max_edge_weight <= MAX_CRS_DIST ?
+                                     ReadDirectMatrix<CrsDist>(std::move(row_index), weight) :
+                                     ReadDirectMatrix<CrsWideDist>(std::move(row_index), weight);
+        return SparseGraphPtr(new SparseGraph(direct_matrix, weight));
     }
 
-    bool GraphIsEdgeVertexWeighted(const std::vector <std::string> &header_splits) {
-        if(header_splits.size() != 3 || header_splits[2].length() != 3)
-            return false;
-        return header_splits[2] == "011";
-    }
+private:
+    DECL_LOGGER("MetisGraphReader");
+};
 
-    size_t GetNumVertices(const std::vector<std::string> &header_splits) {
-        VERIFY(header_splits.size() > 0);
-        return string_to_number<size_t>(header_splits[0]);
+/*
+ * class BinaryGraphReader
+ *      takes as an input binary graph container
+ *      creates list of edges directly from CRS arrays
+ *      returns graph
+ */
+class BinaryGraphReader {
+    template<typename DistType>
+    CrsMatrixPtr ReadDirectMatrix(size_t num_vertices, size_t num_edges, const uint64_t *row_index,
+                                  const uint64_t *col, const uint64_t *dist) const {
+        // CRS arrays are narrowed in place, without intermediate list of edges
+        std::vector<size_t> crs_row_index(row_index, row_index + num_vertices + 1);
+        std::vector<CrsColumn> crs_col(num_edges);
+        std::vector<DistType> crs_dist(num_edges);
+#pragma omp parallel for schedule(dynamic, 1024)
+        for(size_t i = 0; i < num_vertices; i++)
+            for(size_t j = row_index[i]; j < row_index[i + 1]; j++) {
+                VERIFY(i < col[j] && col[j] < num_vertices);
+                crs_col[j] = static_cast<CrsColumn>(col[j]);
+                crs_dist[j] = static_cast<DistType>(dist[j]);
+            }
+        return std::make_shared<CrsMatrix>(std::move(crs_row_index), std::move(crs_col), std::move(crs_dist));
     }
 
 public:
-    SparseGraphPtr ReadGraph(std::ifstream &graph_stream) {
-        std::string header_line;
-        getline(graph_stream, header_line);
-        std::vector<std::string> splits = SplitGraphString(header_line);
-        size_t num_vertices = GetNumVertices(splits);
-        if (GraphIsUnweighted(splits)) {
-            TRACE("Unweighted graph reader was chosen");
-            return UnweightedGraphReader().ReadGraph(num_vertices, graph_stream);
-        }
-        if (GraphIsEdgeWeighted(splits)) {
-            TRACE("Edge weighted graph reader was chosen");
-            return EdgeWeightedGraphReader().ReadGraph(num_vertices, graph_stream);
-        }
-        if (GraphIsEdgeVertexWeighted(splits)) {
-            TRACE("Edge & vertex graph reader was chosen");
-            return EdgeVertexWeightedGraphReader().ReadGraph(num_vertices, graph_stream);
-        }
-        VERIFY_MSG(false, "Unknown format of graph file!");
-        return SparseGraphPtr(NULL);
-    }
+    SparseGraphPtr ReadGraph(const std::string &graph_filename) {
+        io::binary::ContainerReader reader(graph_filename, io::binary::ContainerType::Graph);
+        VERIFY_MSG(reader.NumSections() == 5, "Binary graph container should contain 5 sections");
+        VERIFY(reader.SectionSize<uint64_t>(0) == 2);
+        const uint64_t *sizes = reader.Section<uint64_t>(0);
+        size_t num_vertices = static_cast<size_t>(sizes[0]);
+        size_t num_edges = static_cast<size_t>(sizes[1]);
+        VERIFY(reader.SectionSize<uint64_t>(1) == num_vertices + 1);
+        VERIFY(reader.SectionSize<uint64_t>(2) == num_edges);
+        VERIFY(reader.SectionSize<uint64_t>(3) == num_edges);
+        VERIFY(reader.SectionSize<uint64_t>(4) == num_vertices);
+        const uint64_t *row_index = reader.Section<uint64_t>(1);
+        const uint64_t *col = reader.Section<uint64_t>(2);
+        const uint64_t *dist = reader.Section<uint64_t>(3);
+        VERIFY(row_index[num_vertices] == num_edges);
 
-private:
-    DECL_LOGGER("VersatileGraphReader");
+        uint64_t max_edge_weight = num_edges == 0 ? 0 : *std::max_element(dist, dist + num_edges);
+        VERIFY_MSG(max_edge_weight <= MAX_CRS_WIDE_DIST, "Edge weight " << max_edge_weight << " exceeds " << MAX_CRS_WIDE_DIST);
+        CrsMatrixPtr direct_matrix = max_edge_weight <= MAX_CRS_DIST ?
+                ReadDirectMatrix<CrsDist>(num_vertices, num_edges, row_index, col, dist) :
+                ReadDirectMatrix<CrsWideDist>(num_vertices, num_edges, row_index, col, dist);
+        return SparseGraphPtr(new SparseGraph(direct_matrix, reader.CopySection<size_t>(4)));
+    }
 };
 
+void WriteBinaryGraph(const std::string &graph_filename,
+                      const std::vector<size_t> &row_index,
+                      const std::vector<size_t> &col,
+                      const std::vector<size_t> &dist,
+                      const std::vector<size_t> &weight) {
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "size_t is expected to be 64-bit");
+    VERIFY(row_index.size() == weight.size() + 1);
+    VERIFY(col.size() == dist.size() && row_index.back() == col.size());
+    std::vector<size_t> sizes = { weight.size(), col.size() };
+    io::binary::ContainerWriter writer(io::binary::ContainerType::Graph);
+    writer.AddSection(sizes);
+    writer.AddSection(row_index);
+    writer.AddSection(col);
+    writer.AddSection(dist);
+    writer.AddSection(weight);
+    writer.Write(graph_filename);
+}
+
 /*
  *
  */
@@ -199,7 +281,41 @@ SparseGraphPtr GraphReader::CreateGraph() {
         WARN("File " + this->graph_filename + " with graph was not found");
         return SparseGraphPtr(NULL);
     }
-    SparseGraphPtr graph_ptr = VersatileGraphReader().ReadGraph(graph_stream);
+    SparseGraphPtr graph_ptr;
+    if(io::binary::IsBinaryContainer(graph_filename)) {
+        TRACE("Binary graph reader was chosen");
+        graph_ptr = BinaryGraphReader().ReadGraph(graph_filename);
+    }
+    else
+        graph_ptr = MetisGraphReader().ReadGraph(graph_filename);
     TRACE("Extracted graph contains " << graph_ptr->N() << " vertices & " << graph_ptr->NZ() << " edges");
     return graph_ptr;
-}
\ No newline at end of file
+}
+
+void GraphWriter::PrintGraph(SparseGraphPtr graph_ptr) {
+    if(io::binary::HasBinaryExtension(graph_filename)) {
+        std::vector<size_t> dist(graph_ptr->NZ());
+        for(size_t j = 0; j < dist.size(); j++)
+            dist[j] = graph_ptr->Dist(j);
+        WriteBinaryGraph(graph_filename, graph_ptr->RowIndex(),
+                         std::vector<size_t>(graph_ptr->Col().cbegin(), graph_ptr->Col().cend()),
+                         dist, graph_ptr->Weight());
+        TRACE("Graph was written to " << graph_filename << " in binary format");
+        return;
+    }
+    std::ofstream out(graph_filename);
+    bool vertex_weighted = false;
+    for(auto it = graph_ptr->Weight().begin(); it != graph_ptr->Weight().end(); it++)
+        vertex_weighted = vertex_weighted or *it != 1;
+    out << graph_ptr->N() << " " << graph_ptr->NZ() << " " << (vertex_weighted ? "011" : "001") << "\n";
+    for(size_t i = 0; i < graph_ptr->N(); i++) {
+        if(vertex_weighted)
+            out << graph_ptr->WeightOfVertex(i) << " ";
+        for(size_t j = graph_ptr->RowIndexT()[i]; j < graph_ptr->RowIndexT()[i + 1]; j++)
+            out << graph_ptr->ColT()[j] + 1 << " " << graph_ptr->DistT(j) << " ";
+        for(size_t j = graph_ptr->RowIndex()[i]; j < graph_ptr->RowIndex()[i + 1]; j++)
+            out << graph_ptr->Col()[j] + 1 << " " << graph_ptr->Dist(j) << " ";
+        out << "\n";
+    }
+    TRACE("Graph was written to " << graph_filename);
+}
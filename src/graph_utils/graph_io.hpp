@@ -3,6 +3,20 @@
 #include <logger/logger.hpp>
 #include "sparse_graph.hpp"
 
+/*
+ * Binary graph container (io::binary::ContainerType::Graph) keeps upper triangle of adjacency matrix in CRS format:
+ *      section 0: N, NZ
+ *      section 1: row indices (N + 1 values)
+ *      section 2: columns (NZ values)
+ *      section 3: edge weights (NZ values)
+ *      section 4: vertex weights (N values)
+ */
+void WriteBinaryGraph(const std::string &graph_filename,
+                      const std::vector<size_t> &row_index,
+                      const std::vector<size_t> &col,
+                      const std::vector<size_t> &dist,
+                      const std::vector<size_t> &weight);
+
 class GraphReader {
     std::string graph_filename;
 
@@ -11,6 +25,7 @@ public:
         this->graph_filename = graph_filename;
     }
 
+    // graph file can be either in METIS format or binary container
     SparseGraphPtr CreateGraph();
 
 private:
@@ -25,8 +40,10 @@ public:
         this->graph_filename = graph_filename;
     }
 
+    // graph is written in binary format if filename has extension io::binary::BINARY_EXTENSION,
+    // otherwise METIS format is used
     void PrintGraph(SparseGraphPtr graph_ptr);
 
 private:
     DECL_LOGGER("GraphWriter");
-};
\ No newline at end of file
+};
@@ -1,65 +1,127 @@
-#include <queue>
+#include <algorithm>
+#include <numeric>
+#include <openmp_wrapper.h>
+#include <adt/concurrent_dsu.hpp>
 #include <logger/logger.hpp>
 #include "graph_splitter.hpp"
 
-void ConnectedComponentGraphSplitter::InitializeInnerVertices() {
-    for(size_t i = 0; i < graph_ptr_->N(); i++)
-        visited_vertices_.push_back(false);
+namespace {
+    void AtomicMin(size_t &value, size_t candidate) {
+        size_t current = value;
+        while(candidate < current) {
+            size_t previous = __sync_val_compare_and_swap(&value, current, candidate);
+            if(previous == current)
+                break;
+            current = previous;
+        }
+    }
 }
 
-size_t ConnectedComponentGraphSplitter::GetStartVertex() {
-    for(size_t i = next_start_vertex_; i < graph_ptr_->N(); i++)
-        if(!visited_vertices_[i]) {
-            next_start_vertex_ = i + 1;
-            return i;
-        }
-    return size_t(-1);
+std::vector<size_t> ConnectedComponentGraphSplitter::ComputeVertexRoots() const {
+    size_t num_vertices = graph_ptr_->N();
+    VERIFY_MSG(num_vertices <= size_t(uint32_t(-1)), "Graph is too large for concurrent DSU");
+    ConcurrentDSU dsu(num_vertices);
+    // each edge is stored in direct matrix, so transposed matrix is not needed
+    const std::vector<size_t> &row_index = graph_ptr_->RowIndex();
+    const std::vector<CrsColumn> &col = graph_ptr_->Col();
+#pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t i = 0; i < num_vertices; i++)
+        for(size_t j = row_index[i]; j < row_index[i + 1]; j++)
+            dsu.unite(static_cast<unsigned>(i), static_cast<unsigned>(col[j]));
+    std::vector<size_t> vertex_root(num_vertices);
+#pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < num_vertices; i++)
+        vertex_root[i] = dsu.find_set(static_cast<unsigned>(i));
+    return vertex_root;
 }
 
-SparseGraphPtr ConnectedComponentGraphSplitter::GetConnectedComponentByVertex(size_t component_id, size_t start_vertex) {
-    std::queue<size_t> vertex_queue;
-    vertex_queue.push(start_vertex);
-    std::set<size_t> connected_component;
-    // check if vertex is isolated
-    if(graph_ptr_->VertexIsIsolated(start_vertex)) {
-        connected_component.insert(start_vertex);
-        return graph_ptr_->GetSubgraph(component_id, connected_component);
-    }
-    // otherwise search for connected component
-    while(!vertex_queue.empty()) {
-        size_t cur_vertex = vertex_queue.front();
-        vertex_queue.pop();
-        connected_component.insert(cur_vertex);
-        visited_vertices_[cur_vertex] = true;
-        for(size_t i = graph_ptr_->RowIndex()[cur_vertex]; i < graph_ptr_->RowIndex()[cur_vertex + 1]; i++) {
-            size_t cur_neigh = graph_ptr_->Col()[i];
-            if(!visited_vertices_[cur_neigh]) {
-                vertex_queue.push(cur_neigh);
-                visited_vertices_[cur_neigh] = true;
-            }
-        }
-        for(size_t i = graph_ptr_->RowIndexT()[cur_vertex]; i < graph_ptr_->RowIndexT()[cur_vertex + 1]; i++) {
-            size_t cur_neigh = graph_ptr_->ColT()[i];
-            if(!visited_vertices_[cur_neigh]) {
-                vertex_queue.push(cur_neigh);
-                visited_vertices_[cur_neigh] = true;
-            }
-        }
+// component ids are ranks of minimal vertices of components
+size_t ConnectedComponentGraphSplitter::NumberComponents(const std::vector<size_t> &vertex_root,
+                                                         std::vector<size_t> &vertex_component) const {
+    size_t num_vertices = vertex_root.size();
+    std::vector<size_t> root_min_vertex(num_vertices, size_t(-1));
+#pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < num_vertices; i++)
+        AtomicMin(root_min_vertex[vertex_root[i]], i);
+
+    // exclusive prefix sums of minimal vertices over static thread chunks
+    vertex_component.assign(num_vertices, 0);
+    std::vector<size_t> chunk_offsets(omp_get_max_threads() + 1, 0);
+#pragma omp parallel
+    {
+        size_t num_threads = omp_get_num_threads();
+        size_t thread_id = omp_get_thread_num();
+        size_t begin = num_vertices * thread_id / num_threads;
+        size_t end = num_vertices * (thread_id + 1) / num_threads;
+        size_t num_min_vertices = 0;
+        for(size_t i = begin; i < end; i++)
+            if(root_min_vertex[vertex_root[i]] == i)
+                num_min_vertices++;
+        chunk_offsets[thread_id + 1] = num_min_vertices;
+#pragma omp barrier
+#pragma omp single
+        std::partial_sum(chunk_offsets.begin(), chunk_offsets.begin() + num_threads + 1, chunk_offsets.begin());
+        size_t next_component = chunk_offsets[thread_id];
+        for(size_t i = begin; i < end; i++)
+            if(root_min_vertex[vertex_root[i]] == i)
+                vertex_component[i] = next_component++;
+#pragma omp barrier
+#pragma omp for schedule(static)
+        for(size_t i = 0; i < num_vertices; i++)
+            vertex_component[i] = vertex_component[root_min_vertex[vertex_root[i]]];
     }
-    return graph_ptr_->GetSubgraph(component_id, connected_component);
+    size_t num_components = 0;
+    for(size_t i = 0; i < chunk_offsets.size(); i++)
+        num_components = std::max(num_components, chunk_offsets[i]);
+    return num_components;
+}
+
+// vertices inside buckets are sorted, as component map requires
+void ConnectedComponentGraphSplitter::BucketVertices(const std::vector<size_t> &vertex_component,
+                                                     size_t num_components,
+                                                     std::vector<size_t> &component_offsets,
+                                                     std::vector<size_t> &component_vertices) const {
+    size_t num_vertices = vertex_component.size();
+    component_offsets.assign(num_components + 1, 0);
+#pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < num_vertices; i++)
+        __sync_fetch_and_add(&component_offsets[vertex_component[i] + 1], 1);
+    std::partial_sum(component_offsets.begin(), component_offsets.end(), component_offsets.begin());
+    std::vector<size_t> next_position(component_offsets.begin(), component_offsets.end() - 1);
+    component_vertices.resize(num_vertices);
+#pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < num_vertices; i++)
+        component_vertices[__sync_fetch_and_add(&next_position[vertex_component[i]], 1)] = i;
+#pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t i = 0; i < num_components; i++)
+        std::sort(component_vertices.begin() + component_offsets[i],
+                  component_vertices.begin() + component_offsets[i + 1]);
 }
 
 std::vector<SparseGraphPtr> ConnectedComponentGraphSplitter::Split() {
-    InitializeInnerVertices();
-    TRACE("Connected component splitter was initialized");
-    std::vector<SparseGraphPtr> connected_components;
-    size_t start_vertex = GetStartVertex();
-    while(start_vertex != size_t(-1)) {
-        size_t component_id = connected_components.size();
-        SparseGraphPtr cur_connected_component = GetConnectedComponentByVertex(component_id, start_vertex);
-        connected_components.push_back(cur_connected_component);
-        start_vertex = GetStartVertex();
-    }
+    std::vector<size_t> vertex_component;
+    size_t num_components = NumberComponents(ComputeVertexRoots(), vertex_component);
+    TRACE("Connected component splitter found " << num_components << " component(s)");
+    std::vector<size_t> component_offsets;
+    std::vector<size_t> component_vertices;
+    BucketVertices(vertex_component, num_components, component_offsets, component_vertices);
+    vertex_component = std::vector<size_t>();
+
+    // largest components are extracted first to balance threads
+    std::vector<size_t> processing_order(num_components);
+    std::iota(processing_order.begin(), processing_order.end(), 0);
+    std::stable_sort(processing_order.begin(), processing_order.end(),
+                     [&component_offsets](size_t i, size_t j) {
+                         return component_offsets[i + 1] - component_offsets[i] >
+                                component_offsets[j + 1] - component_offsets[j];
+                     });
+    graph_ptr_->GetGraphComponentMap().AddComponentsInMap(std::move(component_offsets),
+                                                          std::move(component_vertices));
+    std::vector<SparseGraphPtr> connected_components(num_components);
+    const SparseGraph &graph = *graph_ptr_;
+#pragma omp parallel for schedule(dynamic, 1)
+    for(size_t i = 0; i < num_components; i++)
+        connected_components[processing_order[i]] = graph.ExtractSubgraph(processing_order[i]);
     TRACE("Graph was splitted into " << connected_components.size() << " connected component(s)");
     return connected_components;
-}
\ No newline at end of file
+}
@@ -2,24 +2,26 @@
 
 #include "sparse_graph.hpp"
 
+/*
+    splits graph into connected components in parallel:
+    edges are united in concurrent DSU, vertices are bucketed by components
+    and components are extracted as subgraphs
+    components are numbered in order of their minimal vertices
+ */
 class ConnectedComponentGraphSplitter {
     // input parameters
     SparseGraphPtr graph_ptr_;
 
-    // auxiliary parameters
-    std::vector<bool> visited_vertices_;
-    size_t next_start_vertex_;
+    std::vector<size_t> ComputeVertexRoots() const;
 
-    void InitializeInnerVertices();
+    size_t NumberComponents(const std::vector<size_t> &vertex_root, std::vector<size_t> &vertex_component) const;
 
-    size_t GetStartVertex();
-
-    SparseGraphPtr GetConnectedComponentByVertex(size_t component_id, size_t start_vertex);
+    void BucketVertices(const std::vector<size_t> &vertex_component, size_t num_components,
+                        std::vector<size_t> &component_offsets, std::vector<size_t> &component_vertices) const;
 
 public:
     ConnectedComponentGraphSplitter(SparseGraphPtr graph_ptr) :
-            graph_ptr_(graph_ptr),
-            next_start_vertex_(0) { }
+            graph_ptr_(graph_ptr) { }
 
     std::vector<SparseGraphPtr> Split();
-};
\ No newline at end of file
+};
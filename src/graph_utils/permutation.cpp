@@ -22,6 +22,16 @@ void Permutation::ReadFromFile(std::string filename) {
     perm_fhandler.close();
 }
 
+void Permutation::ReadFromVector(const std::vector<size_t> &inverse_permutation) {
+    VERIFY_MSG(inverse_permutation.size() == num_vertices_, "Size of permutation (" << inverse_permutation.size() <<
+            ") does not match with number of vertices (" << num_vertices_ << ")");
+    for(size_t index1 = 0; index1 < inverse_permutation.size(); index1++) {
+        size_t index2 = inverse_permutation[index1];
+        direct_[index1] = index2;
+        reverse_[index2] = index1;
+    }
+}
+
 std::ostream& operator<<(std::ostream &out, const Permutation &permutation) {
     out << "Direct: ";
     for(size_t i = 0; i < permutation.Size(); i++)
@@ -18,6 +18,9 @@ public:
 
     void ReadFromFile(std::string filename);
 
+    // i-th element of inverse_permutation is the new position of vertex i (the same as METIS .iperm file)
+    void ReadFromVector(const std::vector<size_t> &inverse_permutation);
+
     size_t Size() const { return num_vertices_; }
 
     const std::vector<size_t>& Direct() const { return direct_; }
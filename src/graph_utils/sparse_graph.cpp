@@ -30,25 +30,30 @@ bool SparseGraph::HasEdge(size_t from, size_t to) const {
 }
 
 // vertex set should be sorted
-std::shared_ptr<SparseGraph> SparseGraph::GetSubgraph(size_t subgraph_id, const std::set<size_t> &vertex_set) {
+std::shared_ptr<SparseGraph> SparseGraph::GetSubgraph(size_t subgraph_id, const std::vector<size_t> &vertex_set) {
+    component_map_.AddComponentInMap(subgraph_id, vertex_set);
+    return ExtractSubgraph(subgraph_id);
+}
+
+std::shared_ptr<SparseGraph> SparseGraph::ExtractSubgraph(size_t subgraph_id) const {
+    size_t num_vertices = component_map_.SubgraphSize(subgraph_id);
     std::vector<GraphEdge> subgraph_edges;
     std::vector<size_t> vertex_weights;
-    component_map_.AddComponentInMap(subgraph_id, vertex_set);
-    for(auto it = vertex_set.begin(); it != vertex_set.end(); it++) {
-        size_t vertex1 = *it;
+    vertex_weights.reserve(num_vertices);
+    for(size_t new_vertex1 = 0; new_vertex1 < num_vertices; new_vertex1++) {
+        size_t vertex1 = component_map_.GetOldVertexByNewVertex(subgraph_id, new_vertex1);
         vertex_weights.push_back(WeightOfVertex(vertex1));
         for(size_t i = RowIndex()[vertex1]; i < RowIndex()[vertex1 + 1]; i++) {
             size_t vertex2 = Col()[i];
-            size_t weight = Dist()[i];
-            if(vertex_set.find(vertex2) != vertex_set.end()) {
-                size_t new_vertex1 = component_map_.GetNewVertexByOldVertex(vertex1);
+            size_t weight = Dist(i);
+            if(component_map_.OldVertexBelongsToSubgraph(vertex2, subgraph_id)) {
                 size_t new_vertex2 = component_map_.GetNewVertexByOldVertex(vertex2);
                 subgraph_edges.push_back(GraphEdge(new_vertex1, new_vertex2, weight));
             }
         }
     }
-    //INFO("Subgraph contains " << vertex_set.size() << " vertices and " << subgraph_edges.size() << " edges");
-    return std::shared_ptr<SparseGraph>(new SparseGraph(vertex_set.size(), subgraph_edges, vertex_weights));
+    //INFO("Subgraph contains " << num_vertices << " vertices and " << subgraph_edges.size() << " edges");
+    return std::shared_ptr<SparseGraph>(new SparseGraph(num_vertices, subgraph_edges, vertex_weights));
 }
 
 std::ostream& operator<<(std::ostream &out, const SparseGraph &graph) {
@@ -21,15 +21,19 @@ private:
     GraphComponentMap component_map_;
 
 public:
-    SparseGraph(size_t N, const std::vector<GraphEdge> &edges, const std::vector<size_t>& weight) :
-            direct_matrix_(new CrsMatrix(N, edges)), weight_(weight) {
+    SparseGraph(CrsMatrixPtr direct_matrix, const std::vector<size_t>& weight) :
+            direct_matrix_(direct_matrix), weight_(weight) {
+        VERIFY(weight_.size() == direct_matrix_->N());
         trans_matrix_ = direct_matrix_->Transpose();
-        vertex_.reserve(N);
-        for (size_t i = 0; i < N; i++) {
+        vertex_.reserve(N());
+        for (size_t i = 0; i < N(); i++) {
             vertex_.push_back(Vertex(*this, i));
         }
     }
 
+    SparseGraph(size_t N, const std::vector<GraphEdge> &edges, const std::vector<size_t>& weight) :
+            SparseGraph(std::make_shared<CrsMatrix>(N, edges), weight) {}
+
     SparseGraph(size_t N, const std::vector<GraphEdge> &edges) : SparseGraph(N, edges, std::vector<size_t>(N, 1)) {}
 
     size_t N() const { return direct_matrix_->N(); }
@@ -50,13 +54,13 @@ public:
 
     const std::vector<size_t>& RowIndexT() const { return trans_matrix_->RowIndex(); }
 
-    const std::vector<size_t>& Col() const { return direct_matrix_->Col(); }
+    const std::vector<CrsColumn>& Col() const { return direct_matrix_->Col(); }
 
-    const std::vector<size_t>& ColT() const { return trans_matrix_->Col(); }
+    const std::vector<CrsColumn>& ColT() const { return trans_matrix_->Col(); }
 
-    const std::vector<size_t>& Dist() const { return direct_matrix_->Dist(); }
+    size_t Dist(size_t k) const { return direct_matrix_->Dist(k); }
 
-    const std::vector<size_t>& DistT() const { return trans_matrix_->Dist(); }
+    size_t DistT(size_t k) const { return trans_matrix_->Dist(k); }
 
     const std::vector<size_t>& Weight() const { return weight_; }
 
@@ -66,7 +70,10 @@ public:
 
     const CrsMatrixPtr TransposedMatrix() const { return trans_matrix_; }
 
-    std::shared_ptr<SparseGraph> GetSubgraph(size_t subgraph_id, const std::set<size_t> &vertex_set);
+    std::shared_ptr<SparseGraph> GetSubgraph(size_t subgraph_id, const std::vector<size_t> &vertex_set);
+
+    // subgraph induced by vertices of component subgraph_id that is already added in component map
+    std::shared_ptr<SparseGraph> ExtractSubgraph(size_t subgraph_id) const;
 
     GraphComponentMap& GetGraphComponentMap() { return component_map_; }
 
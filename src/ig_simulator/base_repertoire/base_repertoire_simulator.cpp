@@ -7,23 +7,23 @@
 namespace ig_simulator {
 
 BaseRepertoire BaseRepertoireSimulator::Simulate(size_t size) {
-    BaseRepertoire repertoire;
-    repertoire.reserve(size);
-
     size_t productive_size = static_cast<size_t> (static_cast<double>(size) * productive_part);
-    size_t i = 0;
-    while(i < productive_size) {
-        MetarootCluster cluster{metaroot_creator_p->Createroot(),
-                                multiplicity_creator_p->RandomMultiplicity()};
-        if (cluster.MetarootPtr()->IsProductive()) {
-            repertoire.emplace_back(std::move(cluster));
-            i++;
-        }
+    std::vector<AbstractMetarootCPtr> metaroots(size);
+    std::vector<size_t> multiplicities(size);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for(size_t i = 0; i < size; ++i) {
+        RandomStreams::SeedThreadGenerator(random_seed, RandomStreamType::MetarootStream, i);
+        do {
+            metaroots[i] = metaroot_creator_p->Createroot();
+            multiplicities[i] = multiplicity_creator_p->RandomMultiplicity();
+        } while(i < productive_size and not metaroots[i]->IsProductive());
     }
 
-    for(; i < size; ++i) {
-        repertoire.emplace_back(metaroot_creator_p->Createroot(),
-                                multiplicity_creator_p->RandomMultiplicity());
+    BaseRepertoire repertoire;
+    repertoire.reserve(size);
+    for(size_t i = 0; i < size; ++i) {
+        repertoire.emplace_back(std::move(metaroots[i]), multiplicities[i]);
     }
     return repertoire;
 }
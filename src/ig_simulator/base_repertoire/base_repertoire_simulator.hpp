@@ -23,14 +23,17 @@ private:
     AbstractMetarootCreatorCPtr metaroot_creator_p;
     AbstractMultiplicityCreatorPtr multiplicity_creator_p;
     double productive_part;
+    uint64_t random_seed;
 
 public:
     BaseRepertoireSimulator(const IgSimulatorConfig::SimulationParams::BaseRepertoireParams& config,
                             const germline_utils::ChainType& chain_type,
-                            std::vector<germline_utils::CustomGeneDatabase> &db):
+                            std::vector<germline_utils::CustomGeneDatabase> &db,
+                            uint64_t random_seed):
         metaroot_creator_p(get_metarootcreator(chain_type, config.metaroot_simulation_params, db)),
         multiplicity_creator_p(get_multiplicity_creator(config.multiplicity_creator_params)),
-        productive_part(config.productive_params.productive_part)
+        productive_part(config.productive_params.productive_part),
+        random_seed(random_seed)
     { }
 
     BaseRepertoireSimulator() = delete;
@@ -39,6 +42,8 @@ public:
     BaseRepertoireSimulator& operator=(const BaseRepertoireSimulator&) = delete;
     BaseRepertoireSimulator& operator=(BaseRepertoireSimulator&&) = delete;
 
+    // i-th metaroot cluster is simulated from its own random stream, so the result does not depend on
+    // the number of threads. First productive_part * size clusters are regenerated until they are productive
     BaseRepertoire Simulate(size_t size);
 };
 
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <string>
 #include <annotation_utils/cdr_labeling_primitives.hpp>
+#include "clonal_trees/tree/node.hpp"
 
 namespace ig_simulator {
 
@@ -71,6 +72,43 @@ public:
         return HasStopCodon(str, labeling.cdr1.start_pos % 3);
     }
 
+    /**
+     *  Checks sequence obtained from parent_seq by SHMs.
+     *  parent_seq should not contain stop codons in the frame orf,
+     *  so only codons containing SHMs are checked.
+     */
+    bool static HasStopCodon(const std::string& parent_seq, const Node::SHM_Vector& shms, size_t orf) {
+        for(const auto& shm : shms) {
+            size_t pos = std::get<0>(shm);
+            if (pos < orf) {
+                continue;
+            }
+            size_t codon_start = pos - (pos - orf) % 3;
+            if (codon_start + 2 >= parent_seq.length()) {
+                continue;
+            }
+            char codon[3] { parent_seq[codon_start], parent_seq[codon_start + 1], parent_seq[codon_start + 2] };
+            for(const auto& codon_shm : shms) {
+                size_t codon_shm_pos = std::get<0>(codon_shm);
+                if (codon_shm_pos >= codon_start and codon_shm_pos < codon_start + 3) {
+                    codon[codon_shm_pos - codon_start] = std::get<2>(codon_shm);
+                }
+            }
+            size_t hash = FastStopCodonCheckerDetails::get_hash(codon, hash_base, hash_base_sq);
+            if (std::find(stop_codons_hashes.begin(), stop_codons_hashes.end(), hash)
+                != stop_codons_hashes.end())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool static HasStopCodon(const std::string& parent_seq, const Node::SHM_Vector& shms,
+                             const annotation_utils::CDRLabeling& labeling) {
+        return HasStopCodon(parent_seq, shms, labeling.cdr1.start_pos % 3);
+    }
+
     FastStopCodonChecker() = delete;
     FastStopCodonChecker(const FastStopCodonChecker&) = delete;
     FastStopCodonChecker(FastStopCodonChecker&&) = delete;
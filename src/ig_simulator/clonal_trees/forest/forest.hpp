@@ -18,7 +18,7 @@ public:
     Forest(const MetarootCluster* const metaroot_cluster,
            std::vector<Tree>&& trees = {}) noexcept:
         metaroot_cluster(metaroot_cluster),
-        trees(trees)
+        trees(std::move(trees))
     { }
 
     Forest(const Forest&) = default;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include <string>
@@ -16,7 +17,8 @@ namespace ig_simulator {
 
 class Node {
 public:
-    using SHM_Vector = std::vector<std::tuple<size_t, seqan::Dna5, seqan::Dna>>;
+    // position, old nucleotide, new nucleotide
+    using SHM_Vector = std::vector<std::tuple<uint32_t, seqan::Dna5, seqan::Dna>>;
 
 private:
     const size_t parent_ind;
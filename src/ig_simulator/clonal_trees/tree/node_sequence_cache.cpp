@@ -0,0 +1,47 @@
+#include "node_sequence_cache.hpp"
+#include "verify.hpp"
+
+namespace ig_simulator {
+
+void NodeSequenceCache::ApplySHMs(std::string& seq, const Node::SHM_Vector& shms) {
+    for(const auto& shm : shms) {
+        VERIFY_MSG(seq[std::get<0>(shm)] == std::get<1>(shm),
+                   std::string("real seq: ") << seq <<
+                   ", position: " << std::get<0>(shm) <<
+                   ", expected: " << std::get<1>(shm));
+        seq[std::get<0>(shm)] = std::get<2>(shm);
+    }
+}
+
+const std::string& NodeSequenceCache::Sequence(size_t node_ind) {
+    VERIFY(node_ind < nodes.size());
+    if (node_ind == 0) {
+        return root_sequence;
+    }
+    auto it = cache_index.find(node_ind);
+    if (it != cache_index.end()) {
+        cache.splice(cache.begin(), cache, it->second);
+        return cache.front().second;
+    }
+
+    path.clear();
+    size_t ancestor = node_ind;
+    while(ancestor != 0 and cache_index.find(ancestor) == cache_index.end()) {
+        path.push_back(ancestor);
+        ancestor = nodes[ancestor].ParentInd();
+    }
+    std::string seq = ancestor == 0 ? root_sequence : cache_index[ancestor]->second;
+    for(auto path_it = path.rbegin(); path_it != path.rend(); ++path_it) {
+        ApplySHMs(seq, nodes[*path_it].SHMs());
+    }
+
+    if (cache.size() == capacity) {
+        cache_index.erase(cache.back().first);
+        cache.pop_back();
+    }
+    cache.emplace_front(node_ind, std::move(seq));
+    cache_index[node_ind] = cache.begin();
+    return cache.front().second;
+}
+
+} // End namespace ig_simulator
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "node.hpp"
+
+namespace ig_simulator {
+
+/*
+ * Nodes of clonal trees store only SHMs on the edges from their parents.
+ * Sequence of a node is decoded from the nearest ancestor present in the cache
+ * (the root is always present); a few recently decoded sequences are kept in LRU order.
+ * A returned reference is valid until the next call of Sequence.
+ */
+class NodeSequenceCache {
+private:
+    using CacheList = std::list<std::pair<size_t, std::string>>;
+
+    const std::string& root_sequence;
+    const std::vector<Node>& nodes;
+    const size_t capacity;
+
+    CacheList cache;
+    std::unordered_map<size_t, CacheList::iterator> cache_index;
+    std::vector<size_t> path;
+
+public:
+    static void ApplySHMs(std::string& seq, const Node::SHM_Vector& shms);
+
+    static const size_t DEFAULT_CAPACITY = 16;
+
+    NodeSequenceCache(const std::string& root_sequence,
+                      const std::vector<Node>& nodes,
+                      size_t capacity = DEFAULT_CAPACITY):
+        root_sequence(root_sequence),
+        nodes(nodes),
+        capacity(std::max<size_t>(capacity, 1))
+    { }
+
+    NodeSequenceCache(const NodeSequenceCache&) = delete;
+    NodeSequenceCache(NodeSequenceCache&&) = delete;
+    NodeSequenceCache& operator=(const NodeSequenceCache&) = delete;
+    NodeSequenceCache& operator=(NodeSequenceCache&&) = delete;
+
+    const std::string& Sequence(size_t node_ind);
+};
+
+} // End namespace ig_simulator
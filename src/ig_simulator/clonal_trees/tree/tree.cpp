@@ -8,18 +8,18 @@
 
 namespace ig_simulator {
 
-std::ostream& operator<<(std::ostream& out, const Tree& tree) {
-    VERIFY(tree.nodes.size() >= 1);
+void PrintTreeDot(std::ostream& out, bool metaroot_productive, const std::vector<Node>& nodes) {
+    VERIFY(nodes.size() >= 1);
 
     out << "digraph G {\n";
-    out << '\t' << 0 << " [shape = "     << (tree.Metaroot()->IsProductive() ? "circle" : "box") << "," <<
-                          "fillcolor = " << (tree.nodes.front().IsIncluded() ? "cyan"   : "magenta") << "," <<
+    out << '\t' << 0 << " [shape = "     << (metaroot_productive ? "circle" : "box") << "," <<
+                          "fillcolor = " << (nodes.front().IsIncluded() ? "cyan"   : "magenta") << "," <<
                           "style = filled,size=1]; // " <<
-        '(' << (tree.nodes.front().IsIncluded()   ? "included" : "excluded") << ')' << ' ' <<
-        '(' << (tree.nodes.front().IsProductive() ? "productive" : "non-productive") << ')' << '\n';
+        '(' << (nodes.front().IsIncluded()   ? "included" : "excluded") << ')' << ' ' <<
+        '(' << (nodes.front().IsProductive() ? "productive" : "non-productive") << ')' << '\n';
 
-    for (size_t i = 1; i < tree.nodes.size(); ++i) {
-        const auto& node = tree.nodes[i];
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        const auto& node = nodes[i];
         const auto& shms = node.SHMs();
         out << '\t' << i << " [shape = "     << (node.IsProductive() ? "circle" : "box"    ) << "," <<
                               "fillcolor = " << (node.IsIncluded()   ? "cyan"   : "magenta") << "," <<
@@ -40,6 +40,10 @@ std::ostream& operator<<(std::ostream& out, const Tree& tree) {
         // VERIFY(not aa_calculator.ComputeAminoAcidAnnotation(read, tree.Metaroot()->CDRLabeling()).HasStopCodon());
     }
     out << "}\n";
+}
+
+std::ostream& operator<<(std::ostream& out, const Tree& tree) {
+    PrintTreeDot(out, tree.Metaroot()->IsProductive(), tree.nodes);
     return out;
 }
 
@@ -5,22 +5,21 @@
 #pragma once
 
 #include "node.hpp"
+#include "node_sequence_cache.hpp"
 #include "base_repertoire/metaroot/metaroot.hpp"
 
 namespace ig_simulator {
 
 class Tree {
     const AbstractMetaroot* metaroot;
+    // sequences of nodes are not stored, they are decoded from SHMs by NodeSequenceCache
     const std::vector<Node> nodes;
-    const std::vector<std::string> sequences;
 
 public:
     Tree(const AbstractMetaroot* const metaroot,
-         std::vector<Node>&& nodes = {},
-         std::vector<std::string>&& sequences = {}) noexcept:
+         std::vector<Node>&& nodes = {}) noexcept:
         metaroot(metaroot),
-        nodes(std::move(nodes)),
-        sequences(std::move(sequences))
+        nodes(std::move(nodes))
     { }
 
     Tree(const Tree&) = default;
@@ -32,7 +31,13 @@ public:
     size_t Size() const { return nodes.size(); }
     const AbstractMetaroot* Metaroot() const { return metaroot; }
 
-    const std::vector<std::string>& Sequences() const { return sequences; }
+    const std::vector<Node>& Nodes() const { return nodes; }
+
+    const std::string& RootSequence() const { return metaroot->Sequence(); }
+
+    std::string Sequence(size_t node_ind) const {
+        return NodeSequenceCache(RootSequence(), nodes, 1).Sequence(node_ind);
+    }
 
     bool IsNodeIncluded(size_t node_ind) const {
         return nodes[node_ind].IsIncluded();
@@ -43,4 +48,7 @@ public:
 
 std::ostream& operator<<(std::ostream& out, const Tree& tree);
 
+// edge list of tree in dot format
+void PrintTreeDot(std::ostream& out, bool metaroot_productive, const std::vector<Node>& nodes);
+
 } // End namespace ig_simulator
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "tree_archive.hpp"
+#include "verify.hpp"
+
+namespace ig_simulator {
+
+namespace {
+
+const char ARCHIVE_MAGIC[] = "IGSTREES";
+const size_t ARCHIVE_MAGIC_LENGTH = 8;
+const uint32_t ARCHIVE_VERSION = 1;
+const size_t ARCHIVE_HEADER_SIZE = ARCHIVE_MAGIC_LENGTH + 4 + 4 + 8 + 8;
+const size_t ARCHIVE_INDEX_ENTRY_SIZE = 8 + 4 + 4;
+
+void PutFixed(std::string& buffer, uint64_t value, size_t num_bytes) {
+    for (size_t i = 0; i < num_bytes; ++i) {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint64_t GetFixed(const char* data, size_t num_bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < num_bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+void PutVarint(std::string& buffer, uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+class RecordParser {
+private:
+    const std::string& record;
+    size_t pos;
+
+public:
+    explicit RecordParser(const std::string& record): record(record), pos(0) { }
+
+    uint8_t GetByte() {
+        VERIFY_MSG(pos < record.size(), "Tree record is truncated");
+        return static_cast<uint8_t>(record[pos++]);
+    }
+
+    uint64_t GetVarint() {
+        uint64_t value = 0;
+        for (size_t shift = 0; ; shift += 7) {
+            VERIFY_MSG(shift < 64, "Malformed varint in tree record");
+            uint8_t byte = GetByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (not (byte & 0x80)) {
+                return value;
+            }
+        }
+    }
+
+    bool AtEnd() const { return pos == record.size(); }
+
+    size_t Remaining() const { return record.size() - pos; }
+};
+
+} // End anonymous namespace
+
+std::string EncodeTree(bool metaroot_productive, const std::vector<Node>& nodes) {
+    VERIFY(nodes.size() >= 1);
+    std::string record;
+    PutVarint(record, nodes.size());
+    record.push_back(static_cast<char>(metaroot_productive << 2 |
+                                       nodes.front().IsIncluded() << 1 |
+                                       nodes.front().IsProductive()));
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        const auto& node = nodes[i];
+        VERIFY(node.ParentInd() < i);
+        PutVarint(record, (i - node.ParentInd()) << 2 | node.IsIncluded() << 1 | node.IsProductive());
+        PutVarint(record, node.SHMs().size());
+        for (const auto& shm : node.SHMs()) {
+            PutVarint(record, std::get<0>(shm));
+            record.push_back(static_cast<char>(std::get<1>(shm).value << 2 | std::get<2>(shm).value));
+        }
+    }
+    return record;
+}
+
+ArchivedTree DecodeTree(const std::string& record) {
+    RecordParser parser(record);
+    ArchivedTree tree;
+    size_t num_nodes = parser.GetVarint();
+    VERIFY_MSG(num_nodes >= 1, "Tree record has no nodes");
+    uint8_t root_flags = parser.GetByte();
+    tree.metaroot_productive = root_flags & 4;
+    tree.nodes.reserve(num_nodes);
+    tree.nodes.emplace_back(size_t(-1), Node::SHM_Vector(), root_flags & 2, root_flags & 1);
+    for (size_t i = 1; i < num_nodes; ++i) {
+        uint64_t edge = parser.GetVarint();
+        size_t parent_distance = edge >> 2;
+        VERIFY_MSG(parent_distance >= 1 and parent_distance <= i, "Malformed edge in tree record");
+        size_t num_shms = parser.GetVarint();
+        VERIFY_MSG(num_shms <= parser.Remaining(), "Tree record is truncated");
+        Node::SHM_Vector shms(num_shms);
+        for (auto& shm : shms) {
+            uint32_t pos = static_cast<uint32_t>(parser.GetVarint());
+            uint8_t nucls = parser.GetByte();
+            shm = std::make_tuple(pos, seqan::Dna5(nucls >> 2), seqan::Dna(nucls & 3));
+        }
+        tree.nodes.emplace_back(i - parent_distance, std::move(shms), edge & 2, edge & 1);
+    }
+    VERIFY_MSG(parser.AtEnd(), "Tree record has trailing bytes");
+    return tree;
+}
+
+TreeArchiveWriter::TreeArchiveWriter(const std::string& filename):
+    out(filename, std::ios::out | std::ios::binary),
+    offset(ARCHIVE_HEADER_SIZE)
+{
+    VERIFY_MSG(out.good(), "Tree archive " << filename << " was not opened");
+    WriteHeader(0);
+}
+
+void TreeArchiveWriter::WriteHeader(uint64_t index_offset) {
+    std::string header(ARCHIVE_MAGIC, ARCHIVE_MAGIC_LENGTH);
+    PutFixed(header, ARCHIVE_VERSION, 4);
+    PutFixed(header, 0, 4);
+    PutFixed(header, index.size(), 8);
+    PutFixed(header, index_offset, 8);
+    out.write(header.data(), header.size());
+}
+
+void TreeArchiveWriter::AddTree(size_t forest_ind, size_t tree_ind, const std::string& record) {
+    VERIFY(out.is_open());
+    index.push_back({ offset, static_cast<uint32_t>(forest_ind), static_cast<uint32_t>(tree_ind) });
+    out.write(record.data(), record.size());
+    offset += record.size();
+}
+
+void TreeArchiveWriter::Close() {
+    if (not out.is_open()) {
+        return;
+    }
+    std::string buffer;
+    buffer.reserve(index.size() * ARCHIVE_INDEX_ENTRY_SIZE);
+    for (const auto& entry : index) {
+        PutFixed(buffer, entry.offset, 8);
+        PutFixed(buffer, entry.forest_ind, 4);
+        PutFixed(buffer, entry.tree_ind, 4);
+    }
+    out.write(buffer.data(), buffer.size());
+    out.seekp(0);
+    WriteHeader(offset);
+    VERIFY_MSG(out.good(), "Tree archive was not written");
+    out.close();
+}
+
+TreeArchiveReader::TreeArchiveReader(const std::string& filename):
+    in(filename, std::ios::in | std::ios::binary),
+    filename(filename)
+{
+    VERIFY_MSG(in.good(), "Tree archive " << filename << " was not opened");
+    std::string header(ARCHIVE_HEADER_SIZE, '\0');
+    in.read(&header[0], header.size());
+    VERIFY_MSG(in.gcount() == static_cast<std::streamsize>(header.size()) and
+               header.compare(0, ARCHIVE_MAGIC_LENGTH, ARCHIVE_MAGIC) == 0,
+               filename << " is not a tree archive");
+    const char* data = header.data() + ARCHIVE_MAGIC_LENGTH;
+    VERIFY_MSG(GetFixed(data, 4) == ARCHIVE_VERSION, "Unsupported version of tree archive " << filename);
+    size_t num_trees = GetFixed(data + 8, 8);
+    uint64_t index_offset = GetFixed(data + 16, 8);
+    VERIFY_MSG(index_offset >= ARCHIVE_HEADER_SIZE, "Tree archive " << filename << " was not closed");
+
+    std::string buffer(num_trees * ARCHIVE_INDEX_ENTRY_SIZE, '\0');
+    in.seekg(index_offset);
+    in.read(&buffer[0], buffer.size());
+    VERIFY_MSG(in.gcount() == static_cast<std::streamsize>(buffer.size()), "Tree archive " << filename <<
+                                                                           " is truncated");
+    index.resize(num_trees);
+    for (size_t i = 0; i < num_trees; ++i) {
+        const char* entry = buffer.data() + i * ARCHIVE_INDEX_ENTRY_SIZE;
+        index[i].offset = GetFixed(entry, 8);
+        index[i].forest_ind = static_cast<uint32_t>(GetFixed(entry + 8, 4));
+        index[i].tree_ind = static_cast<uint32_t>(GetFixed(entry + 12, 4));
+    }
+    for (size_t i = 0; i < num_trees; ++i) {
+        uint64_t end = i + 1 < num_trees ? index[i + 1].offset : index_offset;
+        VERIFY_MSG(index[i].offset <= end, "Malformed index of tree archive " << filename);
+        index[i].length = end - index[i].offset;
+    }
+}
+
+size_t TreeArchiveReader::FindTree(const std::string& tree_id) const {
+    unsigned long long forest_ind, tree_ind;
+    int num_chars = 0;
+    if (std::sscanf(tree_id.c_str(), "forest_%llu_tree_%llu%n", &forest_ind, &tree_ind, &num_chars) == 2 and
+        static_cast<size_t>(num_chars) == tree_id.size()) {
+        using TreeKey = std::pair<unsigned long long, unsigned long long>;
+        auto it = std::lower_bound(index.begin(), index.end(), TreeKey(forest_ind, tree_ind),
+                                   [](const IndexEntry& entry, const TreeKey& key) {
+                                       return TreeKey(entry.forest_ind, entry.tree_ind) < key;
+                                   });
+        if (it != index.end() and it->forest_ind == forest_ind and it->tree_ind == tree_ind) {
+            return static_cast<size_t>(it - index.begin());
+        }
+        return index.size();
+    }
+    char* end = nullptr;
+    size_t ind = std::strtoull(tree_id.c_str(), &end, 10);
+    if (tree_id.empty() or *end != '\0' or ind >= index.size()) {
+        return index.size();
+    }
+    return ind;
+}
+
+ArchivedTree TreeArchiveReader::ReadTree(size_t ind) const {
+    VERIFY(ind < index.size());
+    std::string record(index[ind].length, '\0');
+    in.seekg(index[ind].offset);
+    in.read(&record[0], record.size());
+    VERIFY_MSG(in.gcount() == static_cast<std::streamsize>(record.size()), "Tree archive " << filename <<
+                                                                           " is truncated");
+    return DecodeTree(record);
+}
+
+} // End namespace ig_simulator
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "node.hpp"
+
+namespace ig_simulator {
+
+/*
+ * Single-file archive of edge lists of simulated trees.
+ * Header (little-endian): magic "IGSTREES", uint32 version, uint32 reserved,
+ * uint64 number of trees, uint64 offset of index.
+ * Header is followed by tree records written in order of (forest, tree) and by the index:
+ * for every tree uint64 offset of its record, uint32 forest index, uint32 tree index.
+ * Record: varint number of nodes, byte of root flags (metaroot productive, included, productive);
+ * for every non-root node varint ((node - parent) << 2 | included << 1 | productive),
+ * varint number of SHMs and for every SHM varint position and byte (old nucleotide << 2 | new nucleotide).
+ */
+struct ArchivedTree {
+    bool metaroot_productive;
+    std::vector<Node> nodes;
+};
+
+std::string EncodeTree(bool metaroot_productive, const std::vector<Node>& nodes);
+
+ArchivedTree DecodeTree(const std::string& record);
+
+class TreeArchiveWriter {
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        uint32_t forest_ind;
+        uint32_t tree_ind;
+    };
+
+    std::ofstream out;
+    std::vector<IndexEntry> index;
+    uint64_t offset;
+
+    void WriteHeader(uint64_t index_offset);
+
+public:
+    explicit TreeArchiveWriter(const std::string& filename);
+
+    TreeArchiveWriter(const TreeArchiveWriter&) = delete;
+    TreeArchiveWriter(TreeArchiveWriter&&) = delete;
+    TreeArchiveWriter& operator=(const TreeArchiveWriter&) = delete;
+    TreeArchiveWriter& operator=(TreeArchiveWriter&&) = delete;
+
+    // records should be added in order of (forest, tree)
+    void AddTree(size_t forest_ind, size_t tree_ind, const std::string& record);
+
+    // writes index and the final header
+    void Close();
+
+    size_t NumTrees() const { return index.size(); }
+
+    ~TreeArchiveWriter() { Close(); }
+};
+
+class TreeArchiveReader {
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        uint64_t length;
+        uint32_t forest_ind;
+        uint32_t tree_ind;
+    };
+
+    mutable std::ifstream in;
+    std::string filename;
+    std::vector<IndexEntry> index;
+
+public:
+    explicit TreeArchiveReader(const std::string& filename);
+
+    size_t size() const { return index.size(); }
+
+    size_t ForestInd(size_t ind) const { return index[ind].forest_ind; }
+
+    size_t TreeInd(size_t ind) const { return index[ind].tree_ind; }
+
+    // tree_id is either 0-based number of tree in archive or forest_<i>_tree_<j>; returns size() if there is no such tree
+    size_t FindTree(const std::string& tree_id) const;
+
+    ArchivedTree ReadTree(size_t ind) const;
+};
+
+} // End namespace ig_simulator
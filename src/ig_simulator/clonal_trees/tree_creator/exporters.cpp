@@ -2,51 +2,111 @@
 // Created by Andrew Bzikadze on 4/14/17.
 //
 
+#include <algorithm>
+
 #include "exporters.hpp"
 
 namespace ig_simulator {
 
 void TreeExporter(const Tree& tree, size_t forest_ind, size_t tree_ind,
-                         std::ostream& full, std::ostream& included)
+                  std::string& full, std::string& included)
 {
-    const auto sequences = tree.Sequences();
-    for (size_t i = 0; i < sequences.size(); ++i) {
-        std::stringstream id_ss;
-        id_ss << ">forest_" << forest_ind << "_tree_" << tree_ind << "_antibody_" << i;
-        std::string id { id_ss.str() };
-        full << id << '\n' << sequences[i] << '\n';
+    NodeSequenceCache sequence_cache(tree.RootSequence(), tree.Nodes());
+    std::string id_prefix = ">forest_" + std::to_string(forest_ind) + "_tree_" + std::to_string(tree_ind) +
+                            "_antibody_";
+    for (size_t i = 0; i < tree.Size(); ++i) {
+        size_t record_start = full.size();
+        full += id_prefix;
+        full += std::to_string(i);
+        full += '\n';
+        full += sequence_cache.Sequence(i);
+        full += '\n';
         if (tree.IsNodeIncluded(i)) {
-            included << id << '\n' << sequences[i] << '\n';
+            included.append(full, record_start, std::string::npos);
         }
     }
 }
 
-void ForestExporter(const Forest& forest, size_t forest_ind, std::ostream& full, std::ostream& included) {
+void ForestExporter(const Forest& forest, size_t forest_ind, std::string& full, std::string& included) {
     for (size_t i = 0; i < forest.Trees().size(); ++i) {
         TreeExporter(forest.Trees()[i], forest_ind, i, full, included);
     }
 }
 
-void ForestStorageExporter(const ForestStorage& forest_storage, std::ostream& full, std::ostream& included) {
-    for (size_t i = 0; i < forest_storage.size(); ++i) {
-        ForestExporter(forest_storage[i], i, full, included);
+ForestStreamExporter::ForestStreamExporter(const IgSimulatorConfig::IOParams::OutputParams& config,
+                                           size_t max_pending_forests):
+    full_pool(path::append_path(config.output_dir, config.full_pool)),
+    filtered_pool(path::append_path(config.output_dir, config.filtered_pool)),
+    max_pending_forests(std::max<size_t>(max_pending_forests, 1)),
+    next_forest(0),
+    num_trees(0),
+    writing(false)
+{
+    VERIFY_MSG(full_pool.good(), "Full pool file was not opened");
+    VERIFY_MSG(filtered_pool.good(), "Filtered pool file was not opened");
+    using TreeOutputMode = IgSimulatorConfig::IOParams::OutputParams::TreeOutputMode;
+    if (config.tree_output_mode == TreeOutputMode::ArchiveTreeOutputMode) {
+        tree_archive.reset(new TreeArchiveWriter(path::append_path(config.output_dir, config.tree_archive)));
+    } else {
+        trees_dir = path::append_path(config.output_dir, config.trees_dir);
+        path::make_dir(trees_dir);
+    }
+}
+
+void ForestStreamExporter::Write(size_t forest_ind, const ForestRecords& records) {
+    full_pool << records.full_pool;
+    filtered_pool << records.filtered_pool;
+    for (size_t i = 0; i < records.trees.size(); ++i) {
+        tree_archive->AddTree(forest_ind, i, records.trees[i]);
     }
+    num_trees += records.num_trees;
 }
 
-void EdgeListsExporters(const ForestStorage& forest_storage, const IgSimulatorConfig::IOParams::OutputParams& config) {
-    std::string path = path::append_path(config.output_dir, config.trees_dir);
-    path::make_dir(path);
-    for (size_t i = 0; i < forest_storage.size(); ++i) {
-        for (size_t j = 0; j < forest_storage[i].Size(); ++j) {
-            std::stringstream filename;
-            filename << "forest_" << i << "_tree_" << j << ".dot";
-            std::string full_filename = path::append_path(path, filename.str());
-            std::ofstream out;
-            out.open(full_filename);
-            out << forest_storage[i].Trees()[j];
-            out.close();
+void ForestStreamExporter::AddForest(const Forest& forest, size_t forest_ind) {
+    ForestRecords records;
+    ForestExporter(forest, forest_ind, records.full_pool, records.filtered_pool);
+    records.num_trees = forest.Size();
+    if (tree_archive) {
+        records.trees.reserve(forest.Size());
+        for (const auto& tree : forest.Trees()) {
+            records.trees.emplace_back(EncodeTree(tree.Metaroot()->IsProductive(), tree.Nodes()));
+        }
+    } else {
+        for (size_t i = 0; i < forest.Size(); ++i) {
+            std::string filename = "forest_" + std::to_string(forest_ind) + "_tree_" + std::to_string(i) + ".dot";
+            std::ofstream out(path::append_path(trees_dir, filename));
+            out << forest.Trees()[i];
         }
     }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    forest_written.wait(lock, [&]() { return forest_ind < next_forest + max_pending_forests; });
+    pending_forests.emplace(forest_ind, std::move(records));
+    if (writing) {
+        // thread that is writing now will write this forest as well
+        return;
+    }
+    writing = true;
+    while (not pending_forests.empty() and pending_forests.begin()->first == next_forest) {
+        size_t next_forest_ind = next_forest;
+        ForestRecords next_records = std::move(pending_forests.begin()->second);
+        pending_forests.erase(pending_forests.begin());
+        lock.unlock();
+        Write(next_forest_ind, next_records);
+        lock.lock();
+        next_forest++;
+        forest_written.notify_all();
+    }
+    writing = false;
+}
+
+void ForestStreamExporter::Close() {
+    VERIFY_MSG(pending_forests.empty(), "Some simulated forests were not written");
+    full_pool.close();
+    filtered_pool.close();
+    if (tree_archive) {
+        tree_archive->Close();
+    }
 }
 
 } // End namespace ig_simulator
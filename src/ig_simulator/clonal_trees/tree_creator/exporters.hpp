@@ -4,17 +4,69 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <clonal_trees/tree/tree.hpp>
+#include <clonal_trees/tree/tree_archive.hpp>
 #include <clonal_trees/forest/forest.hpp>
 #include "ig_simulator_config.hpp"
 
 namespace ig_simulator {
 
-void TreeExporter(const Tree& tree, size_t forest_ind, size_t tree_ind, std::ostream& full, std::ostream& included);
-void ForestExporter(const Forest& forest, size_t forest_ind, std::ostream& full, std::ostream& included);
-void ForestStorageExporter(const ForestStorage& forest_storage, std::ostream& full, std::ostream& included);
+// append FASTA records of all nodes to full and of included nodes to included
+void TreeExporter(const Tree& tree, size_t forest_ind, size_t tree_ind, std::string& full, std::string& included);
+void ForestExporter(const Forest& forest, size_t forest_ind, std::string& full, std::string& included);
 
-void EdgeListsExporters(const ForestStorage& forest_storage, const IgSimulatorConfig::IOParams::OutputParams& config);
+/*
+ * Writes full and filtered pools and the tree archive while forests are simulated.
+ * AddForest may be called from several threads in any order: forests are serialized by the calling thread
+ * and written in order of their indices. A thread waits while its forest is max_pending_forests or more
+ * forests ahead of the first unwritten one, so memory consumption does not depend on the repertoire size.
+ * In files mode the calling thread writes .dot files of the forest trees instead of archive records.
+ */
+class ForestStreamExporter {
+private:
+    struct ForestRecords {
+        std::string full_pool;
+        std::string filtered_pool;
+        std::vector<std::string> trees;
+        size_t num_trees;
+    };
+
+    std::ofstream full_pool;
+    std::ofstream filtered_pool;
+    // null in files mode
+    std::unique_ptr<TreeArchiveWriter> tree_archive;
+    std::string trees_dir;
+    const size_t max_pending_forests;
+
+    std::mutex mutex;
+    std::condition_variable forest_written;
+    std::map<size_t, ForestRecords> pending_forests;
+    size_t next_forest;
+    size_t num_trees;
+    bool writing;
+
+    void Write(size_t forest_ind, const ForestRecords& records);
+
+public:
+    ForestStreamExporter(const IgSimulatorConfig::IOParams::OutputParams& config, size_t max_pending_forests);
+
+    ForestStreamExporter(const ForestStreamExporter&) = delete;
+    ForestStreamExporter(ForestStreamExporter&&) = delete;
+    ForestStreamExporter& operator=(const ForestStreamExporter&) = delete;
+    ForestStreamExporter& operator=(ForestStreamExporter&&) = delete;
+
+    void AddForest(const Forest& forest, size_t forest_ind);
+
+    // all forests with indices less than NumForests() should be added before
+    void Close();
+
+    size_t NumForests() const { return next_forest; }
+    size_t NumTrees() const { return num_trees; }
+};
 
 } // End namespace ig_simulator
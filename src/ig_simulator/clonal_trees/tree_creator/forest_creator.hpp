@@ -13,11 +13,14 @@ namespace ig_simulator {
 class ForestCreator {
 private:
     const TreeCreator tree_creator;
+    const uint64_t random_seed;
 
 public:
     ForestCreator(const vj_finder::VJFinderConfig& vjf_config,
-                  const ClonalTreeSimulatorParams& config):
-        tree_creator(vjf_config, config)
+                  const ClonalTreeSimulatorParams& config,
+                  uint64_t random_seed):
+        tree_creator(vjf_config, config),
+        random_seed(random_seed)
     { }
 
     ForestCreator(const ForestCreator&) = delete;
@@ -25,15 +28,22 @@ public:
     ForestCreator& operator=(const ForestCreator&) = delete;
     ForestCreator& operator=(ForestCreator&&) = delete;
 
+    // i-th tree of the forest is simulated from the random stream (forest_index, i)
     template<class PoolManager>
-    Forest GenerateForest(const MetarootCluster& root) const {
+    std::vector<Tree> GenerateTrees(const MetarootCluster& root, size_t forest_index) const {
         std::vector<Tree> trees;
         trees.reserve(root.Multiplicity());
         for(size_t i = 0; i < root.Multiplicity(); ++i) {
+            RandomStreams::SeedThreadGenerator(random_seed, RandomStreamType::TreeStream, forest_index, i);
             Tree tree { tree_creator.GenerateTree<PoolManager>(root.MetarootPtr().get()) };
             trees.emplace_back(std::move(tree));
         }
-        return Forest(&root, std::move(trees));
+        return trees;
+    }
+
+    template<class PoolManager>
+    Forest GenerateForest(const MetarootCluster& root, size_t forest_index) const {
+        return Forest(&root, GenerateTrees<PoolManager>(root, forest_index));
     }
 };
 
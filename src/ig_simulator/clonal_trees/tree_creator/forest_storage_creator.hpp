@@ -15,8 +15,9 @@ private:
 
 public:
     ForestStorageCreator(const vj_finder::VJFinderConfig& vjf_config,
-                         const ClonalTreeSimulatorParams& config):
-        forest_creator(vjf_config, config)
+                         const ClonalTreeSimulatorParams& config,
+                         uint64_t random_seed):
+        forest_creator(vjf_config, config, random_seed)
     { }
 
     ForestStorageCreator(const ForestStorageCreator&) = delete;
@@ -24,14 +25,32 @@ public:
     ForestStorageCreator& operator=(const ForestStorageCreator&) = delete;
     ForestStorageCreator& operator=(ForestStorageCreator&&) = delete;
 
+    // forests are simulated in parallel, the result does not depend on the number of threads
     template<class PoolManager>
     ForestStorage GenerateForest(const BaseRepertoire& repertoire) const {
+        std::vector<std::vector<Tree>> trees(repertoire.size());
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(size_t i = 0; i < repertoire.size(); ++i) {
+            trees[i] = forest_creator.GenerateTrees<PoolManager>(repertoire[i], i);
+        }
+
         ForestStorage storage;
-        for(const auto& cluster : repertoire) {
-            storage.emplace_back(forest_creator.GenerateForest<PoolManager>(cluster));
+        storage.reserve(repertoire.size());
+        for(size_t i = 0; i < repertoire.size(); ++i) {
+            storage.emplace_back(&repertoire[i], std::move(trees[i]));
         }
         return storage;
     }
+
+    // each forest is passed to handler(forest, forest_index) by the thread that simulated it
+    template<class PoolManager, class ForestHandler>
+    void GenerateForest(const BaseRepertoire& repertoire, ForestHandler& handler) const {
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(size_t i = 0; i < repertoire.size(); ++i) {
+            const Forest forest(&repertoire[i], forest_creator.GenerateTrees<PoolManager>(repertoire[i], i));
+            handler(forest, i);
+        }
+    }
 };
 
 } // End namespace ig_simulator
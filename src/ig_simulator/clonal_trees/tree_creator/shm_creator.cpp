@@ -10,7 +10,7 @@ namespace ig_simulator {
 Node::SHM_Vector PoissonShmCreator::GenerateSHM_Vector(const std::string& seq) const {
     size_t length = seq.length();
     std::uniform_int_distribution<size_t> ind_distr(fix_left, length - 1 - fix_right);
-    size_t mut_numb = distribution(MTSingleton::GetInstance()) + 1;
+    size_t mut_numb = std::poisson_distribution<size_t>(lambda)(MTSingleton::GetInstance()) + 1;
     std::vector<size_t> mut_inds;
     mut_inds.reserve(mut_numb);
     while(mut_inds.size() < mut_numb) {
@@ -34,7 +34,7 @@ Node::SHM_Vector PoissonShmCreator::GenerateSHM_Vector(const std::string& seq) c
                        << " old nucl index: " << ind_nucl_old
                        << " new nucl index: " << ind_nucl_new
         );
-        shm_vector.emplace_back(mut_ind, old_nucl, new_nucl);
+        shm_vector.emplace_back(static_cast<uint32_t>(mut_ind), old_nucl, new_nucl);
     }
     return shm_vector;
 }
@@ -39,13 +39,15 @@ using AbstractShmCreatorCPtr = std::unique_ptr<AbstractShmCreator>;
 
 class PoissonShmCreator final : public AbstractShmCreator {
 private:
-    mutable std::poisson_distribution<size_t> distribution;
+    // poisson_distribution caches normal variates, so it is constructed per call
+    // to keep streams of random numbers of different trees independent
+    const double lambda;
 
 public:
     PoissonShmCreator(const vj_finder::VJFinderConfig& vjf_config,
                       double lambda):
         AbstractShmCreator(vjf_config),
-        distribution(check_numeric_positive(lambda))
+        lambda(check_numeric_positive(lambda))
     { }
 
     PoissonShmCreator(const vj_finder::VJFinderConfig& vjf_config,
@@ -22,16 +22,9 @@ protected:
     mutable std::geometric_distribution<size_t> distr_n_children;
 
 private:
-    std::string CreateSequence(const std::string& base_seq, const Node::SHM_Vector& shms) const {
+    static std::string CreateSequence(const std::string& base_seq, const Node::SHM_Vector& shms) {
         std::string seq = base_seq;
-
-        for(const auto& shm : shms) {
-            VERIFY_MSG(seq[std::get<0>(shm)] == std::get<1>(shm),
-                       std::string("real seq: ") << seq <<
-                       ", position: " << std::get<0>(shm) <<
-                       ", expected: " << std::get<1>(shm));
-            seq[std::get<0>(shm)] = std::get<2>(shm);
-        }
+        NodeSequenceCache::ApplySHMs(seq, shms);
         return seq;
     }
 
@@ -69,15 +62,15 @@ public:
         nodes.reserve(tree_size);
         nodes.emplace_back();
 
-        std::vector<std::string> sequences;
-        sequences.reserve(tree_size);
-        sequences.emplace_back(root->Sequence());
-
         if (not root->IsProductive()) {
             nodes.back().MakeNonProductive();
-            return Tree(root, std::move(nodes), std::move(sequences));
+            return Tree(root, std::move(nodes));
         }
 
+        const std::string& root_sequence = root->Sequence();
+        // all nodes in pool except the root have no stop codons, so their children are checked incrementally
+        const bool root_has_stop_codon = FastStopCodonChecker::HasStopCodon(root_sequence, root->CDRLabeling());
+        NodeSequenceCache sequence_cache(root_sequence, nodes);
         PoolManager pool_manager(ret_prob);
 
         while(nodes.size() < tree_size) {
@@ -92,15 +85,17 @@ public:
                 nodes[parent_ind].Exclude();
             }
 
+            const std::string& base_sequence = sequence_cache.Sequence(parent_ind);
             for (size_t i = 0; i < n_children; ++i) {
-                const std::string& base_sequence = sequences[parent_ind];
                 Node::SHM_Vector shm_vector { shm_creator->GenerateSHM_Vector(base_sequence)};
-                std::string sequence = CreateSequence(base_sequence, shm_vector);
+                bool has_stop_codon = parent_ind == 0 and root_has_stop_codon ?
+                    FastStopCodonChecker::HasStopCodon(CreateSequence(base_sequence, shm_vector),
+                                                       root->CDRLabeling()) :
+                    FastStopCodonChecker::HasStopCodon(base_sequence, shm_vector, root->CDRLabeling());
 
                 nodes.emplace_back(parent_ind, std::move(shm_vector));
-                sequences.emplace_back(std::move(sequence));
 
-                if (FastStopCodonChecker::HasStopCodon(sequences.back(), root->CDRLabeling())) {
+                if (has_stop_codon) {
                     nodes.back().MakeNonProductive();
                     pool_manager.Erase(pool_manager.MaxIndex() - n_children + i);
                 }
@@ -110,7 +105,7 @@ public:
         if (pool_manager.Size() != 0) { // Only when leafs all non-productive VERIFY should not be checked.
             VERIFY(nodes.size() == tree_size);
         }
-        return Tree(root, std::move(nodes), std::move(sequences));
+        return Tree(root, std::move(nodes));
     }
 };
 
@@ -23,6 +23,17 @@ void load(IgSimulatorConfig::IOParams::OutputParams &output_params, boost::prope
     load(output_params.base_repertoire_info, pt, "base_repertoire_info");
     load(output_params.filtered_pool, pt, "filtered_pool");
     load(output_params.full_pool, pt, "full_pool");
+
+    using TreeOutputMode = IgSimulatorConfig::IOParams::OutputParams::TreeOutputMode;
+    std::string mode_str(pt.get<std::string>("tree_output_mode"));
+    if (mode_str == "archive") {
+        output_params.tree_output_mode = TreeOutputMode::ArchiveTreeOutputMode;
+    } else if (mode_str == "files") {
+        output_params.tree_output_mode = TreeOutputMode::FilesTreeOutputMode;
+    } else {
+        VERIFY_MSG(false, "Unknown tree output mode: " << mode_str);
+    }
+    load(output_params.tree_archive, pt, "tree_archive");
     load(output_params.trees_dir, pt, "trees_dir");
 }
 
@@ -33,6 +44,11 @@ void load(IgSimulatorConfig::IOParams &io_params, boost::property_tree::ptree co
 }
 // IOParams end
 
+void load(IgSimulatorConfig::RunParams &run_params, boost::property_tree::ptree const &pt, bool) {
+    using config_common::load;
+    load(run_params.num_threads, pt, "num_threads");
+}
+
 // SimulationParams start
 void load(GeneChooserParams::CustomGeneChooserParams& custom_gene_chooser_params,
           boost::property_tree::ptree const &pt, bool)
@@ -307,6 +323,7 @@ void load(IgSimulatorConfig::SimulationParams &simulation_params,
     using config_common::load;
     load(simulation_params.base_repertoire_params, pt, "base_repertoire_params");
     load(simulation_params.clonal_tree_simulator_params, pt, "clonal_tree_simulator_params");
+    load(simulation_params.random_seed, pt, "random_seed");
 }
 // SimulationParams end
 
@@ -314,6 +331,7 @@ void load(IgSimulatorConfig::SimulationParams &simulation_params,
 void load(IgSimulatorConfig &cfg, boost::property_tree::ptree const &pt, bool complete) {
     using config_common::load;
     load(cfg.io_params, pt, "io_params", complete);
+    load(cfg.run_params, pt, "run_params", complete);
     load(cfg.simulation_params, pt, "simulation_params", complete);
     load(cfg.germline_params, pt, "germline_params");
     // TODO remove this hack
@@ -26,6 +26,12 @@ struct IgSimulatorConfig {
             std::string base_repertoire_info;
             std::string filtered_pool;
             std::string full_pool;
+
+            // archive mode writes edge lists of all trees into a single indexed file,
+            // files mode writes forest_<i>_tree_<j>.dot files into trees_dir
+            enum class TreeOutputMode { FilesTreeOutputMode, ArchiveTreeOutputMode };
+            TreeOutputMode tree_output_mode;
+            std::string tree_archive;
             std::string trees_dir;
         };
 
@@ -33,6 +39,10 @@ struct IgSimulatorConfig {
         OutputParams output_params;
     };
 
+    struct RunParams {
+        size_t num_threads;
+    };
+
 
     struct SimulationParams {
         struct BaseRepertoireParams {
@@ -158,9 +168,12 @@ struct IgSimulatorConfig {
 
         BaseRepertoireParams base_repertoire_params;
         ClonalTreeSimulatorParams clonal_tree_simulator_params;
+        // master seed of all random streams, 0 means a random one
+        size_t random_seed;
     };
 
     IOParams io_params;
+    RunParams run_params;
     germline_utils::GermlineParams germline_params;
     SimulationParams simulation_params;
 };
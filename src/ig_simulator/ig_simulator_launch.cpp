@@ -3,6 +3,9 @@
 //
 
 #include <chrono>
+#include <random>
+
+#include <omp.h>
 
 #include <clonal_trees/tree_creator/tree_creator.hpp>
 #include <clonal_trees/tree_creator/exporters.hpp>
@@ -47,7 +50,8 @@ IgSimulatorLaunch::GetBaseRepertoire(const germline_utils::ChainType chain_type,
     INFO("== Base Repertoire starts ==");
     BaseRepertoireSimulator base_repertoire_simulator{config_.simulation_params.base_repertoire_params,
                                                       chain_type,
-                                                      db};
+                                                      db,
+                                                      config_.simulation_params.random_seed};
     auto base_repertoire =
         base_repertoire_simulator.Simulate(config_.simulation_params.base_repertoire_params.number_of_metaroots);
     std::ofstream base_repertoire_fasta;
@@ -64,57 +68,58 @@ IgSimulatorLaunch::GetBaseRepertoire(const germline_utils::ChainType chain_type,
 }
 
 template<class PoolManager>
-ForestStorage IgSimulatorLaunch::__GetForestStorage(const BaseRepertoire& base_repertoire) const
+void IgSimulatorLaunch::__SimulateForests(const BaseRepertoire& base_repertoire) const
 {
-    INFO("== Forest Storage generation starts ==");
+    INFO("== Forest Storage generation and export starts ==");
     const auto& vjf_config = config_.simulation_params.base_repertoire_params.metaroot_simulation_params.
                              cdr_labeler_config.vj_finder_config;
     ForestStorageCreator forest_storage_creator(vjf_config,
-                                                config_.simulation_params.clonal_tree_simulator_params);
-    auto forest_storage = forest_storage_creator.GenerateForest<PoolManager>(base_repertoire);
-    INFO("== Forest Storage generation ends ==");
-
-    INFO("== Forest Storage export starts ==");
-    INFO("== Full and filtered pool export start");
-    std::ofstream full, included;
-    full.open(path::append_path(config_.io_params.output_params.output_dir,
-                                config_.io_params.output_params.full_pool));
-    included.open(path::append_path(config_.io_params.output_params.output_dir,
-                                    config_.io_params.output_params.filtered_pool));
-    ForestStorageExporter(forest_storage, full, included);
-    full.close();
-    included.close();
-    INFO("== Full and filtered pool export ends");
-
-    INFO("== Edge lists export starts");
-    EdgeListsExporters(forest_storage, config_.io_params.output_params);
-    INFO("== Edge lists export ends");
-    INFO("== Forest Storage export ends ==");
-    return forest_storage;
+                                                config_.simulation_params.clonal_tree_simulator_params,
+                                                config_.simulation_params.random_seed);
+    ForestStreamExporter exporter(config_.io_params.output_params, 2 * config_.run_params.num_threads);
+    auto export_forest = [&exporter](const Forest& forest, size_t forest_ind) {
+        exporter.AddForest(forest, forest_ind);
+    };
+    forest_storage_creator.GenerateForest<PoolManager>(base_repertoire, export_forest);
+    exporter.Close();
+    const auto& output_params = config_.io_params.output_params;
+    using TreeOutputMode = IgSimulatorConfig::IOParams::OutputParams::TreeOutputMode;
+    INFO(exporter.NumTrees() << " trees of " << exporter.NumForests() << " forests were written to " <<
+         path::append_path(output_params.output_dir,
+                           output_params.tree_output_mode == TreeOutputMode::ArchiveTreeOutputMode ?
+                           output_params.tree_archive : output_params.trees_dir));
+    INFO("== Forest Storage generation and export ends ==");
 }
 
-ForestStorage IgSimulatorLaunch::GetForestStorage(const BaseRepertoire& base_repertoire) const
+void IgSimulatorLaunch::SimulateForests(const BaseRepertoire& base_repertoire) const
 {
     const auto& pool_manager_strategy = config_.simulation_params.clonal_tree_simulator_params.pool_manager_strategy;
     if (pool_manager_strategy == PoolManagerStrategy::UniformPoolManager) {
-        return __GetForestStorage<UniformPoolManager>(base_repertoire);
+        __SimulateForests<UniformPoolManager>(base_repertoire);
     } else if (pool_manager_strategy == PoolManagerStrategy::DeepTreePoolManager) {
-        return __GetForestStorage<DeepTreePoolManager>(base_repertoire);
+        __SimulateForests<DeepTreePoolManager>(base_repertoire);
     } else if (pool_manager_strategy == PoolManagerStrategy::WideTreePoolManager) {
-        return __GetForestStorage<WideTreePoolManager>(base_repertoire);
+        __SimulateForests<WideTreePoolManager>(base_repertoire);
+    } else {
+        VERIFY(false);
     }
-    VERIFY(false);
 }
 
 void IgSimulatorLaunch::Run() {
-    // MTSingleton::SetSeed(1);
     INFO("== IgSimulator starts ==");
+    omp_set_num_threads(static_cast<int>(config_.run_params.num_threads));
+    INFO("IgSimulator uses " << config_.run_params.num_threads << " threads");
+    if (config_.simulation_params.random_seed == 0) {
+        std::random_device rd;
+        config_.simulation_params.random_seed = (static_cast<size_t>(rd()) << 32) | rd();
+    }
+    INFO("Random seed: " << config_.simulation_params.random_seed);
 
     germline_utils::ChainType chain_type = GetLaunchChainType();
     std::vector<germline_utils::CustomGeneDatabase> db { GetDB(chain_type) };
 
     const BaseRepertoire base_repertoire = GetBaseRepertoire(chain_type, db);
-    const ForestStorage forest_storage = GetForestStorage(base_repertoire);
+    SimulateForests(base_repertoire);
 
     INFO("== IgSimulator ends ==");
 }
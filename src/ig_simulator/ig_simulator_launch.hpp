@@ -26,9 +26,10 @@ private:
                       std::vector<germline_utils::CustomGeneDatabase>& db) const;
 
     template<class PoolManager>
-    ForestStorage __GetForestStorage(const BaseRepertoire& base_repertoire) const;
+    void __SimulateForests(const BaseRepertoire& base_repertoire) const;
 
-    ForestStorage GetForestStorage(const BaseRepertoire& base_repertoire) const;
+    // forests are exported as soon as they are simulated and are not kept in memory
+    void SimulateForests(const BaseRepertoire& base_repertoire) const;
 
 public:
     IgSimulatorLaunch(const IgSimulatorConfig &config) :
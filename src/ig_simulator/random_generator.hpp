@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 namespace ig_simulator {
@@ -20,16 +21,53 @@ private:
     { }
 
 public:
+    // Seeds generator of the calling thread only
     static void SetSeed(Sseq seed = std::random_device()()) {
         RandomGeneratorSingleton::GetInstance().seed(seed);
     }
 
     static STLRandomGenerator& GetInstance() {
-        static RandomGeneratorSingleton rg;
+        static thread_local RandomGeneratorSingleton rg;
         return rg.generator_;
     }
 };
 
 using MTSingleton = RandomGeneratorSingleton<std::mt19937>;
 
+/*
+ * Every simulated object (metaroot cluster, clonal tree) has its own stream of random numbers:
+ * before simulation of an object generator of the calling thread is reseeded
+ * by a hash of the master seed, type of the object and its indices.
+ * Thus results do not depend on the number of threads and on the order of simulation.
+ */
+enum class RandomStreamType : uint64_t { MetarootStream = 1, TreeStream = 2 };
+
+class RandomStreams {
+private:
+    // splitmix64 finalizer
+    static uint64_t Mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+    static uint64_t StreamSeed(uint64_t master_seed, RandomStreamType type,
+                               uint64_t index1, uint64_t index2 = 0) {
+        uint64_t seed = Mix(master_seed);
+        seed = Mix(seed ^ static_cast<uint64_t>(type));
+        seed = Mix(seed ^ index1);
+        return Mix(seed ^ index2);
+    }
+
+    static void SeedThreadGenerator(uint64_t master_seed, RandomStreamType type,
+                                    uint64_t index1, uint64_t index2 = 0) {
+        uint64_t seed = StreamSeed(master_seed, type, index1, index2);
+        // all 64 bits of the seed are used, otherwise streams collide for millions of trees
+        std::seed_seq seq { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) };
+        MTSingleton::GetInstance().seed(seq);
+    }
+};
+
 } // End namespace ig_simulator
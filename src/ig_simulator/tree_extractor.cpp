@@ -0,0 +1,31 @@
+#include <iostream>
+
+#include <logger/log_writers.hpp>
+
+#include "clonal_trees/tree/tree.hpp"
+#include "clonal_trees/tree/tree_archive.hpp"
+
+void create_console_logger() {
+    using namespace logging;
+    logger *lg = create_logger("");
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+int main(int argc, char **argv) {
+    create_console_logger();
+    if (argc != 3) {
+        INFO("Extracts a single clonal tree in dot format from tree archive written by IgSimulator.");
+        INFO("Usage: <tree archive> <tree number or forest_<i>_tree_<j>>");
+        return 1;
+    }
+    ig_simulator::TreeArchiveReader reader(argv[1]);
+    size_t index = reader.FindTree(argv[2]);
+    if (index == reader.size()) {
+        INFO("Tree " << argv[2] << " was not found in archive " << argv[1] << " of " << reader.size() << " trees");
+        return 1;
+    }
+    ig_simulator::ArchivedTree tree = reader.ReadTree(index);
+    ig_simulator::PrintTreeDot(std::cout, tree.metaroot_productive, tree.nodes);
+    return 0;
+}
@@ -89,6 +89,23 @@ public:
 		return reads;
 	}
 
+	// reads the next non-empty record, returns false if there are no more records
+	bool ReadNext(FastqRead &read) {
+		std::string tmp;
+		while(!src_.eof()) {
+			getline(src_, read.name);
+			getline(src_, read.seq);
+			getline(src_, tmp);
+			getline(src_, read.quality);
+
+			VERIFY(read.seq.size() == read.quality.size());
+
+			if(read.name != "" && read.seq != "" && read.quality != "")
+				return true;
+		}
+		return false;
+	}
+
     bool eof() {
         return src_.eof();
     }
@@ -126,6 +143,11 @@ public:
 	FastqWriter(std::string fname) :
 		out_(fname.c_str()) { }
 
+	// no flush after each line, the stream is flushed on destruction
+	void Write(const FastqRead &read) {
+		out_ << read.name << '\n' << read.seq << '\n' << "+\n" << read.quality << '\n';
+	}
+
 	void Write(std::vector<FastqRead> reads) {
 		for(size_t i = 0; i < reads.size(); i++) {
 			out_ << reads[i].name << std::endl << reads[i].seq << std::endl <<
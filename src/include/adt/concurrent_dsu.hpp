@@ -7,6 +7,7 @@
 #ifndef CONCURRENTDSU_HPP_
 #define CONCURRENTDSU_HPP_
 
+#include "verify.hpp"
 #include "io/mmapped_writer.hpp"
 
 #include <cmath>
@@ -15,6 +16,8 @@
 #include <cstdint>
 
 #include <algorithm>
+#include <fstream>
+#include <iostream>
 #include <vector>
 #include <unordered_map>
 
@@ -44,6 +47,13 @@ class ConcurrentDSU {
     }
   }
 
+  ~ConcurrentDSU() {
+    delete[] data;
+  }
+
+  ConcurrentDSU(const ConcurrentDSU&) = delete;
+  ConcurrentDSU& operator=(const ConcurrentDSU&) = delete;
+
   void unite(unsigned x, unsigned y) {
     while (true) {
       x = find_set(x);
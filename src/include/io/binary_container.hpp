@@ -0,0 +1,190 @@
+#pragma once
+
+/*
+ * Binary interchange container for IgReC pipeline stages.
+ *
+ * File layout:
+ *   ContainerHeader
+ *   SectionEntry[num_sections]
+ *   sections, each one starts at offset aligned to SECTION_ALIGNMENT
+ *
+ * Sections are plain arrays of fixed-width records, so the whole file is mapped once and
+ * sections are accessed in place without parsing and copying.
+ * Meaning of sections is defined by container type (see graph_utils/graph_io.hpp,
+ * graph_utils/decomposition.hpp and fast_ig_tools/binary_reads.hpp).
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "verify.hpp"
+#include "io/mmapped_reader.hpp"
+#include "io/mmapped_writer.hpp"
+
+namespace io {
+namespace binary {
+
+enum class ContainerType : uint32_t {
+    Reads = 1,
+    Graph = 2,
+    Decomposition = 3
+};
+
+const char CONTAINER_MAGIC[8] = { 'I', 'G', 'R', 'E', 'C', 'B', 'I', 'N' };
+const uint32_t CONTAINER_VERSION = 1;
+const size_t SECTION_ALIGNMENT = 8;
+
+// files with this extension are written in binary format, readers detect format by magic number
+const std::string BINARY_EXTENSION = ".igb";
+
+struct ContainerHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t type;
+    uint64_t num_sections;
+};
+
+// offset from the beginning of the file and size of section in bytes
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+inline bool HasBinaryExtension(const std::string &filename) {
+    return filename.size() >= BINARY_EXTENSION.size() &&
+           filename.compare(filename.size() - BINARY_EXTENSION.size(), BINARY_EXTENSION.size(),
+                            BINARY_EXTENSION) == 0;
+}
+
+inline bool IsBinaryContainer(const std::string &filename) {
+    std::ifstream in(filename.c_str(), std::ios_base::binary);
+    char magic[sizeof(CONTAINER_MAGIC)];
+    if (!in.read(magic, sizeof(magic)))
+        return false;
+    return memcmp(magic, CONTAINER_MAGIC, sizeof(magic)) == 0;
+}
+
+inline ContainerType GetContainerType(const std::string &filename) {
+    std::ifstream in(filename.c_str(), std::ios_base::binary);
+    ContainerHeader header;
+    VERIFY_MSG(in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+               memcmp(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) == 0,
+               "File " << filename << " is not a binary container");
+    return static_cast<ContainerType>(header.type);
+}
+
+inline size_t AlignedSize(size_t size) {
+    return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+/*
+ * Collects sections and writes them through a single mmapped region.
+ * Sections are not copied, so the added arrays should live until Write is called
+ */
+class ContainerWriter {
+    ContainerType type_;
+    std::vector<std::pair<const void*, size_t>> sections_;
+
+public:
+    ContainerWriter(ContainerType type) : type_(type) { }
+
+    template<typename T>
+    void AddSection(const std::vector<T> &section) {
+        AddSection(section.data(), section.size());
+    }
+
+    template<typename T>
+    void AddSection(const T *data, size_t num_records) {
+        sections_.push_back(std::make_pair(static_cast<const void*>(data), num_records * sizeof(T)));
+    }
+
+    void Write(const std::string &filename) const {
+        ContainerHeader header;
+        memcpy(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+        header.version = CONTAINER_VERSION;
+        header.type = static_cast<uint32_t>(type_);
+        header.num_sections = sections_.size();
+
+        std::vector<SectionEntry> entries(sections_.size());
+        size_t offset = AlignedSize(sizeof(ContainerHeader) + entries.size() * sizeof(SectionEntry));
+        for (size_t i = 0; i < sections_.size(); i++) {
+            entries[i].offset = offset;
+            entries[i].size = sections_[i].second;
+            offset += AlignedSize(sections_[i].second);
+        }
+
+        MMappedWriter writer(filename);
+        writer.reserve(offset);
+        writer.write(&header, sizeof(header));
+        writer.write(entries.data(), entries.size() * sizeof(SectionEntry));
+        char padding[SECTION_ALIGNMENT] = { 0 };
+        size_t written = sizeof(header) + entries.size() * sizeof(SectionEntry);
+        for (size_t i = 0; i < sections_.size(); i++) {
+            writer.write(padding, entries[i].offset - written);
+            if (sections_[i].second != 0)
+                writer.write(const_cast<void*>(sections_[i].first), sections_[i].second);
+            written = entries[i].offset + sections_[i].second;
+        }
+    }
+};
+
+/*
+ * Maps the whole container and provides zero-copy access to its sections
+ */
+class ContainerReader {
+    std::unique_ptr<MMappedReader> reader_;
+    const uint8_t *data_;
+    const ContainerHeader *header_;
+    const SectionEntry *sections_;
+
+public:
+    ContainerReader(const std::string &filename, ContainerType type) :
+            reader_(new MMappedReader(filename, false, -1ULL)) {
+        data_ = static_cast<const uint8_t*>(reader_->data());
+        VERIFY_MSG(reader_->size() >= sizeof(ContainerHeader) && data_ != nullptr,
+                   "File " << filename << " is too short for binary container");
+        header_ = reinterpret_cast<const ContainerHeader*>(data_);
+        VERIFY_MSG(memcmp(header_->magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) == 0,
+                   "File " << filename << " is not a binary container");
+        VERIFY_MSG(header_->version == CONTAINER_VERSION,
+                   "Unsupported version " << header_->version << " of binary container " << filename);
+        VERIFY_MSG(header_->type == static_cast<uint32_t>(type),
+                   "Binary container " << filename << " has type " << header_->type << " instead of " <<
+                   static_cast<uint32_t>(type));
+        VERIFY(reader_->size() >= sizeof(ContainerHeader) + header_->num_sections * sizeof(SectionEntry));
+        sections_ = reinterpret_cast<const SectionEntry*>(data_ + sizeof(ContainerHeader));
+        for (size_t i = 0; i < NumSections(); i++) {
+            VERIFY_MSG(sections_[i].offset % SECTION_ALIGNMENT == 0 &&
+                       sections_[i].offset + sections_[i].size <= reader_->size(),
+                       "Section " << i << " of binary container " << filename << " is corrupted");
+        }
+    }
+
+    size_t NumSections() const { return static_cast<size_t>(header_->num_sections); }
+
+    template<typename T>
+    size_t SectionSize(size_t index) const {
+        VERIFY(index < NumSections());
+        VERIFY(sections_[index].size % sizeof(T) == 0);
+        return static_cast<size_t>(sections_[index].size / sizeof(T));
+    }
+
+    template<typename T>
+    const T* Section(size_t index) const {
+        VERIFY(index < NumSections());
+        return reinterpret_cast<const T*>(data_ + sections_[index].offset);
+    }
+
+    template<typename T>
+    std::vector<T> CopySection(size_t index) const {
+        const T *section = Section<T>(index);
+        return std::vector<T>(section, section + SectionSize<T>(index));
+    }
+};
+
+}
+}
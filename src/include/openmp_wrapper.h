@@ -15,6 +15,7 @@
 # define omp_get_max_threads()   1
 # define omp_get_thread_num()    0
 # define omp_get_num_threads()   1
+# define omp_in_parallel()       0
 # define omp_lock_t              size_t
 # define omp_init_lock(x)        ((void)(x))
 # define omp_destroy_lock(x)     ((void)(x))
@@ -8,6 +8,7 @@ merger_setting parse_settings(int argc, char *argv[]) {
     std::string min_overlap_str = "--min-overlap=";
     std::string max_mismatch_str = "--max-mismatch=";
     std::string simulated_mode_str = "--simulated-mode";
+    std::string threads_str = "--threads=";
     for(size_t i = 4; i < static_cast<size_t>(argc); i++) {
         std::string tmp(argv[i]);
         if(tmp.substr(0, min_overlap_str.size()) == min_overlap_str) {
@@ -20,6 +21,10 @@ merger_setting parse_settings(int argc, char *argv[]) {
         }
         else if(tmp == simulated_mode_str)
             setting.simulated_mode = true;
+        else if(tmp.substr(0, threads_str.size()) == threads_str) {
+            tmp = tmp.substr(threads_str.size(), tmp.size() - threads_str.size());
+            setting.num_threads = std::max<size_t>(1, string_to_number<size_t>(tmp));
+        }
 
     }
     setting.print();
@@ -35,7 +40,6 @@ void create_console_logger(std::string log_filename) {
 
 
 int main(int argc, char *argv[]) {
-    omp_set_num_threads(1);
     /*
      * argv[1] - left fastq reads
      * argv[2] - right fastq reads
@@ -44,17 +48,16 @@ int main(int argc, char *argv[]) {
     create_console_logger("");
 
     if(argc < 4) {
-        ERROR("paired_read_merger left_reads.fq right_reads.fq output_prefix [--min-overlap=N1 --max-mismatch=N2 --simulated-mode]");
+        ERROR("paired_read_merger left_reads.fq right_reads.fq output_prefix [--min-overlap=N1 --max-mismatch=N2 --simulated-mode --threads=N3]");
         return 1;
     }
 
-    std::vector<PairedFastqRead> paired_reads = PairedFastqReader(argv[1],
-            argv[2]).Read();
-    INFO(paired_reads.size() << " paired reads were read from " << argv[1] <<
+    merger_setting setting = parse_settings(argc, argv);
+    FastqWriter writer((std::string(argv[3])));
+    std::pair<size_t, size_t> merge_stats = PairedReadsMerger(setting).Merge(argv[1], argv[2], writer);
+    INFO(merge_stats.first << " paired reads were read from " << argv[1] <<
             " and " << argv[2]);
-    std::vector<FastqRead> merged_reads = PairedReadsMerger(parse_settings(argc, argv)).Merge(paired_reads);
-    INFO(merged_reads.size() << " read from " << paired_reads.size() << " were successfully merged");
-    FastqWriter(std::string(argv[3])).Write(merged_reads);
+    INFO(merge_stats.second << " read from " << merge_stats.first << " were successfully merged");
     INFO("Merged reads were written to " << std::string(argv[3]));
     return 0;
 }
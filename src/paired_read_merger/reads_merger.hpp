@@ -1,49 +1,92 @@
 #pragma once
 
+#include <map>
+#include <memory>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <utils/fastq_reader.hpp>
 #include <utils/sequence_tools.hpp>
 #include <utils/string_tools.hpp>
 
 #include "logger/log_writers.hpp"
+#include "io/read_processor.hpp"
 
 struct merger_setting {
     size_t min_overlap;
     double max_mismatch_rate;
     bool simulated_mode;
+    size_t num_threads;
+    // number of pairs read, merged and written at once
+    size_t chunk_size;
 
     merger_setting() :
         min_overlap(50),
         max_mismatch_rate(.1),
-        simulated_mode(false) { }
+        simulated_mode(false),
+        num_threads(1),
+        chunk_size(10000) { }
 
     void print() {
         INFO("Min overlap size: " << min_overlap);
         INFO("Max mismatch rate: " << max_mismatch_rate);
         if(simulated_mode)
             INFO("Simulated mode is ON");
+        INFO("Number of threads: " << num_threads);
     }
 };
 
+// Number of positions where s1 and s2 differ.
+// Counting stops as soon as it exceeds bound, then some value greater than bound is returned
+inline size_t CountMismatches(const char *s1, const char *s2, size_t len, size_t bound) {
+    size_t dist = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    for(; i + 16 <= len; i += 16) {
+        __m128i block1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + i));
+        __m128i block2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i));
+        unsigned equal_mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block1, block2)));
+        dist += 16 - size_t(__builtin_popcount(equal_mask));
+        if(dist > bound)
+            return dist;
+    }
+#endif
+    for(; i < len; i++)
+        dist += s1[i] != s2[i];
+    return dist;
+}
+
 class SequenceMerger {
     merger_setting setting_;
 
-    std::string reverse_quality_string(std::string qual) {
-        for(size_t i = 0; i < qual.size() / 2; i++) {
-            char tmp = qual[i];
-            qual[i] = qual[qual.size() - i - 1];
-            qual[qual.size() - i - 1] = tmp;
-        }
-        return qual;
+    // buffers are reused for all pairs merged by this object
+    std::string rc_right_;
+    std::string reversed_qual_;
+
+    void reverse_quality_string(const std::string &qual) {
+        reversed_qual_.assign(qual.rbegin(), qual.rend());
+    }
+
+    void reverse_complementary_seq(const std::string &seq) {
+        rc_right_.resize(seq.size());
+        for(size_t i = 0; i < seq.size(); i++)
+            rc_right_[seq.size() - i - 1] = get_complementary(seq[i]);
     }
 
-    std::pair<size_t, size_t> FindBestOverlap(std::string seq1, std::string seq2) {
+    std::pair<size_t, size_t> FindBestOverlap(const std::string &seq1, const std::string &seq2) const {
         std::pair<size_t, size_t> best_overlap(size_t(-1), size_t(-1));
-        for(size_t i = 0; i < seq1.size(); i++) {
+        for(size_t i = 0; i < seq1.size() and best_overlap.first != 0; i++) {
             size_t overlap_size = std::min<size_t>(seq2.size(), seq1.size() - i);
             if(overlap_size >= setting_.min_overlap) {
-                std::string subseq1 = seq1.substr(i, overlap_size);
-                std::string subseq2 = seq2.substr(0, overlap_size);
-                size_t dist = HammingDistance(subseq1, subseq2);
+                // distances above both the mismatch rate limit and the current best are not interesting
+                size_t bound = std::min<size_t>(static_cast<size_t>(setting_.max_mismatch_rate *
+                                                                    static_cast<double>(overlap_size)) + 1,
+                                                best_overlap.first - 1);
+                size_t dist = CountMismatches(seq1.data() + i, seq2.data(), overlap_size, bound);
+                if(dist > bound)
+                    continue;
                 double mism_rate = static_cast<double>(dist) / static_cast<double>(overlap_size);
                 if(mism_rate <= setting_.max_mismatch_rate) {
                     if(best_overlap.first > dist) {
@@ -56,52 +99,53 @@ class SequenceMerger {
         return best_overlap;
     }
 
-    std::pair<std::string, std::string> MergeQualifiedSeq(PairedFastqRead &paired_read) {
-        std::string rc_right = reverse_complementary(paired_read.right_read.seq);
-        std::string left = paired_read.left_read.seq;
+    std::pair<std::string, std::string> MergeQualifiedSeq(const PairedFastqRead &paired_read) {
+        reverse_complementary_seq(paired_read.right_read.seq);
+        const std::string &rc_right = rc_right_;
+        const std::string &left = paired_read.left_read.seq;
         std::pair<size_t, size_t> overlap = FindBestOverlap(left, rc_right);
         if(overlap == std::make_pair(size_t(-1), size_t(-1)))
             return make_pair(std::string(), std::string());
 
         size_t overlap_size = std::min<size_t>(left.size() - overlap.second,
                 rc_right.size());
-        std::string overlap_seq = left.substr(overlap.second, overlap_size);
-        std::string qual1 = paired_read.left_read.quality;
-        std::string qual2 = reverse_quality_string(paired_read.right_read.quality);
-        std::string overlap_qual = qual1.substr(overlap.second,
-                overlap_size);
+        const std::string &qual1 = paired_read.left_read.quality;
+        reverse_quality_string(paired_read.right_read.quality);
+        const std::string &qual2 = reversed_qual_;
+
+        std::string merged_seq;
+        std::string merged_qual;
+        merged_seq.reserve(overlap.second + std::max(overlap_size, rc_right.size()));
+        merged_qual.reserve(merged_seq.capacity());
+        merged_seq.append(left, 0, overlap.second + overlap_size);
+        merged_qual.append(qual1, 0, overlap.second + overlap_size);
 
         if(!setting_.simulated_mode)
             for(size_t i = 0; i < overlap_size; i++)
                 if(qual1[overlap.second + i] < qual2[i]) {
-                    overlap_seq[i] = rc_right[i];
-                    overlap_qual[i] = qual2[i];
+                    merged_seq[overlap.second + i] = rc_right[i];
+                    merged_qual[overlap.second + i] = qual2[i];
                 }
 
-        std::string merged_seq = left.substr(0, overlap.second) + overlap_seq;
-        std::string merged_qual = qual1.substr(0, overlap.second) + overlap_qual;
         if(overlap_size > rc_right.size()) {
-            merged_seq = merged_seq + left.substr(overlap.second + overlap_size,
+            merged_seq.append(left, overlap.second + overlap_size,
                     left.size() - overlap.second - overlap_size);
-            merged_qual = merged_qual + qual1.substr(overlap.second + overlap_size,
+            merged_qual.append(qual1, overlap.second + overlap_size,
                     left.size() - overlap.second - overlap_size);
         }
         else {
-            merged_seq = merged_seq + rc_right.substr(overlap_size,
+            merged_seq.append(rc_right, overlap_size,
+                    rc_right.size() - overlap_size);
+            merged_qual.append(qual2, overlap_size,
                     rc_right.size() - overlap_size);
-            merged_qual = merged_qual + qual2.substr(overlap_size,
-                    rc_right.size() - overlap_size );
         }
         VERIFY(merged_seq.size() == merged_qual.size());
-        return make_pair(merged_seq, merged_qual);
+        return make_pair(std::move(merged_seq), std::move(merged_qual));
     }
 
-    std::string MergeNames(size_t index, std::string name1, std::string name2) {
-        name2 = ""; // Prevent warning
-        if(name1[0] == '@')
-            name1 = name1.substr(1, name1.size() - 1);
+    std::string MergeNames(size_t index, const std::string &name1) const {
         std::stringstream ss;
-        ss << "@" << index << "_merged_read_" << delete_whitespaces(name1);
+        ss << "@" << index << "_merged_read_" << delete_whitespaces(name1[0] == '@' ? name1.substr(1) : name1);
         return ss.str();
     }
 
@@ -109,34 +153,132 @@ public:
     SequenceMerger(merger_setting setting) :
         setting_(setting) { }
 
-    FastqRead Merge(size_t index, PairedFastqRead paired_read) {
-        std::string merged_name = MergeNames(index, paired_read.left_read.name,
-                paired_read.right_read.name);
+    FastqRead Merge(size_t index, const PairedFastqRead &paired_read) {
         std::pair<std::string, std::string> merged_seq_qual = MergeQualifiedSeq(paired_read);
-        return FastqRead(merged_name, merged_seq_qual.first,
-                merged_seq_qual.second);
+        if(merged_seq_qual.first.empty())
+            return FastqRead();
+        return FastqRead(MergeNames(index, paired_read.left_read.name), std::move(merged_seq_qual.first),
+                std::move(merged_seq_qual.second));
+    }
+};
+
+// consecutive pairs of reads, index of the first pair is stored to name merged reads
+struct PairedReadsChunk {
+    size_t index;
+    size_t first_pair_index;
+    std::vector<PairedFastqRead> paired_reads;
+    std::vector<FastqRead> merged_reads;
+
+    PairedReadsChunk(size_t index, size_t first_pair_index) :
+        index(index),
+        first_pair_index(first_pair_index) { }
+};
+
+typedef std::shared_ptr<PairedReadsChunk> PairedReadsChunkPtr;
+
+class PairedFastqChunkReader {
+    SingleFastqReader left_;
+    SingleFastqReader right_;
+    size_t chunk_size_;
+    size_t num_chunks_;
+    size_t num_pairs_;
+
+public:
+    typedef PairedReadsChunkPtr ReadT;
+
+    PairedFastqChunkReader(std::string left_fname, std::string right_fname, size_t chunk_size) :
+        left_(left_fname),
+        right_(right_fname),
+        chunk_size_(chunk_size),
+        num_chunks_(0),
+        num_pairs_(0) { }
+
+    bool eof() {
+        return left_.eof() and right_.eof();
+    }
+
+    PairedFastqChunkReader& operator>>(PairedReadsChunkPtr &chunk) {
+        chunk = std::make_shared<PairedReadsChunk>(num_chunks_++, num_pairs_);
+        chunk->paired_reads.reserve(chunk_size_);
+        PairedFastqRead paired_read;
+        while(chunk->paired_reads.size() < chunk_size_) {
+            bool left_read = left_.ReadNext(paired_read.left_read);
+            bool right_read = right_.ReadNext(paired_read.right_read);
+            VERIFY_MSG(left_read == right_read, "Files with left and right reads contain different numbers of reads");
+            if(!left_read)
+                break;
+            chunk->paired_reads.push_back(paired_read);
+        }
+        num_pairs_ += chunk->paired_reads.size();
+        return *this;
     }
+
+    size_t NumPairs() const { return num_pairs_; }
+};
+
+// writes merged reads in the order of input chunks, chunks merged out of order wait in the reorder buffer
+class MergedReadsChunkWriter {
+    FastqWriter &writer_;
+    std::map<size_t, PairedReadsChunkPtr> reorder_buffer_;
+    size_t next_chunk_;
+    size_t num_pairs_;
+    size_t num_merged_reads_;
+
+public:
+    MergedReadsChunkWriter(FastqWriter &writer) :
+        writer_(writer),
+        next_chunk_(0),
+        num_pairs_(0),
+        num_merged_reads_(0) { }
+
+    MergedReadsChunkWriter& operator<<(const PairedReadsChunkPtr &chunk) {
+        reorder_buffer_[chunk->index] = chunk;
+        for(auto it = reorder_buffer_.begin(); it != reorder_buffer_.end() and it->first == next_chunk_;
+            it = reorder_buffer_.erase(it)) {
+            for(auto read = it->second->merged_reads.begin(); read != it->second->merged_reads.end(); read++)
+                writer_.Write(*read);
+            num_merged_reads_ += it->second->merged_reads.size();
+            size_t num_pairs = num_pairs_ + it->second->paired_reads.size();
+            if(num_pairs / 1000000 != num_pairs_ / 1000000)
+                INFO(num_pairs << " pairs were processed");
+            num_pairs_ = num_pairs;
+            next_chunk_++;
+        }
+        return *this;
+    }
+
+    bool Empty() const { return reorder_buffer_.empty(); }
+
+    size_t NumMergedReads() const { return num_merged_reads_; }
 };
 
 class PairedReadsMerger {
-    SequenceMerger seq_merger_;
+    merger_setting setting_;
+
 public:
     PairedReadsMerger(merger_setting settings) :
-        seq_merger_(settings) { }
-
-    std::vector<FastqRead> Merge(std::vector<PairedFastqRead> reads) {
-        std::vector<FastqRead> merged_reads;
-        double processed_rate = 10;
-        for(size_t i = 0; i < reads.size(); i++) {
-            FastqRead merged_read = seq_merger_.Merge(i, reads[i]);
-            if(!merged_read.is_empty())
-                merged_reads.push_back(merged_read);
-            if(static_cast<double>(i) / static_cast<double>(reads.size()) * 100. > processed_rate) {
-                INFO(processed_rate << "% reads were processed");
-                processed_rate += 10;
+        setting_(settings) { }
+
+    // master thread reads and writes chunks while others merge them
+    // returns pair (number of pairs, number of merged reads)
+    std::pair<size_t, size_t> Merge(std::string left_fname, std::string right_fname, FastqWriter &writer) {
+        VERIFY_MSG(setting_.chunk_size > 0, "Chunk size should be positive");
+        PairedFastqChunkReader reader(left_fname, right_fname, setting_.chunk_size);
+        MergedReadsChunkWriter chunk_writer(writer);
+        auto merger = [this](PairedReadsChunkPtr &chunk) -> PairedReadsChunkPtr* {
+            SequenceMerger seq_merger(setting_);
+            chunk->merged_reads.reserve(chunk->paired_reads.size());
+            for(size_t i = 0; i < chunk->paired_reads.size(); i++) {
+                FastqRead merged_read = seq_merger.Merge(chunk->first_pair_index + i, chunk->paired_reads[i]);
+                if(!merged_read.is_empty())
+                    chunk->merged_reads.push_back(std::move(merged_read));
             }
-        }
+            return &chunk;
+        };
+        hammer::ReadProcessor read_processor(static_cast<unsigned>(setting_.num_threads));
+        read_processor.Run(reader, merger, chunk_writer);
+        VERIFY_MSG(chunk_writer.Empty(), "Some merged chunks were not written");
         INFO("100% reads were processed");
-        return merged_reads;
+        return std::make_pair(reader.NumPairs(), chunk_writer.NumMergedReads());
     }
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+enum class CounterStreamType : uint64_t { BarcodeStream = 1, AmplificationStream = 2, ChimeraStream = 3, ShuffleStream = 4 };
+
+/*
+ * Counter-based random stream: i-th value is a hash of (seed, stream type, cycle, index, i).
+ * Values of a stream do not depend on the other streams, so molecules can be processed in any order
+ */
+class CounterRandomStream {
+    uint64_t key_;
+    uint64_t counter_;
+
+public:
+    static uint64_t Mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    CounterRandomStream(uint64_t seed, CounterStreamType type, uint64_t cycle, uint64_t index) :
+            key_(Mix(Mix(Mix(seed ^ Mix(static_cast<uint64_t>(type))) ^ cycle) ^ index)),
+            counter_(0) { }
+
+    uint64_t Next() { return Mix(key_ + 0xD1B54A32D192ED03ULL * ++counter_); }
+
+    // uniform in [0, 1)
+    double NextDouble() { return static_cast<double>(Next() >> 11) * (1.0 / static_cast<double>(1ULL << 53)); }
+
+    // uniform in [0, n)
+    size_t NextIndex(size_t n) { return static_cast<size_t>(Next() % n); }
+
+    // number of failures before the first success of Bernoulli trials, log_failure_prob = log(1 - p)
+    size_t NextGeometric(double log_failure_prob) {
+        if (log_failure_prob == 0)
+            return std::numeric_limits<size_t>::max();
+        double failures = std::floor(std::log(1.0 - NextDouble()) / log_failure_prob);
+        return failures < 1e18 ? static_cast<size_t>(failures) : std::numeric_limits<size_t>::max();
+    }
+};
+
+/*
+ * Pseudo-random permutation of [0, size) computed on the fly: Feistel network over
+ * the smallest domain of 4^k elements covering size with cycle walking.
+ * Takes O(1) memory instead of a shuffled vector of indices
+ */
+class RandomPermutation {
+    static const size_t NUM_ROUNDS = 4;
+
+    size_t size_;
+    unsigned half_bits_;
+    uint64_t half_mask_;
+    uint64_t keys_[NUM_ROUNDS];
+
+    uint64_t Encrypt(uint64_t value) const {
+        uint64_t left = value >> half_bits_;
+        uint64_t right = value & half_mask_;
+        for (size_t round = 0; round < NUM_ROUNDS; round ++) {
+            uint64_t new_right = left ^ (CounterRandomStream::Mix(right ^ keys_[round]) & half_mask_);
+            left = right;
+            right = new_right;
+        }
+        return (left << half_bits_) | right;
+    }
+
+public:
+    RandomPermutation(size_t size, uint64_t seed) : size_(size), half_bits_(1) {
+        while ((uint64_t(1) << (2 * half_bits_)) < size)
+            half_bits_ ++;
+        half_mask_ = (uint64_t(1) << half_bits_) - 1;
+        CounterRandomStream stream(seed, CounterStreamType::ShuffleStream, 0, size);
+        for (size_t round = 0; round < NUM_ROUNDS; round ++)
+            keys_[round] = stream.Next();
+    }
+
+    size_t size() const { return size_; }
+
+    size_t operator[](size_t index) const {
+        uint64_t value = index;
+        do {
+            value = Encrypt(value);
+        } while (value >= size_);
+        return static_cast<size_t>(value);
+    }
+};
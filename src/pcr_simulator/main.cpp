@@ -33,6 +33,10 @@ Options parse_options(int argc, const char* const* argv) {
             ("barcode-position,b", po::value<size_t>(&simulationOptions.barcode_position)->default_value(3),
              "indicator of barcode position in the read, used for chimeras simulation. "
              "1 for barcode going with the left half, 2 for the right half, 3 for random choice (defaults to 3)")
+            ("seed,s", po::value<size_t>(&simulationOptions.random_seed)->default_value(8356),
+             "random seed; results do not depend on the number of threads (defaults to 8356)")
+            ("threads,t", po::value<size_t>(&options.num_threads)->default_value(16),
+             "number of threads (defaults to 16)")
             ;
     po::variables_map vm;
     store(po::command_line_parser(argc, argv).options(cmdline_options).run(), vm);
@@ -48,13 +52,12 @@ void create_console_logger() {
 }
 
 int main(int argc, const char* const* argv) {
-    omp_set_num_threads(1);
     perf_counter pc;
     segfault_handler sh;
     create_console_logger();
-    std::srand(495634);
 
     const Options& options = parse_options(argc, argv);
+    omp_set_num_threads(static_cast<int>(options.num_threads));
 
     PcrSimulator simulator(options.simulation_options);
     simulator.ReadRepertoire(options.repertoire_file_path);
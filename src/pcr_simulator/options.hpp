@@ -10,10 +10,12 @@ struct Options {
         // 1 for barcode going with the left half, 2 for the right half, 3 for random choice
         size_t barcode_position;
         size_t barcode_length;
+        size_t random_seed;
     };
 
     std::string repertoire_file_path;
     std::string output_dir_path;
     size_t output_estimation_limit;
+    size_t num_threads;
     SimulationOptions simulation_options;
 };
\ No newline at end of file
@@ -2,23 +2,40 @@
 #include <verify.hpp>
 #include <logger/logger.hpp>
 #include <bitset>
+#include <fstream>
 #include <unordered_set>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem.hpp>
 #include "pcr_simulator.hpp"
+#include "counter_random.hpp"
 #include "../ig_tools/utils/string_tools.hpp"
 #include "../umi_experiments/umi_utils.hpp"
 
-std::default_random_engine PcrSimulator::random_engine_;
-const size_t PcrSimulator::CHIMERIC_READ_ERROR_COUNT = std::numeric_limits<size_t>::max() / 2;
 const size_t PcrSimulator::MAP_NOWHERE = std::numeric_limits<size_t>::max();
 
+namespace {
+    const size_t MAX_READ_LENGTH = (1 << 30) - 1;
+
+    void AppendNumber(std::string& str, size_t number) {
+        char buffer[24];
+        size_t length = 0;
+        do {
+            buffer[length ++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number != 0);
+        while (length != 0) {
+            str.push_back(buffer[-- length]);
+        }
+    }
+}
+
 void PcrSimulator::ReadRepertoire(const std::string& repertoire_file_path) {
     seqan::SeqFileIn reads_file(repertoire_file_path.c_str());
     readRecords(original_ids_, original_reads_, reads_file);
     INFO("Total " << original_ids_.size() << " records read.");
     size_t total_length = 0;
     for (const auto& read : original_reads_) {
+        VERIFY_MSG(length(read) + options_.barcode_length <= MAX_READ_LENGTH, "Read is too long: " << length(read));
         total_length += length(read);
     }
     INFO("Average read length: " << static_cast<double>(total_length) / static_cast<double>(original_reads_.size()));
@@ -33,28 +50,22 @@ void PcrSimulator::Amplify(size_t output_estimation_limit) {
         if (boost::algorithm::ends_with(id, "_copy_1")) {
             current ++;
         }
-        read_to_compressed_.push_back(current - 1);
-        read_to_original_.push_back(i);
+        original_to_compressed_.push_back(current - 1);
     }
+    compressed_count_ = current;
 
-    amplified_reads_ = std::vector<Record>();
+    original_barcodes_.clear();
     for (size_t i = 0; i < original_reads_.size(); i ++) {
-        amplified_reads_.emplace_back("original_" + std::to_string(i), original_reads_[i], GenerateBarcode(), 0);
+        original_barcodes_.push_back(GenerateBarcode(i));
     }
 
     {
-        std::unordered_set<seqan::Dna5String> barcodes(amplified_reads_.size());
-        for (const auto& read : amplified_reads_) {
-            barcodes.insert(read.barcode);
-        }
+        std::unordered_set<seqan::Dna5String> barcodes(original_barcodes_.begin(), original_barcodes_.end());
         INFO("Total " << barcodes.size() << " unique barcodes generated.");
     }
 
+    AddOriginalMolecules();
     SimulatePcr();
-
-    perm_ = std::vector<size_t>(amplified_reads_.size());
-    std::iota(perm_.begin(), perm_.end(), 0);
-    std::shuffle(perm_.begin(), perm_.end(), random_engine_);
 }
 
 void PcrSimulator::CheckLimit(size_t output_estimation_limit) {
@@ -63,150 +74,303 @@ void PcrSimulator::CheckLimit(size_t output_estimation_limit) {
     VERIFY(exp_reads_count <= (double) output_estimation_limit);
 }
 
-seqan::Dna5String PcrSimulator::GenerateBarcode() {
+seqan::Dna5String PcrSimulator::GenerateBarcode(size_t original_idx) const {
+    CounterRandomStream stream(options_.random_seed, CounterStreamType::BarcodeStream, 0, original_idx);
     seqan::Dna5String barcode;
+    resize(barcode, options_.barcode_length);
     for (size_t i = 0; i < options_.barcode_length; i ++) {
-        barcode += std::rand() % 4;
+        barcode[i] = stream.NextIndex(4);
     }
     return barcode;
 }
 
-void PcrSimulator::ReportAverageErrorRate() {
+void PcrSimulator::AddOriginalMolecules() {
+    parents_.clear();
+    flags_.assign(NumOriginals(), 0);
+    read_lengths_.clear();
+    error_counts_.assign(NumOriginals(), 0);
+    substitution_offsets_.assign(NumOriginals() + 1, 0);
+    substitutions_.clear();
+    chimeras_.clear();
+    for (size_t i = 0; i < NumOriginals(); i ++) {
+        parents_.push_back(static_cast<MoleculeIndex>(i));
+        read_lengths_.push_back(static_cast<uint32_t>(length(original_reads_[i])));
+    }
+}
+
+void PcrSimulator::ReportAverageErrorRate() const {
     size_t total_errors = 0;
     size_t interesting_reads = 0;
-    for (const auto& record : amplified_reads_) {
-        if (record.error_count < CHIMERIC_READ_ERROR_COUNT) {
-            total_errors += record.error_count;
+    for (size_t i = 0; i < NumMolecules(); i ++) {
+        if (!(flags_[i] & ChimericAncestry)) {
+            total_errors += error_counts_[i];
             interesting_reads ++;
         }
     }
-    INFO("Average amount of errors per read is " << ((double) total_errors / (double) interesting_reads) << " (total " << total_errors << " in " << interesting_reads << " of " << amplified_reads_.size() << " reads)");
-    INFO("Average amount of errors per barcode is " << ((double) barcode_error_count_ / (double) amplified_reads_.size()) << " (total " << barcode_error_count_ << " in " << amplified_reads_.size() << " reads)");
-}
-
-void PcrSimulator::AmplifySequences(double pcr_error_prob) {
-    size_t size = amplified_reads_.size();
-    for (size_t read_idx = 0; read_idx < size; read_idx ++) {
-        if (std::rand() <= static_cast<double>(RAND_MAX) * options_.amplification_rate) {
-            seqan::Dna5String new_read = amplified_reads_[read_idx].read;
-            seqan::Dna5String new_barcode = amplified_reads_[read_idx].barcode;
-            size_t errors = amplified_reads_[read_idx].error_count;
-            for (size_t pos = 0; pos < length(new_barcode) + length(new_read); pos ++) {
-                if (std::rand() <= static_cast<double>(RAND_MAX) * pcr_error_prob) {
-                    auto current_value = pos < length(new_barcode) ? new_barcode[pos] : new_read[pos - length(new_barcode)];
-                    int new_value_candidate = std::rand() % 3;
-                    int new_value = new_value_candidate + (new_value_candidate >= current_value ? 1 : 0);
-                    if (pos >= length(new_barcode)) {
-                        new_read[pos - length(new_barcode)] = new_value;
-                        errors ++;
-                    } else {
-                        new_barcode[pos] = new_value;
-                        barcode_error_count_ ++;
-                    }
-                }
+    INFO("Average amount of errors per read is " << ((double) total_errors / (double) interesting_reads) << " (total " << total_errors << " in " << interesting_reads << " of " << NumMolecules() << " reads)");
+    INFO("Average amount of errors per barcode is " << ((double) barcode_error_count_ / (double) NumMolecules()) << " (total " << barcode_error_count_ << " in " << NumMolecules() << " reads)");
+}
+
+void PcrSimulator::AmplifyBlock(size_t cycle, double log_no_error_prob, size_t block_start, size_t block_end,
+                                AmplifiedBlock& block) const {
+    for (size_t molecule = block_start; molecule < block_end; molecule ++) {
+        CounterRandomStream stream(options_.random_seed, CounterStreamType::AmplificationStream, cycle, molecule);
+        if (stream.NextDouble() >= options_.amplification_rate) {
+            continue;
+        }
+        const size_t total_length = options_.barcode_length + read_lengths_[molecule];
+        uint32_t errors = error_counts_[molecule];
+        size_t pos = 0;
+        while (true) {
+            size_t skip = stream.NextGeometric(log_no_error_prob);
+            if (skip >= total_length - pos) {
+                break;
+            }
+            pos += skip;
+            block.substitutions.push_back(static_cast<uint32_t>(pos << 2 | stream.NextIndex(3)));
+            if (pos >= options_.barcode_length) {
+                errors ++;
+            } else {
+                block.barcode_error_count ++;
             }
-            const std::string new_id = std::string(seqan_string_to_string(amplified_reads_[read_idx].id).find("chimera") == std::string::npos ? "" : "_chimera") +
-                                       "_mutated_from_" + std::to_string(read_idx);
-            AddRecord(new_id, new_read, new_barcode, errors);
-            read_to_compressed_.push_back(read_to_compressed_[read_idx]);
-            read_to_original_.push_back(read_to_original_[read_idx]);
+            pos ++;
         }
+        block.parents.push_back(static_cast<MoleculeIndex>(molecule));
+        block.error_counts.push_back(errors);
+        block.substitution_ends.push_back(block.substitutions.size());
     }
-    std::uniform_int_distribution<size_t> read_distribution(0, size - 1);
-    std::uniform_int_distribution<size_t> barcode_position_distribution(1, std::bitset<2>(options_.barcode_position).count());
-    for (size_t chimera = 0; chimera < (size_t) ((double) size * options_.chimeras_rate); chimera ++) {
-        size_t left_idx = read_distribution(random_engine_);
-        size_t right_idx = read_distribution(random_engine_);
-        std::string left = seqan_string_to_string(amplified_reads_[left_idx].read);
-        left = left.substr(0, left.length() / 2);
-        std::string right = seqan_string_to_string(amplified_reads_[right_idx].read);
-        right = right.substr(right.length() / 2);
-        const std::string new_id = "_chimera_from_" + std::to_string(left_idx) + "_" + std::to_string(right_idx);
-        const seqan::Dna5String new_read(left + right);
-        size_t barcode_idx = (options_.barcode_position & 1) && barcode_position_distribution(random_engine_) == 1 ? left_idx : right_idx;
-        const seqan::Dna5String& new_barcode = amplified_reads_[barcode_idx].barcode;
-        AddChimericRecord(new_id, new_read, new_barcode);
-        read_to_compressed_.push_back(MAP_NOWHERE);
-        read_to_original_.push_back(MAP_NOWHERE);
-    }
-    VERIFY(amplified_reads_.size() == read_to_compressed_.size() && amplified_reads_.size() == read_to_original_.size());
+}
 
-//    ReportAverageErrorRate(read_error_count);
+void PcrSimulator::AddAmplifiedBlock(const AmplifiedBlock& block) {
+    const size_t substitutions_start = substitutions_.size();
+    substitutions_.insert(substitutions_.end(), block.substitutions.begin(), block.substitutions.end());
+    for (size_t i = 0; i < block.parents.size(); i ++) {
+        const MoleculeIndex parent = block.parents[i];
+        parents_.push_back(parent);
+        flags_.push_back(static_cast<uint8_t>(flags_[parent] & ChimericAncestry));
+        read_lengths_.push_back(read_lengths_[parent]);
+        error_counts_.push_back(block.error_counts[i]);
+        substitution_offsets_.push_back(substitutions_start + block.substitution_ends[i]);
+    }
+    barcode_error_count_ += block.barcode_error_count;
 }
 
-void PcrSimulator::AddRecord(const std::string& id, const seqan::Dna5String& read, const seqan::Dna5String& barcode, size_t error_count) {
-    amplified_reads_.emplace_back(std::to_string(amplified_reads_.size()) + id, read, barcode, error_count);
+void PcrSimulator::AddChimeras(size_t cycle, size_t size) {
+    const size_t chimeras_count = (size_t) ((double) size * options_.chimeras_rate);
+    const size_t barcode_positions = std::bitset<2>(options_.barcode_position).count();
+    std::vector<Chimera> chimeras(chimeras_count);
+#pragma omp parallel for schedule(static)
+    for (size_t chimera = 0; chimera < chimeras_count; chimera ++) {
+        CounterRandomStream stream(options_.random_seed, CounterStreamType::ChimeraStream, cycle, chimera);
+        chimeras[chimera].left = static_cast<MoleculeIndex>(stream.NextIndex(size));
+        chimeras[chimera].right = static_cast<MoleculeIndex>(stream.NextIndex(size));
+        chimeras[chimera].barcode_from_left = (options_.barcode_position & 1) && stream.NextIndex(barcode_positions) == 0;
+    }
+    for (const auto& chimera : chimeras) {
+        parents_.push_back(static_cast<MoleculeIndex>(chimeras_.size()));
+        flags_.push_back(ChimericMolecule | ChimericAncestry);
+        read_lengths_.push_back(read_lengths_[chimera.left] / 2 +
+                                (read_lengths_[chimera.right] - read_lengths_[chimera.right] / 2));
+        error_counts_.push_back(0);
+        substitution_offsets_.push_back(substitutions_.size());
+        chimeras_.push_back(chimera);
+    }
 }
 
-void PcrSimulator::AddChimericRecord(const std::string& id, const seqan::Dna5String& read, const seqan::Dna5String& barcode){
-    AddRecord(id, read, barcode, CHIMERIC_READ_ERROR_COUNT);
+void PcrSimulator::AmplifySequences(size_t cycle, double pcr_error_prob) {
+    const size_t size = NumMolecules();
+    const double log_no_error_prob = std::log1p(-std::min(std::max(pcr_error_prob, 0.0), 1.0));
+    const size_t blocks_count = (size + AMPLIFICATION_BLOCK_SIZE - 1) / AMPLIFICATION_BLOCK_SIZE;
+    std::vector<AmplifiedBlock> blocks(blocks_count);
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < blocks_count; i ++) {
+        AmplifyBlock(cycle, log_no_error_prob, i * AMPLIFICATION_BLOCK_SIZE,
+                     std::min(size, (i + 1) * AMPLIFICATION_BLOCK_SIZE), blocks[i]);
+    }
+    size_t amplified_count = 0;
+    for (const auto& block : blocks) {
+        amplified_count += block.parents.size();
+    }
+    const size_t chimeras_count = (size_t) ((double) size * options_.chimeras_rate);
+    VERIFY_MSG(size + amplified_count + chimeras_count <= std::numeric_limits<MoleculeIndex>::max(),
+               "Too many molecules on cycle " << cycle);
+    for (auto& block : blocks) {
+        AddAmplifiedBlock(block);
+        block = AmplifiedBlock();
+    }
+    AddChimeras(cycle, size);
+    VERIFY(NumMolecules() == flags_.size() && NumMolecules() == read_lengths_.size() &&
+           NumMolecules() == error_counts_.size() && NumMolecules() + 1 == substitution_offsets_.size());
 }
 
 void PcrSimulator::SimulatePcr() {
     barcode_error_count_ = 0;
     double pcr_error_prob = options_.error_prob_first;
     for (size_t i = 0; i < options_.cycles_count; i ++) {
-        AmplifySequences(pcr_error_prob);
+        AmplifySequences(i, pcr_error_prob);
         pcr_error_prob += (options_.error_prob_last - options_.error_prob_first) / static_cast<double>(options_.cycles_count - 1);
     }
+    INFO("Total " << NumMolecules() << " molecules (" << chimeras_.size() << " chimeras) after " << options_.cycles_count <<
+         " cycles, " << substitutions_.size() << " substitutions stored");
 
     ReportAverageErrorRate();
 }
 
-void PcrSimulator::WriteResults(const std::string& output_dir_path) {
-    boost::filesystem::create_directory(output_dir_path);
-    UpdateReadIds();
-    WriteRepertoire(boost::filesystem::path(output_dir_path).append("amplified.fasta").string());
-    WriteRcm(boost::filesystem::path(output_dir_path).append("amplified_to_comp.rcm").string(), amplified_reads_, read_to_compressed_);
-    WriteRcm(boost::filesystem::path(output_dir_path).append("amplified_to_orig.rcm").string(), amplified_reads_, read_to_original_);
-    WriteCompressed(boost::filesystem::path(output_dir_path).append("repertoire_comp.fasta").string());
+void PcrSimulator::ApplySubstitutions(MoleculeIndex molecule, seqan::Dna5String& barcode, seqan::Dna5String* read) const {
+    for (size_t i = substitution_offsets_[molecule]; i < substitution_offsets_[molecule + 1]; i ++) {
+        const size_t pos = substitutions_[i] >> 2;
+        const unsigned rank = substitutions_[i] & 3;
+        if (pos < options_.barcode_length) {
+            barcode[pos] = rank + (rank >= seqan::ordValue(barcode[pos]) ? 1 : 0);
+        } else if (read != nullptr) {
+            auto&& nucl = (*read)[pos - options_.barcode_length];
+            nucl = rank + (rank >= seqan::ordValue(nucl) ? 1 : 0);
+        }
+    }
+}
+
+size_t PcrSimulator::RestoreMolecule(MoleculeIndex molecule, seqan::Dna5String& barcode, seqan::Dna5String* read,
+                                     std::vector<MoleculeIndex>& chain) const {
+    const size_t chain_start = chain.size();
+    while (IsCopy(molecule)) {
+        chain.push_back(molecule);
+        molecule = parents_[molecule];
+    }
+    size_t original = MAP_NOWHERE;
+    if (molecule < NumOriginals()) {
+        original = molecule;
+        barcode = original_barcodes_[molecule];
+        if (read != nullptr) {
+            *read = original_reads_[molecule];
+        }
+    } else {
+        const Chimera& chimera = chimeras_[parents_[molecule]];
+        if (read != nullptr) {
+            seqan::Dna5String left_barcode;
+            seqan::Dna5String right_barcode;
+            seqan::Dna5String right_read;
+            RestoreMolecule(chimera.left, left_barcode, read, chain);
+            resize(*read, length(*read) / 2);
+            RestoreMolecule(chimera.right, right_barcode, &right_read, chain);
+            append(*read, suffix(right_read, length(right_read) / 2));
+            barcode = chimera.barcode_from_left ? left_barcode : right_barcode;
+        } else {
+            RestoreMolecule(chimera.barcode_from_left ? chimera.left : chimera.right, barcode, nullptr, chain);
+        }
+    }
+    for (size_t i = chain.size(); i > chain_start; i --) {
+        ApplySubstitutions(chain[i - 1], barcode, read);
+    }
+    chain.resize(chain_start);
+    return original;
 }
 
-void PcrSimulator::UpdateReadIds() {
-    for (auto& read : amplified_reads_) {
-        std::stringstream ss;
-        ss << read.id << "_UMI:" << read.barcode;
-        read.id = seqan::CharString(ss.str());
+void PcrSimulator::FormatId(MoleculeIndex molecule, const seqan::Dna5String& barcode, std::string& id) const {
+    id.clear();
+    if (molecule < NumOriginals()) {
+        id += "original_";
+        AppendNumber(id, molecule);
+    } else if (flags_[molecule] & ChimericMolecule) {
+        const Chimera& chimera = chimeras_[parents_[molecule]];
+        AppendNumber(id, molecule);
+        id += "_chimera_from_";
+        AppendNumber(id, chimera.left);
+        id += "_";
+        AppendNumber(id, chimera.right);
+    } else {
+        AppendNumber(id, molecule);
+        if (flags_[molecule] & ChimericAncestry) {
+            id += "_chimera";
+        }
+        id += "_mutated_from_";
+        AppendNumber(id, parents_[molecule]);
+    }
+    id += "_UMI:";
+    for (size_t i = 0; i < length(barcode); i ++) {
+        id.push_back(static_cast<char>(barcode[i]));
     }
 }
 
-void PcrSimulator::WriteRepertoire(const std::string& path) {
+void PcrSimulator::WriteResults(const std::string& output_dir_path) const {
+    boost::filesystem::create_directory(output_dir_path);
+    WriteRepertoire(boost::filesystem::path(output_dir_path).append("amplified.fasta").string());
+    auto compressed_sizes = WriteRcms(boost::filesystem::path(output_dir_path).append("amplified_to_comp.rcm").string(),
+                                      boost::filesystem::path(output_dir_path).append("amplified_to_orig.rcm").string());
+    WriteCompressed(boost::filesystem::path(output_dir_path).append("repertoire_comp.fasta").string(), compressed_sizes);
+}
+
+void PcrSimulator::WriteRepertoire(const std::string& path) const {
+    const RandomPermutation perm(NumMolecules(), options_.random_seed);
+    std::vector<std::string> ids(std::min(OUTPUT_BLOCK_SIZE, NumMolecules()));
+    std::vector<seqan::Dna5String> reads(ids.size());
     seqan::SeqFileOut output_file(path.c_str());
-    for (size_t i = 0; i < amplified_reads_.size(); i ++) {
-        std::stringstream sstr;
-        seqan::writeRecord(output_file, amplified_reads_[perm_[i]].id, amplified_reads_[perm_[i]].read);
+    for (size_t block_start = 0; block_start < NumMolecules(); block_start += OUTPUT_BLOCK_SIZE) {
+        const size_t block_size = std::min(OUTPUT_BLOCK_SIZE, NumMolecules() - block_start);
+#pragma omp parallel
+        {
+            std::vector<MoleculeIndex> chain;
+            seqan::Dna5String barcode;
+#pragma omp for schedule(dynamic, 256)
+            for (size_t i = 0; i < block_size; i ++) {
+                const auto molecule = static_cast<MoleculeIndex>(perm[block_start + i]);
+                RestoreMolecule(molecule, barcode, &reads[i], chain);
+                FormatId(molecule, barcode, ids[i]);
+            }
+        }
+        for (size_t i = 0; i < block_size; i ++) {
+            seqan::writeRecord(output_file, ids[i], reads[i]);
+        }
     }
 }
 
-void PcrSimulator::WriteCompressed(const std::string& path) {
-    std::map<size_t, size_t> id_to_count;
-    for (size_t id : read_to_compressed_) {
-        id_to_count[id] ++;
+std::vector<size_t> PcrSimulator::WriteRcms(const std::string& comp_path, const std::string& orig_path) const {
+    std::vector<size_t> compressed_sizes(compressed_count_);
+    std::vector<std::string> ids(std::min(OUTPUT_BLOCK_SIZE, NumMolecules()));
+    std::vector<size_t> originals(ids.size());
+    std::ofstream comp_ofs(comp_path);
+    std::ofstream orig_ofs(orig_path);
+    for (size_t block_start = 0; block_start < NumMolecules(); block_start += OUTPUT_BLOCK_SIZE) {
+        const size_t block_size = std::min(OUTPUT_BLOCK_SIZE, NumMolecules() - block_start);
+#pragma omp parallel
+        {
+            std::vector<MoleculeIndex> chain;
+            seqan::Dna5String barcode;
+#pragma omp for schedule(dynamic, 256)
+            for (size_t i = 0; i < block_size; i ++) {
+                const auto molecule = static_cast<MoleculeIndex>(block_start + i);
+                originals[i] = RestoreMolecule(molecule, barcode, nullptr, chain);
+                FormatId(molecule, barcode, ids[i]);
+            }
+        }
+        for (size_t i = 0; i < block_size; i ++) {
+            const size_t compressed = originals[i] == MAP_NOWHERE ? MAP_NOWHERE : original_to_compressed_[originals[i]];
+            comp_ofs << ids[i];
+            if (compressed != MAP_NOWHERE) {
+                comp_ofs << "\t" << compressed;
+                compressed_sizes[compressed] ++;
+            }
+            comp_ofs << "\n";
+            orig_ofs << ids[i];
+            if (originals[i] != MAP_NOWHERE) {
+                orig_ofs << "\t" << originals[i];
+            }
+            orig_ofs << "\n";
+        }
     }
+    return compressed_sizes;
+}
 
+void PcrSimulator::WriteCompressed(const std::string& path, const std::vector<size_t>& compressed_sizes) const {
     std::vector<seqan::CharString> compressed_ids;
     std::vector<seqan::Dna5String> compressed_reads;
-    size_t current = 0;
     for (size_t i = 0; i < original_ids_.size(); i ++) {
-        read_to_compressed_.push_back(current);
         auto id = seqan_string_to_string(original_ids_[i]);
         if (boost::algorithm::ends_with(id, "_copy_1")) {
-            current ++;
-            compressed_ids.emplace_back((boost::format("cluster___%d___size___%d") % (current - 1) % id_to_count[current - 1]).str());
-            compressed_reads.push_back(amplified_reads_[i].read);
+            const size_t compressed = original_to_compressed_[i];
+            compressed_ids.emplace_back((boost::format("cluster___%d___size___%d") % compressed % compressed_sizes[compressed]).str());
+            compressed_reads.push_back(original_reads_[i]);
         }
     }
     seqan::SeqFileOut compressed_file(path.c_str());
     seqan::writeRecords(compressed_file, compressed_ids, compressed_reads);
 }
-
-void PcrSimulator::WriteRcm(const std::string& path, const std::vector<PcrSimulator::Record>& reads, const std::vector<size_t>& map) {
-    std::ofstream ofs(path);
-    for (size_t i = 0; i < reads.size(); i ++) {
-        ofs << reads[i].id;
-        if (map[i] != MAP_NOWHERE) {
-            ofs << "\t" << map[i];
-        }
-        ofs << "\n";
-    }
-}
@@ -1,54 +1,98 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 #include <seqan/file.h>
+#include "gtest/gtest_prod.h"
 #include "options.hpp"
 
+/*
+ * Molecules are stored in flat arrays: every amplified molecule refers to the molecule it was copied from
+ * and keeps only its own substitutions, chimeras refer to their left and right molecules.
+ * Reads and barcodes are restored from originals only at output time
+ */
 class PcrSimulator {
+    friend class PcrSimulatorTest;
+
 private:
-    static std::default_random_engine random_engine_;
+    typedef uint32_t MoleculeIndex;
+
+    enum MoleculeFlags : uint8_t { ChimericMolecule = 1, ChimericAncestry = 2 };
+
+    struct Chimera {
+        MoleculeIndex left;
+        MoleculeIndex right;
+        bool barcode_from_left;
+    };
 
-    struct Record {
-        seqan::CharString id;
-        const seqan::Dna5String read;
-        const seqan::Dna5String barcode;
-        const size_t error_count;
+    // molecules amplified on a single cycle from a block of molecules
+    struct AmplifiedBlock {
+        std::vector<MoleculeIndex> parents;
+        std::vector<uint32_t> error_counts;
+        std::vector<size_t> substitution_ends;
+        std::vector<uint32_t> substitutions;
+        size_t barcode_error_count;
 
-        Record(const seqan::CharString& id_, const seqan::Dna5String& read_, const seqan::Dna5String& barcode_, size_t error_count_) :
-                id(id_), read(read_), barcode(barcode_), error_count(error_count_) {}
+        AmplifiedBlock() : barcode_error_count(0) { }
     };
 
+    static const size_t AMPLIFICATION_BLOCK_SIZE = 1 << 14;
+    static const size_t OUTPUT_BLOCK_SIZE = 1 << 16;
+
     const Options::SimulationOptions options_;
     std::vector<seqan::CharString> original_ids_;
     std::vector<seqan::Dna5String> original_reads_;
-    std::vector<Record> amplified_reads_;
-    std::vector<size_t> perm_;
-    std::vector<size_t> read_to_compressed_;
-    std::vector<size_t> read_to_original_;
+    std::vector<seqan::Dna5String> original_barcodes_;
+    std::vector<size_t> original_to_compressed_;
+    size_t compressed_count_;
+
+    // parent of copied molecule, index in chimeras_ for chimeric molecule, itself for original molecule
+    std::vector<MoleculeIndex> parents_;
+    std::vector<uint8_t> flags_;
+    std::vector<uint32_t> read_lengths_;
+    // read errors accumulated from the original molecule, meaningless for molecules of chimeric ancestry
+    std::vector<uint32_t> error_counts_;
+    // substitutions of i-th molecule are substitutions_[substitution_offsets_[i], substitution_offsets_[i + 1])
+    std::vector<size_t> substitution_offsets_;
+    // position in concatenation of barcode and read << 2 | rank of new nucleotide among the other three
+    std::vector<uint32_t> substitutions_;
+    std::vector<Chimera> chimeras_;
     size_t barcode_error_count_;
 
 public:
-    static const size_t CHIMERIC_READ_ERROR_COUNT;
-
-    PcrSimulator(const Options::SimulationOptions& options) : options_(options) {
-        random_engine_.seed(8356);
-    };
+    PcrSimulator(const Options::SimulationOptions& options) : options_(options),
+                                                              compressed_count_(0),
+                                                              barcode_error_count_(0) { }
     void ReadRepertoire(const std::string& repertoire_file_path);
     void Amplify(size_t output_estimation_limit);
-    void WriteResults(const std::string& output_dir_path);
+    void WriteResults(const std::string& output_dir_path) const;
 
 private:
     static const size_t MAP_NOWHERE;
 
+    size_t NumOriginals() const { return original_reads_.size(); }
+    size_t NumMolecules() const { return parents_.size(); }
+    bool IsCopy(MoleculeIndex molecule) const {
+        return molecule >= NumOriginals() && !(flags_[molecule] & ChimericMolecule);
+    }
+
     void CheckLimit(size_t output_estimation_limit);
-    seqan::Dna5String GenerateBarcode();
-    void ReportAverageErrorRate();
+    seqan::Dna5String GenerateBarcode(size_t original_idx) const;
+    void AddOriginalMolecules();
+    void ReportAverageErrorRate() const;
     void SimulatePcr();
-    void AddRecord(const std::string& id, const seqan::Dna5String& read, const seqan::Dna5String& barcode, size_t error_count);
-    void AddChimericRecord(const std::string& id, const seqan::Dna5String& read, const seqan::Dna5String& barcode);
-    void AmplifySequences(double pcr_error_prob);
-    void UpdateReadIds();
-    void WriteRepertoire(const std::string& path);
-    void WriteCompressed(const std::string& path);
-    void WriteRcm(const std::string& path, const std::vector<Record>& reads, const std::vector<size_t>& map);
+    void AmplifyBlock(size_t cycle, double log_no_error_prob, size_t block_start, size_t block_end,
+                      AmplifiedBlock& block) const;
+    void AddAmplifiedBlock(const AmplifiedBlock& block);
+    void AddChimeras(size_t cycle, size_t size);
+    void AmplifySequences(size_t cycle, double pcr_error_prob);
+
+    void ApplySubstitutions(MoleculeIndex molecule, seqan::Dna5String& barcode, seqan::Dna5String* read) const;
+    size_t RestoreMolecule(MoleculeIndex molecule, seqan::Dna5String& barcode, seqan::Dna5String* read,
+                           std::vector<MoleculeIndex>& chain) const;
+    void FormatId(MoleculeIndex molecule, const seqan::Dna5String& barcode, std::string& id) const;
+
+    void WriteRepertoire(const std::string& path) const;
+    void WriteCompressed(const std::string& path, const std::vector<size_t>& compressed_sizes) const;
+    std::vector<size_t> WriteRcms(const std::string& comp_path, const std::string& orig_path) const;
 };
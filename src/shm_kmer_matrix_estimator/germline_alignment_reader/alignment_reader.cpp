@@ -38,27 +38,19 @@ VectorEvolutionaryEdgeAlignments AlignmentReader::read_alignments() const {
     std::string cdr_details_line;
     std::getline(cdr_details, cdr_details_line); // skip header
 
-    // v_alignments
-    std::vector<seqan::CharString> names;
-    std::vector<seqan::CharString> reads;
+    // v_alignments are streamed by pairs of records: read and germline
     seqan::SeqFileIn seqFileIn(alignments_filename_.c_str());
-    seqan::readRecords(names, reads, seqFileIn);
+    seqan::CharString read_name, read, germline_name, germline;
     VectorEvolutionaryEdgeAlignments alignments;
 
-    auto ReadIterator = reads.cbegin();
-    auto NamesIterator = names.cbegin();
-
-    while (ReadIterator != reads.cend()) {
+    while (not seqan::atEnd(seqFileIn)) {
         // Reading v_alignment
-        std::string read_seq = std::string(seqan::toCString(*ReadIterator));
-        ++ReadIterator;
-        ++NamesIterator;
-        VERIFY(ReadIterator != reads.cend());
-        VERIFY(NamesIterator != names.cend());
-        std::string germline_seq = std::string(seqan::toCString(*ReadIterator));
-        std::string gene_id = std::string(seqan::toCString(*NamesIterator));
-        ++ReadIterator;
-        ++NamesIterator;
+        seqan::readRecord(read_name, read, seqFileIn);
+        VERIFY_MSG(not seqan::atEnd(seqFileIn), "Germline record is missing for " << read_name);
+        seqan::readRecord(germline_name, germline, seqFileIn);
+        std::string read_seq = std::string(seqan::toCString(read));
+        std::string germline_seq = std::string(seqan::toCString(germline));
+        std::string gene_id = std::string(seqan::toCString(germline_name));
 
         // Reading cdr info
         std::getline(cdr_details, cdr_details_line);
@@ -9,6 +9,8 @@
 
 namespace shm_kmer_matrix_estimator {
 
+const size_t KmerUtils::INVALID_KMER_INDEX;
+
 size_t KmerUtils::GetIndexNucl(const char nucl) {
     return static_cast<size_t>(seqan::ordValue(static_cast<seqan::Dna>(nucl)));
 }
@@ -58,4 +60,25 @@ size_t KmerUtils::GetMutationIndexByKmerAndNucl(const std::string &kmer, const c
     return index_nucl - (index_nucl > index_center_kmer_nucl);
 }
 
+void KmerUtils::GetIndicesOfAllKmers(const std::string &seq, const size_t kmer_len, std::vector<size_t> &indices) {
+    indices.clear();
+    if (seq.size() < kmer_len)
+        return;
+    indices.reserve(seq.size() - kmer_len + 1);
+    const size_t mask = (size_t(1) << (2 * kmer_len)) - 1;
+    size_t index_kmer = 0;
+    // number of nucleotides since the last N
+    size_t valid_len = 0;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        if (seq[i] == 'N') {
+            valid_len = 0;
+        } else {
+            ++valid_len;
+        }
+        index_kmer = ((index_kmer << 2) | GetIndexNucl(seq[i])) & mask;
+        if (i + 1 >= kmer_len)
+            indices.push_back(valid_len >= kmer_len ? index_kmer : INVALID_KMER_INDEX);
+    }
+}
+
 } // End namespace shm_kmer_matrix_estimator
@@ -22,6 +22,11 @@ public:
     static size_t GetIndexByKmer(const std::string& kmer);
     static std::vector<std::string> GenerateAllKmersFixedLength(const size_t kmer_len);
     static size_t GetMutationIndexByKmerAndNucl(const std::string& kmer, const char nucl);
+
+    static const size_t INVALID_KMER_INDEX = size_t(-1);
+    // Indices (as GetIndexByKmer) of all kmers of seq computed by rolling 2-bit encoding:
+    // i-th element corresponds to kmer starting at i, kmers containing N get INVALID_KMER_INDEX.
+    static void GetIndicesOfAllKmers(const std::string& seq, const size_t kmer_len, std::vector<size_t>& indices);
 };
 
 } // End namespace shm_kmer_matrix_estimator
\ No newline at end of file
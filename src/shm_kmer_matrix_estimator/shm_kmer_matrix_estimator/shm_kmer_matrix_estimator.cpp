@@ -2,6 +2,8 @@
 // Created by Andrew Bzikadze on 5/24/16.
 //
 
+#include <omp.h>
+
 #include "mutation_strategies/trivial_strategy.hpp"
 #include "mutation_strategies/no_k_neighbours.hpp"
 #include "alignment_checker/no_gaps_alignment_checker.hpp"
@@ -35,69 +37,110 @@ ShmKmerMatrixEstimator::ShmKmerMatrixEstimator(const shm_kmer_matrix_estimator_c
 
 void ShmKmerMatrixEstimator::calculate_mutation_statistics_per_position(KmerMatrix &mutations_statistics,
                                                                      const size_t center_nucl_pos,
-                                                                     const EvolutionaryEdgeAlignment &alignment) const {
-    std::string gene_substring = alignment.parent().substr(center_nucl_pos - kmer_len_ / 2, kmer_len_);
-    if ((alignment.son()[center_nucl_pos] == 'N') ||
-        (gene_substring.find_first_of('N') != std::string::npos)) {
+                                                                     const EvolutionaryEdgeAlignment &alignment,
+                                                                     const std::vector<size_t> &parent_kmer_indices) const {
+    size_t kmer_index = parent_kmer_indices[center_nucl_pos - kmer_len_ / 2];
+    if ((alignment.son()[center_nucl_pos] == 'N') || (kmer_index == KmerUtils::INVALID_KMER_INDEX)) {
         return;
     }
     size_t position = seqan::ordValue(static_cast<seqan::Dna>(alignment.son()[center_nucl_pos]));
-    mutations_statistics.at(gene_substring).at(position)++;
+    mutations_statistics.at(kmer_index).at(position)++;
 }
 
+void ShmKmerMatrixEstimator::calculate_mutation_statistics_per_alignment(KmerMatrix &mutations_statistics_fr,
+                                                                      KmerMatrix &mutations_statistics_cdr,
+                                                                      EvolutionaryEdgeAlignment &alignment,
+                                                                      std::vector<size_t> &parent_kmer_indices) const {
+    if (not alignment_checker_->check(alignment))
+        return;
 
-std::pair<KmerMatrix, KmerMatrix>
-ShmKmerMatrixEstimator::calculate_mutation_statistics(
-        const annotation_utils::AnnotatedCloneSet<annotation_utils::AnnotatedClone>& clone_set) const
-{
-    VectorEvolutionaryEdgeAlignments alignments;
-    for (const auto& clone : clone_set) {
-        if (not clone.RegionIsEmpty(annotation_utils::StructuralRegion::CDR1) and
-            not clone.RegionIsEmpty(annotation_utils::StructuralRegion::CDR2))
-        {
-            alignments.emplace_back(clone);
-        }
+    alignment_cropper_->crop(alignment);
+
+    std::vector<size_t> relevant_positions = mutation_strategy_->calculate_relevant_positions(alignment);
+    KmerUtils::GetIndicesOfAllKmers(alignment.parent(), kmer_len_, parent_kmer_indices);
+    size_t i = 0;
+
+    while (i < relevant_positions.size() and relevant_positions[i] < alignment.cdr1_start()) {
+        calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment,
+                                                   parent_kmer_indices);
+        i++;
+    }
+    while (i < relevant_positions.size() and relevant_positions[i] <= alignment.cdr1_end()) {
+        calculate_mutation_statistics_per_position(mutations_statistics_cdr, relevant_positions[i], alignment,
+                                                   parent_kmer_indices);
+        i++;
+    }
+    while (i < relevant_positions.size() and relevant_positions[i] < alignment.cdr2_start()) {
+        calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment,
+                                                   parent_kmer_indices);
+        i++;
+    }
+    while (i < relevant_positions.size() and relevant_positions[i] <= alignment.cdr2_end()) {
+        calculate_mutation_statistics_per_position(mutations_statistics_cdr, relevant_positions[i], alignment,
+                                                   parent_kmer_indices);
+        i++;
+    }
+    while (i < relevant_positions.size()) {
+        calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment,
+                                                   parent_kmer_indices);
+        i++;
     }
-    return calculate_mutation_statistics(alignments);
 }
 
 
+template <typename ItemProcessor>
 std::pair<KmerMatrix, KmerMatrix>
-ShmKmerMatrixEstimator::calculate_mutation_statistics(VectorEvolutionaryEdgeAlignments &alignments) const {
+ShmKmerMatrixEstimator::accumulate_mutation_statistics(size_t num_items, const ItemProcessor &process_item) const {
     size_t kmer_matrix_size = static_cast<size_t>(pow(4., kmer_len_));
-    KmerMatrix mutations_statistics_fr(kmer_matrix_size);
-    KmerMatrix mutations_statistics_cdr(kmer_matrix_size);
-    for (auto alignment : alignments) {
-        if (not alignment_checker_->check(alignment))
-            continue;
-
-        alignment_cropper_->crop(alignment);
-
-        std::vector<size_t> relevant_positions = mutation_strategy_->calculate_relevant_positions(alignment);
-        size_t i = 0;
+    const size_t num_threads = omp_in_parallel() ? 1 : static_cast<size_t>(omp_get_max_threads());
+    std::vector<KmerMatrix> statistics_fr(num_threads, KmerMatrix(kmer_matrix_size));
+    std::vector<KmerMatrix> statistics_cdr(num_threads, KmerMatrix(kmer_matrix_size));
+#pragma omp parallel num_threads(num_threads)
+    {
+        size_t thread_id = omp_get_thread_num();
+        std::vector<size_t> parent_kmer_indices;
+#pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < num_items; ++i)
+            process_item(i, statistics_fr[thread_id], statistics_cdr[thread_id], parent_kmer_indices);
+    }
 
-        while (i < relevant_positions.size() and relevant_positions[i] < alignment.cdr1_start()) {
-            calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment);
-            i++;
-        }
-        while (i < relevant_positions.size() and relevant_positions[i] <= alignment.cdr1_end()) {
-            calculate_mutation_statistics_per_position(mutations_statistics_cdr, relevant_positions[i], alignment);
-            i++;
-        }
-        while (i < relevant_positions.size() and relevant_positions[i] < alignment.cdr2_start()) {
-            calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment);
-            i++;
-        }
-        while (i < relevant_positions.size() and relevant_positions[i] <= alignment.cdr2_end()) {
-            calculate_mutation_statistics_per_position(mutations_statistics_cdr, relevant_positions[i], alignment);
-            i++;
-        }
-        while (i < relevant_positions.size()) {
-            calculate_mutation_statistics_per_position(mutations_statistics_fr, relevant_positions[i], alignment);
-            i++;
+    for (size_t thread_id = 1; thread_id < num_threads; ++thread_id) {
+        for (size_t i = 0; i < kmer_matrix_size; ++i) {
+            for (size_t j = 0; j < statistics_fr[0][i].size(); ++j) {
+                statistics_fr[0][i][j] += statistics_fr[thread_id][i][j];
+                statistics_cdr[0][i][j] += statistics_cdr[thread_id][i][j];
+            }
         }
     }
-    return std::make_pair(mutations_statistics_fr, mutations_statistics_cdr);
+    return std::make_pair(std::move(statistics_fr[0]), std::move(statistics_cdr[0]));
+}
+
+
+std::pair<KmerMatrix, KmerMatrix>
+ShmKmerMatrixEstimator::calculate_mutation_statistics(
+        const annotation_utils::AnnotatedCloneSet<annotation_utils::AnnotatedClone>& clone_set) const
+{
+    return accumulate_mutation_statistics(clone_set.size(),
+        [this, &clone_set](size_t i, KmerMatrix &statistics_fr, KmerMatrix &statistics_cdr,
+                           std::vector<size_t> &parent_kmer_indices) {
+            const auto& clone = clone_set[i];
+            if (clone.RegionIsEmpty(annotation_utils::StructuralRegion::CDR1) or
+                clone.RegionIsEmpty(annotation_utils::StructuralRegion::CDR2))
+                return;
+            EvolutionaryEdgeAlignment alignment(clone);
+            calculate_mutation_statistics_per_alignment(statistics_fr, statistics_cdr, alignment, parent_kmer_indices);
+        });
+}
+
+
+std::pair<KmerMatrix, KmerMatrix>
+ShmKmerMatrixEstimator::calculate_mutation_statistics(VectorEvolutionaryEdgeAlignments &alignments) const {
+    return accumulate_mutation_statistics(alignments.size(),
+        [this, &alignments](size_t i, KmerMatrix &statistics_fr, KmerMatrix &statistics_cdr,
+                            std::vector<size_t> &parent_kmer_indices) {
+            calculate_mutation_statistics_per_alignment(statistics_fr, statistics_cdr, alignments[i],
+                                                        parent_kmer_indices);
+        });
 }
 
 } // End namespace shm_kmer_matrix_estimator
@@ -26,7 +26,20 @@ private:
 private:
     void calculate_mutation_statistics_per_position(KmerMatrix &mutations_statistics,
                                                     const size_t center_nucl_pos,
-                                                    const EvolutionaryEdgeAlignment &) const;
+                                                    const EvolutionaryEdgeAlignment &,
+                                                    const std::vector<size_t> &parent_kmer_indices) const;
+
+    // kmer indices of parent are a buffer reused between alignments
+    void calculate_mutation_statistics_per_alignment(KmerMatrix &mutations_statistics_fr,
+                                                     KmerMatrix &mutations_statistics_cdr,
+                                                     EvolutionaryEdgeAlignment &,
+                                                     std::vector<size_t> &parent_kmer_indices) const;
+
+    // Items are processed in parallel by process_item(i, statistics_fr, statistics_cdr, parent_kmer_indices),
+    // each thread accumulates its own matrices that are summed up at the end.
+    template <typename ItemProcessor>
+    std::pair<KmerMatrix, KmerMatrix>
+    accumulate_mutation_statistics(size_t num_items, const ItemProcessor &process_item) const;
 
 public:
     explicit ShmKmerMatrixEstimator(const shm_kmer_matrix_estimator_config::mutations_strategy_params &shm_config_ms,
@@ -34,6 +47,7 @@ public:
                                     const shm_kmer_matrix_estimator_config::alignment_cropper_params &shm_config_acp);
 
 
+    // alignments are checked and cropped in place
     std::pair<KmerMatrix, KmerMatrix>
     calculate_mutation_statistics(VectorEvolutionaryEdgeAlignments &) const;
 
@@ -2,6 +2,7 @@
 #include <logger/log_writers.hpp>
 
 #include <sstream>
+#include <random>
 
 #include <cdr_config.hpp>
 #include <germline_utils/germline_db_generator.hpp>
@@ -14,7 +15,9 @@
 #include "shm_model_utils/shm_model.hpp"
 #include "mutation_strategies/no_k_neighbours.hpp"
 #include "evolutionary_graph_utils/evolutionary_edge/base_evolutionary_edge.hpp"
+#include "evolutionary_graph_utils/evolutionary_edge_constructor.hpp"
 #include "shm_model_utils/shm_model_edge_weight_calculator.hpp"
+#include "tree_archive.hpp"
 
 void create_console_logger() {
     using namespace logging;
@@ -190,3 +193,225 @@ TEST_F(AntEvoloTest, ShmModelEdgeWeightCalculator) {
     };
     double_eq(weight, -21.132585490945221);
 }
+
+TEST(TreeArchive, RoundTrip) {
+    const std::string archive_dir = "test_tree_archive";
+    path::make_dir(archive_dir);
+    std::vector<std::string> names = { "clonal_tree_1-0-0_Vsize_2_Esize_1.tree", "clonal_tree_2-0-0_Vsize_1_Esize_0.tree" };
+    std::vector<TreeSectionRecords> records = { { { "edges_1\n", "vertices_1\nvertices_1\n", "shms_1\n" } },
+                                                { { "", "vertices_2\n", "" } } };
+    {
+        TreeArchiveWriter writer(archive_dir);
+        for (size_t i = 0; i < names.size(); ++i) {
+            writer.AddTree(names[i], records[i]);
+        }
+    }
+    TreeArchiveReader reader(archive_dir);
+    ASSERT_EQ(names.size(), reader.size());
+    EXPECT_EQ(1u, reader.FindTree("2"));
+    EXPECT_EQ(1u, reader.FindTree(names[1]));
+    EXPECT_EQ(reader.size(), reader.FindTree("3"));
+    EXPECT_EQ(reader.size(), reader.FindTree("unknown_tree"));
+    for (size_t i = 0; i < names.size(); ++i) {
+        EXPECT_EQ(names[i], reader[i].tree_name);
+        EXPECT_EQ(records[i][TreeEdgesSection], reader.ReadSection(i, TreeEdgesSection));
+        EXPECT_EQ(records[i][TreeVerticesSection], reader.ReadSection(i, TreeVerticesSection));
+        EXPECT_EQ(records[i][TreeSHMsSection], reader.ReadSection(i, TreeSHMsSection));
+    }
+    path::remove_dir(archive_dir);
+}
+
+class EdgeClassificationTest : public ::testing::Test {
+public:
+    void SetUp() {
+        create_console_logger();
+    }
+
+    // mutation of gene position: substitution to one of two nucleotides (0, 1), deletion (2) or nothing,
+    // followed by nucleotides inserted after the position
+    typedef std::vector<std::pair<size_t, std::string>> SegmentMutations;
+
+    // nucleotides are taken from small alphabets to make coincidences of SHMs frequent
+    static void MutatePosition(std::mt19937 &random, SegmentMutations &mutations, size_t gene_pos) {
+        mutations[gene_pos].first = random() % 6;
+        mutations[gene_pos].second.clear();
+        if (random() % 4 == 0) {
+            for (size_t block_size = 1 + random() % 2; block_size > 0; block_size--)
+                mutations[gene_pos].second.push_back("AC"[random() % 2]);
+        }
+    }
+
+    static annotation_utils::GeneSegmentSHMs CreateSHMs(const germline_utils::ImmuneGene &gene,
+                                                        germline_utils::SegmentType segment_type,
+                                                        const SegmentMutations &mutations) {
+        annotation_utils::GeneSegmentSHMs shms(core::Read(), gene);
+        size_t read_pos = 0;
+        for (size_t gene_pos = 0; gene_pos < mutations.size(); gene_pos++) {
+            char gene_nucl = "ACGT"[gene_pos % 4];
+            size_t mutation = mutations[gene_pos].first;
+            if (mutation == 0 || mutation == 1) {
+                char read_nucl = "ACGT"[(gene_pos + 1 + mutation) % 4];
+                shms.AddSHM(annotation_utils::SHM(segment_type, gene_pos, read_pos, gene_nucl, read_nucl, 'X', 'X'));
+            }
+            else if (mutation == 2) {
+                shms.AddSHM(annotation_utils::SHM(segment_type, gene_pos, read_pos, gene_nucl, '-', 'X', '-'));
+                continue;
+            }
+            read_pos++;
+            for (char read_nucl : mutations[gene_pos].second) {
+                shms.AddSHM(annotation_utils::SHM(segment_type, gene_pos, read_pos, '-', read_nucl, '-', 'X'));
+                read_pos++;
+            }
+        }
+        return shms;
+    }
+
+    // classification of the former VJEvolutionaryEdgeConstructor::ConstructEdge on SHMComparator,
+    // lengths are computed as in the former edge classes
+    static EvolutionaryEdgeInfo ClassifyBySHMComparator(const annotation_utils::GeneSegmentSHMs &src_v_shms,
+                                                        const annotation_utils::GeneSegmentSHMs &src_j_shms,
+                                                        const annotation_utils::GeneSegmentSHMs &dst_v_shms,
+                                                        const annotation_utils::GeneSegmentSHMs &dst_j_shms,
+                                                        size_t cdr3_distance,
+                                                        size_t min_num_intersected_v_shms,
+                                                        size_t &length) {
+        using annotation_utils::SHMComparator;
+        EvolutionaryEdgeInfo edge_info;
+        length = size_t(-1);
+        if (!(SHMComparator::SHMsInsertionBlocksAreEqual(src_v_shms, dst_v_shms) &&
+              SHMComparator::SHMsInsertionBlocksAreEqual(src_j_shms, dst_j_shms))) {
+            return edge_info;
+        }
+        size_t src_num_shms = src_v_shms.size() + src_j_shms.size();
+        size_t dst_num_shms = dst_v_shms.size() + dst_j_shms.size();
+        if (SHMComparator::SHMsAreEqual(src_v_shms, dst_v_shms) && SHMComparator::SHMsAreEqual(src_j_shms, dst_j_shms)) {
+            edge_info.edge_type = EvolutionaryEdgeType::UndirectedEdgeType;
+            length = cdr3_distance;
+            return edge_info;
+        }
+        if (SHMComparator::SHMs1AreNestedInSHMs2(src_v_shms, dst_v_shms) &&
+            SHMComparator::SHMs1AreNestedInSHMs2(src_j_shms, dst_j_shms)) {
+            edge_info.edge_type = EvolutionaryEdgeType::DirectedEdgeType;
+            edge_info.num_individual_v_shms = dst_v_shms.size() - src_v_shms.size();
+            edge_info.num_individual_j_shms = dst_j_shms.size() - src_j_shms.size();
+            length = dst_num_shms - src_num_shms + cdr3_distance;
+            return edge_info;
+        }
+        if (SHMComparator::SHMs1AreNestedInSHMs2(dst_v_shms, src_v_shms) &&
+            SHMComparator::SHMs1AreNestedInSHMs2(dst_j_shms, src_j_shms)) {
+            edge_info.edge_type = EvolutionaryEdgeType::ReverseDirectedEdgeType;
+            edge_info.num_individual_v_shms = src_v_shms.size() - dst_v_shms.size();
+            edge_info.num_individual_j_shms = src_j_shms.size() - dst_j_shms.size();
+            length = (src_num_shms - dst_num_shms + cdr3_distance) * 5;
+            return edge_info;
+        }
+        size_t num_intersected_v_shms = SHMComparator::GetNumberOfIntersections(src_v_shms, dst_v_shms);
+        size_t num_individual_v_shms = src_v_shms.size() + dst_v_shms.size() - 2 * num_intersected_v_shms;
+        size_t num_intersected_j_shms = SHMComparator::GetNumberOfIntersections(src_j_shms, dst_j_shms);
+        size_t num_individual_j_shms = src_j_shms.size() + dst_j_shms.size() - 2 * num_intersected_j_shms;
+        size_t num_shared_shms = num_intersected_v_shms + num_intersected_j_shms;
+        if (num_shared_shms >= min_num_intersected_v_shms &&
+            2 * num_individual_v_shms <= num_shared_shms * min_num_intersected_v_shms) {
+            edge_info.edge_type = EvolutionaryEdgeType::IntersectedEdgeType;
+            edge_info.num_individual_v_shms = num_individual_v_shms;
+            edge_info.num_intersected_v_shms = num_intersected_v_shms;
+            edge_info.num_individual_j_shms = num_individual_j_shms;
+            edge_info.num_intersected_j_shms = num_intersected_j_shms;
+            edge_info.double_mutated =
+                    SHMComparator::IndividualSHMsAreIdenticallyPositioned(src_v_shms, dst_v_shms) &&
+                    SHMComparator::IndividualSHMsAreIdenticallyPositioned(src_j_shms, dst_j_shms);
+            length = cdr3_distance + num_individual_v_shms + num_individual_v_shms;
+        }
+        return edge_info;
+    }
+};
+
+TEST_F(EdgeClassificationTest, CompactSHMsCoincideWithSHMComparator) {
+    using annotation_utils::SHMComparator;
+    std::mt19937 random(8356);
+    germline_utils::ImmuneGene gene;
+    std::vector<std::pair<SegmentMutations, SegmentMutations>> clone_mutations;
+    std::vector<std::pair<annotation_utils::GeneSegmentSHMs, annotation_utils::GeneSegmentSHMs>> clone_shms;
+    std::vector<CompactClone> clones;
+    for (size_t i = 0; i < 150; i++) {
+        // a clone either is random or differs from one of the previous clones in a single position
+        if (i == 0 || random() % 2 == 0) {
+            clone_mutations.emplace_back(SegmentMutations(8), SegmentMutations(3));
+            for (size_t gene_pos = 0; gene_pos < 8; gene_pos++)
+                MutatePosition(random, clone_mutations.back().first, gene_pos);
+            for (size_t gene_pos = 0; gene_pos < 3; gene_pos++)
+                MutatePosition(random, clone_mutations.back().second, gene_pos);
+        }
+        else {
+            clone_mutations.push_back(clone_mutations[random() % clone_mutations.size()]);
+            if (random() % 4 == 0)
+                MutatePosition(random, clone_mutations.back().second, random() % 3);
+            else
+                MutatePosition(random, clone_mutations.back().first, random() % 8);
+        }
+        clone_shms.emplace_back(CreateSHMs(gene, germline_utils::SegmentType::VariableSegment,
+                                           clone_mutations.back().first),
+                                CreateSHMs(gene, germline_utils::SegmentType::JoinSegment,
+                                           clone_mutations.back().second));
+        CompactClone clone;
+        clone.v_shms = CompactSHMs(clone_shms.back().first);
+        clone.j_shms = CompactSHMs(clone_shms.back().second);
+        for (size_t j = 0; j < 6; j++)
+            seqan::appendValue(clone.cdr3, "AC"[random() % 2]);
+        clones.push_back(clone);
+    }
+
+    std::vector<size_t> num_edges_by_type(5);
+    size_t num_double_mutated_edges = 0;
+    for (size_t min_num_intersected_v_shms = 1; min_num_intersected_v_shms <= 3; min_num_intersected_v_shms++) {
+        AntEvoloConfig::AlgorithmParams::EdgeConstructionParams params;
+        params.min_num_intersected_v_shms = min_num_intersected_v_shms;
+        params.intersected_edge_coeff = 0;
+        VJEvolutionaryEdgeConstructor edge_constructor(params);
+        for (size_t src = 0; src < clones.size(); src++) {
+            for (size_t dst = 0; dst < clones.size(); dst++) {
+                const auto &src_shms = clone_shms[src];
+                const auto &dst_shms = clone_shms[dst];
+                for (auto segments : { std::make_pair(&src_shms.first, &dst_shms.first),
+                                       std::make_pair(&src_shms.second, &dst_shms.second) }) {
+                    const annotation_utils::GeneSegmentSHMs &shms1 = *segments.first;
+                    const annotation_utils::GeneSegmentSHMs &shms2 = *segments.second;
+                    CompactSHMs compact1(shms1);
+                    CompactSHMs compact2(shms2);
+                    ASSERT_EQ(SHMComparator::SHMsAreEqual(shms1, shms2), compact1 == compact2);
+                    ASSERT_EQ(SHMComparator::SHMs1AreNestedInSHMs2(shms1, shms2),
+                              CompactSHMs::SHMs1AreNestedInSHMs2(compact1, compact2));
+                    ASSERT_EQ(SHMComparator::SHMsInsertionBlocksAreEqual(shms1, shms2),
+                              CompactSHMs::InsertionBlocksAreEqual(compact1, compact2));
+                    ASSERT_EQ(SHMComparator::GetNumberOfIntersections(shms1, shms2),
+                              CompactSHMs::GetNumberOfIntersections(compact1, compact2));
+                    ASSERT_EQ(SHMComparator::IndividualSHMsAreIdenticallyPositioned(shms1, shms2),
+                              CompactSHMs::IndividualSHMsAreIdenticallyPositioned(compact1, compact2));
+                }
+
+                size_t cdr3_distance = HammingDistance(clones[src].cdr3, clones[dst].cdr3);
+                size_t expected_length;
+                auto expected = ClassifyBySHMComparator(src_shms.first, src_shms.second,
+                                                        dst_shms.first, dst_shms.second,
+                                                        cdr3_distance, min_num_intersected_v_shms, expected_length);
+                auto edge_info = edge_constructor.ComputeEdgeInfo(clones[src], clones[dst], src, dst);
+                ASSERT_EQ(expected.edge_type, edge_info.edge_type) << "clones " << src << " and " << dst;
+                ASSERT_EQ(src, edge_info.SrcNum());
+                ASSERT_EQ(dst, edge_info.DstNum());
+                ASSERT_EQ(cdr3_distance, edge_info.cdr3_distance);
+                ASSERT_EQ(expected_length, edge_info.Length()) << "clones " << src << " and " << dst;
+                ASSERT_EQ(expected.IsDoubleMutated(), edge_info.IsDoubleMutated());
+                if (!expected.Empty() && !expected.IsUndirected()) {
+                    ASSERT_EQ(expected.num_individual_v_shms, edge_info.num_individual_v_shms);
+                    ASSERT_EQ(expected.num_individual_j_shms, edge_info.num_individual_j_shms);
+                }
+                num_edges_by_type[edge_info.edge_type]++;
+                num_double_mutated_edges += edge_info.IsDoubleMutated();
+            }
+        }
+    }
+    // every type of edges is checked
+    for (size_t edge_type = 0; edge_type < num_edges_by_type.size(); edge_type++)
+        ASSERT_GT(num_edges_by_type[edge_type], 0u) << "edge type " << edge_type;
+    ASSERT_GT(num_double_mutated_edges, 0u);
+}
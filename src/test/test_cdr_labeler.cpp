@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <logger/log_writers.hpp>
 
+#include <chrono>
+#include <random>
 #include <sstream>
 
 #include <cdr_config.hpp>
@@ -125,3 +127,61 @@ TEST_F(CDRLabelerTest, ReadCDRsAreIgBlastConsistent) {
     CheckFirstAnnotatedClone(annotated_clone_set);
     CheckSecondAnnotatedClone(annotated_clone_set);
 }
+
+core::ReadArchive SimulateVJRepertoire(size_t num_reads, size_t seed) {
+    std::mt19937 random_engine(seed);
+    std::uniform_int_distribution<size_t> v_distribution(0, filtered_v_db.size() - 1);
+    std::uniform_int_distribution<size_t> j_distribution(0, filtered_j_db.size() - 1);
+    std::uniform_int_distribution<size_t> insertion_distribution(3, 15);
+    std::uniform_int_distribution<size_t> nucl_distribution(0, 3);
+    std::bernoulli_distribution shm_distribution(0.02);
+    core::ReadArchive read_archive;
+    for(size_t i = 0; i < num_reads; i++) {
+        seqan::Dna5String read = filtered_v_db[v_distribution(random_engine)].seq();
+        for(size_t pos = 0; pos < seqan::length(read); pos++)
+            if(shm_distribution(random_engine))
+                read[pos] = (seqan::ordValue(read[pos]) + 1 + nucl_distribution(random_engine) % 3) % 4;
+        size_t insertion_length = insertion_distribution(random_engine);
+        for(size_t pos = 0; pos < insertion_length; pos++)
+            seqan::appendValue(read, seqan::Dna5(nucl_distribution(random_engine)));
+        seqan::append(read, filtered_j_db[j_distribution(random_engine)].seq());
+        read_archive.AddRead("simulated_read_" + std::to_string(i), read);
+    }
+    return read_archive;
+}
+
+TEST_F(CDRLabelerTest, AnnotatedCloneSetDoesNotDependOnNumberOfThreads) {
+    using namespace cdr_labeler;
+    auto v_labeling = GermlineDbLabeler(filtered_v_db, config.cdrs_params).ComputeLabeling();
+    auto j_labeling = GermlineDbLabeler(filtered_j_db, config.cdrs_params).ComputeLabeling();
+    auto labeled_v_db = v_labeling.CreateFilteredDb();
+    auto labeled_j_db = j_labeling.CreateFilteredDb();
+    core::ReadArchive read_archive = SimulateVJRepertoire(2000, 1234);
+    vj_finder::VJParallelProcessor processor(read_archive, config.vj_finder_config.algorithm_params,
+                                             labeled_v_db, labeled_j_db, 4);
+    vj_finder::VJAlignmentInfo alignment_info = processor.Process();
+    ASSERT_GT(alignment_info.NumVJHits(), 0);
+    ReadCDRLabeler read_labeler(config.shm_params, v_labeling, j_labeling);
+    // the first run is not timed, it warms up caches
+    auto single_thread_set = read_labeler.CreateAnnotatedCloneSet(alignment_info, 1);
+    double single_thread_time = 0;
+    for(size_t num_threads : {1, 2, 4, 8}) {
+        auto start = std::chrono::steady_clock::now();
+        auto clone_set = read_labeler.CreateAnnotatedCloneSet(alignment_info, num_threads);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(num_threads == 1)
+            single_thread_time = time;
+        INFO(num_threads << " threads: " << clone_set.size() << " clones in " << time << " s, speedup " <<
+             single_thread_time / time);
+        ASSERT_EQ(clone_set.size(), alignment_info.NumVJHits());
+        for(size_t i = 0; i < clone_set.size(); i++) {
+            ASSERT_EQ(clone_set[i].Read().name, alignment_info.GetVJHitsByIndex(i).Read().name);
+            ASSERT_EQ(core::seqan_string_to_string(clone_set[i].CDR3()),
+                      core::seqan_string_to_string(single_thread_set[i].CDR3()));
+            ASSERT_EQ(core::seqan_string_to_string(clone_set[i].AA()),
+                      core::seqan_string_to_string(single_thread_set[i].AA()));
+            ASSERT_EQ(clone_set[i].VSHMs().size(), single_thread_set[i].VSHMs().size());
+            ASSERT_EQ(clone_set[i].JSHMs().size(), single_thread_set[i].JSHMs().size());
+        }
+    }
+}
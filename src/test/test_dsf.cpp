@@ -9,6 +9,7 @@
 #include "../dense_sgraph_finder/graph_decomposer/dense_subgraph_constructor.hpp"
 #include "../dense_sgraph_finder/dsf_config.hpp"
 #include "../graph_utils/graph_io.hpp"
+#include "../graph_utils/graph_splitter.hpp"
 
 void create_console_logger() {
     using namespace logging;
@@ -32,6 +33,7 @@ dsf_config::metis_io_params CreateStandardMetisParams(std::string output_dir) {
     metis_params.path_to_metis = "build/release/bin/";
     metis_params.run_metis = path::append_path(metis_params.path_to_metis, "./metis");
     metis_params.trash_output = path::append_path(output_dir, "metis.output");
+    metis_params.run_in_process = true;
     return metis_params;
 }
 
@@ -82,3 +84,40 @@ TEST_F(DsfTest, TestSupernodesAreSeparated) {
     }
     INFO("Each dense subgraph contains at most one supernode");
 }
+
+// decompose connected components in several threads: METIS orderings are computed concurrently
+// check that decompositions coincide with ones constructed in a single thread
+TEST_F(DsfTest, TestParallelDecompositionOfComponents) {
+    dsf_config::dense_sgraph_finder_params dsf_params = CreateStandardDsfParams();
+    auto metis_io_params = CreateStandardMetisParams(output_dir);
+    std::vector<SparseGraphPtr> components = ConnectedComponentGraphSplitter(test_graph).Split();
+    std::vector<SparseGraphPtr> graphs;
+    // each component is decomposed several times to run more METIS orderings at once
+    for(size_t i = 0; i < 4; i++)
+        for(auto it = components.begin(); it != components.end(); it++)
+            if((*it)->N() >= dsf_params.min_graph_size)
+                graphs.push_back(*it);
+    ASSERT_GT(graphs.size(), 4u);
+
+    auto decompose = [&](size_t index) {
+        dense_subgraph_finder::MetisDenseSubgraphConstructor dsf_constructor(
+                dsf_params,
+                metis_io_params,
+                path::append_path(output_dir, "component_" + std::to_string(index) + ".graph"));
+        return dsf_constructor.CreateDecomposition(graphs[index]);
+    };
+    std::vector<DecompositionPtr> serial_decompositions(graphs.size());
+    for(size_t i = 0; i < graphs.size(); i++)
+        serial_decompositions[i] = decompose(i);
+    std::vector<DecompositionPtr> parallel_decompositions(graphs.size());
+#pragma omp parallel for schedule(dynamic) num_threads(4)
+    for(size_t i = 0; i < graphs.size(); i++)
+        parallel_decompositions[i] = decompose(i);
+
+    for(size_t i = 0; i < graphs.size(); i++) {
+        ASSERT_EQ(serial_decompositions[i]->Size(), parallel_decompositions[i]->Size());
+        for(size_t v = 0; v < graphs[i]->N(); v++)
+            ASSERT_EQ(serial_decompositions[i]->GetVertexClass(v), parallel_decompositions[i]->GetVertexClass(v));
+    }
+    INFO(graphs.size() << " decompositions constructed in parallel coincide with sequential ones");
+}
@@ -23,6 +23,10 @@
 #include "annotation_utils/cdr_labeling_primitives.hpp"
 #include "base_repertoire/productivity_checker/productivity_checker.hpp"
 #include "annotation_utils/aa_annotation/aa_calculator.hpp"
+#include "base_repertoire/base_repertoire_simulator.hpp"
+#include "clonal_trees/tree_creator/forest_storage_creator.hpp"
+#include "clonal_trees/tree/node_sequence_cache.hpp"
+#include "clonal_trees/tree/tree_archive.hpp"
 
 #include <chrono>
 #include <random_generator.hpp>
@@ -299,4 +303,138 @@ TEST_F(IgSimulatorTest, ProductiveChecker) {
     }
 }
 
+TEST_F(IgSimulatorTest, DeltaEncodedTreeSequences) {
+    const std::string nucls = "ACGT";
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<size_t> nucl_distr(0, 3);
+    std::string root_sequence;
+    while (root_sequence.size() < 300) {
+        std::string codon;
+        for (size_t i = 0; i < 3; ++i) {
+            codon.push_back(nucls[nucl_distr(generator)]);
+        }
+        if (codon != "TAG" and codon != "TAA" and codon != "TGA") {
+            root_sequence += codon;
+        }
+    }
+    root_sequence.push_back('A');
+
+    std::vector<Node> nodes(1);
+    std::vector<std::string> sequences { root_sequence };
+    std::uniform_int_distribution<size_t> pos_distr(0, root_sequence.size() - 1);
+    for (size_t i = 1; i < 2000; ++i) {
+        size_t parent_ind = std::uniform_int_distribution<size_t>(0, i - 1)(generator);
+        while (FastStopCodonChecker::HasStopCodon(sequences[parent_ind], 0)) {
+            parent_ind = nodes[parent_ind].ParentInd();
+        }
+        std::string sequence = sequences[parent_ind];
+        Node::SHM_Vector shms;
+        for (size_t j = 0; j < 3; ++j) {
+            uint32_t pos = static_cast<uint32_t>(pos_distr(generator));
+            if (std::find_if(shms.begin(), shms.end(),
+                             [pos](const std::tuple<uint32_t, seqan::Dna5, seqan::Dna>& shm) {
+                                 return std::get<0>(shm) == pos;
+                             }) != shms.end()) {
+                continue;
+            }
+            char new_nucl = nucls[(nucls.find(sequence[pos]) + 1 + nucl_distr(generator) % 3) % 4];
+            shms.emplace_back(pos, seqan::Dna5(sequence[pos]), seqan::Dna(new_nucl));
+            sequence[pos] = new_nucl;
+        }
+        ASSERT_EQ(FastStopCodonChecker::HasStopCodon(sequences[parent_ind], shms, 0),
+                  FastStopCodonChecker::HasStopCodon(sequence, 0));
+        nodes.emplace_back(parent_ind, std::move(shms));
+        sequences.emplace_back(std::move(sequence));
+    }
+
+    NodeSequenceCache sequence_cache(root_sequence, nodes, 4);
+    for (size_t i = 0; i < 5000; ++i) {
+        size_t node_ind = i < nodes.size() ? i : std::uniform_int_distribution<size_t>(0, nodes.size() - 1)(generator);
+        ASSERT_EQ(sequence_cache.Sequence(node_ind), sequences[node_ind]);
+    }
+}
+
+TEST_F(IgSimulatorTest, TreeArchiveRoundTrip) {
+    std::mt19937 generator(11);
+    std::vector<std::vector<Node>> trees;
+    for (size_t i = 0; i < 20; ++i) {
+        std::vector<Node> nodes;
+        nodes.emplace_back(size_t(-1), Node::SHM_Vector(), i % 2 == 0, i % 3 != 0);
+        for (size_t j = 1; j < 1 + i * 10; ++j) {
+            Node::SHM_Vector shms;
+            for (size_t k = 0; k < j % 4; ++k) {
+                shms.emplace_back(static_cast<uint32_t>(generator() % 100000),
+                                  seqan::Dna5(generator() % 5), seqan::Dna(generator() % 4));
+            }
+            nodes.emplace_back(generator() % j, std::move(shms), generator() % 2, generator() % 2);
+        }
+        trees.emplace_back(std::move(nodes));
+    }
+
+    const std::string archive_fname = "test_ig_simulator_trees.archive";
+    {
+        TreeArchiveWriter writer(archive_fname);
+        for (size_t i = 0; i < trees.size(); ++i) {
+            writer.AddTree(i / 3, i % 3, EncodeTree(i % 5 != 0, trees[i]));
+        }
+    }
+    TreeArchiveReader reader(archive_fname);
+    ASSERT_EQ(reader.size(), trees.size());
+    for (size_t i = 0; i < trees.size(); ++i) {
+        std::string tree_name = "forest_" + std::to_string(i / 3) + "_tree_" + std::to_string(i % 3);
+        ASSERT_EQ(reader.FindTree(tree_name), i);
+        ASSERT_EQ(reader.FindTree(std::to_string(i)), i);
+        ArchivedTree archived_tree = reader.ReadTree(i);
+        ASSERT_EQ(archived_tree.metaroot_productive, i % 5 != 0);
+        std::stringstream expected_dot, dot;
+        PrintTreeDot(expected_dot, i % 5 != 0, trees[i]);
+        PrintTreeDot(dot, archived_tree.metaroot_productive, archived_tree.nodes);
+        ASSERT_EQ(dot.str(), expected_dot.str());
+    }
+    ASSERT_EQ(reader.FindTree("forest_7_tree_0"), reader.size());
+    ASSERT_EQ(reader.FindTree(std::to_string(trees.size())), reader.size());
+    std::remove(archive_fname.c_str());
+}
+
+TEST_F(IgSimulatorTest, SimulationDoesNotDependOnNumberOfThreads) {
+    std::vector<germline_utils::CustomGeneDatabase> db;
+    db.emplace_back(std::move(v_db));
+    db.emplace_back(std::move(d_db));
+    db.emplace_back(std::move(j_db));
+
+    const auto& base_repertoire_params = config.simulation_params.base_repertoire_params;
+    auto tree_params = config.simulation_params.clonal_tree_simulator_params;
+    tree_params.tree_size_generator_params.method = TreeSizeGeneratorParams::TreeSizeGeneratorMethod::Uniform;
+    tree_params.tree_size_generator_params.uniform_params.low = 10;
+    tree_params.tree_size_generator_params.uniform_params.high = 50;
+    const auto& vjf_config = base_repertoire_params.metaroot_simulation_params.cdr_labeler_config.vj_finder_config;
+    const uint64_t seed = 17;
+    const size_t num_metaroots = 50;
+
+    std::vector<BaseRepertoire> repertoires;
+    std::vector<ForestStorage> forest_storages;
+    for (int num_threads : { 1, 4 }) {
+        omp_set_num_threads(num_threads);
+        BaseRepertoireSimulator simulator(base_repertoire_params, germline_utils::ChainType("IGH"), db, seed);
+        repertoires.emplace_back(simulator.Simulate(num_metaroots));
+        ForestStorageCreator forest_storage_creator(vjf_config, tree_params, seed);
+        forest_storages.emplace_back(forest_storage_creator.GenerateForest<UniformPoolManager>(repertoires.back()));
+    }
+    omp_set_num_threads(1);
+
+    for (size_t i = 0; i < num_metaroots; ++i) {
+        ASSERT_EQ(repertoires[0][i].MetarootPtr()->Sequence(), repertoires[1][i].MetarootPtr()->Sequence());
+        ASSERT_EQ(repertoires[0][i].Multiplicity(), repertoires[1][i].Multiplicity());
+        const auto& trees1 = forest_storages[0][i].Trees();
+        const auto& trees2 = forest_storages[1][i].Trees();
+        ASSERT_EQ(trees1.size(), trees2.size());
+        for (size_t j = 0; j < trees1.size(); ++j) {
+            ASSERT_EQ(trees1[j].Size(), trees2[j].Size());
+            for (size_t k = 0; k < trees1[j].Size(); ++k) {
+                ASSERT_EQ(trees1[j].Sequence(k), trees2[j].Sequence(k));
+            }
+        }
+    }
+}
+
 } // End namespace ig_simulator
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <logger/log_writers.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "../paired_read_merger/reads_merger.hpp"
+
+void create_console_logger() {
+    using namespace logging;
+    logger *lg = create_logger("");
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+class PairedReadsMergerTest: public ::testing::Test {
+public:
+    void SetUp() {
+        create_console_logger();
+        work_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("reads_merger_%%%%-%%%%");
+        boost::filesystem::create_directories(work_dir);
+    }
+
+    void TearDown() {
+        boost::filesystem::remove_all(work_dir);
+    }
+
+    // merging as it was done before chunks: all pairs are loaded and merged one by one
+    static size_t MergeSerially(const merger_setting& setting, const std::string& left_fname,
+                                const std::string& right_fname, const std::string& output_fname) {
+        std::vector<FastqRead> left_reads = SingleFastqReader(left_fname).ReadFile();
+        std::vector<FastqRead> right_reads = SingleFastqReader(right_fname).ReadFile();
+        EXPECT_EQ(left_reads.size(), right_reads.size());
+        SequenceMerger seq_merger(setting);
+        std::vector<FastqRead> merged_reads;
+        for (size_t i = 0; i < left_reads.size(); i ++) {
+            FastqRead merged_read = seq_merger.Merge(i, PairedFastqRead(left_reads[i], right_reads[i]));
+            if (!merged_read.is_empty())
+                merged_reads.push_back(merged_read);
+        }
+        FastqWriter(output_fname).Write(merged_reads);
+        return merged_reads.size();
+    }
+
+    static std::string ReadFile(const boost::filesystem::path& path) {
+        std::ifstream in(path.string());
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    boost::filesystem::path work_dir;
+};
+
+TEST_F(PairedReadsMergerTest, ChunkedMergingCoincidesWithSerial) {
+    const std::string left_fname = "test_dataset/1.fq";
+    const std::string right_fname = "test_dataset/2.fq";
+    merger_setting setting;
+    const boost::filesystem::path serial_output = work_dir / "serial.fastq";
+    const size_t num_merged_reads = MergeSerially(setting, left_fname, right_fname, serial_output.string());
+    const std::string expected_output = ReadFile(serial_output);
+    ASSERT_GT(num_merged_reads, 0u);
+
+    // 1000 pairs: several chunks, the last one is incomplete
+    setting.chunk_size = 64;
+    for (size_t threads : {1, 4}) {
+        setting.num_threads = threads;
+        const boost::filesystem::path output = work_dir / ("merged_" + std::to_string(threads) + ".fastq");
+        std::pair<size_t, size_t> merge_stats;
+        {
+            FastqWriter writer(output.string());
+            merge_stats = PairedReadsMerger(setting).Merge(left_fname, right_fname, writer);
+        }
+        ASSERT_EQ(1000u, merge_stats.first);
+        ASSERT_EQ(num_merged_reads, merge_stats.second);
+        ASSERT_TRUE(expected_output == ReadFile(output)) << "merged reads differ for " << threads << " threads";
+    }
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <logger/log_writers.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "../pcr_simulator/pcr_simulator.hpp"
+#include "../pcr_simulator/counter_random.hpp"
+#include "../ig_tools/utils/string_tools.hpp"
+
+void create_console_logger() {
+    using namespace logging;
+    logger *lg = create_logger("");
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+class PcrSimulatorTest: public ::testing::Test {
+public:
+    typedef PcrSimulator::MoleculeIndex MoleculeIndex;
+
+    void SetUp() {
+        create_console_logger();
+        work_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("pcr_simulator_%%%%-%%%%");
+        boost::filesystem::create_directories(work_dir);
+    }
+
+    void TearDown() {
+        boost::filesystem::remove_all(work_dir);
+    }
+
+    static Options::SimulationOptions CreateOptions(size_t barcode_length) {
+        Options::SimulationOptions options;
+        options.cycles_count = 10;
+        options.error_prob_first = 0.002;
+        options.error_prob_last = 0.004;
+        options.amplification_rate = 0.8;
+        options.chimeras_rate = 0.01;
+        options.barcode_position = 3;
+        options.barcode_length = barcode_length;
+        options.random_seed = 8356;
+        return options;
+    }
+
+    static void SetOriginals(PcrSimulator& simulator, const std::vector<std::string>& reads,
+                             const std::vector<std::string>& barcodes) {
+        for (size_t i = 0; i < reads.size(); i ++) {
+            simulator.original_ids_.push_back(seqan::CharString("read_" + std::to_string(i) + "_copy_1"));
+            simulator.original_reads_.push_back(seqan::Dna5String(reads[i]));
+            simulator.original_barcodes_.push_back(seqan::Dna5String(barcodes[i]));
+        }
+        simulator.AddOriginalMolecules();
+    }
+
+    // substitution of nucleotide at position in concatenation of barcode and read
+    static uint32_t Substitution(size_t pos, char from, char to) {
+        const unsigned from_rank = seqan::ordValue(seqan::Dna5(from));
+        const unsigned to_rank = seqan::ordValue(seqan::Dna5(to));
+        return static_cast<uint32_t>(pos << 2 | (to_rank - (to_rank > from_rank ? 1 : 0)));
+    }
+
+    static MoleculeIndex AddCopy(PcrSimulator& simulator, MoleculeIndex parent, const std::vector<uint32_t>& substitutions) {
+        PcrSimulator::AmplifiedBlock block;
+        block.parents.push_back(parent);
+        block.error_counts.push_back(0);
+        block.substitutions = substitutions;
+        block.substitution_ends.push_back(substitutions.size());
+        simulator.AddAmplifiedBlock(block);
+        return static_cast<MoleculeIndex>(simulator.NumMolecules() - 1);
+    }
+
+    static MoleculeIndex AddChimera(PcrSimulator& simulator, MoleculeIndex left, MoleculeIndex right, bool barcode_from_left) {
+        simulator.parents_.push_back(static_cast<MoleculeIndex>(simulator.chimeras_.size()));
+        simulator.flags_.push_back(PcrSimulator::ChimericMolecule | PcrSimulator::ChimericAncestry);
+        simulator.read_lengths_.push_back(simulator.read_lengths_[left] / 2 +
+                                          (simulator.read_lengths_[right] - simulator.read_lengths_[right] / 2));
+        simulator.error_counts_.push_back(0);
+        simulator.substitution_offsets_.push_back(simulator.substitutions_.size());
+        simulator.chimeras_.push_back({left, right, barcode_from_left});
+        return static_cast<MoleculeIndex>(simulator.NumMolecules() - 1);
+    }
+
+    // returns "barcode read" of restored molecule
+    static std::string Restore(const PcrSimulator& simulator, MoleculeIndex molecule, size_t& original) {
+        std::vector<MoleculeIndex> chain;
+        seqan::Dna5String barcode;
+        seqan::Dna5String read;
+        original = simulator.RestoreMolecule(molecule, barcode, &read, chain);
+        EXPECT_TRUE(chain.empty());
+
+        seqan::Dna5String barcode_only;
+        EXPECT_EQ(original, simulator.RestoreMolecule(molecule, barcode_only, nullptr, chain));
+        EXPECT_EQ(seqan_string_to_string(barcode), seqan_string_to_string(barcode_only));
+        return seqan_string_to_string(barcode) + " " + seqan_string_to_string(read);
+    }
+
+    static size_t MapNowhere() { return PcrSimulator::MAP_NOWHERE; }
+    static size_t OutputBlockSize() { return PcrSimulator::OUTPUT_BLOCK_SIZE; }
+    static size_t NumMolecules(const PcrSimulator& simulator) { return simulator.NumMolecules(); }
+    static size_t NumChimeras(const PcrSimulator& simulator) { return simulator.chimeras_.size(); }
+
+    void WriteRepertoire(const std::string& path, size_t reads_count, size_t read_length) const {
+        std::ofstream out(path);
+        CounterRandomStream stream(1, CounterStreamType::BarcodeStream, 0, 0);
+        for (size_t i = 0; i < reads_count; i ++) {
+            out << ">antibody_" << i / 3 << "_copy_" << i % 3 + 1 << "\n";
+            for (size_t j = 0; j < read_length; j ++) {
+                out << "ACGT"[stream.NextIndex(4)];
+            }
+            out << "\n";
+        }
+    }
+
+    static std::string ReadFile(const boost::filesystem::path& path) {
+        std::ifstream in(path.string());
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    boost::filesystem::path work_dir;
+};
+
+TEST_F(PcrSimulatorTest, RestoresMutatedMolecules) {
+    PcrSimulator simulator(CreateOptions(4));
+    SetOriginals(simulator, {"ACGTACGTAC", "GGGGCCCTT"}, {"AAAA", "CCCC"});
+
+    // barcode A -> G at 1, read T -> C at 3
+    const MoleculeIndex copy = AddCopy(simulator, 0, {Substitution(1, 'A', 'G'), Substitution(4 + 3, 'T', 'C')});
+    // read A -> T at 0, the last nucleotide of read C -> A
+    const MoleculeIndex copy_of_copy = AddCopy(simulator, copy, {Substitution(4, 'A', 'T'), Substitution(4 + 9, 'C', 'A')});
+    const MoleculeIndex copy_of_other = AddCopy(simulator, 1, {Substitution(3, 'C', 'T')});
+
+    size_t original;
+    ASSERT_EQ("AAAA ACGTACGTAC", Restore(simulator, 0, original));
+    ASSERT_EQ(0u, original);
+    ASSERT_EQ("AGAA ACGCACGTAC", Restore(simulator, copy, original));
+    ASSERT_EQ(0u, original);
+    ASSERT_EQ("AGAA TCGCACGTAA", Restore(simulator, copy_of_copy, original));
+    ASSERT_EQ(0u, original);
+    ASSERT_EQ("CCCT GGGGCCCTT", Restore(simulator, copy_of_other, original));
+    ASSERT_EQ(1u, original);
+}
+
+TEST_F(PcrSimulatorTest, RestoresChimericMolecules) {
+    PcrSimulator simulator(CreateOptions(4));
+    SetOriginals(simulator, {"ACGTACGTAC", "GGGGCCCTT"}, {"AAAA", "CCCC"});
+
+    const MoleculeIndex copy = AddCopy(simulator, 0, {Substitution(1, 'A', 'G'), Substitution(4 + 3, 'T', 'C')});
+    const MoleculeIndex copy_of_other = AddCopy(simulator, 1, {Substitution(3, 'C', 'T'), Substitution(4 + 8, 'T', 'G')});
+    // ACGCA + CCCTG, barcode from the right molecule
+    const MoleculeIndex chimera = AddChimera(simulator, copy, copy_of_other, false);
+    // GGGG + CGTAC, barcode from the left molecule
+    const MoleculeIndex reversed_chimera = AddChimera(simulator, 1, 0, true);
+    // barcode C -> A at 0, read G -> T at 9
+    const MoleculeIndex copy_of_chimera = AddCopy(simulator, chimera, {Substitution(0, 'C', 'A'), Substitution(4 + 9, 'G', 'T')});
+    // ACGCA + CGTAC, barcode from the left molecule
+    const MoleculeIndex chimera_of_chimeras = AddChimera(simulator, chimera, reversed_chimera, true);
+
+    size_t original;
+    ASSERT_EQ("CCCT ACGCACCCTG", Restore(simulator, chimera, original));
+    ASSERT_EQ(MapNowhere(), original);
+    ASSERT_EQ("CCCC GGGGCGTAC", Restore(simulator, reversed_chimera, original));
+    ASSERT_EQ(MapNowhere(), original);
+    ASSERT_EQ("ACCT ACGCACCCTT", Restore(simulator, copy_of_chimera, original));
+    ASSERT_EQ(MapNowhere(), original);
+    ASSERT_EQ("CCCT ACGCACGTAC", Restore(simulator, chimera_of_chimeras, original));
+    ASSERT_EQ(MapNowhere(), original);
+}
+
+TEST_F(PcrSimulatorTest, RandomPermutationIsBijection) {
+    for (size_t size : {1, 2, 3, 5, 7, 15, 16, 17, 63, 65, 100, 1000, 4095, 4097, 100003}) {
+        for (uint64_t seed : {0, 1, 8356}) {
+            const RandomPermutation perm(size, seed);
+            ASSERT_EQ(size, perm.size());
+            std::vector<char> seen(size);
+            for (size_t i = 0; i < size; i ++) {
+                const size_t value = perm[i];
+                ASSERT_LT(value, size) << "size " << size << ", seed " << seed;
+                ASSERT_FALSE(seen[value]) << "size " << size << ", seed " << seed;
+                seen[value] = true;
+            }
+        }
+    }
+}
+
+TEST_F(PcrSimulatorTest, ResultsDoNotDependOnNumberOfThreads) {
+    const std::string repertoire_path = (work_dir / "repertoire.fasta").string();
+    // about 1.5 * 10^5 molecules: several amplification and output blocks
+    WriteRepertoire(repertoire_path, 400, 60);
+    const std::vector<std::string> output_files = {"amplified.fasta", "amplified_to_comp.rcm",
+                                                   "amplified_to_orig.rcm", "repertoire_comp.fasta"};
+
+    const int max_threads = omp_get_max_threads();
+    std::vector<std::string> first_outputs;
+    for (int threads : {1, 4}) {
+        omp_set_num_threads(threads);
+        PcrSimulator simulator(CreateOptions(12));
+        simulator.ReadRepertoire(repertoire_path);
+        simulator.Amplify(static_cast<size_t>(1e6));
+        ASSERT_GT(NumMolecules(simulator), 2 * OutputBlockSize());
+        ASSERT_GT(NumChimeras(simulator), 0u);
+        const boost::filesystem::path output_dir = work_dir / ("output_" + std::to_string(threads));
+        simulator.WriteResults(output_dir.string());
+        for (size_t i = 0; i < output_files.size(); i ++) {
+            const std::string output = ReadFile(output_dir / output_files[i]);
+            ASSERT_FALSE(output.empty()) << output_files[i];
+            if (first_outputs.size() < output_files.size()) {
+                first_outputs.push_back(output);
+            } else {
+                ASSERT_TRUE(first_outputs[i] == output) << output_files[i] << " differs for " << threads << " threads";
+            }
+        }
+    }
+    omp_set_num_threads(max_threads);
+}
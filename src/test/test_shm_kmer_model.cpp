@@ -13,6 +13,7 @@
 #include "germline_alignment_reader/alignment_reader.hpp"
 #include "mutation_strategies/trivial_strategy.hpp"
 #include "mutation_strategies/no_k_neighbours.hpp"
+#include "shm_kmer_matrix_estimator/shm_kmer_matrix_estimator.hpp"
 
 using namespace shm_kmer_matrix_estimator;
 
@@ -276,3 +277,71 @@ TEST_F(MutationStrategiesTest, CheckNoKNeighbour) {
         EXPECT_THAT(rel_pos, testing::ElementsAre(6, 9, 12, 13, 14, 15, 16, 17, 20, 23));
     }
 }
+
+class KmerUtilsTest: public ::testing::Test {
+public:
+    void SetUp() { create_console_logger(); }
+};
+
+TEST_F(KmerUtilsTest, RollingIndicesAreCorrect) {
+    std::string seq = "ACGTTGCANGTACCGTAGGNNACGTAC";
+    const size_t kmer_len = 5;
+    std::vector<size_t> indices;
+    KmerUtils::GetIndicesOfAllKmers(seq, kmer_len, indices);
+    ASSERT_EQ(indices.size(), seq.size() - kmer_len + 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        std::string kmer = seq.substr(i, kmer_len);
+        if (kmer.find('N') != std::string::npos)
+            ASSERT_EQ(indices[i], KmerUtils::INVALID_KMER_INDEX);
+        else
+            ASSERT_EQ(indices[i], KmerUtils::GetIndexByKmer(kmer));
+    }
+    KmerUtils::GetIndicesOfAllKmers("ACG", kmer_len, indices);
+    ASSERT_TRUE(indices.empty());
+}
+
+class ShmKmerMatrixEstimatorTest: public ::testing::Test {
+public:
+    void SetUp() { create_console_logger(); }
+};
+
+TEST_F(ShmKmerMatrixEstimatorTest, StatisticsMatchKmerCounting) {
+    shm_kmer_matrix_estimator_config shm_config;
+    std::string config = "configs/shm_kmer_matrix_estimator/config.info";
+    load(shm_config, config);
+
+    AlignmentReader alignment_reader(shm_config.io.input.v_alignments,
+                                     shm_config.io.input.cdr_details,
+                                     shm_config.achp,
+                                     shm_config.acrp);
+    auto alignments = alignment_reader.read_alignments();
+
+    // straightforward counting over substrings of the same relevant positions
+    const size_t kmer_len = shm_config.mfp.kmer_len;
+    const size_t kmer_matrix_size = static_cast<size_t>(pow(4., kmer_len));
+    KmerMatrix expected_fr(kmer_matrix_size), expected_cdr(kmer_matrix_size);
+    NoKNeighboursMutationStrategy ms_nkn(shm_config.mfp);
+    for (auto alignment : alignments) {
+        for (size_t pos : ms_nkn.calculate_relevant_positions(alignment)) {
+            std::string kmer = alignment.parent().substr(pos - kmer_len / 2, kmer_len);
+            if (alignment.son()[pos] == 'N' or kmer.find('N') != std::string::npos)
+                continue;
+            bool is_cdr = (pos >= alignment.cdr1_start() and pos <= alignment.cdr1_end()) or
+                          (pos >= alignment.cdr2_start() and pos <= alignment.cdr2_end());
+            (is_cdr ? expected_cdr : expected_fr).at(kmer).at(KmerUtils::GetIndexNucl(alignment.son()[pos]))++;
+        }
+    }
+
+    ShmKmerMatrixEstimator estimator(shm_config.mfp, shm_config.achp, shm_config.acrp);
+    KmerMatrix statistics_fr, statistics_cdr;
+    std::tie(statistics_fr, statistics_cdr) = estimator.calculate_mutation_statistics(alignments);
+    ASSERT_EQ(statistics_fr.size(), kmer_matrix_size);
+    size_t total = 0;
+    for (size_t i = 0; i < kmer_matrix_size; ++i) {
+        ASSERT_EQ(statistics_fr[i], expected_fr[i]);
+        ASSERT_EQ(statistics_cdr[i], expected_cdr[i]);
+        for (size_t j = 0; j < statistics_fr[i].size(); ++j)
+            total += statistics_fr[i][j] + statistics_cdr[i][j];
+    }
+    ASSERT_GT(total, 0);
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <logger/log_writers.hpp>
+#include <set>
+#include <tuple>
 #include "../graph_utils/sparse_graph.hpp"
+#include "../graph_utils/graph_splitter.hpp"
+#include "../graph_utils/decomposition.hpp"
+#include "../graph_utils/graph_io.hpp"
 
 struct GraphPair {
     std::vector<std::vector<bool> > matrix_;
@@ -28,6 +33,33 @@ struct GraphPair {
     }
 };
 
+std::vector<size_t> Dists(const CrsMatrix &matrix) {
+    std::vector<size_t> dists;
+    for (size_t k = 0; k < matrix.NZ(); k ++) {
+        dists.push_back(matrix.Dist(k));
+    }
+    return dists;
+}
+
+// edges of upper triangle sorted by rows, columns & weights: some rows are empty, some edges are repeated
+std::vector<GraphEdge> RandomEdges(size_t size, size_t num_edges, size_t max_weight) {
+    std::vector<std::tuple<size_t, size_t, size_t> > entries;
+    for (size_t k = 0; size > 1 && k < num_edges; k ++) {
+        size_t i = rand() % (size / 2);
+        size_t j = i + 1 + rand() % (size - i - 1);
+        entries.push_back(std::make_tuple(i, j, 1 + rand() % max_weight));
+        if (rand() % 5 == 0) {
+            entries.push_back(entries.back());
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+    std::vector<GraphEdge> edges;
+    for (const auto &entry : entries) {
+        edges.push_back(GraphEdge(std::get<0>(entry), std::get<1>(entry), std::get<2>(entry)));
+    }
+    return edges;
+}
+
 class SparseGraphTestFixture : public ::testing::Test {
 public:
     void SetUp();
@@ -91,6 +123,171 @@ TEST_F(SparseGraphTestFixture, TestIterateEdges) {
     }
 }
 
+TEST_F(SparseGraphTestFixture, TestConnectedComponentMap) {
+    for (auto graph : graphs) {
+        auto components = ConnectedComponentGraphSplitter(graph.sparse_).Split();
+        GraphComponentMap &component_map = graph.sparse_->GetGraphComponentMap();
+        ASSERT_EQ(components.size(), component_map.SubgraphIds().size());
+        ASSERT_EQ(graph.matrix_.size(), component_map.OldVerticesList().size());
+        size_t num_vertices = 0;
+        for (size_t i = 0; i < components.size(); i ++) {
+            num_vertices += components[i]->N();
+            for (size_t j = 0; j < components[i]->N(); j ++) {
+                size_t old_vertex = component_map.GetOldVertexByNewVertex(i, j);
+                ASSERT_EQ(i, component_map.GetSubgraphIdByOldVertex(old_vertex));
+                ASSERT_EQ(j, component_map.GetNewVertexByOldVertex(old_vertex));
+                for (size_t k = 0; k < components[i]->N(); k ++) {
+                    ASSERT_EQ(graph.matrix_[old_vertex][component_map.GetOldVertexByNewVertex(i, k)],
+                              components[i]->HasEdge(j, k));
+                }
+            }
+        }
+        ASSERT_EQ(graph.matrix_.size(), num_vertices);
+    }
+}
+
+TEST_F(SparseGraphTestFixture, TestMetisRoundTrip) {
+    const std::string filename = "test_sparse_graph.graph";
+    for (auto graph : graphs) {
+        GraphWriter(filename).PrintGraph(graph.sparse_);
+        auto read_graph = GraphReader(filename).CreateGraph();
+        ASSERT_EQ(graph.sparse_->N(), read_graph->N());
+        ASSERT_EQ(graph.sparse_->RowIndex(), read_graph->RowIndex());
+        ASSERT_EQ(graph.sparse_->Col(), read_graph->Col());
+        ASSERT_EQ(Dists(*graph.sparse_->DirectMatrix()), Dists(*read_graph->DirectMatrix()));
+        ASSERT_EQ(graph.sparse_->Weight(), read_graph->Weight());
+    }
+    std::remove(filename.c_str());
+}
+
+TEST(GraphReaderTest, TestMetisFormats) {
+    const std::string filename = "test_graph_formats.graph";
+    // isolated vertices are empty lines, separators are spaces, tabs & CR
+    std::ofstream(filename) << "4 2\n2\t3 \r\n1\n1\n\n";
+    auto unweighted = GraphReader(filename).CreateGraph();
+    ASSERT_EQ(4u, unweighted->N());
+    ASSERT_EQ(2u, unweighted->NZ());
+    ASSERT_TRUE(unweighted->HasEdge(0, 2));
+    ASSERT_FALSE(unweighted->HasEdge(2, 3));
+
+    std::ofstream(filename) << "3 2 001\n2 4 3 1\n1 4\n1 1";
+    auto edge_weighted = GraphReader(filename).CreateGraph();
+    ASSERT_EQ(std::vector<CrsColumn>({ 1, 2 }), edge_weighted->Col());
+    ASSERT_EQ(std::vector<size_t>({ 4, 1 }), Dists(*edge_weighted->DirectMatrix()));
+
+    // empty lines of vertex weighted graphs are skipped
+    std::ofstream(filename) << "3 1 011\n5 3 2\n\n7\n1 1 2\n";
+    auto vertex_weighted = GraphReader(filename).CreateGraph();
+    ASSERT_EQ(std::vector<size_t>({ 5, 7, 1 }), vertex_weighted->Weight());
+    ASSERT_EQ(std::vector<size_t>({ 0, 1, 1, 1 }), vertex_weighted->RowIndex());
+    ASSERT_EQ(std::vector<size_t>({ 2 }), Dists(*vertex_weighted->DirectMatrix()));
+    std::remove(filename.c_str());
+}
+
+TEST(GraphReaderTest, TestWideEdgeWeights) {
+    // weights that do not fit in CrsDist are kept in CrsWideDist
+    for (const std::string filename : { "test_wide_weights.graph", "test_wide_weights.igb" }) {
+        std::vector<GraphEdge> edges = { GraphEdge(0, 1, 300), GraphEdge(0, 2, 1), GraphEdge(1, 2, 70000) };
+        GraphWriter(filename).PrintGraph(SparseGraphPtr(new SparseGraph(3, edges)));
+        auto graph = GraphReader(filename).CreateGraph();
+        ASSERT_TRUE(graph->DirectMatrix()->WideDist());
+        ASSERT_TRUE(graph->TransposedMatrix()->WideDist());
+        ASSERT_EQ(std::vector<size_t>({ 300, 1, 70000 }), Dists(*graph->DirectMatrix()));
+        ASSERT_EQ(std::vector<size_t>({ 300, 1, 70000 }), Dists(*graph->TransposedMatrix()));
+        auto subgraph = graph->GetSubgraph(0, { 1, 2 });
+        ASSERT_EQ(std::vector<size_t>({ 70000 }), Dists(*subgraph->DirectMatrix()));
+        std::remove(filename.c_str());
+    }
+
+    std::vector<GraphEdge> edges = { GraphEdge(0, 1, 255), GraphEdge(0, 2, 1) };
+    ASSERT_FALSE(CrsMatrix(3, edges).WideDist());
+}
+
+TEST(CrsMatrixTest, TestTransposeTwice) {
+    srand(935486);
+    for (size_t max_weight : { 3, 1000 }) {
+        for (size_t size : { 0, 1, 2, 10, 100, 1000 }) {
+            std::vector<GraphEdge> edges = RandomEdges(size, 3 * size, max_weight);
+            CrsMatrix matrix(size, edges);
+            bool wide_dist = false;
+            for (const auto &edge : edges) {
+                wide_dist = wide_dist || edge.dist > MAX_CRS_DIST;
+            }
+            ASSERT_EQ(wide_dist, matrix.WideDist());
+            auto trans_matrix = matrix.Transpose();
+            auto matrix_copy = trans_matrix->Transpose();
+            ASSERT_EQ(matrix.N(), matrix_copy->N());
+            ASSERT_EQ(matrix.NZ(), matrix_copy->NZ());
+            ASSERT_EQ(matrix.RowIndex(), matrix_copy->RowIndex());
+            ASSERT_EQ(matrix.Col(), matrix_copy->Col());
+            ASSERT_EQ(Dists(matrix), Dists(*matrix_copy));
+            ASSERT_EQ(wide_dist, matrix_copy->WideDist());
+        }
+    }
+}
+
+TEST(CrsMatrixTest, TestEmptyRows) {
+    SparseGraph graph(5, { GraphEdge(1, 3, 2), GraphEdge(1, 4, 1) });
+    ASSERT_EQ(std::vector<size_t>({ 0, 0, 2, 2, 2, 2 }), graph.RowIndex());
+    ASSERT_EQ(std::vector<size_t>({ 0, 0, 0, 0, 1, 2 }), graph.RowIndexT());
+    ASSERT_EQ(std::vector<CrsColumn>({ 1, 1 }), graph.ColT());
+    ASSERT_EQ(std::vector<size_t>({ 2, 1 }), Dists(*graph.TransposedMatrix()));
+    ASSERT_TRUE(graph.VertexIsIsolated(0));
+    ASSERT_TRUE(graph.VertexIsIsolated(2));
+    ASSERT_EQ(0u, graph.Degree(2));
+    ASSERT_EQ(1u, graph.Degree(3));
+
+    SparseGraph empty_graph(3, std::vector<GraphEdge>());
+    ASSERT_EQ(0u, empty_graph.NZ());
+    ASSERT_EQ(std::vector<size_t>({ 0, 0, 0, 0 }), empty_graph.RowIndexT());
+    for (size_t i = 0; i < empty_graph.N(); i ++) {
+        ASSERT_TRUE(empty_graph.VertexIsIsolated(i));
+    }
+}
+
+TEST(CrsMatrixTest, TestDuplicateEdges) {
+    // rows of transposed matrix are sorted by columns & weights
+    SparseGraph graph(3, { GraphEdge(0, 2, 5), GraphEdge(0, 2, 1), GraphEdge(0, 1, 3), GraphEdge(1, 2, 4) });
+    ASSERT_EQ(4u, graph.NZ());
+    ASSERT_EQ(std::vector<size_t>({ 0, 0, 1, 4 }), graph.RowIndexT());
+    ASSERT_EQ(std::vector<CrsColumn>({ 0, 0, 0, 1 }), graph.ColT());
+    ASSERT_EQ(std::vector<size_t>({ 3, 1, 5, 4 }), Dists(*graph.TransposedMatrix()));
+    ASSERT_EQ(3u, graph.Degree(2));
+
+    auto matrix_copy = graph.TransposedMatrix()->Transpose();
+    ASSERT_EQ(std::vector<size_t>({ 0, 3, 4, 4 }), matrix_copy->RowIndex());
+    ASSERT_EQ(std::vector<CrsColumn>({ 1, 2, 2, 2 }), matrix_copy->Col());
+    ASSERT_EQ(std::vector<size_t>({ 3, 1, 5, 4 }), Dists(*matrix_copy));
+}
+
+TEST(DecompositionTest, TestClassesMatchVertexClasses) {
+    const size_t num_vertices = 1000;
+    Decomposition decomposition(num_vertices);
+    std::vector<std::set<size_t> > classes;
+    for (size_t i = 0; i < 5 * num_vertices; i ++) {
+        size_t vertex = rand() % num_vertices;
+        size_t class_id = rand() % 50;
+        if (decomposition.VertexClassIsInitialized(vertex)) {
+            classes[decomposition.GetVertexClass(vertex)].erase(vertex);
+        }
+        decomposition.SetClass(vertex, class_id);
+        if (classes.size() <= class_id) {
+            classes.resize(class_id + 1);
+        }
+        classes[class_id].insert(vertex);
+        ASSERT_TRUE(decomposition.LastClassContains(vertex) == (class_id == decomposition.LastClassId()));
+        if (i % 1000 == 0) {
+            ASSERT_EQ(classes.size(), decomposition.Size());
+            for (size_t j = 0; j < classes.size(); j ++) {
+                auto cur_class = decomposition.GetClass(j);
+                ASSERT_EQ(classes[j].size(), decomposition.ClassSize(j));
+                ASSERT_EQ(std::vector<size_t>(classes[j].begin(), classes[j].end()),
+                          std::vector<size_t>(cur_class.begin(), cur_class.end()));
+            }
+        }
+    }
+}
+
 void create_console_logger() {
     using namespace logging;
 
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <logger/log_writers.hpp>
+
+#include <random>
+
+#include "../umi_experiments/clusterer.hpp"
+
+void create_console_logger() {
+    using namespace logging;
+    logger *lg = create_logger("");
+    lg->add_writer(std::make_shared<console_writer>());
+    attach_logger(lg);
+}
+
+namespace clusterer {
+
+class ClustererTest: public ::testing::Test {
+public:
+    typedef std::vector<std::pair<size_t, size_t>> UmiPairs;
+
+    void SetUp() {
+        create_console_logger();
+    }
+
+    // reads are mutated copies of a few templates, UMIs are assigned at random
+    static void CreateDataset(std::mt19937& random, std::vector<Read>& reads,
+                              std::unordered_map<Umi, std::vector<size_t>>& umi_to_reads,
+                              std::unordered_map<Umi, UmiPtr>& umi_ptr_by_umi, std::vector<UmiPtr>& umis) {
+        const size_t read_length = 30;
+        std::vector<seqan::Dna5String> templates(3);
+        for (auto& sequence : templates) {
+            for (size_t i = 0; i < read_length; i ++) {
+                seqan::appendValue(sequence, "ACGT"[random() % 4]);
+            }
+        }
+        for (size_t i = 0; i < 8; i ++) {
+            seqan::Dna5String umi;
+            for (size_t j = 0; j < 6; j ++) {
+                seqan::appendValue(umi, "ACGT"[random() % 4]);
+            }
+            if (umi_ptr_by_umi.count(Umi(umi))) continue;
+            umis.push_back(std::make_shared<Umi>(umi));
+            umi_ptr_by_umi[Umi(umi)] = umis.back();
+        }
+        const size_t reads_count = 10 + random() % 30;
+        for (size_t i = 0; i < reads_count; i ++) {
+            seqan::Dna5String sequence = templates[random() % templates.size()];
+            for (size_t mutations = random() % 4; mutations > 0; mutations --) {
+                sequence[random() % read_length] = "ACGT"[random() % 4];
+            }
+            reads.emplace_back(sequence, seqan::CharString("read_" + std::to_string(i)), i);
+            umi_to_reads[*umis[random() % umis.size()]].push_back(i);
+        }
+        for (auto it = umis.begin(); it != umis.end(); ) {
+            if (umi_to_reads.count(**it)) {
+                it ++;
+            } else {
+                umi_ptr_by_umi.erase(**it);
+                it = umis.erase(it);
+            }
+        }
+    }
+
+    static UmiPairs CreateUmiPairs(std::mt19937& random, size_t umis_count) {
+        UmiPairs umi_pairs;
+        for (size_t i = 0; i < umis_count; i ++) {
+            umi_pairs.emplace_back(i, i);
+        }
+        for (size_t i = 0; i < umis_count; i ++) {
+            umi_pairs.emplace_back(random() % umis_count, random() % umis_count);
+        }
+        std::shuffle(umi_pairs.begin(), umi_pairs.end(), random);
+        return umi_pairs;
+    }
+
+    // clustering as it was done before lazy evaluation of closeness: clusters are merged one by one
+    // and every pair of current clusters is compared
+    static void ClusterPairwise(Clusterer<Read>& clusterer, const ReadDist& read_dist, size_t limit,
+                                const std::vector<UmiPtr>& umis, const UmiPairs& umi_pairs) {
+        const auto& original = clusterer.current_umi_to_cluster_;
+        ManyToManyCorrespondenceUmiToCluster<Read> result(original);
+        DisjointSets<ClusterPtr<Read>> ds;
+        for (const auto& cluster : original.toSet()) {
+            ds.addNewSet(cluster);
+        }
+        for (const auto& umi_pair : umi_pairs) {
+            for (const auto& first_cluster_original : original.forth(umis[umi_pair.first])) {
+                for (const auto& second_cluster_original : original.forth(umis[umi_pair.second])) {
+                    const auto first_cluster = result.getTo(ds.findRoot(first_cluster_original));
+                    const auto second_cluster = result.getTo(ds.findRoot(second_cluster_original));
+                    if (first_cluster == second_cluster) continue;
+                    if (!Clusterer<Read>::clusters_are_close(first_cluster, second_cluster, read_dist, limit)) continue;
+
+                    std::unordered_set<UmiPtr, UmiPtrHash, UmiPtrEquals> merged_umis(result.back(first_cluster));
+                    const auto& second_cluster_umis = result.back(second_cluster);
+                    merged_umis.insert(second_cluster_umis.begin(), second_cluster_umis.end());
+                    result.removeTo(first_cluster);
+                    result.removeTo(second_cluster);
+                    ds.unite(first_cluster_original, second_cluster_original);
+                    size_t new_id = ds.findRoot(first_cluster_original)->id;
+                    result.add(merged_umis, Clusterer<Read>::merge_clusters(first_cluster, second_cluster, new_id));
+                }
+            }
+        }
+        clusterer.current_umi_to_cluster_ = result;
+    }
+
+    // sorted descriptions of clusters: id, weight, center, members and UMIs
+    static std::vector<std::string> DescribeClusters(const Clusterer<Read>& clusterer) {
+        const auto& umi_to_cluster = clusterer.getCurrentUmiToCluster();
+        std::vector<std::string> descriptions;
+        for (const auto& cluster : umi_to_cluster.toSet()) {
+            std::stringstream ss;
+            ss << cluster->id << " " << cluster->weight << " " << seqan_string_to_string(cluster->center) << " |";
+            for (const auto& member : cluster->members) {
+                ss << " " << member.GetId();
+            }
+            std::vector<std::string> cluster_umis;
+            for (const auto& umi : umi_to_cluster.back(cluster)) {
+                cluster_umis.push_back(seqan_string_to_string(umi->GetString()));
+            }
+            std::sort(cluster_umis.begin(), cluster_umis.end());
+            ss << " |";
+            for (const auto& umi : cluster_umis) {
+                ss << " " << umi;
+            }
+            descriptions.push_back(ss.str());
+        }
+        std::sort(descriptions.begin(), descriptions.end());
+        return descriptions;
+    }
+};
+
+TEST_F(ClustererTest, LazyClusteringCoincidesWithPairwise) {
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+    std::mt19937 random(8356);
+    for (size_t iteration = 0; iteration < 50; iteration ++) {
+        std::vector<Read> reads;
+        std::unordered_map<Umi, std::vector<size_t>> umi_to_reads;
+        std::unordered_map<Umi, UmiPtr> umi_ptr_by_umi;
+        std::vector<UmiPtr> umis;
+        CreateDataset(random, reads, umi_to_reads, umi_ptr_by_umi, umis);
+        const UmiPairs umi_pairs = CreateUmiPairs(random, umis.size());
+        const size_t limit = 1 + iteration % 3;
+        const ReadDist read_dist = ClusteringMode::bounded_hamming_dist(limit);
+
+        Clusterer<Read> lazy_clusterer(umi_to_reads, umi_ptr_by_umi, reads);
+        lazy_clusterer.cluster(read_dist, limit, umis, umi_pairs);
+        Clusterer<Read> pairwise_clusterer(umi_to_reads, umi_ptr_by_umi, reads);
+        ClusterPairwise(pairwise_clusterer, read_dist, limit, umis, umi_pairs);
+
+        ASSERT_EQ(DescribeClusters(pairwise_clusterer), DescribeClusters(lazy_clusterer)) << "iteration " << iteration;
+    }
+    omp_set_num_threads(max_threads);
+}
+
+}
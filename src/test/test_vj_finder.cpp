@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <logger/log_writers.hpp>
 
+#include <fstream>
 #include <sstream>
 
 #include <cdr_config.hpp>
 #include <germline_utils/germline_db_generator.hpp>
 #include <vj_parallel_processor.hpp>
+#include <vjf_launch.hpp>
 #include <convert.hpp>
 
 void create_console_logger() {
@@ -125,3 +127,46 @@ TEST_F(VJFinderTest, BaseVJFinderTest) {
     TestReadLeftRightCropping();
     TestReadLeftRightFilling();
 }
+
+std::string ReadFile(const std::string &fname) {
+    std::ifstream in(fname);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+TEST_F(VJFinderTest, StreamingModeCoincidesWithInMemoryMode) {
+    create_console_logger();
+    vj_finder::VJFinderConfig config;
+    vj_finder::load(config, "configs/vj_finder/config.info");
+    config.run_params.num_threads = 4;
+    // several chunks, the last one is incomplete
+    config.run_params.chunk_size = 32;
+    auto &output_files = config.io_params.output_params.output_files;
+    const std::string output_dir = output_files.output_dir;
+    std::vector<std::string> output_fnames;
+    std::vector<std::string> in_memory_outputs;
+    for (bool streaming : { false, true }) {
+        config.run_params.streaming = streaming;
+        output_files.output_dir = path::append_path(output_dir, streaming ? "streaming" : "in_memory");
+        path::make_dirs(output_files.output_dir);
+        auto mode_output_files = output_files;
+        vj_finder::update_output_files_config(output_files);
+        vj_finder::VJFinderLaunch(config).Run();
+        output_fnames = { output_files.cleaned_reads_fname, output_files.filtered_reads_fname,
+                          output_files.alignment_info_fname, output_files.filtering_info_filename,
+                          output_files.valignments_filename };
+        for (size_t i = 0; i < output_fnames.size(); i++) {
+            std::string output = ReadFile(output_fnames[i]);
+            if (!streaming) {
+                in_memory_outputs.push_back(output);
+            } else {
+                ASSERT_TRUE(in_memory_outputs[i] == output) << output_fnames[i] << " differs from in-memory output";
+            }
+        }
+        output_files = mode_output_files;
+    }
+    ASSERT_FALSE(in_memory_outputs[0].empty());
+    ASSERT_FALSE(in_memory_outputs[2].empty());
+    path::remove_dir(output_dir);
+}
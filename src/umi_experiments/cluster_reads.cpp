@@ -130,14 +130,12 @@ int main(int argc, const char* const* argv) {
     }
 
     const clusterer::ReadDist& hamming_dist = clusterer::ClusteringMode::bounded_hamming_dist(params.clustering_threshold);
-    const auto hamming_dist_checker = clusterer::ClusteringMode::clusters_close_by_min(hamming_dist, params.clustering_threshold);
     const clusterer::ReadDist& edit_dist = clusterer::ClusteringMode::bounded_edit_dist(params.clustering_threshold, params.clustering_threshold);
-    const auto edit_dist_checker = clusterer::ClusteringMode::clusters_close_by_min(edit_dist, params.clustering_threshold);
 
     clusterer::Clusterer<Read> clusterer(umi_to_reads, umi_ptr_by_umi, reads);
 
     INFO("Clustering reads by hamming within single UMIs with threshold " << params.clustering_threshold);
-    clusterer.cluster(hamming_dist_checker, compressed_umi_ptrs, clusterer::ReflexiveUmiPairsIterable(compressed_umi_ptrs.size()));
+    clusterer.cluster(hamming_dist, params.clustering_threshold, compressed_umi_ptrs, clusterer::ReflexiveUmiPairsIterable(compressed_umi_ptrs.size()));
     for (const auto& cluster : clusterer.getCurrentUmiToCluster().toSet()) {
         VERIFY_MSG(clusterer.getCurrentUmiToCluster().back(cluster).size() == 1, "We haven't united any reads across different UMIs yet.");
     }
@@ -164,7 +162,7 @@ int main(int argc, const char* const* argv) {
     clusterer.print_umi_split_stats();
 
     INFO("Uniting read clusters for adjacent UMIs");
-    clusterer.cluster(hamming_dist_checker, compressed_umi_ptrs, clusterer::GraphUmiPairsIterable(input.umi_graph));
+    clusterer.cluster(hamming_dist, params.clustering_threshold, compressed_umi_ptrs, clusterer::GraphUmiPairsIterable(input.umi_graph));
     INFO(clusterer.getCurrentUmiToCluster().toSize() << " clusters found");
 //    size_t hamm_corrected_reads = clusterer::count_reads_with_corrected_umi(umi_to_clusters_hamm_inside_umi, umi_to_clusters_hamm_adj_umi);
 //    INFO(hamm_corrected_reads << " reads have UMI corrected for hamming dist.");
@@ -173,14 +171,14 @@ int main(int argc, const char* const* argv) {
 
 
     INFO("Clustering reads by edit distance within single UMIs with threshold " << params.clustering_threshold);
-    clusterer.cluster(edit_dist_checker, compressed_umi_ptrs, clusterer::ReflexiveUmiPairsIterable(compressed_umi_ptrs.size()));
+    clusterer.cluster(edit_dist, params.clustering_threshold, compressed_umi_ptrs, clusterer::ReflexiveUmiPairsIterable(compressed_umi_ptrs.size()));
     INFO(clusterer.getCurrentUmiToCluster().toSize() << " clusters found");
 
     clusterer.write_clusters_and_correspondence(params.output_dir, "_3_edit", params.save_clusters, params.output_intermediate);
 
 
     INFO("Uniting read clusters for adjacent UMIs");
-    clusterer.cluster(edit_dist_checker, compressed_umi_ptrs, clusterer::GraphUmiPairsIterable(input.umi_graph));
+    clusterer.cluster(edit_dist, params.clustering_threshold, compressed_umi_ptrs, clusterer::GraphUmiPairsIterable(input.umi_graph));
     INFO(clusterer.getCurrentUmiToCluster().toSize() << " clusters found");
 
     clusterer.write_clusters_and_correspondence(params.output_dir, "_4_edit_ngh", params.save_clusters, params.output_intermediate);
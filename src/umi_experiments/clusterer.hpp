@@ -1,8 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <seqan/seq_io.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
+#include "gtest/gtest_prod.h"
 #include "utils.hpp"
 #include "../graph_utils/sparse_graph.hpp"
 #include "umi_utils.hpp"
@@ -168,11 +170,15 @@ namespace clusterer {
     // ElementType is always Read now. Gradually refactoring to use this information.
     template <typename ElementType>
     class Clusterer {
+        friend class ClustererTest;
+
     public:
         Clusterer(const std::unordered_map<Umi, std::vector<size_t>>& umi_to_reads, const std::unordered_map<Umi, UmiPtr>& umi_ptr_by_umi, const std::vector<Read>& reads);
 
+        // Unites clusters of UMI pairs if they have members within read_dist limit (as clusters_close_by_min).
+        // Closeness is evaluated lazily during merges, groups of UMIs not sharing pairs or clusters are merged in parallel.
         template <typename UmiPairsIterable>
-        void cluster(const ClusterDistChecker& dist_checker,
+        void cluster(const ReadDist& read_dist, size_t limit,
                      const std::vector<UmiPtr>& umis,
                      const UmiPairsIterable& umi_pairs_iterable);
 
@@ -199,6 +205,18 @@ namespace clusterer {
         // In particular it inherits id from one of the parents and can be used by ManyToManyCorrespondence, which relies it's a good equality measure and hash value.
         static ClusterPtr<ElementType> merge_clusters(const ClusterPtr<ElementType>& first, const ClusterPtr<ElementType>& second, const size_t id);
         static seqan::Dna5String findNewCenter(const std::vector<ElementType>& members);
+        // sorted members of clusters with given indices
+        static std::vector<ElementType> collect_members(const std::vector<ClusterPtr<ElementType>>& clusters,
+                                                        const std::vector<size_t>& indices);
+        static bool clusters_are_close(const ClusterPtr<ElementType>& first, const ClusterPtr<ElementType>& second,
+                                       const ReadDist& read_dist, size_t limit);
+        // merged clusters are close if any pair of their original clusters is close, closeness of original clusters
+        // is memoized by key of their pair of indices
+        static bool merged_clusters_are_close(const std::vector<ClusterPtr<ElementType>>& clusters,
+                                              const std::vector<size_t>& first_indices,
+                                              const std::vector<size_t>& second_indices,
+                                              const ReadDist& read_dist, size_t limit,
+                                              std::unordered_map<size_t, bool>& close_originals);
         static void print_umi_to_cluster_stats(const ManyToManyCorrespondenceUmiToCluster<ElementType>& umis_to_clusters);
         void get_graph(const size_t tau, const size_t strategy, const size_t k, const std::vector<seqan::Dna5String> &sequences,
                 const ReadDist &dist, Graph &graph, size_t &num_of_dist_computations) const;
@@ -222,54 +240,156 @@ namespace clusterer {
     template <typename ElementType>
     template <typename UmiPairsIterable>
     void Clusterer<ElementType>::cluster(
-            const ClusterDistChecker& dist_checker,
+            const ReadDist& read_dist, size_t limit,
             const std::vector<UmiPtr>& umis,
             const UmiPairsIterable& umi_pairs_iterable) {
-        ManyToManyCorrespondenceUmiToCluster<Read> result(current_umi_to_cluster_);
-        // operated on clusters from original umis_to_clusters
-        DisjointSets<ClusterPtr<Read>> ds;
+        // clusters from original umis_to_clusters are indexed
+        std::vector<ClusterPtr<Read>> clusters;
+        std::unordered_map<size_t, size_t> cluster_index_by_id;
         for (const auto& cluster : current_umi_to_cluster_.toSet()) {
-            ds.addNewSet(cluster);
+            cluster_index_by_id[cluster->id] = clusters.size();
+            clusters.push_back(cluster);
         }
-//        std::map<size_t, size_t> dist_distribution;
+
+        // UMIs are grouped by pairs and by shared clusters: merges of different groups touch disjoint clusters
+        // and commute, so groups are replayed in parallel while pairs of a group keep their order
+        std::vector<std::pair<size_t, size_t>> umi_pairs;
+        IndexDisjointSets umi_groups(umis.size());
+        std::vector<char> paired_umis(umis.size());
         for (const auto& umi_pair : umi_pairs_iterable) {
             VERIFY_MSG(umi_pair.first < umis.size() && umi_pair.second < umis.size(), "Invalid umi pair.");
-            const UmiPtr& first_umi = umis[umi_pair.first];
-            const UmiPtr& second_umi = umis[umi_pair.second];
-            for (const auto& first_cluster_original : current_umi_to_cluster_.forth(first_umi)) {
-                for (const auto& second_cluster_original : current_umi_to_cluster_.forth(second_umi)) {
-                    const auto& first_cluster = result.getTo(ds.findRoot(first_cluster_original));
-                    const auto& second_cluster = result.getTo(ds.findRoot(second_cluster_original));
-                    if (first_cluster == second_cluster) continue;
-                    bool same_cluster = dist_checker(first_cluster, second_cluster);
-//                    dist_distribution[dist] ++;
-                    if (same_cluster) {
-//                    if (dist <= mode.threshold || (dist <= 1.5 * static_cast<double>(mode.threshold) && first_cluster->size() == 1 && second_cluster->size() == 1)) {
-                        // TODO: avoid returning copied umi set by providing access to its begin() and end()
-                        const auto& first_cluster_umis = result.back(first_cluster);
-                        const auto& second_cluster_umis = result.back(second_cluster);
-                        std::unordered_set<UmiPtr, UmiPtrHash, UmiPtrEquals> merged_umis(first_cluster_umis);
-                        merged_umis.insert(second_cluster_umis.begin(), second_cluster_umis.end());
-
-                        VERIFY_MSG(result.removeTo(first_cluster), "Trying to remove an absent cluster");
-                        VERIFY_MSG(result.removeTo(second_cluster), "Trying to remove an absent cluster");
-
-                        VERIFY_MSG(ds.unite(first_cluster_original, second_cluster_original), "Tried to unite two equal sets");
-                        size_t new_id = ds.findRoot(first_cluster_original)->id;
-                        const auto merged_cluster = merge_clusters(first_cluster, second_cluster, new_id);
-
-                        result.add(merged_umis, merged_cluster);
+            umi_pairs.emplace_back(umi_pair.first, umi_pair.second);
+            umi_groups.unite(umi_pair.first, umi_pair.second);
+            paired_umis[umi_pair.first] = paired_umis[umi_pair.second] = true;
+        }
+        {
+            const size_t NO_UMI = std::numeric_limits<size_t>::max();
+            std::vector<size_t> umi_by_cluster(clusters.size(), NO_UMI);
+            for (size_t umi = 0; umi < umis.size(); umi ++) {
+                if (!paired_umis[umi]) continue;
+                for (const auto& cluster : current_umi_to_cluster_.forth(umis[umi])) {
+                    size_t& cluster_umi = umi_by_cluster[cluster_index_by_id.at(cluster->id)];
+                    if (cluster_umi == NO_UMI) {
+                        cluster_umi = umi;
+                    } else {
+                        umi_groups.unite(cluster_umi, umi);
                     }
                 }
             }
         }
+        std::vector<std::vector<std::pair<size_t, size_t>>> group_pairs;
+        {
+            std::unordered_map<size_t, size_t> group_by_root;
+            for (const auto& umi_pair : umi_pairs) {
+                auto it = group_by_root.emplace(umi_groups.findRoot(umi_pair.first), group_pairs.size()).first;
+                if (it->second == group_pairs.size()) {
+                    group_pairs.emplace_back();
+                }
+                group_pairs[it->second].push_back(umi_pair);
+            }
+            std::vector<std::pair<size_t, size_t>>().swap(umi_pairs);
+        }
 
-        print_umi_to_cluster_stats(result);
+        // Merges are replayed in the order of pairs: centers and ids of merged clusters depend on it.
+        // Center of a merged cluster is either the center of original cluster center_refs[root] or, if
+        // center_snapshots[root] is not empty, consensus of these original clusters as in merge_clusters.
+        // Consensuses are computed only for clusters that remain after all merges.
+        IndexDisjointSets ds(clusters.size());
+        std::vector<std::vector<size_t>> merged_indices(clusters.size());
+        std::vector<size_t> sizes(clusters.size());
+        std::vector<size_t> weights(clusters.size());
+        std::vector<size_t> center_refs(clusters.size());
+        std::vector<std::vector<size_t>> center_snapshots(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i ++) {
+            merged_indices[i].push_back(i);
+            sizes[i] = clusters[i]->size();
+            weights[i] = clusters[i]->weight;
+            center_refs[i] = i;
+        }
+        size_t compared = 0;
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic) reduction(+:compared) if(group_pairs.size() > 1))
+        for (size_t group = 0; group < group_pairs.size(); group ++) {
+            // closeness of original clusters is evaluated only when their merged clusters are compared
+            std::unordered_map<size_t, bool> close_originals;
+            for (const auto& umi_pair : group_pairs[group]) {
+                const UmiPtr& first_umi = umis[umi_pair.first];
+                const UmiPtr& second_umi = umis[umi_pair.second];
+                for (const auto& first_cluster_original : current_umi_to_cluster_.forth(first_umi)) {
+                    for (const auto& second_cluster_original : current_umi_to_cluster_.forth(second_umi)) {
+                        size_t first = ds.findRoot(cluster_index_by_id.at(first_cluster_original->id));
+                        size_t second = ds.findRoot(cluster_index_by_id.at(second_cluster_original->id));
+                        if (first == second) continue;
+                        if (!merged_clusters_are_close(clusters, merged_indices[first], merged_indices[second],
+                                                       read_dist, limit, close_originals)) continue;
+
+                        size_t max_cluster = sizes[first] > sizes[second] ? first : second;
+                        size_t max_size = sizes[max_cluster];
+                        size_t merged_size = sizes[first] + sizes[second];
+                        bool need_new_center = max_size <= 20 || __builtin_clzll(max_size) != __builtin_clzll(merged_size);
+                        size_t center_ref = center_refs[max_cluster];
+                        std::vector<size_t> center_snapshot;
+                        if (need_new_center) {
+                            center_snapshot = merged_indices[first];
+                            center_snapshot.insert(center_snapshot.end(),
+                                                   merged_indices[second].begin(), merged_indices[second].end());
+                        } else {
+                            center_snapshot.swap(center_snapshots[max_cluster]);
+                        }
 
-        //        INFO("Dist distribution");
-//        for (const auto& entry : dist_distribution) {
-//            INFO("dist " << entry.first << " : " << entry.second << " times");
-//        }
+                        VERIFY_MSG(ds.unite(first, second), "Tried to unite two equal sets");
+                        size_t root = ds.findRoot(first);
+                        size_t child = root == first ? second : first;
+                        if (merged_indices[root].size() < merged_indices[child].size()) {
+                            std::swap(merged_indices[root], merged_indices[child]);
+                        }
+                        merged_indices[root].insert(merged_indices[root].end(), merged_indices[child].begin(), merged_indices[child].end());
+                        std::vector<size_t>().swap(merged_indices[child]);
+                        std::vector<size_t>().swap(center_snapshots[child]);
+                        sizes[root] = merged_size;
+                        weights[root] = weights[first] + weights[second];
+                        center_refs[root] = center_ref;
+                        center_snapshots[root].swap(center_snapshot);
+                    }
+                }
+            }
+            compared += close_originals.size();
+        }
+        INFO(compared << " pairs of clusters compared");
+
+        // merged cluster inherits id of the root of its original clusters
+        std::vector<size_t> merged_roots;
+        for (size_t i = 0; i < clusters.size(); i ++) {
+            if (ds.findRoot(i) == i && merged_indices[i].size() > 1) {
+                merged_roots.push_back(i);
+            }
+        }
+        std::vector<ClusterPtr<ElementType>> merged_clusters(merged_roots.size());
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 8))
+        for (size_t i = 0; i < merged_roots.size(); i ++) {
+            size_t root = merged_roots[i];
+            const seqan::Dna5String center = center_snapshots[root].empty() ?
+                    clusters[center_refs[root]]->center :
+                    findNewCenter(collect_members(clusters, center_snapshots[root]));
+            merged_clusters[i] = std::make_shared<Cluster<ElementType>>(collect_members(clusters, merged_indices[root]),
+                                                                        center, clusters[root]->id, weights[root]);
+        }
+        ManyToManyCorrespondenceUmiToCluster<Read> result;
+        for (size_t i = 0; i < clusters.size(); i ++) {
+            if (ds.findRoot(i) == i && merged_indices[i].size() == 1) {
+                result.add(current_umi_to_cluster_.back(clusters[i]), clusters[i]);
+            }
+        }
+        for (size_t i = 0; i < merged_roots.size(); i ++) {
+            std::unordered_set<UmiPtr, UmiPtrHash, UmiPtrEquals> merged_umis;
+            for (size_t index : merged_indices[merged_roots[i]]) {
+                const auto& cluster_umis = current_umi_to_cluster_.back(clusters[index]);
+                merged_umis.insert(cluster_umis.begin(), cluster_umis.end());
+            }
+            VERIFY_MSG(merged_clusters[i]->size() == sizes[merged_roots[i]], "Clusters already intersect.");
+            result.add(merged_umis, merged_clusters[i]);
+        }
+
+        print_umi_to_cluster_stats(result);
 
         current_umi_to_cluster_ = result;
     }
@@ -682,6 +802,75 @@ namespace clusterer {
         return std::make_shared<Cluster<ElementType>>(members, center, id, first->weight + second->weight);
     }
 
+    template <typename ElementType>
+    std::vector<ElementType> Clusterer<ElementType>::collect_members(const std::vector<ClusterPtr<ElementType>>& clusters,
+                                                                     const std::vector<size_t>& indices) {
+        std::vector<ElementType> members;
+        for (size_t index : indices) {
+            members.insert(members.end(), clusters[index]->members.begin(), clusters[index]->members.end());
+        }
+        std::sort(members.begin(), members.end());
+        return members;
+    }
+
+    template <typename ElementType>
+    bool Clusterer<ElementType>::clusters_are_close(const ClusterPtr<ElementType>& first, const ClusterPtr<ElementType>& second,
+                                                    const ReadDist& read_dist, size_t limit) {
+        for (const auto& first_member : first->members) {
+            for (const auto& second_member : second->members) {
+                if (read_dist(first_member.GetSequence(), second_member.GetSequence()) <= limit) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <typename ElementType>
+    bool Clusterer<ElementType>::merged_clusters_are_close(const std::vector<ClusterPtr<ElementType>>& clusters,
+                                                           const std::vector<size_t>& first_indices,
+                                                           const std::vector<size_t>& second_indices,
+                                                           const ReadDist& read_dist, size_t limit,
+                                                           std::unordered_map<size_t, bool>& close_originals) {
+        std::vector<size_t> unknown_keys;
+        for (size_t first : first_indices) {
+            for (size_t second : second_indices) {
+                size_t key = std::min(first, second) * clusters.size() + std::max(first, second);
+                const auto it = close_originals.find(key);
+                if (it == close_originals.end()) {
+                    unknown_keys.push_back(key);
+                } else if (it->second) {
+                    return true;
+                }
+            }
+        }
+        if (unknown_keys.empty()) {
+            return false;
+        }
+        // the flag only stops the remaining comparisons early, the result is taken from close
+        std::atomic<bool> stop(false);
+        std::vector<char> computed(unknown_keys.size());
+        std::vector<char> close(unknown_keys.size());
+        SEQAN_OMP_PRAGMA(parallel for schedule(dynamic, 8))
+        for (size_t i = 0; i < unknown_keys.size(); i ++) {
+            if (stop.load(std::memory_order_relaxed)) continue;
+            close[i] = clusters_are_close(clusters[unknown_keys[i] / clusters.size()],
+                                          clusters[unknown_keys[i] % clusters.size()], read_dist, limit);
+            computed[i] = true;
+            if (close[i]) {
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+        bool found = false;
+        for (size_t i = 0; i < unknown_keys.size(); i ++) {
+            if (computed[i]) {
+                close_originals[unknown_keys[i]] = close[i];
+                found = found || close[i];
+            }
+        }
+        return found;
+    }
+
     template <typename ElementType>
     seqan::Dna5String Clusterer<ElementType>::findNewCenter(const std::vector<ElementType>& members) {
         VERIFY_MSG(members.size() >= 2, "Too few elements to find new center.");
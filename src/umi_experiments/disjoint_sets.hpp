@@ -1,6 +1,8 @@
 #pragma once
 
+#include <numeric>
 #include <unordered_map>
+#include <vector>
 #include <verify.hpp>
 
 template <typename T, typename Hash = std::hash<T>>
@@ -40,4 +42,46 @@ public:
 private:
     std::unordered_map<T, T, Hash> parent_;
     std::unordered_map<T, size_t, Hash> depth_;
-};
\ No newline at end of file
+};
+
+// The same structure over indices 0..size-1: unions by depth coincide, so roots do too
+class IndexDisjointSets {
+public:
+    explicit IndexDisjointSets(size_t size) : parent_(size), depth_(size, 0) {
+        std::iota(parent_.begin(), parent_.end(), 0);
+    }
+
+    size_t findRoot(size_t element) {
+        size_t root = element;
+        while (parent_[root] != root) {
+            root = parent_[root];
+        }
+        while (parent_[element] != root) {
+            size_t next = parent_[element];
+            parent_[element] = root;
+            element = next;
+        }
+        return root;
+    }
+
+    bool unite(size_t first, size_t second) {
+        size_t first_parent = findRoot(first);
+        size_t second_parent = findRoot(second);
+        if (first_parent == second_parent) {
+            return false;
+        }
+        if (depth_[first_parent] > depth_[second_parent]) {
+            parent_[second_parent] = first_parent;
+        } else {
+            parent_[first_parent] = second_parent;
+            if (depth_[first_parent] == depth_[second_parent]) {
+                depth_[second_parent] ++;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<size_t> parent_;
+    std::vector<size_t> depth_;
+};
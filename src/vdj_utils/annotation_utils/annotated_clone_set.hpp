@@ -12,7 +12,11 @@ namespace annotation_utils {
 
     public:
         void AddClone(AnnotatedClone clone) {
-            annotated_clones_.push_back(clone);
+            annotated_clones_.push_back(std::move(clone));
+        }
+
+        void reserve(size_t size) {
+            annotated_clones_.reserve(size);
         }
 
         typedef typename std::vector<AnnotatedClone>::iterator iterator;
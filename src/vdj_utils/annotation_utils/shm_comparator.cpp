@@ -1,7 +1,7 @@
 #include "shm_comparator.hpp"
 
 namespace annotation_utils {
-    bool SHMComparator::SHMsAreEqual(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    bool SHMComparator::SHMsAreEqual(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         if(shms1.size() != shms2.size())
             return false;
         for(size_t i = 0; i < shms1.size(); i++)
@@ -37,7 +37,7 @@ namespace annotation_utils {
         return true;
     }
 
-    bool SHMComparator::SHMs1AreNestedInSHMs2(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    bool SHMComparator::SHMs1AreNestedInSHMs2(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         size_t index2 = 0;
         for(auto it1 = shms1.cbegin(); it1 != shms1.cend(); it1++) {
             if (it1->shm_type == SHMType::InsertionSHM) {
@@ -57,8 +57,8 @@ namespace annotation_utils {
 //        return SHMsInsertionBlocksAreEqual(shms1, shms2);
     }
 
-    bool SHMComparator::AllSHMs1InsertionBlocksArePresentedInSHMs2(GeneSegmentSHMs shms1,
-                                                                   GeneSegmentSHMs shms2) {
+    bool SHMComparator::AllSHMs1InsertionBlocksArePresentedInSHMs2(const GeneSegmentSHMs &shms1,
+                                                                   const GeneSegmentSHMs &shms2) {
         size_t index2 = 0;
         for (auto it1 = shms1.cbegin(); it1 != shms1.cend(); it1++) {
             bool shm_found = false;
@@ -83,13 +83,13 @@ namespace annotation_utils {
         }
         return true;
     }
-    bool SHMComparator::SHMsInsertionBlocksAreEqual(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2)
+    bool SHMComparator::SHMsInsertionBlocksAreEqual(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2)
     {
         return AllSHMs1InsertionBlocksArePresentedInSHMs2(shms1, shms2) &&
                AllSHMs1InsertionBlocksArePresentedInSHMs2(shms2, shms1);
     }
 
-    size_t SHMComparator::GetNumberOfIntersections(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    size_t SHMComparator::GetNumberOfIntersections(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         size_t num_shared_shms = 0;
         size_t index2 = 0;
         for(auto it1 = shms1.cbegin(); it1 != shms1.cend(); it1++) {
@@ -103,7 +103,7 @@ namespace annotation_utils {
         return num_shared_shms;
     }
 
-    bool SHMComparator::AddedSHMsAreSynonimous(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    bool SHMComparator::AddedSHMsAreSynonimous(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         size_t index1 = 0;
         for(auto it2 = shms2.cbegin(); it2 != shms2.cend(); it2++) {
             bool shm_found = false;
@@ -120,7 +120,7 @@ namespace annotation_utils {
         return true;
     }
 
-    bool SHMComparator::AllAddedSHMs1HaveIdenticallyPositionedSHMs2(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    bool SHMComparator::AllAddedSHMs1HaveIdenticallyPositionedSHMs2(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         size_t index1 = 0;
         for(auto it2 = shms2.cbegin(); it2 != shms2.cend(); it2++) {
             bool shm_found = false;
@@ -139,13 +139,13 @@ namespace annotation_utils {
         return true;
     }
 
-    bool SHMComparator::IndividualSHMsAreIdenticallyPositioned(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    bool SHMComparator::IndividualSHMsAreIdenticallyPositioned(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         return SHMsInsertionBlocksAreEqual(shms1, shms2) &&
                AllAddedSHMs1HaveIdenticallyPositionedSHMs2(shms1, shms2);
     }
 
     // return a vector of SHMs that appeared in SHM2, but not presented in SHM1
-    std::vector<SHM> SHMComparator::GetAddedSHMs(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2) {
+    std::vector<SHM> SHMComparator::GetAddedSHMs(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2) {
         std::vector<SHM> added_shms;
         for(auto it2 = shms2.cbegin(); it2 != shms2.cend(); it2++) {
             bool shm_found = false;
@@ -5,22 +5,22 @@
 namespace annotation_utils {
     class SHMComparator {
     public:
-        static bool SHMsAreEqual(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool SHMsAreEqual(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool SHMs1AreNestedInSHMs2(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool SHMs1AreNestedInSHMs2(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool AllSHMs1InsertionBlocksArePresentedInSHMs2(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool AllSHMs1InsertionBlocksArePresentedInSHMs2(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool SHMsInsertionBlocksAreEqual(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool SHMsInsertionBlocksAreEqual(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static size_t GetNumberOfIntersections(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static size_t GetNumberOfIntersections(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool AddedSHMsAreSynonimous(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool AddedSHMsAreSynonimous(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool AllAddedSHMs1HaveIdenticallyPositionedSHMs2(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool AllAddedSHMs1HaveIdenticallyPositionedSHMs2(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static bool IndividualSHMsAreIdenticallyPositioned(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static bool IndividualSHMsAreIdenticallyPositioned(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
 
-        static std::vector<SHM> GetAddedSHMs(GeneSegmentSHMs shms1, GeneSegmentSHMs shms2);
+        static std::vector<SHM> GetAddedSHMs(const GeneSegmentSHMs &shms1, const GeneSegmentSHMs &shms2);
     };
 }
@@ -90,6 +90,10 @@ void parse_command_line_args(vj_finder::VJFinderConfig &cfg, int argc, const cha
     po::options_description hidden("Hidden options");
     hidden.add_options()
             ("help-hidden", "show all options, including developers options")
+            ("streaming", po::value<bool>(&cfg.run_params.streaming)->default_value(cfg.run_params.streaming),
+             "align and output reads by chunks without loading the whole input")
+            ("chunk-size", po::value<size_t>(&cfg.run_params.chunk_size)->default_value(cfg.run_params.chunk_size),
+             "number of reads in chunk for streaming mode")
             ("left-uncoverage-limit", po::value<int>(&cfg.algorithm_params.filtering_params.left_uncovered_limit)->default_value(cfg.algorithm_params.filtering_params.left_uncovered_limit),
              "uncoverage limit of left end")
             ("right-uncoverage-limit", po::value<int>(&cfg.algorithm_params.filtering_params.right_uncovered_limit)->default_value(cfg.algorithm_params.filtering_params.right_uncovered_limit),
@@ -3,6 +3,26 @@
 #include "immune_gene_alignment_converter.hpp"
 
 namespace vj_finder {
+    const size_t VJAlignmentInfo::NO_RECORD;
+
+    VJAlignmentInfo::VJAlignmentInfo(std::vector<VJHits> &&alignment_records,
+                                     std::vector<VJFilteringInfo> &&filtering_infos,
+                                     ChainTypeAbundanceMap chain_type_abundance) :
+            alignment_records_(std::move(alignment_records)),
+            filtering_infos_(std::move(filtering_infos)),
+            chain_type_abundance_(std::move(chain_type_abundance)) {
+        for(size_t i = 0; i < alignment_records_.size(); i++)
+            SetRecordIndex(read_id_hit_index_, alignment_records_[i].Read().id, i);
+        for(size_t i = 0; i < filtering_infos_.size(); i++)
+            SetRecordIndex(read_id_filtering_info_index_, filtering_infos_[i].read->id, i);
+    }
+
+    void VJAlignmentInfo::SetRecordIndex(std::vector<size_t> &read_id_index, size_t read_id, size_t record_index) {
+        if(read_id >= read_id_index.size())
+            read_id_index.resize(std::max(read_id + 1, 2 * read_id_index.size()), NO_RECORD);
+        read_id_index[read_id] = record_index;
+    }
+
     void VJAlignmentInfo::Update(VJAlignmentInfo vj_alignment_info) {
         for(size_t i = 0; i < vj_alignment_info.NumVJHits(); i++)
             UpdateHits(vj_alignment_info.GetVJHitsByIndex(i));
@@ -11,20 +31,17 @@ namespace vj_finder {
     }
 
     void VJAlignmentInfo::UpdateFilteringInfo(VJFilteringInfo filtering_info) {
+        SetRecordIndex(read_id_filtering_info_index_, filtering_info.read->id, filtering_infos_.size());
         filtering_infos_.push_back(filtering_info);
-        read_id_filtering_info_map_[filtering_info.read->id] = filtering_infos_.size() - 1;
     }
 
     void VJAlignmentInfo::UpdateChainTypeMap(const VJHits &vj_hits) {
-        auto chain_type = vj_hits.GetVHitByIndex(0).ImmuneGene().Chain();
-        if(chain_type_abundance_.find(chain_type) == chain_type_abundance_.end())
-            chain_type_abundance_[chain_type] = 0;
-        chain_type_abundance_[chain_type]++;
+        chain_type_abundance_[vj_hits.GetVHitByIndex(0).ImmuneGene().Chain()]++;
     }
 
     void VJAlignmentInfo::UpdateHits(VJHits vj_hits) {
         UpdateChainTypeMap(vj_hits);
-        read_id_hit_index_map_[vj_hits.Read().id] = alignment_records_.size();
+        SetRecordIndex(read_id_hit_index_, vj_hits.Read().id, alignment_records_.size());
         alignment_records_.push_back(std::move(vj_hits));
     }
 
@@ -42,52 +59,84 @@ namespace vj_finder {
     }
 
     const VJHits& VJAlignmentInfo::GetVJHitsByRead(const core::Read &read) const {
-        VERIFY_MSG(read_id_hit_index_map_.find(read.id) != read_id_hit_index_map_.end(),
+        VERIFY_MSG(HasRecord(read_id_hit_index_, read.id),
                    "Alignment info does not contain read " << read.name);
-        return alignment_records_[read_id_hit_index_map_.at(read.id)];
+        return alignment_records_[read_id_hit_index_[read.id]];
     }
 
     VJFilteringInfo VJAlignmentInfo::GetFilteringInfoByRead(const core::Read &read) const {
-        VERIFY_MSG(read_id_filtering_info_map_.find(read.id) != read_id_filtering_info_map_.end(),
+        VERIFY_MSG(HasRecord(read_id_filtering_info_index_, read.id),
                    "Alignment info does not contain read " << read.name);
-        return filtering_infos_[read_id_filtering_info_map_.at(read.id)];
+        return filtering_infos_[read_id_filtering_info_index_[read.id]];
     }
 
-    void VJAlignmentOutput::OutputAlignmentInfo() const {
-        std::ofstream out(output_params_.output_files.alignment_info_fname);
-        const auto columns = ReportColumns::ColumnSet<VJFReportEvalContext>::ParseColumns(
-                output_params_.output_details.alignment_columns
-        ).value();
-        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++) {
-            const auto vj_hits = alignment_info_.GetVJHitsByIndex(i);
-            for(size_t j = 0; j < output_params_.output_details.num_aligned_candidates; j++) {
+    namespace {
+        typedef ReportColumns::ColumnSet<VJFReportEvalContext> VJFReportColumnSet;
+
+        VJFReportColumnSet ParseAlignmentColumns(const VJFinderConfig::IOParams::OutputParams &output_params) {
+            return VJFReportColumnSet::ParseColumns(output_params.output_details.alignment_columns).value();
+        }
+
+        void PrintAlignmentInfo(std::ostream &out, const VJFReportColumnSet &columns,
+                                const VJHits &vj_hits, size_t num_aligned_candidates) {
+            for(size_t j = 0; j < num_aligned_candidates; j++) {
                 const auto v_hits = vj_hits.GetVHitByIndex(j);
                 const auto j_hits = vj_hits.GetJHitByIndex(j);
                 columns.Print(out, VJFReportEvalContext{vj_hits, v_hits, j_hits});
             }
         }
+
+        void PrintRead(std::ostream &out, const core::Read &read) {
+            out << ">" << read.name << std::endl;
+            out << read.seq << std::endl;
+        }
+
+        // index is 1-based number of aligned read
+        void PrintVAlignment(std::ostream &out, ImmuneGeneAlignmentConverter &alignment_converter,
+                             const VJHits &vj_hits, size_t index) {
+            auto v_hit = vj_hits.GetVHitByIndex(0);
+            auto v_alignment = alignment_converter.ConvertToAlignment(v_hit.ImmuneGene(), vj_hits.Read(),
+                                                                      v_hit.BlockAlignment());
+            auto subject_row = seqan::row(v_alignment.Alignment(), 0);
+            auto query_row = seqan::row(v_alignment.Alignment(), 1);
+            out << ">INDEX:" << index << "|READ:" << vj_hits.Read().name << "|START_POS:" <<
+                    v_alignment.StartSubjectPosition() << "|END_POS:" <<
+                    v_alignment.EndSubjectPosition() << std::endl;
+            out << query_row << std::endl;
+            out << ">INDEX:" << index << "|GENE:" << v_alignment.subject().name() <<
+            "|START_POS:" << v_alignment.StartQueryPosition() << "|END_POS:" <<
+                    v_alignment.EndQueryPosition() << "|CHAIN_TYPE:" <<
+                    v_alignment.subject().Chain() << std::endl;
+            out << subject_row << std::endl;
+        }
+
+        void PrintFilteringInfo(std::ostream &out, const VJFilteringInfo &filtering_info) {
+            out << filtering_info.read->name << "\t" << filtering_info << std::endl;
+        }
+    }
+
+    void VJAlignmentOutput::OutputAlignmentInfo() const {
+        std::ofstream out(output_params_.output_files.alignment_info_fname);
+        const auto columns = ParseAlignmentColumns(output_params_);
+        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++)
+            PrintAlignmentInfo(out, columns, alignment_info_.GetVJHitsByIndex(i),
+                               output_params_.output_details.num_aligned_candidates);
         out.close();
         INFO("Alignment info was written to " << output_params_.output_files.alignment_info_fname);
     }
 
     void VJAlignmentOutput::OutputCleanedReads() const {
         std::ofstream out(output_params_.output_files.cleaned_reads_fname);
-        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++) {
-            auto read = alignment_info_.GetVJHitsByIndex(i).Read();
-            out << ">" << read.name << std::endl;
-            out << read.seq << std::endl;
-        }
+        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++)
+            PrintRead(out, alignment_info_.GetVJHitsByIndex(i).Read());
         out.close();
         INFO("Cleaned reads were written to " << output_params_.output_files.cleaned_reads_fname);
     }
 
     void VJAlignmentOutput::OutputFilteredReads() const {
         std::ofstream out(output_params_.output_files.filtered_reads_fname);
-        for(size_t i = 0; i < alignment_info_.NumFilteredReads(); i++) {
-            auto read = alignment_info_.GetFilteredReadByIndex(i);
-            out << ">" << read.name << std::endl;
-            out << read.seq << std::endl;
-        }
+        for(size_t i = 0; i < alignment_info_.NumFilteredReads(); i++)
+            PrintRead(out, alignment_info_.GetFilteredReadByIndex(i));
         out.close();
         INFO("Filtered reads were written to " << output_params_.output_files.filtered_reads_fname);
     }
@@ -95,36 +144,63 @@ namespace vj_finder {
     void VJAlignmentOutput::OutputVAlignments() const {
         ImmuneGeneAlignmentConverter alignment_converter;
         std::ofstream out(output_params_.output_files.valignments_filename);
-        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++) {
-            auto vj_hits = alignment_info_.GetVJHitsByIndex(i);
-            auto v_hit = vj_hits.GetVHitByIndex(0);
-            auto v_alignment = alignment_converter.ConvertToAlignment(v_hit.ImmuneGene(), vj_hits.Read(),
-                                                                      v_hit.BlockAlignment());
-            auto subject_row = seqan::row(v_alignment.Alignment(), 0);
-            auto query_row = seqan::row(v_alignment.Alignment(), 1);
-            out << ">INDEX:" << i + 1 << "|READ:" << vj_hits.Read().name << "|START_POS:" <<
-                    v_alignment.StartSubjectPosition() << "|END_POS:" <<
-                    v_alignment.EndSubjectPosition() << std::endl;
-            out << query_row << std::endl;
-            out << ">INDEX:" << i + 1 << "|GENE:" << v_alignment.subject().name() <<
-            "|START_POS:" << v_alignment.StartQueryPosition() << "|END_POS:" <<
-                    v_alignment.EndQueryPosition() << "|CHAIN_TYPE:" <<
-                    v_alignment.subject().Chain() << std::endl;
-            out << subject_row << std::endl;
-        }
+        for(size_t i = 0; i < alignment_info_.NumVJHits(); i++)
+            PrintVAlignment(out, alignment_converter, alignment_info_.GetVJHitsByIndex(i), i + 1);
         out.close();
         INFO("V alignments were written to " << output_params_.output_files.valignments_filename);
     }
 
     void VJAlignmentOutput::OutputFilteringInfo() const {
         std::ofstream out(output_params_.output_files.filtering_info_filename);
-        for(size_t i = 0; i < alignment_info_.NumFilteredReads(); i++) {
-            auto filtering_info = alignment_info_.GetFilteringInfoByIndex(i);
-            out << filtering_info.read->name << "\t" << filtering_info << std::endl;
-        }
+        for(size_t i = 0; i < alignment_info_.NumFilteredReads(); i++)
+            PrintFilteringInfo(out, alignment_info_.GetFilteringInfoByIndex(i));
         out.close();
         INFO("Information about filtered reads was written to " << output_params_.output_files.filtering_info_filename);
     }
+
+    VJAlignmentStreamOutput::VJAlignmentStreamOutput(
+            const VJFinderConfig::IOParams::OutputParams &output_params) :
+            output_params_(output_params),
+            alignment_info_out_(output_params.output_files.alignment_info_fname),
+            cleaned_reads_out_(output_params.output_files.cleaned_reads_fname),
+            filtered_reads_out_(output_params.output_files.filtered_reads_fname),
+            valignments_out_(output_params.output_files.valignments_filename),
+            filtering_info_out_(output_params.output_files.filtering_info_filename),
+            num_vj_hits_(0),
+            num_filtered_reads_(0) { }
+
+    void VJAlignmentStreamOutput::Write(const VJAlignmentInfo &alignment_info) {
+        const auto columns = ParseAlignmentColumns(output_params_);
+        ImmuneGeneAlignmentConverter alignment_converter;
+        for(size_t i = 0; i < alignment_info.NumVJHits(); i++) {
+            const auto &vj_hits = alignment_info.GetVJHitsByIndex(i);
+            PrintAlignmentInfo(alignment_info_out_, columns, vj_hits,
+                               output_params_.output_details.num_aligned_candidates);
+            PrintRead(cleaned_reads_out_, vj_hits.Read());
+            PrintVAlignment(valignments_out_, alignment_converter, vj_hits, num_vj_hits_ + i + 1);
+        }
+        for(size_t i = 0; i < alignment_info.NumFilteredReads(); i++) {
+            PrintRead(filtered_reads_out_, alignment_info.GetFilteredReadByIndex(i));
+            PrintFilteringInfo(filtering_info_out_, alignment_info.GetFilteringInfoByIndex(i));
+        }
+        num_vj_hits_ += alignment_info.NumVJHits();
+        num_filtered_reads_ += alignment_info.NumFilteredReads();
+        for(auto it = alignment_info.chain_type_cbegin(); it != alignment_info.chain_type_cend(); it++)
+            chain_type_abundance_[it->first] += it->second;
+    }
+
+    void VJAlignmentStreamOutput::Close() {
+        alignment_info_out_.close();
+        INFO("Alignment info was written to " << output_params_.output_files.alignment_info_fname);
+        cleaned_reads_out_.close();
+        INFO("Cleaned reads were written to " << output_params_.output_files.cleaned_reads_fname);
+        valignments_out_.close();
+        INFO("V alignments were written to " << output_params_.output_files.valignments_filename);
+        filtered_reads_out_.close();
+        INFO("Filtered reads were written to " << output_params_.output_files.filtered_reads_fname);
+        filtering_info_out_.close();
+        INFO("Information about filtered reads was written to " << output_params_.output_files.filtering_info_filename);
+    }
 }
 
 namespace ReportColumns {
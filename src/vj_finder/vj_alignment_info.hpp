@@ -1,5 +1,6 @@
 #pragma once
 
+#include <fstream>
 #include <unordered_set>
 #include "vj_finder_config.hpp"
 #include "vj_alignment_structs.hpp"
@@ -7,19 +8,38 @@
 
 namespace vj_finder {
     class VJAlignmentInfo {
+    public:
+        typedef std::unordered_map<germline_utils::ChainType, size_t,
+                germline_utils::ChainTypeHasher> ChainTypeAbundanceMap;
+
+    private:
+        static const size_t NO_RECORD = size_t(-1);
+
         std::vector<VJHits> alignment_records_;
         std::vector<VJFilteringInfo> filtering_infos_;
 
-        std::map<size_t, size_t> read_id_hit_index_map_;
-        std::map<size_t, size_t> read_id_filtering_info_map_;
+        // i-th element is index of record for read with id i or NO_RECORD
+        std::vector<size_t> read_id_hit_index_;
+        std::vector<size_t> read_id_filtering_info_index_;
+
+        ChainTypeAbundanceMap chain_type_abundance_;
 
-        std::unordered_map<germline_utils::ChainType, size_t, germline_utils::ChainTypeHasher> chain_type_abundance_;
+        static void SetRecordIndex(std::vector<size_t> &read_id_index, size_t read_id, size_t record_index);
+
+        static bool HasRecord(const std::vector<size_t> &read_id_index, size_t read_id) {
+            return read_id < read_id_index.size() and read_id_index[read_id] != NO_RECORD;
+        }
 
         void UpdateChainTypeMap(const VJHits &vj_hits);
 
     public:
         VJAlignmentInfo() { }
 
+        // records are taken as is, abundances of chain types should be computed by caller
+        VJAlignmentInfo(std::vector<VJHits> &&alignment_records,
+                        std::vector<VJFilteringInfo> &&filtering_infos,
+                        ChainTypeAbundanceMap chain_type_abundance);
+
         void UpdateHits(VJHits vj_hits);
 
         void UpdateFilteringInfo(VJFilteringInfo filtering_info);
@@ -41,19 +61,19 @@ namespace vj_finder {
         VJFilteringInfo GetFilteringInfoByRead(const core::Read &read) const;
 
         bool ReadIsFiltered(const core::Read &read) const {
-            return read_id_filtering_info_map_.find(read.id) != read_id_filtering_info_map_.end();
+            return HasRecord(read_id_filtering_info_index_, read.id);
         }
 
         size_t GetVJHitIndexByRead(const core::Read &read) const {
-            VERIFY_MSG(read_id_hit_index_map_.find(read.id) != read_id_hit_index_map_.end(),
+            VERIFY_MSG(HasRecord(read_id_hit_index_, read.id),
                        "Info does contain record for aligned read " << read.name);
-            return read_id_hit_index_map_.at(read.id);
+            return read_id_hit_index_[read.id];
         }
 
         size_t GetFilteringInfoIndexByRead(const core::Read &read) const {
-            VERIFY_MSG(read_id_filtering_info_map_.find(read.id) != read_id_filtering_info_map_.end(),
+            VERIFY_MSG(HasRecord(read_id_filtering_info_index_, read.id),
                        "Info does contain record for filtered read " << read.name);
-            return read_id_filtering_info_map_.at(read.id);
+            return read_id_filtering_info_index_[read.id];
         }
 
         const core::Read& GetFilteredReadByIndex(size_t filtering_info_index) const {
@@ -62,14 +82,19 @@ namespace vj_finder {
             return *(filtering_infos_[filtering_info_index].read);
         }
 
-        typedef std::unordered_map<germline_utils::ChainType, size_t,
-                germline_utils::ChainTypeHasher>::const_iterator ChainTypeAbundanceConstIter;
+        typedef ChainTypeAbundanceMap::const_iterator ChainTypeAbundanceConstIter;
 
         ChainTypeAbundanceConstIter chain_type_cbegin() const { return chain_type_abundance_.cbegin(); }
 
         ChainTypeAbundanceConstIter chain_type_cend() const { return chain_type_abundance_.cend(); }
     };
 
+    struct VJFReportEvalContext {
+        const VJHits& vj_hits;
+        const VGeneHit& v_hits;
+        const JGeneHit& j_hits;
+    };
+
     class VJAlignmentOutput {
         const VJFinderConfig::IOParams::OutputParams &output_params_;
         const VJAlignmentInfo &alignment_info_;
@@ -91,9 +116,37 @@ namespace vj_finder {
 
     };
 
-    struct VJFReportEvalContext {
-        const VJHits& vj_hits;
-        const VGeneHit& v_hits;
-        const JGeneHit& j_hits;
+
+    // Appends alignment infos to the same files as VJAlignmentOutput does, e.g. chunk by chunk.
+    // Output of consecutive Write calls is the same as output of VJAlignmentOutput for the joined info
+    class VJAlignmentStreamOutput {
+        const VJFinderConfig::IOParams::OutputParams &output_params_;
+
+        std::ofstream alignment_info_out_;
+        std::ofstream cleaned_reads_out_;
+        std::ofstream filtered_reads_out_;
+        std::ofstream valignments_out_;
+        std::ofstream filtering_info_out_;
+
+        size_t num_vj_hits_;
+        size_t num_filtered_reads_;
+        VJAlignmentInfo::ChainTypeAbundanceMap chain_type_abundance_;
+
+    public:
+        VJAlignmentStreamOutput(const VJFinderConfig::IOParams::OutputParams &output_params);
+
+        void Write(const VJAlignmentInfo &alignment_info);
+
+        void Close();
+
+        size_t NumFilteredReads() const { return num_filtered_reads_; }
+
+        size_t NumVJHits() const { return num_vj_hits_; }
+
+        typedef VJAlignmentInfo::ChainTypeAbundanceConstIter ChainTypeAbundanceConstIter;
+
+        ChainTypeAbundanceConstIter chain_type_cbegin() const { return chain_type_abundance_.cbegin(); }
+
+        ChainTypeAbundanceConstIter chain_type_cend() const { return chain_type_abundance_.cend(); }
     };
 }
\ No newline at end of file
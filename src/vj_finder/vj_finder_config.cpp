@@ -10,6 +10,8 @@ namespace vj_finder {
     void load(VJFinderConfig::RunParams &rp, boost::property_tree::ptree const &pt, bool) {
         using config_common::load;
         load(rp.num_threads, pt, "num_threads");
+        load(rp.streaming, pt, "streaming");
+        load(rp.chunk_size, pt, "chunk_size");
     }
 
     void update_input_config(VJFinderConfig::IOParams::InputParams & ip) {
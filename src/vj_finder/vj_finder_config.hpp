@@ -12,6 +12,9 @@ namespace vj_finder {
     struct VJFinderConfig {
         struct RunParams {
             size_t num_threads;
+            // reads are aligned and written by chunks without loading the whole input
+            bool streaming;
+            size_t chunk_size;
         };
 
         struct IOParams {
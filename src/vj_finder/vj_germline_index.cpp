@@ -0,0 +1,40 @@
+#include <verify.hpp>
+#include <logger/logger.hpp>
+
+#include "vj_germline_index.hpp"
+
+namespace vj_finder {
+    void VJGermlineIndex::CheckDbConsistencyFatal() const {
+        VERIFY_MSG(v_custom_db_.num_dbs() == j_custom_db_.num_dbs(), "Size of V gene DB (" << v_custom_db_.num_dbs() <<
+                ") does not match with J gene DB (" << j_custom_db_.num_dbs() << ")");
+    }
+
+    void VJGermlineIndex::Initialize(const VJFinderConfig::AlgorithmParams::AlignerParams &aligner_params) {
+        v_kmer_index_helper_.reset(new CustomGermlineDbHelper(v_custom_db_));
+        v_kmer_index_.reset(new VKmerIndex(v_custom_db_, aligner_params.word_size_v, *v_kmer_index_helper_));
+        TRACE("Kmer index for V gene segment DB was constructed");
+        for(auto it = j_custom_db_.cbegin(); it != j_custom_db_.cend(); it++) {
+            const germline_utils::ImmuneGeneDatabase &j_gene_db = j_custom_db_.GetConstDbByGeneType(*it);
+            std::unique_ptr<ImmuneGeneGermlineDbHelper> j_helper(new ImmuneGeneGermlineDbHelper(j_gene_db));
+            std::unique_ptr<JKmerIndex> j_index(new JKmerIndex(j_gene_db, aligner_params.word_size_j, *j_helper));
+            j_kmer_index_helpers_[*it] = std::move(j_helper);
+            j_kmer_indices_[*it] = std::move(j_index);
+            TRACE("Kmer index for J gene segment DB " << *it << " was constructed");
+        }
+    }
+
+    bool VJGermlineIndex::ContainsJIndex(germline_utils::ImmuneGeneType j_gene_type) const {
+        return j_kmer_indices_.find(j_gene_type) != j_kmer_indices_.end();
+    }
+
+    const VJGermlineIndex::JKmerIndex& VJGermlineIndex::JIndex(germline_utils::ImmuneGeneType j_gene_type) const {
+        VERIFY_MSG(ContainsJIndex(j_gene_type), "Custom DB does not contains gene type " << j_gene_type);
+        return *j_kmer_indices_.at(j_gene_type);
+    }
+
+    const ImmuneGeneGermlineDbHelper& VJGermlineIndex::JIndexHelper(
+            germline_utils::ImmuneGeneType j_gene_type) const {
+        VERIFY_MSG(ContainsJIndex(j_gene_type), "Custom DB does not contains gene type " << j_gene_type);
+        return *j_kmer_index_helpers_.at(j_gene_type);
+    }
+}
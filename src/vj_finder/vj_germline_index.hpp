@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "vj_finder_config.hpp"
+#include "vj_alignment_structs.hpp"
+#include "hashes/subject_query_kmer_index.hpp"
+
+namespace vj_finder {
+    // immutable k-mer index over V and J germline databases
+    // it is constructed once and shared (read-only) by all aligners and threads
+    class VJGermlineIndex {
+    public:
+        typedef algorithms::SubjectQueryKmerIndex<germline_utils::CustomGeneDatabase, seqan::Dna5String>
+                VKmerIndex;
+        typedef algorithms::SubjectQueryKmerIndex<germline_utils::ImmuneGeneDatabase, seqan::Dna5String>
+                JKmerIndex;
+
+    private:
+        const germline_utils::CustomGeneDatabase &v_custom_db_;
+        const germline_utils::CustomGeneDatabase &j_custom_db_;
+
+        // helpers are stored by pointers since indices keep references to them
+        std::unique_ptr<CustomGermlineDbHelper> v_kmer_index_helper_;
+        std::unique_ptr<VKmerIndex> v_kmer_index_;
+
+        // J indices are constructed for each locus (gene type) separately
+        std::unordered_map<germline_utils::ImmuneGeneType,
+                std::unique_ptr<ImmuneGeneGermlineDbHelper>, germline_utils::ImmuneGeneTypeHasher> j_kmer_index_helpers_;
+        std::unordered_map<germline_utils::ImmuneGeneType,
+                std::unique_ptr<JKmerIndex>, germline_utils::ImmuneGeneTypeHasher> j_kmer_indices_;
+
+        void CheckDbConsistencyFatal() const;
+
+        void Initialize(const VJFinderConfig::AlgorithmParams::AlignerParams &aligner_params);
+
+    public:
+        VJGermlineIndex(const VJFinderConfig::AlgorithmParams &algorithm_params,
+                        const germline_utils::CustomGeneDatabase &v_custom_db,
+                        const germline_utils::CustomGeneDatabase &j_custom_db) :
+                v_custom_db_(v_custom_db),
+                j_custom_db_(j_custom_db) {
+            CheckDbConsistencyFatal();
+            Initialize(algorithm_params.aligner_params);
+        }
+
+        VJGermlineIndex(const VJGermlineIndex &) = delete;
+        VJGermlineIndex& operator=(const VJGermlineIndex &) = delete;
+
+        const germline_utils::CustomGeneDatabase& VDb() const { return v_custom_db_; }
+
+        const germline_utils::CustomGeneDatabase& JDb() const { return j_custom_db_; }
+
+        const VKmerIndex& VIndex() const { return *v_kmer_index_; }
+
+        const CustomGermlineDbHelper& VIndexHelper() const { return *v_kmer_index_helper_; }
+
+        bool ContainsJIndex(germline_utils::ImmuneGeneType j_gene_type) const;
+
+        const JKmerIndex& JIndex(germline_utils::ImmuneGeneType j_gene_type) const;
+
+        const ImmuneGeneGermlineDbHelper& JIndexHelper(germline_utils::ImmuneGeneType j_gene_type) const;
+
+    private:
+        DECL_LOGGER("VJGermlineIndex");
+    };
+}
@@ -1,49 +1,54 @@
 #include "vj_parallel_processor.hpp"
 
 namespace vj_finder {
-    void VJParallelProcessor::Initialize() {
-        for(size_t i = 0; i < read_archive_.size(); i++)
-            thread_id_per_read_.push_back(size_t(-1));
-        for(size_t i = 0; i < num_threads_; i++)
-            info_per_thread.push_back(VJAlignmentInfo());
-    }
-
-    VJAlignmentInfo VJParallelProcessor::GatherAlignmentInfos() {
-        VJAlignmentInfo consistent_alignment_info;
-        for(size_t i = 0; i < read_archive_.size(); i++) {
-            size_t thread_id = thread_id_per_read_[i];
-            if(info_per_thread[thread_id].ReadIsFiltered(read_archive_[i])) {
-                size_t local_index = info_per_thread[thread_id].GetFilteringInfoIndexByRead(read_archive_[i]);
-                consistent_alignment_info.UpdateFilteringInfo(
-                        info_per_thread[thread_id].GetFilteringInfoByIndex(local_index));
-            }
-            else {
-                size_t local_index = info_per_thread[thread_id].GetVJHitIndexByRead(read_archive_[i]);
-                consistent_alignment_info.UpdateHits(info_per_thread[thread_id].GetVJHitsByIndex(local_index));
-            }
+    VJAlignmentInfo VJParallelProcessor::CreateAlignmentInfo(
+            std::vector<ProcessedVJHits> &processed_reads,
+            const std::vector<VJAlignmentInfo::ChainTypeAbundanceMap> &chain_types_per_thread) const {
+        VJAlignmentInfo::ChainTypeAbundanceMap chain_type_abundance;
+        for(auto it = chain_types_per_thread.begin(); it != chain_types_per_thread.end(); it++)
+            for(auto it2 = it->begin(); it2 != it->end(); it2++)
+                chain_type_abundance[it2->first] += it2->second;
+        size_t num_filtered_reads = 0;
+        for(auto it = processed_reads.begin(); it != processed_reads.end(); it++)
+            num_filtered_reads += it->ReadToBeFiltered();
+        std::vector<VJHits> alignment_records;
+        std::vector<VJFilteringInfo> filtering_infos;
+        alignment_records.reserve(processed_reads.size() - num_filtered_reads);
+        filtering_infos.reserve(num_filtered_reads);
+        for(auto it = processed_reads.begin(); it != processed_reads.end(); it++) {
+            if(it->ReadToBeFiltered())
+                filtering_infos.push_back(it->filtering_info);
+            else
+                alignment_records.push_back(std::move(it->vj_hits));
         }
-        return consistent_alignment_info;
+        return VJAlignmentInfo(std::move(alignment_records), std::move(filtering_infos),
+                               std::move(chain_type_abundance));
     }
 
     VJAlignmentInfo VJParallelProcessor::Process() {
         omp_set_num_threads(int(num_threads_));
+        // germline index is shared by all threads, query processors are thread-local
+        std::vector<VJQueryProcessor> query_processors;
+        query_processors.reserve(num_threads_);
+        for(size_t i = 0; i < num_threads_; i++)
+            query_processors.emplace_back(algorithm_params_, read_archive_, germline_index_);
+        // i-th slot is written only by the thread processing i-th read, so no synchronization is needed
+        std::vector<ProcessedVJHits> processed_reads;
+        processed_reads.reserve(read_archive_.size());
+        for(size_t i = 0; i < read_archive_.size(); i++)
+            processed_reads.emplace_back(read_archive_[i]);
+        std::vector<VJAlignmentInfo::ChainTypeAbundanceMap> chain_types_per_thread(num_threads_);
 #pragma omp parallel for schedule(dynamic)
         for(size_t i = 0; i < read_archive_.size(); i++) {
             TRACE("Processing read: " << read_archive_[i].name);
             size_t thread_id = omp_get_thread_num();
-            thread_id_per_read_[i] = thread_id;
-            VJQueryProcessor vj_query_processor(algorithm_params_, read_archive_, v_db_, j_db_);
-            auto processed_read = vj_query_processor.Process(read_archive_[i]);
-            if(processed_read.ReadToBeFiltered()) {
-//                std::cout << "bad: " << processed_read.filtering_info.filtering_reason << std::endl;
-                info_per_thread[thread_id].UpdateFilteringInfo(processed_read.filtering_info);
-            }
-            else {
-//                std::cout << "good" << std::endl;
-                info_per_thread[thread_id].UpdateHits(processed_read.vj_hits);
-            }
+            auto processed_read = query_processors[thread_id].Process(read_archive_[i]);
+            processed_reads[i].filtering_info = processed_read.filtering_info;
+            processed_reads[i].vj_hits = std::move(processed_read.vj_hits);
+            if(!processed_read.ReadToBeFiltered())
+                chain_types_per_thread[thread_id][processed_reads[i].vj_hits.GetVHitByIndex(0).ImmuneGene().Chain()]++;
         }
-        auto total_alignment_info = GatherAlignmentInfos();
+        auto total_alignment_info = CreateAlignmentInfo(processed_reads, chain_types_per_thread);
         size_t num_aligned_reads = total_alignment_info.NumVJHits();
         for(auto it = total_alignment_info.chain_type_cbegin(); it != total_alignment_info.chain_type_cend(); it++) {
             float perc = float(it->second) / float(num_aligned_reads) * 100;
@@ -7,30 +7,35 @@ namespace vj_finder {
     class VJParallelProcessor {
         core::ReadArchive &read_archive_;
         const VJFinderConfig::AlgorithmParams &algorithm_params_;
-        const germline_utils::CustomGeneDatabase &v_db_;
-        const germline_utils::CustomGeneDatabase &j_db_;
+        // index is owned by processor only if it was not provided by caller
+        std::shared_ptr<VJGermlineIndex> own_germline_index_;
+        const VJGermlineIndex &germline_index_;
         size_t num_threads_;
 
-        // i-th element shows which thread processed i-th read
-        std::vector<size_t> thread_id_per_read_;
-        // i-th element stores Alignment info created by i-th thread
-        std::vector<VJAlignmentInfo> info_per_thread;
-
-        void Initialize();
-
-        VJAlignmentInfo GatherAlignmentInfos();
+        // records of processed reads are moved to alignment info in the order of reads
+        VJAlignmentInfo CreateAlignmentInfo(std::vector<ProcessedVJHits> &processed_reads,
+                                            const std::vector<VJAlignmentInfo::ChainTypeAbundanceMap> &
+                                                    chain_types_per_thread) const;
 
     public:
         VJParallelProcessor(core::ReadArchive &read_archive,
                             const VJFinderConfig::AlgorithmParams &algorithm_params,
                             const germline_utils::CustomGeneDatabase &v_db,
-                            const germline_utils::CustomGeneDatabase &j_db_,
+                            const germline_utils::CustomGeneDatabase &j_db,
+                            size_t num_threads) : read_archive_(read_archive),
+                                                  algorithm_params_(algorithm_params),
+                                                  own_germline_index_(std::make_shared<VJGermlineIndex>(
+                                                          algorithm_params, v_db, j_db)),
+                                                  germline_index_(*own_germline_index_),
+                                                  num_threads_(num_threads) { }
+
+        VJParallelProcessor(core::ReadArchive &read_archive,
+                            const VJFinderConfig::AlgorithmParams &algorithm_params,
+                            const VJGermlineIndex &germline_index,
                             size_t num_threads) : read_archive_(read_archive),
                                                   algorithm_params_(algorithm_params),
-                                                  v_db_(v_db), j_db_(j_db_),
-                                                  num_threads_(num_threads) {
-            Initialize();
-        }
+                                                  germline_index_(germline_index),
+                                                  num_threads_(num_threads) { }
 
         VJAlignmentInfo Process();
     };
@@ -5,11 +5,6 @@
 #include "vj_query_aligner.hpp"
 
 namespace vj_finder {
-    void VJQueryAligner::CheckDbConsistencyFatal() {
-        VERIFY_MSG(v_custom_db_.num_dbs() == j_custom_db_.num_dbs(), "Size of V gene DB (" << v_custom_db_.num_dbs() <<
-                ") does not match with J gene DB (" << j_custom_db_.num_dbs() << ")");
-    }
-
     bool VJQueryAligner::VAlignmentsAreConsistent(const VJQueryAligner::CustomDbBlockAlignmentHits &v_alignments) const {
         std::unordered_set<germline_utils::ImmuneGeneType, germline_utils::ImmuneGeneTypeHasher> gene_types;
         for(size_t i = 0; i < v_alignments.size(); i++)
@@ -37,18 +32,8 @@ namespace vj_finder {
     VJHits VJQueryAligner::Align(core::Read &read) {
         using namespace algorithms;
         TRACE("VJ Aligner algorithm starts");
-        // we can construct it once and use as a parameter of constructor
-        CustomGermlineDbHelper v_kmer_index_helper(v_custom_db_);
-        SubjectQueryKmerIndex<germline_utils::CustomGeneDatabase, seqan::Dna5String> v_kmer_index(
-                v_custom_db_, algorithm_params_.aligner_params.word_size_v, v_kmer_index_helper);
-        TRACE("Kmer index for V gene segment DB was constructed");
-        PairwiseBlockAligner<germline_utils::CustomGeneDatabase, seqan::Dna5String> v_aligner(
-                v_kmer_index, v_kmer_index_helper,
-                CreateBlockAlignmentScoring<VJFinderConfig::AlgorithmParams::ScoringParams::VScoringParams>(
-                algorithm_params_.scoring_params.v_scoring),
-                CreateVBlockAlignerParams());
         TRACE("Computation of V hits");
-        CustomDbBlockAlignmentHits v_aligns = v_aligner.Align(read.seq);
+        CustomDbBlockAlignmentHits v_aligns = v_aligner_.Align(read.seq);
         TRACE(v_aligns.size() << " V hits were computed: ")
         for(auto it = v_aligns.begin(); it != v_aligns.end(); it++) {
             TRACE(v_custom_db_[it->second].name() << ", start: " << it->first.first_match_read_pos() <<
@@ -58,7 +43,7 @@ namespace vj_finder {
         bool strand = true;
         if(algorithm_params_.aligner_params.fix_strand) {
             core::Read read_rc = read.ReverseComplement();
-            CustomDbBlockAlignmentHits reverse_v_aligns = v_aligner.Align(read_rc.seq);
+            CustomDbBlockAlignmentHits reverse_v_aligns = v_aligner_.Align(read_rc.seq);
             if(v_aligns.BestScore() < reverse_v_aligns.BestScore()) {
                 TRACE("Reverse complementary strand was selected");
                 stranded_read = read_rc;
@@ -72,18 +57,12 @@ namespace vj_finder {
         TRACE("V Locus was identified: " << v_chain_type);
         TRACE("Strand: " << strand);
 
-        const germline_utils::ImmuneGeneDatabase& j_gene_db = j_custom_db_.GetConstDbByGeneType(
-                germline_utils::ImmuneGeneType(v_chain_type, germline_utils::SegmentType::JoinSegment));
+        germline_utils::ImmuneGeneType j_gene_type(v_chain_type, germline_utils::SegmentType::JoinSegment);
+        const germline_utils::ImmuneGeneDatabase& j_gene_db = j_custom_db_.GetConstDbByGeneType(j_gene_type);
         TRACE("J database for locus " << v_chain_type << " consists of " << j_gene_db.size() << " gene segments");
 
-        ImmuneGeneGermlineDbHelper j_kmer_index_helper(j_gene_db);
-        SubjectQueryKmerIndex<germline_utils::ImmuneGeneDatabase, seqan::Dna5String> j_kmer_index(
-                j_gene_db, algorithm_params_.aligner_params.word_size_j, j_kmer_index_helper);
-        PairwiseBlockAligner<germline_utils::ImmuneGeneDatabase, seqan::Dna5String> j_aligner(
-                j_kmer_index, j_kmer_index_helper,
-                CreateBlockAlignmentScoring<VJFinderConfig::AlgorithmParams::ScoringParams::JScoringParams>(
-                        algorithm_params_.scoring_params.j_scoring),
-                CreateJBlockAlignerParams());
+        // J aligner is lightweight: it refers to the prebuilt J index of the locus
+        JBlockAligner j_aligner = CreateJAligner(j_gene_type);
         auto dj_read_suffix = DefineReadJSuffix(v_aligns, stranded_read.seq);
         if(seqan::length(dj_read_suffix) == 0)
             return VJHits(read);
@@ -3,18 +3,21 @@
 #include "vj_finder_config.hpp"
 #include <germline_utils/germline_databases/custom_gene_database.hpp>
 #include "vj_alignment_structs.hpp"
+#include "vj_germline_index.hpp"
 #include "block_alignment/pairwise_block_aligner.hpp"
 
 namespace vj_finder {
     class VJQueryAligner {
         const VJFinderConfig::AlgorithmParams & algorithm_params_;
 
+        // index is owned by aligner only if it was not provided by caller
+        std::shared_ptr<VJGermlineIndex> own_germline_index_;
+        const VJGermlineIndex &germline_index_;
+
         //core::ReadArchive &read_archive_;
         const germline_utils::CustomGeneDatabase &v_custom_db_;
         const germline_utils::CustomGeneDatabase &j_custom_db_;
 
-        void CheckDbConsistencyFatal();
-
         template<typename ConfigStruct>
         algorithms::BlockAlignmentScoringScheme CreateBlockAlignmentScoring(const ConfigStruct& cfg) const {
             algorithms::BlockAlignmentScoringScheme scoring;
@@ -43,6 +46,26 @@ namespace vj_finder {
 
         typedef algorithms::BlockAlignmentHits<germline_utils::ImmuneGeneDatabase> ImmuneDbBlockAlignmentHits;
 
+        typedef algorithms::PairwiseBlockAligner<germline_utils::CustomGeneDatabase, seqan::Dna5String> VBlockAligner;
+
+        typedef algorithms::PairwiseBlockAligner<germline_utils::ImmuneGeneDatabase, seqan::Dna5String> JBlockAligner;
+
+        VBlockAligner v_aligner_;
+
+        VBlockAligner CreateVAligner() const {
+            return VBlockAligner(germline_index_.VIndex(), germline_index_.VIndexHelper(),
+                                 CreateBlockAlignmentScoring<VJFinderConfig::AlgorithmParams::ScoringParams::VScoringParams>(
+                                         algorithm_params_.scoring_params.v_scoring),
+                                 CreateVBlockAlignerParams());
+        }
+
+        JBlockAligner CreateJAligner(germline_utils::ImmuneGeneType j_gene_type) const {
+            return JBlockAligner(germline_index_.JIndex(j_gene_type), germline_index_.JIndexHelper(j_gene_type),
+                                 CreateBlockAlignmentScoring<VJFinderConfig::AlgorithmParams::ScoringParams::JScoringParams>(
+                                         algorithm_params_.scoring_params.j_scoring),
+                                 CreateJBlockAlignerParams());
+        }
+
         bool VAlignmentsAreConsistent(const CustomDbBlockAlignmentHits& v_alignments) const;
 
         germline_utils::ChainType IdentifyLocus(const CustomDbBlockAlignmentHits& v_alignments) const;
@@ -51,16 +74,27 @@ namespace vj_finder {
                                             seqan::Dna5String read) const;
 
     public:
+        // constructs k-mer index of V and J databases on its own
+        // it is expensive, so a shared VJGermlineIndex should be used if many reads are aligned
         VJQueryAligner(const VJFinderConfig::AlgorithmParams &algorithm_params,
                        //core::ReadArchive &read_archive,
                        const germline_utils::CustomGeneDatabase &v_custom_db,
                        const germline_utils::CustomGeneDatabase &j_custom_db) :
                 algorithm_params_(algorithm_params),
+                own_germline_index_(std::make_shared<VJGermlineIndex>(algorithm_params, v_custom_db, j_custom_db)),
+                germline_index_(*own_germline_index_),
                 //read_archive_(read_archive),
                 v_custom_db_(v_custom_db),
-                j_custom_db_(j_custom_db) {
-            CheckDbConsistencyFatal();
-        }
+                j_custom_db_(j_custom_db),
+                v_aligner_(CreateVAligner()) { }
+
+        VJQueryAligner(const VJFinderConfig::AlgorithmParams &algorithm_params,
+                       const VJGermlineIndex &germline_index) :
+                algorithm_params_(algorithm_params),
+                germline_index_(germline_index),
+                v_custom_db_(germline_index.VDb()),
+                j_custom_db_(germline_index.JDb()),
+                v_aligner_(CreateVAligner()) { }
 
         VJHits Align(core::Read& read);
 
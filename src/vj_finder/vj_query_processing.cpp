@@ -20,8 +20,7 @@ namespace vj_finder {
     }
 
     ProcessedVJHits VJQueryProcessor::Process(core::Read &read) {
-        VJQueryAligner vj_query_aligner(params_, v_db_, j_db_);
-        VJHits vj_hits = vj_query_aligner.Align(read);
+        VJHits vj_hits = vj_query_aligner_.Align(read);
         ProcessedVJHits hits_after_fitering = ComputeFilteringResults(read, vj_hits);
         if(hits_after_fitering.ReadToBeFiltered()) {
             return hits_after_fitering;
@@ -22,8 +22,8 @@ namespace vj_finder {
     class VJQueryProcessor {
         const VJFinderConfig::AlgorithmParams &params_;
         core::ReadArchive &read_archive_;
-        const germline_utils::CustomGeneDatabase &v_db_;
-        const germline_utils::CustomGeneDatabase &j_db_;
+        // aligner is reused for all reads processed by this object
+        VJQueryAligner vj_query_aligner_;
 
         ProcessedVJHits ComputeFilteringResults(core::Read &read, VJHits vj_hits);
 
@@ -32,11 +32,9 @@ namespace vj_finder {
     public:
         VJQueryProcessor(const VJFinderConfig::AlgorithmParams &params,
                          core::ReadArchive &read_archive,
-                         const germline_utils::CustomGeneDatabase &v_db,
-                         const germline_utils::CustomGeneDatabase &j_db) : params_(params),
-                                                                           read_archive_(read_archive),
-                                                                           v_db_(v_db),
-                                                                           j_db_(j_db) { }
+                         const VJGermlineIndex &germline_index) : params_(params),
+                                                                  read_archive_(read_archive),
+                                                                  vj_query_aligner_(params, germline_index) { }
 
         ProcessedVJHits Process(core::Read &read);
     };
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cctype>
+
+#include <verify.hpp>
+#include <path_helper.hpp>
+#include <io/read_processor.hpp>
+
+#include "vj_streaming_processor.hpp"
+#include "vj_query_processing.hpp"
+
+namespace vj_finder {
+    VJReadChunkReader::VJReadChunkReader(const std::string &input_reads, size_t chunk_size, bool fix_spaces) :
+            chunk_size_(chunk_size),
+            fix_spaces_(fix_spaces),
+            num_chunks_(0),
+            num_reads_(0) {
+        VERIFY_MSG(chunk_size_ > 0, "Chunk size should be positive");
+        path::CheckFileExistenceFATAL(input_reads);
+        VERIFY_MSG(seqan::open(input_file_, input_reads.c_str()), "Cannot open " << input_reads);
+    }
+
+    VJReadChunkReader& VJReadChunkReader::operator>>(VJReadChunkPtr &chunk) {
+        chunk = std::make_shared<VJReadChunk>(num_chunks_++);
+        seqan::CharString header;
+        seqan::Dna5String seq;
+        while(chunk->read_archive.size() < chunk_size_ and !eof()) {
+            seqan::readRecord(header, seq, input_file_);
+            std::string name(seqan::toCString(header));
+            if(fix_spaces_)
+                std::replace_if(name.begin(), name.end(), [](char c) { return std::isspace(c); }, '_');
+            chunk->read_archive.AddRead(name, seq);
+        }
+        num_reads_ += chunk->read_archive.size();
+        return *this;
+    }
+
+    VJReadChunkWriter& VJReadChunkWriter::operator<<(const VJReadChunkPtr &chunk) {
+        reorder_buffer_[chunk->index] = chunk;
+        for(auto it = reorder_buffer_.begin(); it != reorder_buffer_.end() and it->first == next_chunk_;
+            it = reorder_buffer_.erase(it)) {
+            output_.Write(it->second->alignment_info);
+            next_chunk_++;
+        }
+        return *this;
+    }
+
+    void VJStreamingProcessor::AlignChunk(VJReadChunk &chunk) const {
+        // fix-fill-crop processor updates reads of the chunk archive
+        VJQueryProcessor query_processor(config_.algorithm_params, chunk.read_archive, germline_index_);
+        for(size_t i = 0; i < chunk.read_archive.size(); i++) {
+            TRACE("Processing read: " << chunk.read_archive[i].name);
+            auto processed_read = query_processor.Process(chunk.read_archive[i]);
+            if(processed_read.ReadToBeFiltered())
+                chunk.alignment_info.UpdateFilteringInfo(processed_read.filtering_info);
+            else
+                chunk.alignment_info.UpdateHits(processed_read.vj_hits);
+        }
+    }
+
+    void VJStreamingProcessor::Process() {
+        VJReadChunkReader reader(config_.io_params.input_params.input_reads,
+                                 config_.run_params.chunk_size,
+                                 config_.io_params.output_params.output_details.fix_spaces);
+        VJAlignmentStreamOutput output(config_.io_params.output_params);
+        VJReadChunkWriter writer(output);
+        auto aligner = [this](VJReadChunkPtr &chunk) -> VJReadChunkPtr* {
+            AlignChunk(*chunk);
+            return &chunk;
+        };
+        // master thread reads and writes chunks while others align them
+        hammer::ReadProcessor read_processor(static_cast<unsigned>(config_.run_params.num_threads));
+        read_processor.Run(reader, aligner, writer);
+        VERIFY_MSG(writer.Empty(), "Some aligned chunks were not written");
+        output.Close();
+
+        INFO(reader.NumReads() << " reads were extracted from " << config_.io_params.input_params.input_reads);
+        INFO(output.NumVJHits() << " reads were aligned; " << output.NumFilteredReads() <<
+                     " reads were filtered out");
+        size_t num_aligned_reads = output.NumVJHits();
+        for(auto it = output.chain_type_cbegin(); it != output.chain_type_cend(); it++) {
+            float perc = float(it->second) / float(num_aligned_reads) * 100;
+            INFO(perc << "% of aligned reads have isotype " << it->first);
+        }
+    }
+}
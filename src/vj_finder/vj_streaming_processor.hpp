@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <seqan/seq_io.h>
+
+#include "vj_alignment_info.hpp"
+#include "vj_germline_index.hpp"
+
+namespace vj_finder {
+    // chunk of consecutive input reads, ids of reads are local indices in the chunk
+    struct VJReadChunk {
+        size_t index;
+        core::ReadArchive read_archive;
+        VJAlignmentInfo alignment_info;
+
+        VJReadChunk(size_t index) : index(index) { }
+    };
+
+    // hits refer to reads of the chunk, so chunks are passed between threads by pointer only
+    typedef std::shared_ptr<VJReadChunk> VJReadChunkPtr;
+
+    class VJReadChunkReader {
+        seqan::SeqFileIn input_file_;
+        size_t chunk_size_;
+        bool fix_spaces_;
+        size_t num_chunks_;
+        size_t num_reads_;
+
+    public:
+        typedef VJReadChunkPtr ReadT;
+
+        VJReadChunkReader(const std::string &input_reads, size_t chunk_size, bool fix_spaces);
+
+        bool eof() { return seqan::atEnd(input_file_); }
+
+        VJReadChunkReader& operator>>(VJReadChunkPtr &chunk);
+
+        size_t NumReads() const { return num_reads_; }
+    };
+
+    // passes chunks to output in the order of reading,
+    // chunks that were aligned earlier than their predecessors wait in the reorder buffer
+    class VJReadChunkWriter {
+        VJAlignmentStreamOutput &output_;
+        std::map<size_t, VJReadChunkPtr> reorder_buffer_;
+        size_t next_chunk_;
+
+    public:
+        VJReadChunkWriter(VJAlignmentStreamOutput &output) : output_(output), next_chunk_(0) { }
+
+        VJReadChunkWriter& operator<<(const VJReadChunkPtr &chunk);
+
+        bool Empty() const { return reorder_buffer_.empty(); }
+    };
+
+    // reads input by chunks, aligns chunks in parallel and writes results in the input order,
+    // so memory consumption does not depend on the input size
+    class VJStreamingProcessor {
+        const VJFinderConfig &config_;
+        const VJGermlineIndex &germline_index_;
+
+        void AlignChunk(VJReadChunk &chunk) const;
+
+    public:
+        VJStreamingProcessor(const VJFinderConfig &config,
+                             const VJGermlineIndex &germline_index) : config_(config),
+                                                                      germline_index_(germline_index) { }
+
+        void Process();
+
+    private:
+        DECL_LOGGER("VJStreamingProcessor");
+    };
+}
@@ -5,6 +5,7 @@
 #include <read_archive.hpp>
 #include "germline_utils/germline_db_generator.hpp"
 #include "vj_parallel_processor.hpp"
+#include "vj_streaming_processor.hpp"
 
 using namespace germline_utils;
 
@@ -19,16 +20,26 @@ namespace vj_finder {
 
     void VJFinderLaunch::Run() {
         INFO("== VJ Finder starts == ");
-        core::ReadArchive read_archive(config_.io_params.input_params.input_reads);
-        if(config_.io_params.output_params.output_details.fix_spaces)
-            read_archive.FixSpacesInHeaders();
         GermlineDbGenerator db_generator(config_.io_params.input_params.germline_input,
                                          config_.algorithm_params.germline_params);
         INFO("Generation of DB for variable segments...");
         germline_utils::CustomGeneDatabase v_db = db_generator.GenerateVariableDb();
         INFO("Generation of DB for join segments...");
         germline_utils::CustomGeneDatabase j_db = db_generator.GenerateJoinDb();
-        VJParallelProcessor processor(read_archive, config_.algorithm_params, v_db, j_db,
+        INFO("Construction of k-mer index for germline segments...");
+        VJGermlineIndex germline_index(config_.algorithm_params, v_db, j_db);
+        if(config_.run_params.streaming) {
+            INFO("Alignment against VJ germline segments starts (streaming mode, chunks of " <<
+                         config_.run_params.chunk_size << " reads)");
+            VJStreamingProcessor processor(config_, germline_index);
+            processor.Process();
+            INFO("== VJ Finder ends == ");
+            return;
+        }
+        core::ReadArchive read_archive(config_.io_params.input_params.input_reads);
+        if(config_.io_params.output_params.output_details.fix_spaces)
+            read_archive.FixSpacesInHeaders();
+        VJParallelProcessor processor(read_archive, config_.algorithm_params, germline_index,
                                       config_.run_params.num_threads);
         INFO("Alignment against VJ germline segments starts");
         VJAlignmentInfo alignment_info = processor.Process();